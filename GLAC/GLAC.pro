@@ -12,6 +12,13 @@ SOURCES += main.cpp \
     observables/topologicalcharge.cpp \
     observables/energydensity.cpp \
     observables/tools/observablestorer.cpp \
+    observables/tools/streamingstatistics.cpp \
+    observables/tools/autocorrelationestimator.cpp \
+    observables/tools/thermalizationdetector.cpp \
+    observables/tools/resampling.cpp \
+    observables/tools/flowanalysis.cpp \
+    observables/tools/flowschedule.cpp \
+    observables/tools/scalesetting.cpp \
     observables/mastersampler.cpp \
     observables/mastersamplertopcxyz.cpp \
     observables/latticeactionchargedensity.cpp \
@@ -30,10 +37,22 @@ SOURCES += main.cpp \
     parallelization/index.cpp \
     parallelization/communicator.cpp \
     parallelization/parallelparameters.cpp \
+    parallelization/phasetimer.cpp \
+    parallelization/processgrid.cpp \
+    parallelization/reductionbuffer.cpp \
+    parallelization/workqueue.cpp \
+    parallelization/haloexchange.cpp \
+    parallelization/linkwindow.cpp \
+    instrumentation/timers.cpp \
     io/observablesio.cpp \
     io/fieldio.cpp \
+    io/checksum.cpp \
+    io/fieldcompression.cpp \
+    io/observablescontainer.cpp \
+    io/checkpointio.cpp \
     tests/testsuite.cpp \
     tests/performancetests.cpp \
+    tests/benchmarks.cpp \
     config/parameters.cpp \
     config/configloader.cpp \
     config/sysprint.cpp \
@@ -60,6 +79,13 @@ HEADERS += \
     observables/topologicalcharge.h \
     observables/energydensity.h \
     observables/tools/observablestorer.h \
+    observables/tools/streamingstatistics.h \
+    observables/tools/autocorrelationestimator.h \
+    observables/tools/thermalizationdetector.h \
+    observables/tools/resampling.h \
+    observables/tools/flowanalysis.h \
+    observables/tools/flowschedule.h \
+    observables/tools/scalesetting.h \
     observables/mastersampler.h \
     observables/observables.h \
     observables/mastersamplertopcxyz.h \
@@ -84,10 +110,23 @@ HEADERS += \
     parallelization/communicator.h \
     parallelization/parallel.h \
     parallelization/parallelparameters.h \
+    parallelization/phasetimer.h \
+    parallelization/processgrid.h \
+    parallelization/reductionbuffer.h \
+    parallelization/workqueue.h \
+    parallelization/haloexchange.h \
+    parallelization/linkwindow.h \
+    instrumentation/timers.h \
     io/observablesio.h \
     io/fieldio.h \
+    io/fieldheader.h \
+    io/checksum.h \
+    io/fieldcompression.h \
+    io/observablescontainer.h \
+    io/checkpointio.h \
     tests/testsuite.h \
     tests/performancetests.h \
+    tests/benchmarks.h \
     tests/test.h \
     config/parameters.h \
     config/configloader.h \
@@ -133,6 +172,11 @@ QMAKE_CFLAGS += -std=c++11
 QMAKE_CXXFLAGS += -std=c++11
 QMAKE_CXXFLAGS_RELEASE += -std=c++11
 
+# Enables the timers of the hot paths, build with "qmake CONFIG+=instrumentation"
+instrumentation {
+    DEFINES += GLAC_INSTRUMENTATION
+}
+
 # Removes flags
 QMAKE_CFLAGS -= -O2
 QMAKE_CXXFLAGS -= -O2
@@ -4,7 +4,6 @@
 Action::Action()
 {
     m_N = Parameters::getN();
-    m_position = std::vector<int>(4,0);
 }
 
 Action::~Action()
@@ -26,11 +26,6 @@ protected:
      * \brief m_N Lattice dimension array
      */
     std::vector<unsigned int> m_N;
-    //! Array for holding the position in lattice.
-    /*!
-     * \brief m_position is used for handling the shift-method in parallelization.
-     */
-    std::vector<int> m_position;
 public:
 
     //! \brief Action base constructor
@@ -24,20 +24,6 @@
 class WilsonExplicitDer : public Action
 {
 private:
-    /*!
-     * \brief m_muIndex Lorentz indices array.
-     *
-     * Needed for loop over the two Lorentz indices in the field strength tensor
-     */
-    int m_muIndex[4];
-
-    /*!
-     * \brief m_nuIndex Lorentz indices array.
-     *
-     * Needed for loop over the two Lorentz indices in the field strength tensor
-     */
-    int m_nuIndex[4];
-
     /*!
      * \brief m_beta the strong coupling constant.
      *
@@ -68,30 +54,6 @@ public:
     double getDeltaAction(SU3 &U, SU3 &UPrime);
     void computeStaple(Lattice<SU3> *lattice, const int i, const int j, const int k, const int l, const int mu);
     Lattice<SU3> getActionDerivative(Lattice<SU3> *lattice, const int mu);
-
-    /*!
-     * \brief updateMuIndex updates the m_muIndex based on mu.
-     * \param mu direction which will be set to 1. All others set to zero.
-     */
-    inline void updateMuIndex(int mu) {
-        for (int i = 0; i < 4; i++)
-        {
-            m_muIndex[i] = 0;
-        }
-        m_muIndex[mu] = 1;
-    }
-
-    /*!
-     * \brief updateNuIndex updates the m_nuIndex based on nu.
-     * \param nu direction which will be set to 1. All others set to zero.
-     */
-    inline void updateNuIndex(int nu) {
-        for (int i = 0; i < 4; i++)
-        {
-            m_nuIndex[i] = 0;
-        }
-        m_nuIndex[nu] = 1;
-    }
 };
 
 #endif // WILSONEXPLICITDER_H
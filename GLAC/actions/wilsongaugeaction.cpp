@@ -2,15 +2,12 @@
 #include "config/parameters.h"
 #include "math/functions.h"
 #include "parallelization/communicator.h"
+#include "instrumentation/timers.h"
 
 WilsonGaugeAction::WilsonGaugeAction(): Action()
 {
     m_beta = Parameters::getBeta();
     m_multiplicationFactor = -m_beta/3.0;
-    for (int i = 0; i < 4; i++) {
-        m_muIndex[i] = 0;
-        m_nuIndex[i] = 0;
-    }
     m_latticeStaple.allocate(m_N);
     m_tempStaple1.allocate(m_N);
     m_tempStaple2.allocate(m_N);
@@ -29,23 +26,18 @@ double WilsonGaugeAction::getDeltaAction(SU3 &U, SU3 &UPrime)
 void WilsonGaugeAction::computeStaple(Lattice<SU3> *lattice, const int i, const int j, const int k, const int l, const int mu)
 {
     m_staple.zeros();
-    updateMuIndex(mu);
-    m_position[0] = i;
-    m_position[1] = j;
-    m_position[2] = k;
-    m_position[3] = l;
+    const unsigned long iSite = Parallel::Index::getIndex(i,j,k,l);
     for (int nu = 0; nu < 4; nu++)
     {
         if (mu == nu) continue;
-        updateNuIndex(nu);
         // Getting first part of staple
-        m_staple1 = Parallel::Communicator::getPositiveLink(lattice,m_position,mu,m_muIndex,nu);
-        m_staple1 *= Parallel::Communicator::getPositiveLink(lattice,m_position,nu,m_nuIndex,mu).inv();
-        m_staple1 *= lattice[nu][Parallel::Index::getIndex(i,j,k,l)].inv();
+        m_staple1 = Parallel::Communicator::getPositiveLink(lattice,iSite,mu,nu);
+        m_staple1 *= Parallel::Communicator::getPositiveLink(lattice,iSite,nu,mu).inv();
+        m_staple1 *= lattice[nu][iSite].inv();
         // Getting second part of staple
-        m_staple2 = Parallel::Communicator::getNeighboursNeighbourLink(lattice,m_position,mu,m_muIndex,nu,m_nuIndex,nu).inv();
-        m_staple2 *= Parallel::Communicator::getNegativeLink(lattice,m_position,nu,m_nuIndex,mu).inv();
-        m_staple2 *= Parallel::Communicator::getNegativeLink(lattice,m_position,nu,m_nuIndex,nu);
+        m_staple2 = Parallel::Communicator::getNeighboursNeighbourLink(lattice,iSite,mu,nu,nu).inv();
+        m_staple2 *= Parallel::Communicator::getNegativeLink(lattice,iSite,nu,mu).inv();
+        m_staple2 *= Parallel::Communicator::getNegativeLink(lattice,iSite,nu,nu);
         // Sums staple
         m_staple += m_staple1;
         m_staple += m_staple2;
@@ -54,6 +46,7 @@ void WilsonGaugeAction::computeStaple(Lattice<SU3> *lattice, const int i, const
 
 Lattice<SU3> WilsonGaugeAction::getActionDerivative(Lattice<SU3> *lattice, const int mu)
 {
+    GLAC_TIMER(ACTION_DERIVATIVE);
     // Computes the staple for current link
     m_latticeStaple.zeros();
     for (int nu = 0; nu < 4; nu++)
@@ -24,9 +24,6 @@
 class WilsonGaugeAction : public Action
 {
 private:
-    // Lorentz indices arrays
-    int m_muIndex[4];
-    int m_nuIndex[4];
     // Action based constants
     double m_beta;
     double m_multiplicationFactor;
@@ -39,21 +36,6 @@ public:
     double getDeltaAction(SU3 &U, SU3 &UPrime);
     void computeStaple(Lattice<SU3> *lattice, const int i, const int j, const int k, const int l, const int mu);
     Lattice<SU3> getActionDerivative(Lattice<SU3> *lattice, const int mu);
-
-    inline void updateMuIndex(int mu) {
-        for (int i = 0; i < 4; i++)
-        {
-            m_muIndex[i] = 0;
-        }
-        m_muIndex[mu] = 1;
-    }
-    inline void updateNuIndex(int nu) {
-        for (int i = 0; i < 4; i++)
-        {
-            m_nuIndex[i] = 0;
-        }
-        m_nuIndex[nu] = 1;
-    }
 };
 
 #endif // WILSONGAUGEACTION_H
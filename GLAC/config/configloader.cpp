@@ -39,6 +39,37 @@ namespace
             Parameters::setFieldConfigurationFileNames(fieldConfigFileNames);
         }
 
+        void setFlowSchedule(json schedule)
+        {
+            std::vector<FlowScheduleEntry> flowSchedule;
+            for (auto it = schedule.begin(); it != schedule.end(); ++it)
+            {
+                FlowScheduleEntry entry;
+                entry.observable = it.key();
+                if (!it.value()["interval"].empty())
+                {
+                    entry.interval = it.value()["interval"];
+                    if (entry.interval == 0)
+                    {
+                        Parallel::Communicator::MPIExit("Error: flow schedule interval of " + entry.observable + " must be at least 1.");
+                    }
+                }
+                if (!it.value()["flowTimes"].empty())
+                {
+                    for (unsigned int i = 0; i < it.value()["flowTimes"].size(); i++)
+                    {
+                        entry.flowTimes.push_back(it.value()["flowTimes"][i]);
+                    }
+                }
+                if (!it.value()["adaptive"].empty())
+                {
+                    entry.adaptive = bool(it.value()["adaptive"]);
+                }
+                flowSchedule.push_back(entry);
+            }
+            Parameters::setFlowSchedule(flowSchedule);
+        }
+
         bool check_file_existence (const std::string fname)
         {
             std::ifstream infile(fname);
@@ -81,6 +112,10 @@ namespace
         Parameters::setOutputFolder(j["outputFolder"]);
         Parameters::setInputFolder(j["inputFolder"]);
         Parameters::setStoreConfigurations(bool(j["storeConfigurations"]));
+        if (!j["fieldConfigurationHeader"].empty())
+        {
+            Parameters::setFieldConfigurationHeader(bool(j["fieldConfigurationHeader"]));
+        }
         Parameters::setStoreThermalizationObservables(bool(j["storeThermalizationObservables"]));
 
         // Human readable output related variables
@@ -101,6 +136,33 @@ namespace
             Parallel::Communicator::setN(tempN);
             Parallel::Index::setN(tempN);
         }
+        if (!j["cartesianTopology"].empty()) {
+            Parameters::setCartesianTopology(bool(j["cartesianTopology"]));
+        }
+        if (!j["sharedMemoryHalo"].empty()) {
+            Parameters::setSharedMemoryHalo(bool(j["sharedMemoryHalo"]));
+        }
+        if (!j["oneSidedMetropolis"].empty()) {
+            Parameters::setOneSidedMetropolis(bool(j["oneSidedMetropolis"]));
+        }
+        if (!j["siteOrdering"].empty()) {
+            Parameters::setSiteOrdering(j["siteOrdering"]);
+            if (!Parallel::Index::setOrdering(Parameters::getSiteOrdering())) {
+                Parallel::Communicator::MPIExit("Error: siteOrdering must be lexicographic, blocked or morton.");
+            }
+        }
+        if (!j["NChains"].empty()) {
+            if (int(j["NChains"]) < 1) {
+                Parallel::Communicator::MPIExit("Error: NChains must be at least 1.");
+            }
+            Parameters::setNChains(j["NChains"]);
+        }
+        if (!j["NFlowGroups"].empty()) {
+            if (int(j["NFlowGroups"]) < 1) {
+                Parallel::Communicator::MPIExit("Error: NFlowGroups must be at least 1.");
+            }
+            Parameters::setNFlowGroups(j["NFlowGroups"]);
+        }
 
         // Exp.func setting (for flow)
         Parameters::setExpFuncName(j["expFunc"]);
@@ -117,6 +179,13 @@ namespace
             setFieldConfigurations(j["field_configs"]);
             Parameters::setLoadFieldConfigurations(bool(j["load_field_configs"]));
             Parameters::setLoadChromaConfigurations(bool(j["chroma_config"]));
+
+            // Without flow, the observables are only measured once for each loaded configuration
+            if (Parameters::getNFlows() == 0)
+            {
+                Parameters::setNCf(j["field_configs"].size());
+                Parameters::setStoreThermalizationObservables(false);
+            }
         }
 
         // Sets a field configuration to load, and then run the metropolis algorithm from the loaded configuration that is assumed to be thermalized
@@ -147,6 +216,25 @@ namespace
         Parameters::setNDerivaitveTests(j["NDerivativeTests"]);
         Parameters::setTaylorPolDegree(j["TaylorPolDegree"]);
 
+        // Component benchmarking
+        if (!j["benchmarking"].empty())
+        {
+            Parameters::setBenchmarking(bool(j["benchmarking"]));
+        }
+        if (!j["benchmarkSubLatticeSizes"].empty())
+        {
+            std::vector<unsigned int> tempSizes = j["benchmarkSubLatticeSizes"];
+            Parameters::setBenchmarkSubLatticeSizes(tempSizes);
+        }
+        if (!j["benchmarkRepetitions"].empty())
+        {
+            Parameters::setBenchmarkRepetitions(j["benchmarkRepetitions"]);
+        }
+        if (!j["benchmarkWarmup"].empty())
+        {
+            Parameters::setBenchmarkWarmup(j["benchmarkWarmup"]);
+        }
+
         // Sets debug variable
         Parameters::setDebug(j["debug"]);
 
@@ -178,5 +266,175 @@ namespace
 
         // Sampling frequency setter
         Parameters::setSamplingFrequency(j["samplingFrequency"]);
+
+        // Binary container output of flow observables
+        if (!j["binaryFlowObservables"].empty())
+        {
+            Parameters::setBinaryFlowObservables(bool(j["binaryFlowObservables"]));
+        }
+        if (!j["flowObservablesBatchSize"].empty())
+        {
+            Parameters::setFlowObservablesBatchSize(j["flowObservablesBatchSize"]);
+        }
+
+        // Field density compression
+        if (!j["compressFieldDensities"].empty())
+        {
+            Parameters::setCompressFieldDensities(bool(j["compressFieldDensities"]));
+        }
+        if (!j["fieldDensityQuantizationBits"].empty())
+        {
+            Parameters::setFieldDensityQuantizationBits(j["fieldDensityQuantizationBits"]);
+            if (Parameters::getFieldDensityQuantizationBits() < 0 || Parameters::getFieldDensityQuantizationBits() > 52)
+            {
+                Parallel::Communicator::MPIExit("Error: fieldDensityQuantizationBits must be between 0(lossless) and 52.");
+            }
+        }
+
+        // Checkpointing of the Markov chain
+        if (!j["checkpointInterval"].empty())
+        {
+            Parameters::setCheckpointInterval(j["checkpointInterval"]);
+        }
+        if (!j["restartFromCheckpoint"].empty())
+        {
+            Parameters::setRestartFromCheckpoint(bool(j["restartFromCheckpoint"]));
+            if (Parameters::getRestartFromCheckpoint() && Parameters::getLoadFieldConfigurations())
+            {
+                Parallel::Communicator::MPIExit("Error: restartFromCheckpoint can only be used when generating configurations.");
+            }
+        }
+        if (!j["autoResume"].empty())
+        {
+            Parameters::setAutoResume(bool(j["autoResume"]));
+            if (Parameters::getAutoResume() && (Parameters::getLoadFieldConfigurations() || Parameters::getCheckpointInterval() <= 0))
+            {
+                Parallel::Communicator::MPIExit("Error: autoResume requires a checkpointInterval, and can only be used when generating configurations.");
+            }
+        }
+
+        // Scaling benchmark
+        if (!j["scalingBenchmark"].empty())
+        {
+            Parameters::setScalingBenchmark(bool(j["scalingBenchmark"]));
+        }
+        if (!j["scalingBenchmarkSweeps"].empty())
+        {
+            Parameters::setScalingBenchmarkSweeps(j["scalingBenchmarkSweeps"]);
+        }
+
+        // Adaptive number of updates between configurations
+        if (!j["adaptiveNCor"].empty())
+        {
+            Parameters::setAdaptiveNCor(bool(j["adaptiveNCor"]));
+        }
+        if (!j["adaptiveNCorTarget"].empty())
+        {
+            Parameters::setAdaptiveNCorTarget(j["adaptiveNCorTarget"]);
+            if (Parameters::getAdaptiveNCorTarget() <= 0.5)
+            {
+                Parallel::Communicator::MPIExit("Error: adaptiveNCorTarget must be larger than 0.5, the integrated autocorrelation time of uncorrelated configurations.");
+            }
+        }
+        if (!j["adaptiveNCorInterval"].empty())
+        {
+            Parameters::setAdaptiveNCorInterval(j["adaptiveNCorInterval"]);
+            if (Parameters::getAdaptiveNCorInterval() < 10)
+            {
+                Parallel::Communicator::MPIExit("Error: adaptiveNCorInterval must be at least 10 configurations.");
+            }
+        }
+        if (!j["adaptiveNCorMax"].empty())
+        {
+            Parameters::setAdaptiveNCorMax(j["adaptiveNCorMax"]);
+        }
+
+        // Automatic end of the thermalization
+        if (!j["autoThermalization"].empty())
+        {
+            Parameters::setAutoThermalization(bool(j["autoThermalization"]));
+            if (Parameters::getAutoThermalization() && Parameters::getStoreThermalizationObservables())
+            {
+                Parallel::Communicator::MPIExit("Error: autoThermalization can not be used together with storeThermalizationObservables.");
+            }
+        }
+        if (!j["NThermMin"].empty())
+        {
+            Parameters::setNThermMin(j["NThermMin"]);
+            if (Parameters::getNThermMin() > Parameters::getNTherm())
+            {
+                Parallel::Communicator::MPIExit("Error: NThermMin can not be larger than NTherm.");
+            }
+        }
+        if (!j["thermalizationWindow"].empty())
+        {
+            Parameters::setThermalizationWindow(j["thermalizationWindow"]);
+        }
+        if (!j["thermalizationInterval"].empty())
+        {
+            Parameters::setThermalizationInterval(j["thermalizationInterval"]);
+            if (Parameters::getThermalizationInterval() == 0)
+            {
+                Parallel::Communicator::MPIExit("Error: thermalizationInterval must be at least 1 update.");
+            }
+        }
+        if (Parameters::getThermalizationWindow() < 10*Parameters::getThermalizationInterval())
+        {
+            Parallel::Communicator::MPIExit("Error: thermalizationWindow must hold at least 10 plaquette measurements, i.e. 10 thermalizationInterval updates.");
+        }
+        if (!j["thermalizationTolerance"].empty())
+        {
+            Parameters::setThermalizationTolerance(j["thermalizationTolerance"]);
+        }
+
+        // Resampling analysis of the flow observables
+        if (!j["flowAnalysis"].empty())
+        {
+            Parameters::setFlowAnalysis(bool(j["flowAnalysis"]));
+        }
+        if (!j["NBootstraps"].empty())
+        {
+            Parameters::setNBootstraps(j["NBootstraps"]);
+            if (Parameters::getNBootstraps() < 2)
+            {
+                Parallel::Communicator::MPIExit("Error: NBootstraps must be at least 2.");
+            }
+        }
+        if (!j["resamplingBlockSize"].empty())
+        {
+            Parameters::setResamplingBlockSize(j["resamplingBlockSize"]);
+            if (Parameters::getResamplingBlockSize() == 0)
+            {
+                Parallel::Communicator::MPIExit("Error: resamplingBlockSize must be at least 1.");
+            }
+        }
+
+        // Measurement schedule of the flow observables
+        if (!j["flowSchedule"].empty())
+        {
+            setFlowSchedule(j["flowSchedule"]);
+        }
+        if (!j["flowScheduleAdaptiveWidth"].empty())
+        {
+            Parameters::setFlowScheduleAdaptiveWidth(j["flowScheduleAdaptiveWidth"]);
+            if (Parameters::getFlowScheduleAdaptiveWidth() <= 0)
+            {
+                Parallel::Communicator::MPIExit("Error: flowScheduleAdaptiveWidth must be positive.");
+            }
+        }
+
+        // Scale setting with early termination of the flow
+        if (!j["scaleSetting"].empty())
+        {
+            Parameters::setScaleSetting(bool(j["scaleSetting"]));
+        }
+        if (!j["scaleSettingMargin"].empty())
+        {
+            Parameters::setScaleSettingMargin(j["scaleSettingMargin"]);
+            if (Parameters::getScaleSettingMargin() < 0)
+            {
+                Parallel::Communicator::MPIExit("Error: scaleSettingMargin can not be negative.");
+            }
+        }
     }
 }
@@ -12,6 +12,12 @@ std::vector<unsigned int> Parameters::m_N;
 unsigned int Parameters::m_subLatticeSize = 1;
 int Parameters::m_processorsPerDimension[4] = {0,0,0,0};
 bool Parameters::m_subLatticeSizePreset = false;
+bool Parameters::m_cartesianTopology = false;
+bool Parameters::m_sharedMemoryHalo = false;
+bool Parameters::m_oneSidedMetropolis = false;
+std::string Parameters::m_siteOrdering = "lexicographic";
+unsigned int Parameters::m_NChains = 1;
+unsigned int Parameters::m_NFlowGroups = 1;
 
 // Physical lattice size dependent values
 double Parameters::m_beta = 0;
@@ -38,6 +44,9 @@ bool Parameters::m_storeThermalizationObservables = false;
 // Variable storing gauge configurations
 bool Parameters::m_storeConfigurations = false;
 
+// Variable storing if the gauge configurations are written with a FieldHeader. Off by default, such that raw readers still work
+bool Parameters::m_fieldConfigurationHeader = false;
+
 // Variable storing if we are to start hot or cold
 bool Parameters::m_hotStart = false;
 
@@ -66,6 +75,12 @@ unsigned int Parameters::m_NRandTests = 0;
 unsigned int Parameters::m_NDerivativeTests = 0;
 unsigned int Parameters::m_NTaylorPolDegree = 8;
 
+// Component benchmarking, sub lattice extents are per processor
+bool Parameters::m_benchmarking = false;
+std::vector<unsigned int> Parameters::m_benchmarkSubLatticeSizes = {4, 8};
+unsigned int Parameters::m_benchmarkRepetitions = 10;
+unsigned int Parameters::m_benchmarkWarmup = 2;
+
 // Data generation related variables
 double Parameters::m_SU3Eps = 0.24;
 double Parameters::m_flowEpsilon = 0.01;
@@ -89,6 +104,50 @@ int Parameters::m_configStartNumber = 0;
 // Parameter for storing the sampling frequency of the field
 int Parameters::m_samplingFrequency = 25;
 
+// Binary container output of flow observables
+bool Parameters::m_binaryFlowObservables = false;
+unsigned int Parameters::m_flowObservablesBatchSize = 10;
+
+// Field density compression. Zero quantization bits gives lossless compression
+bool Parameters::m_compressFieldDensities = false;
+int Parameters::m_fieldDensityQuantizationBits = 12;
+
+// Checkpointing of the Markov chain. The interval is in minutes of wall time, zero disables checkpointing
+double Parameters::m_checkpointInterval = 0;
+bool Parameters::m_restartFromCheckpoint = false;
+bool Parameters::m_autoResume = false;
+
+// Scaling benchmark, timing a fixed number of Metropolis sweeps and the flow of a single configuration
+bool Parameters::m_scalingBenchmark = false;
+unsigned int Parameters::m_scalingBenchmarkSweeps = 10;
+
+// Adaptive NCor. The target is the integrated autocorrelation time in units of configurations, and the interval the number of configurations between adjustments
+bool Parameters::m_adaptiveNCor = false;
+double Parameters::m_adaptiveNCorTarget = 1.0;
+unsigned int Parameters::m_adaptiveNCorInterval = 100;
+unsigned int Parameters::m_adaptiveNCorMax = 1000;
+
+// Automatic end of the thermalization, between NThermMin and NTherm updates. The tolerance is given in standard errors of the difference of the window means,
+// and the plaquette is measured every thermalizationInterval updates
+bool Parameters::m_autoThermalization = false;
+unsigned int Parameters::m_NThermMin = 0;
+unsigned int Parameters::m_thermalizationWindow = 50;
+unsigned int Parameters::m_thermalizationInterval = 5;
+double Parameters::m_thermalizationTolerance = 2.0;
+
+// Jackknife and bootstrap analysis of t0, w0 and chi_t at the end of a run. The block size is given in configurations
+bool Parameters::m_flowAnalysis = false;
+unsigned int Parameters::m_NBootstraps = 500;
+unsigned int Parameters::m_resamplingBlockSize = 1;
+
+// Flow observables without an entry in the schedule are measured at every flow step. The adaptive width is the distance in t^2 E from 0.3
+std::vector<FlowScheduleEntry> Parameters::m_flowSchedule;
+double Parameters::m_flowScheduleAdaptiveWidth = 0.15;
+
+// Scale setting, ending the flow once t^2 E and t d/dt (t^2 E) both exceed 0.3 by the margin. NFlows is then the largest number of flow steps
+bool Parameters::m_scaleSetting = false;
+double Parameters::m_scaleSettingMargin = 0.05;
+
 // Debug parameter
 bool Parameters::m_debug = false;
 
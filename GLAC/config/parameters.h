@@ -16,6 +16,21 @@
 #include <string>
 #include <vector>
 
+/*!
+ * \brief The FlowScheduleEntry struct holds the flow times a flow observable is measured at.
+ *
+ * The observable is measured every interval flow steps, at the steps closest to the given flow times, and, if adaptive, at every step while
+ * t^2 E(t) is close to the reference value of t0. The first and last flow times are always measured, and the flow times skipped are written
+ * as NaN.
+ */
+struct FlowScheduleEntry
+{
+    std::string observable;
+    unsigned int interval = 1;
+    std::vector<double> flowTimes;
+    bool adaptive = false;
+};
+
 class Parameters
 {
     friend class SysPrint;
@@ -30,6 +45,12 @@ private:
     static unsigned int m_subLatticeSize;
     static int m_processorsPerDimension[4];
     static bool m_subLatticeSizePreset;
+    static bool m_cartesianTopology;
+    static bool m_sharedMemoryHalo;
+    static bool m_oneSidedMetropolis;
+    static std::string m_siteOrdering;
+    static unsigned int m_NChains;
+    static unsigned int m_NFlowGroups;
 
     // Action type
     static std::string m_actionType;
@@ -50,6 +71,9 @@ private:
     // Variable storing gauge configurations
     static bool m_storeConfigurations;
 
+    // Variable storing if the gauge configurations are written with a FieldHeader
+    static bool m_fieldConfigurationHeader;
+
     // Variable storing if we are to start hot or cold
     static bool m_hotStart;
 
@@ -84,6 +108,12 @@ private:
     static unsigned int m_NDerivativeTests;
     static unsigned int m_NTaylorPolDegree;
 
+    // Component benchmarking
+    static bool m_benchmarking;
+    static std::vector<unsigned int> m_benchmarkSubLatticeSizes;
+    static unsigned int m_benchmarkRepetitions;
+    static unsigned int m_benchmarkWarmup;
+
     // Data generation related variables
     static double m_SU3Eps;
     static double m_flowEpsilon;
@@ -107,6 +137,49 @@ private:
     // Integer for storing the sampling frequency
     static int m_samplingFrequency;
 
+    // Binary container output of flow observables
+    static bool m_binaryFlowObservables;
+    static unsigned int m_flowObservablesBatchSize;
+
+    // Compression of the sampled field densities
+    static bool m_compressFieldDensities;
+    static int m_fieldDensityQuantizationBits;
+
+    // Checkpointing of the Markov chain
+    static double m_checkpointInterval;
+    static bool m_restartFromCheckpoint;
+    static bool m_autoResume;
+
+    // Scaling benchmark
+    static bool m_scalingBenchmark;
+    static unsigned int m_scalingBenchmarkSweeps;
+
+    // Adaptive number of updates between configurations
+    static bool m_adaptiveNCor;
+    static double m_adaptiveNCorTarget;
+    static unsigned int m_adaptiveNCorInterval;
+    static unsigned int m_adaptiveNCorMax;
+
+    // Automatic end of the thermalization
+    static bool m_autoThermalization;
+    static unsigned int m_NThermMin;
+    static unsigned int m_thermalizationWindow;
+    static unsigned int m_thermalizationInterval;
+    static double m_thermalizationTolerance;
+
+    // Resampling analysis of the flow observables
+    static bool m_flowAnalysis;
+    static unsigned int m_NBootstraps;
+    static unsigned int m_resamplingBlockSize;
+
+    // Measurement schedule of the flow observables
+    static std::vector<FlowScheduleEntry> m_flowSchedule;
+    static double m_flowScheduleAdaptiveWidth;
+
+    // Scale setting with early termination of the flow
+    static bool m_scaleSetting;
+    static double m_scaleSettingMargin;
+
     // Debug parameter
     static bool m_debug;
 
@@ -132,6 +205,7 @@ public:
     static void setOutputFolder(std::string outputFolder) { m_outputFolder = outputFolder; }
     static void setInputFolder(std::string inputFolder) { m_inputFolder = inputFolder; }
     static void setStoreConfigurations(bool storeConfigurations) { m_storeConfigurations = storeConfigurations; }
+    static void setFieldConfigurationHeader(bool fieldConfigurationHeader) { m_fieldConfigurationHeader = fieldConfigurationHeader; }
     static void setStoreThermalizationObservables(bool storeThermalizationObservables) { m_storeThermalizationObservables = storeThermalizationObservables; }
 
     // Human readable output related setters
@@ -155,6 +229,10 @@ public:
     static void setNRandTests(const unsigned int NRandTests) { m_NRandTests = NRandTests; }
     static void setNDerivaitveTests(const unsigned int NDerivativeTests) { m_NDerivativeTests = NDerivativeTests; }
     static void setTaylorPolDegree(const unsigned int NTaylorPolDegree) { m_NTaylorPolDegree = NTaylorPolDegree; }
+    static void setBenchmarking(const bool benchmarking) { m_benchmarking = benchmarking; }
+    static void setBenchmarkSubLatticeSizes(const std::vector<unsigned int> &benchmarkSubLatticeSizes) { m_benchmarkSubLatticeSizes = benchmarkSubLatticeSizes; }
+    static void setBenchmarkRepetitions(const unsigned int benchmarkRepetitions) { m_benchmarkRepetitions = benchmarkRepetitions; }
+    static void setBenchmarkWarmup(const unsigned int benchmarkWarmup) { m_benchmarkWarmup = benchmarkWarmup; }
 
     // Data generation related setters
     static void setFlowEpsilon(const double flowEpsilon) { m_flowEpsilon = flowEpsilon; }
@@ -170,6 +248,12 @@ public:
     static void setSubLatticePreset(const bool subLatticeSizePreset) { m_subLatticeSizePreset = subLatticeSizePreset; }
     static void setSubLatticeSize(const unsigned int subLatticeSize) { m_subLatticeSize = subLatticeSize; }
     static void setProcessorsPerDimension(int *processorsPerDimension) { for (unsigned int i = 0; i < 4; i++) m_processorsPerDimension[i] = processorsPerDimension[i]; }
+    static void setCartesianTopology(const bool cartesianTopology) { m_cartesianTopology = cartesianTopology; }
+    static void setSharedMemoryHalo(const bool sharedMemoryHalo) { m_sharedMemoryHalo = sharedMemoryHalo; }
+    static void setOneSidedMetropolis(const bool oneSidedMetropolis) { m_oneSidedMetropolis = oneSidedMetropolis; }
+    static void setSiteOrdering(const std::string &siteOrdering) { m_siteOrdering = siteOrdering; }
+    static void setNChains(const unsigned int NChains) { m_NChains = NChains; }
+    static void setNFlowGroups(const unsigned int NFlowGroups) { m_NFlowGroups = NFlowGroups; }
 
     // Action type
     static void setActionType(std::string actionType) { m_actionType = actionType; }
@@ -191,6 +275,49 @@ public:
     // Setter for the sampling frequency
     static void setSamplingFrequency(int samplingFrequency) { m_samplingFrequency = samplingFrequency; }
 
+    // Setters for binary container output of flow observables
+    static void setBinaryFlowObservables(bool binaryFlowObservables) { m_binaryFlowObservables = binaryFlowObservables; }
+    static void setFlowObservablesBatchSize(unsigned int flowObservablesBatchSize) { m_flowObservablesBatchSize = flowObservablesBatchSize; }
+
+    // Setters for field density compression
+    static void setCompressFieldDensities(bool compressFieldDensities) { m_compressFieldDensities = compressFieldDensities; }
+    static void setFieldDensityQuantizationBits(int fieldDensityQuantizationBits) { m_fieldDensityQuantizationBits = fieldDensityQuantizationBits; }
+
+    // Setters for checkpointing of the Markov chain
+    static void setCheckpointInterval(double checkpointInterval) { m_checkpointInterval = checkpointInterval; }
+    static void setRestartFromCheckpoint(bool restartFromCheckpoint) { m_restartFromCheckpoint = restartFromCheckpoint; }
+    static void setAutoResume(bool autoResume) { m_autoResume = autoResume; }
+
+    // Setters for the scaling benchmark
+    static void setScalingBenchmark(bool scalingBenchmark) { m_scalingBenchmark = scalingBenchmark; }
+    static void setScalingBenchmarkSweeps(unsigned int scalingBenchmarkSweeps) { m_scalingBenchmarkSweeps = scalingBenchmarkSweeps; }
+
+    // Setters for the adaptive number of updates between configurations
+    static void setAdaptiveNCor(bool adaptiveNCor) { m_adaptiveNCor = adaptiveNCor; }
+    static void setAdaptiveNCorTarget(double adaptiveNCorTarget) { m_adaptiveNCorTarget = adaptiveNCorTarget; }
+    static void setAdaptiveNCorInterval(unsigned int adaptiveNCorInterval) { m_adaptiveNCorInterval = adaptiveNCorInterval; }
+    static void setAdaptiveNCorMax(unsigned int adaptiveNCorMax) { m_adaptiveNCorMax = adaptiveNCorMax; }
+
+    // Setters for the automatic end of the thermalization
+    static void setAutoThermalization(bool autoThermalization) { m_autoThermalization = autoThermalization; }
+    static void setNThermMin(unsigned int NThermMin) { m_NThermMin = NThermMin; }
+    static void setThermalizationWindow(unsigned int thermalizationWindow) { m_thermalizationWindow = thermalizationWindow; }
+    static void setThermalizationInterval(unsigned int thermalizationInterval) { m_thermalizationInterval = thermalizationInterval; }
+    static void setThermalizationTolerance(double thermalizationTolerance) { m_thermalizationTolerance = thermalizationTolerance; }
+
+    // Setters for the resampling analysis of the flow observables
+    static void setFlowAnalysis(bool flowAnalysis) { m_flowAnalysis = flowAnalysis; }
+    static void setNBootstraps(unsigned int NBootstraps) { m_NBootstraps = NBootstraps; }
+    static void setResamplingBlockSize(unsigned int resamplingBlockSize) { m_resamplingBlockSize = resamplingBlockSize; }
+
+    // Setters for the measurement schedule of the flow observables
+    static void setFlowSchedule(std::vector<FlowScheduleEntry> flowSchedule) { m_flowSchedule = flowSchedule; }
+    static void setFlowScheduleAdaptiveWidth(double flowScheduleAdaptiveWidth) { m_flowScheduleAdaptiveWidth = flowScheduleAdaptiveWidth; }
+
+    // Setters for the scale setting
+    static void setScaleSetting(bool scaleSetting) { m_scaleSetting = scaleSetting; }
+    static void setScaleSettingMargin(double scaleSettingMargin) { m_scaleSettingMargin = scaleSettingMargin; }
+
     // Getter for debug parameter
     static void setDebug(bool debug) { m_debug = debug; }
 
@@ -211,6 +338,7 @@ public:
     static std::string getOutputFolder() { return m_outputFolder; }
     static std::string getInputFolder() { return m_inputFolder; }
     static bool getStoreConfigurations() { return m_storeConfigurations; }
+    static bool getFieldConfigurationHeader() { return m_fieldConfigurationHeader; }
     static bool getStoreThermalizationObservables() { return m_storeThermalizationObservables; }
 
     // Human readable output related getters
@@ -234,6 +362,10 @@ public:
     static unsigned int getNRandTests() { return m_NRandTests; }
     static unsigned int getNDerivativeTests() { return m_NDerivativeTests; }
     static unsigned int getTaylorPolDegree() { return m_NTaylorPolDegree; }
+    static bool getBenchmarking() { return m_benchmarking; }
+    static std::vector<unsigned int> getBenchmarkSubLatticeSizes() { return m_benchmarkSubLatticeSizes; }
+    static unsigned int getBenchmarkRepetitions() { return m_benchmarkRepetitions; }
+    static unsigned int getBenchmarkWarmup() { return m_benchmarkWarmup; }
 
     // Data generation related getters
     static double getFlowEpsilon() { return m_flowEpsilon; }
@@ -250,6 +382,12 @@ public:
     static bool getSubLatticePreset() { return m_subLatticeSizePreset; }
     static unsigned int getSubLatticeSize() { return m_subLatticeSize; }
     static void getProcessorsPerDimension(int *processorsPerDimension) { for (unsigned int i = 0; i < 4; i++) m_processorsPerDimension[i] = processorsPerDimension[i]; }
+    static bool getCartesianTopology() { return m_cartesianTopology; }
+    static bool getSharedMemoryHalo() { return m_sharedMemoryHalo; }
+    static bool getOneSidedMetropolis() { return m_oneSidedMetropolis; }
+    static std::string getSiteOrdering() { return m_siteOrdering; }
+    static unsigned int getNChains() { return m_NChains; }
+    static unsigned int getNFlowGroups() { return m_NFlowGroups; }
 
     // Action type
     static std::string getActionType() { return m_actionType; }
@@ -271,6 +409,49 @@ public:
     // Getter for field density sampling frequency
     static int getSamplingFrequency() { return m_samplingFrequency; }
 
+    // Getters for binary container output of flow observables
+    static bool getBinaryFlowObservables() { return m_binaryFlowObservables; }
+    static unsigned int getFlowObservablesBatchSize() { return m_flowObservablesBatchSize; }
+
+    // Getters for field density compression
+    static bool getCompressFieldDensities() { return m_compressFieldDensities; }
+    static int getFieldDensityQuantizationBits() { return m_fieldDensityQuantizationBits; }
+
+    // Getters for checkpointing of the Markov chain
+    static double getCheckpointInterval() { return m_checkpointInterval; }
+    static bool getRestartFromCheckpoint() { return m_restartFromCheckpoint; }
+    static bool getAutoResume() { return m_autoResume; }
+
+    // Getters for the scaling benchmark
+    static bool getScalingBenchmark() { return m_scalingBenchmark; }
+    static unsigned int getScalingBenchmarkSweeps() { return m_scalingBenchmarkSweeps; }
+
+    // Getters for the adaptive number of updates between configurations
+    static bool getAdaptiveNCor() { return m_adaptiveNCor; }
+    static double getAdaptiveNCorTarget() { return m_adaptiveNCorTarget; }
+    static unsigned int getAdaptiveNCorInterval() { return m_adaptiveNCorInterval; }
+    static unsigned int getAdaptiveNCorMax() { return m_adaptiveNCorMax; }
+
+    // Getters for the automatic end of the thermalization
+    static bool getAutoThermalization() { return m_autoThermalization; }
+    static unsigned int getNThermMin() { return m_NThermMin; }
+    static unsigned int getThermalizationWindow() { return m_thermalizationWindow; }
+    static unsigned int getThermalizationInterval() { return m_thermalizationInterval; }
+    static double getThermalizationTolerance() { return m_thermalizationTolerance; }
+
+    // Getters for the resampling analysis of the flow observables
+    static bool getFlowAnalysis() { return m_flowAnalysis; }
+    static unsigned int getNBootstraps() { return m_NBootstraps; }
+    static unsigned int getResamplingBlockSize() { return m_resamplingBlockSize; }
+
+    // Getters for the measurement schedule of the flow observables
+    static std::vector<FlowScheduleEntry> getFlowSchedule() { return m_flowSchedule; }
+    static double getFlowScheduleAdaptiveWidth() { return m_flowScheduleAdaptiveWidth; }
+
+    // Getters for the scale setting
+    static bool getScaleSetting() { return m_scaleSetting; }
+    static double getScaleSettingMargin() { return m_scaleSettingMargin; }
+
     // Getter for debug parameter
     static bool getDebug() { return m_debug; }
 };
@@ -61,6 +61,16 @@ void SysPrint::printSystemInfo()
             cout << Parameters::m_processorsPerDimension[i] << " ";
         }
         cout << endl;
+        cout << "Cartesian topology:                    " << getTrueOrFalseString(Parameters::m_cartesianTopology) << endl;
+        cout << "Shared memory halo:                    " << getTrueOrFalseString(Parameters::m_sharedMemoryHalo) << endl;
+        cout << "One-sided Metropolis:                  " << getTrueOrFalseString(Parameters::m_oneSidedMetropolis) << endl;
+        cout << "Site ordering:                         " << Parameters::m_siteOrdering << endl;
+        if (Parameters::m_NChains > 1) {
+            cout << "Chain:                                 " << Parallel::Communicator::getGroup() << " of " << Parameters::m_NChains << endl;
+        }
+        if (Parameters::m_NFlowGroups > 1) {
+            cout << "Flow group:                            " << Parallel::Communicator::getGroup() << " of " << Parameters::m_NFlowGroups << endl;
+        }
         cout << "Beta:                                  " << Parameters::m_beta << endl;
         if (!Parameters::getLoadFieldConfigurations()) {
             cout << "N configurations:                      " << Parameters::m_NCf << endl;
@@ -77,7 +87,16 @@ void SysPrint::printSystemInfo()
         cout << "Input folder:                          " << Parameters::m_pwd + Parameters::m_inputFolder << endl;
         if (!Parameters::getLoadFieldConfigurations()) {
             cout << "Store field configurations:            " << getTrueOrFalseString(Parameters::m_storeConfigurations) << endl;
+            if (Parameters::m_storeConfigurations) {
+                cout << "Field configuration header:            " << getTrueOrFalseString(Parameters::m_fieldConfigurationHeader) << endl;
+            }
             cout << "Store thermalization observables:      " << getTrueOrFalseString(Parameters::m_storeThermalizationObservables) << endl;
+            if (Parameters::m_autoThermalization) {
+                cout << "Min. thermalization updates:           " << Parameters::m_NThermMin << endl;
+                cout << "Thermalization window:                 " << Parameters::m_thermalizationWindow << endl;
+                cout << "Thermalization interval:               " << Parameters::m_thermalizationInterval << endl;
+                cout << "Thermalization tolerance:              " << Parameters::m_thermalizationTolerance << endl;
+            }
         }
         if (Parameters::m_NFlows != 0) {
             cout << "Exponentiation function:               " << Parameters::m_expFuncName << endl;
@@ -89,9 +108,42 @@ void SysPrint::printSystemInfo()
         if (Parameters::m_NFlows != 0) {
             cout << "Flow observables:                      " << getListString(Parameters::m_flowObservablesList) << endl;
             cout << "Flow epsilon:                          " << Parameters::m_flowEpsilon << endl;
+            cout << "Binary flow observables:               " << getTrueOrFalseString(Parameters::m_binaryFlowObservables) << endl;
+            if (Parameters::m_binaryFlowObservables) {
+                cout << "Flow observables batch size:           " << Parameters::m_flowObservablesBatchSize << endl;
+            }
+            cout << "Flow analysis:                         " << getTrueOrFalseString(Parameters::m_flowAnalysis) << endl;
+            if (Parameters::m_flowAnalysis) {
+                cout << "N bootstrap samples:                   " << Parameters::m_NBootstraps << endl;
+                cout << "Resampling block size:                 " << Parameters::m_resamplingBlockSize << endl;
+            }
+            bool adaptiveFlowSchedule = false;
+            for (auto &entry : Parameters::m_flowSchedule) {
+                cout << std::left << std::setw(39) << ("Flow schedule of " + entry.observable + ":")
+                     << "every " << entry.interval << " steps";
+                if (entry.flowTimes.size() != 0) {
+                    cout << ", " << entry.flowTimes.size() << " flow times";
+                }
+                if (entry.adaptive) {
+                    cout << ", adaptive";
+                    adaptiveFlowSchedule = true;
+                }
+                cout << endl;
+            }
+            if (adaptiveFlowSchedule) {
+                cout << "Flow schedule adaptive width:          " << Parameters::m_flowScheduleAdaptiveWidth << endl;
+            }
+            cout << "Scale setting:                         " << getTrueOrFalseString(Parameters::m_scaleSetting) << endl;
+            if (Parameters::m_scaleSetting) {
+                cout << "Scale setting margin:                  " << Parameters::m_scaleSettingMargin << endl;
+            }
             if (Parameters::getFlowObservablesList()[0] == "energyTopcFieldDensity")
             {
                 cout << "Flow sampling frequency:               " << Parameters::getSamplingFrequency() << endl;
+                cout << "Compress field densities:              " << getTrueOrFalseString(Parameters::m_compressFieldDensities) << endl;
+                if (Parameters::m_compressFieldDensities) {
+                    cout << "Field density quantization bits:       " << Parameters::m_fieldDensityQuantizationBits << endl;
+                }
             }
         }
         if (!Parameters::getLoadFieldConfigurations()) {
@@ -106,6 +158,23 @@ void SysPrint::printSystemInfo()
             if (Parameters::m_hotStart) {
                 cout << "Random start close to unity:           " << getTrueOrFalseString(Parameters::m_RSTHotStart) << endl;
             }
+            if (Parameters::m_checkpointInterval > 0) {
+                cout << "Checkpoint interval(minutes):          " << Parameters::m_checkpointInterval << endl;
+            }
+            if (Parameters::m_restartFromCheckpoint) {
+                cout << "Restart from checkpoint:               TRUE" << endl;
+            }
+            if (Parameters::m_autoResume) {
+                cout << "Auto resume from checkpoint:           TRUE" << endl;
+            }
+            if (Parameters::m_adaptiveNCor) {
+                cout << "Adaptive NCor target tau_int:          " << Parameters::m_adaptiveNCorTarget << endl;
+                cout << "Adaptive NCor interval:                " << Parameters::m_adaptiveNCorInterval << endl;
+                cout << "Adaptive NCor max:                     " << Parameters::m_adaptiveNCorMax << endl;
+            }
+        }
+        if (Parameters::m_scalingBenchmark) {
+            cout << "Scaling benchmark sweeps:              " << Parameters::m_scalingBenchmarkSweeps << endl;
         }
         if (Parameters::m_debug) {
             cout << "Debug:                                 TRUE" << endl;
@@ -1,6 +1,7 @@
 #include "flow.h"
 #include "parallelization/index.h"
 #include "config/parameters.h"
+#include "instrumentation/timers.h"
 
 /*!
  * \brief Flow::Flow
@@ -45,6 +46,7 @@ void Flow::flowField(Lattice<SU3> *lattice)
     /*
      * Performs a single flow on the lattice.
      */
+    GLAC_TIMER(FLOW_STEP);
     // W0 is simply just the original lattice times epsilon
     // Sets Z0 in temporary lattice
     for (unsigned int mu = 0; mu < 4; mu++) {
@@ -97,6 +99,7 @@ inline Lattice<SU3> Flow::matrixExp(const Lattice<SU3> &lattice)
     /*
      * Move semantic method for exponentiating the lattice, using reference.
      */
+    GLAC_TIMER(FLOW_EXPONENTIATION);
     for (unsigned long iSite = 0; iSite < lattice.m_latticeSize; iSite++) {
         m_tempExpLattice.m_sites[iSite] = m_SU3ExpFunc->exp(lattice.m_sites[iSite]);
     }
@@ -108,6 +111,7 @@ inline Lattice<SU3> Flow::matrixExp(Lattice<SU3> &&lattice)
     /*
      * Move semantic method for exponentiating the lattice, using rvalue.
      */
+    GLAC_TIMER(FLOW_EXPONENTIATION);
     for (unsigned long iSite = 0; iSite < lattice.m_latticeSize; iSite++) {
         m_tempExpLattice.m_sites[iSite] = m_SU3ExpFunc->exp(lattice.m_sites[iSite]);
     }
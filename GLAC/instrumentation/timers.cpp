@@ -0,0 +1,177 @@
+#include "timers.h"
+#include "parallelization/communicator.h"
+#include "parallelization/parallelparameters.h"
+#include <mpi.h>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+const char *Instrumentation::Timers::m_regionNames[Instrumentation::NUMBER_OF_REGIONS] = {
+    "System::update",
+    "System::flowConfiguration",
+    "Flow::flowField",
+    "Flow::matrixExp",
+    "Action::getActionDerivative",
+    "shift",
+    "Plaquette::calculate",
+    "TopologicalCharge::calculate",
+    "EnergyDensity::calculate",
+    "MasterSampler::calculate",
+    "MasterSamplerTopcXYZ::calculate",
+    "SuperSampler::calculate",
+    "LatticeActionChargeDensity::calculate",
+    "ObservableStorer::gatherResults",
+    "FieldIO write",
+    "FieldIO read"
+};
+
+thread_local Instrumentation::Accumulator *Instrumentation::Timers::m_threadAccumulators = nullptr;
+thread_local int Instrumentation::Timers::m_threadCounters = -1;
+
+namespace {
+    // Accumulators of all threads, such that they may be summed at the end of the program
+    std::mutex registryMutex;
+    std::deque<std::array<Instrumentation::Accumulator, Instrumentation::NUMBER_OF_REGIONS>> registry;
+
+#ifdef __linux__
+    int openCounter(const unsigned long long config, const int groupLeader)
+    {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(perf_event_attr));
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.size = sizeof(perf_event_attr);
+        attributes.config = config;
+        attributes.disabled = (groupLeader == -1) ? 1 : 0;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_GROUP;
+        return int(syscall(__NR_perf_event_open, &attributes, 0, -1, groupLeader, 0));
+    }
+#endif
+}
+
+/*!
+ * \brief Instrumentation::Timers::registerThread allocates the accumulators of the calling thread, and opens its hardware counters if possible.
+ * \return the accumulators of the calling thread.
+ */
+Instrumentation::Accumulator *Instrumentation::Timers::registerThread()
+{
+#ifdef __linux__
+    // Cycles lead the group, such that both counters are read with a single system call
+    const int cycles = openCounter(PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (cycles >= 0) {
+        const int instructions = openCounter(PERF_COUNT_HW_INSTRUCTIONS, cycles);
+        if (instructions >= 0) {
+            ioctl(cycles, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            m_threadCounters = cycles;
+        } else {
+            close(cycles);
+        }
+    }
+#endif
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    registry.emplace_back();
+    std::memset(registry.back().data(), 0, sizeof(Accumulator)*NUMBER_OF_REGIONS);
+    return registry.back().data();
+}
+
+/*!
+ * \brief Instrumentation::Timers::readCounters reads the hardware counters of the calling thread.
+ * \param cycles the number of cycles counted.
+ * \param instructions the number of instructions counted.
+ * \return false if hardware counters are not available.
+ */
+bool Instrumentation::Timers::readCounters(unsigned long long &cycles, unsigned long long &instructions)
+{
+#ifdef __linux__
+    if (m_threadCounters < 0) return false;
+
+    // Layout given by PERF_FORMAT_GROUP: number of counters followed by their values
+    unsigned long long values[3];
+    if (read(m_threadCounters, values, sizeof(values)) != sizeof(values)) return false;
+    cycles = values[1];
+    instructions = values[2];
+    return true;
+#else
+    (void)cycles;
+    (void)instructions;
+    return false;
+#endif
+}
+
+/*!
+ * \brief Instrumentation::Timers::printSummary sums the regions over threads and processors, and prints a table from the root processor.
+ * \param programTime wall time of the program in seconds, used for the share of each region.
+ *
+ * Prints nothing if no region has been timed, i.e. if the program is built without instrumentation.
+ */
+void Instrumentation::Timers::printSummary(const double programTime)
+{
+    if (!Parallel::ParallelParameters::active) return;
+
+    std::vector<double> seconds(NUMBER_OF_REGIONS, 0);
+    std::vector<unsigned long long> calls(NUMBER_OF_REGIONS, 0), cycles(NUMBER_OF_REGIONS, 0), instructions(NUMBER_OF_REGIONS, 0);
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (auto &threadAccumulators : registry) {
+            for (unsigned int i = 0; i < NUMBER_OF_REGIONS; i++) {
+                seconds[i] += threadAccumulators[i].seconds;
+                calls[i] += threadAccumulators[i].calls;
+                cycles[i] += threadAccumulators[i].cycles;
+                instructions[i] += threadAccumulators[i].instructions;
+            }
+        }
+    }
+
+    std::vector<double> minSeconds(NUMBER_OF_REGIONS), maxSeconds(NUMBER_OF_REGIONS), sumSeconds(NUMBER_OF_REGIONS);
+    std::vector<unsigned long long> maxCalls(NUMBER_OF_REGIONS), sumCycles(NUMBER_OF_REGIONS), sumInstructions(NUMBER_OF_REGIONS);
+    MPI_Reduce(seconds.data(), minSeconds.data(), NUMBER_OF_REGIONS, MPI_DOUBLE, MPI_MIN, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+    MPI_Reduce(seconds.data(), maxSeconds.data(), NUMBER_OF_REGIONS, MPI_DOUBLE, MPI_MAX, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+    MPI_Reduce(seconds.data(), sumSeconds.data(), NUMBER_OF_REGIONS, MPI_DOUBLE, MPI_SUM, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+    MPI_Reduce(calls.data(), maxCalls.data(), NUMBER_OF_REGIONS, MPI_UNSIGNED_LONG_LONG, MPI_MAX, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+    MPI_Reduce(cycles.data(), sumCycles.data(), NUMBER_OF_REGIONS, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+    MPI_Reduce(instructions.data(), sumInstructions.data(), NUMBER_OF_REGIONS, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+
+    if (Parallel::Communicator::getProcessRank() != 0) return;
+
+    bool anyTimed = false;
+    bool anyCounted = false;
+    for (unsigned int i = 0; i < NUMBER_OF_REGIONS; i++) {
+        anyTimed = anyTimed || maxCalls[i] > 0;
+        anyCounted = anyCounted || sumCycles[i] > 0;
+    }
+    if (!anyTimed) return;
+
+    const double numprocs = double(Parallel::Communicator::getNumProc());
+
+    printf("\n\nInstrumented regions(inclusive times, over %d processors):", Parallel::Communicator::getNumProc());
+    printf("\n%-40s %12s %12s %12s %12s %8s", "Region", "Calls", "Min(s)", "Avg(s)", "Max(s)", "Program");
+    if (anyCounted) {
+        printf(" %10s %6s", "GCycles", "IPC");
+    }
+    for (unsigned int i = 0; i < NUMBER_OF_REGIONS; i++) {
+        if (maxCalls[i] == 0) continue;
+        const double avgSeconds = sumSeconds[i] / numprocs;
+        printf("\n%-40s %12llu %12.4E %12.4E %12.4E %7.2f%%", m_regionNames[i], maxCalls[i],
+               minSeconds[i], avgSeconds, maxSeconds[i], 100.0 * avgSeconds / programTime);
+        if (anyCounted) {
+            printf(" %10.4f %6.2f", double(sumCycles[i]) / numprocs * 1e-9,
+                   (sumCycles[i] > 0 ? double(sumInstructions[i]) / double(sumCycles[i]) : 0.0));
+        }
+    }
+    if (!anyCounted) {
+        printf("\nHardware counters are not available, see /proc/sys/kernel/perf_event_paranoid.");
+    }
+    printf("\n");
+}
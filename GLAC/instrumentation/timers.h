@@ -0,0 +1,126 @@
+/*!
+ * \class Timers
+ *
+ * \brief Timers holds the accumulated time spent in the instrumented regions of the hot paths.
+ *
+ * A region is timed by placing GLAC_TIMER(REGION) at the top of a scope, which creates a ScopedTimer adding the time until the end of the scope
+ * to the region. The macro is empty unless the program is built with <code>qmake CONFIG+=instrumentation</code>, such that a regular build is unaffected.
+ *
+ * Accumulators are thread local, and registered on first use such that printSummary may sum them. On Linux, the cycles and instructions of each region
+ * are counted through perf_event if the kernel allows it. Times are inclusive, i.e. a flow step includes the shifts and action derivatives within it.
+ *
+ * Only regions that are entered at most some thousand times per second are instrumented, e.g. a full Metropolis sweep rather than a single link update,
+ * such that the overhead stays well below a percent.
+ *
+ * \author Mathias M. Vege
+ * \version 1.0
+ * \date 2017-2019
+ * \copyright MIT Licence
+ */
+#ifndef TIMERS_H
+#define TIMERS_H
+
+#include <chrono>
+
+namespace Instrumentation
+{
+/*!
+ * \brief The Region enum lists the instrumented regions. Names are given in Timers::m_regionNames.
+ */
+enum Region {
+    SYSTEM_UPDATE = 0,
+    SYSTEM_FLOW_CONFIGURATION,
+    FLOW_STEP,
+    FLOW_EXPONENTIATION,
+    ACTION_DERIVATIVE,
+    LATTICE_SHIFT,
+    OBSERVABLE_PLAQUETTE,
+    OBSERVABLE_TOPOLOGICAL_CHARGE,
+    OBSERVABLE_ENERGY_DENSITY,
+    OBSERVABLE_MASTER_SAMPLER,
+    OBSERVABLE_MASTER_SAMPLER_TOPC_XYZ,
+    OBSERVABLE_SUPER_SAMPLER,
+    OBSERVABLE_LATTICE_ACTION_CHARGE_DENSITY,
+    OBSERVABLE_GATHER_RESULTS,
+    FIELD_IO_WRITE,
+    FIELD_IO_READ,
+    NUMBER_OF_REGIONS
+};
+
+struct Accumulator
+{
+    unsigned long long calls;
+    double seconds;
+    unsigned long long cycles;
+    unsigned long long instructions;
+};
+
+class Timers
+{
+private:
+    static const char *m_regionNames[NUMBER_OF_REGIONS];
+
+    // Accumulators and perf_event group of the calling thread, set up on first use
+    static thread_local Accumulator *m_threadAccumulators;
+    static thread_local int m_threadCounters;
+
+    static Accumulator *registerThread();
+public:
+    /*!
+     * \brief getAccumulator
+     * \param region the instrumented region.
+     * \return the accumulator of the region for the calling thread.
+     */
+    static inline Accumulator &getAccumulator(const Region region)
+    {
+        if (m_threadAccumulators == nullptr) {
+            m_threadAccumulators = registerThread();
+        }
+        return m_threadAccumulators[region];
+    }
+
+    static bool readCounters(unsigned long long &cycles, unsigned long long &instructions);
+    static void printSummary(const double programTime);
+};
+
+/*!
+ * \brief The ScopedTimer class adds the time, cycles and instructions from its construction to its destruction to a region.
+ */
+class ScopedTimer
+{
+private:
+    Accumulator &m_accumulator;
+    bool m_countersRead;
+    unsigned long long m_cycles;
+    unsigned long long m_instructions;
+    std::chrono::steady_clock::time_point m_start;
+public:
+    inline ScopedTimer(const Region region) : m_accumulator(Timers::getAccumulator(region)), m_cycles(0), m_instructions(0)
+    {
+        m_countersRead = Timers::readCounters(m_cycles, m_instructions);
+        m_start = std::chrono::steady_clock::now();
+    }
+
+    inline ~ScopedTimer()
+    {
+        m_accumulator.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+        m_accumulator.calls++;
+        unsigned long long cycles, instructions;
+        if (m_countersRead && Timers::readCounters(cycles, instructions)) {
+            m_accumulator.cycles += cycles - m_cycles;
+            m_accumulator.instructions += instructions - m_instructions;
+        }
+    }
+};
+}
+
+#ifdef GLAC_INSTRUMENTATION
+#define GLAC_TIMER_CONCATENATE_(a, b) a##b
+#define GLAC_TIMER_CONCATENATE(a, b) GLAC_TIMER_CONCATENATE_(a, b)
+//! Times the rest of the enclosing scope as the given Instrumentation::Region.
+#define GLAC_TIMER(region) Instrumentation::ScopedTimer GLAC_TIMER_CONCATENATE(glacScopedTimer, __LINE__)(Instrumentation::region)
+#else
+#define GLAC_TIMER(region)
+#endif
+
+#endif // TIMERS_H
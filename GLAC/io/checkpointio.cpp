@@ -0,0 +1,245 @@
+#include "checkpointio.h"
+#include "checksum.h"
+#include "config/parameters.h"
+#include "parallelization/communicator.h"
+#include "parallelization/phasetimer.h"
+#include <mpi.h>
+#include <cstdio>
+#include <cstring>
+
+const char IO::CheckpointIO::m_magic[8] = {'G','L','A','C','C','H','K','\0'};
+const unsigned int IO::CheckpointIO::m_version = 5;
+
+/*!
+ * \brief IO::CheckpointIO::getFilename
+ * \return the full path of the checkpoint of the batch.
+ */
+std::string IO::CheckpointIO::getFilename()
+{
+    return Parameters::getFilePath() + Parameters::getOutputFolder()
+            + Parameters::getBatchName() + "/"
+            + Parameters::getBatchName() + "_checkpoint.chk";
+}
+
+/*!
+ * \brief IO::CheckpointIO::getPreviousFilename
+ * \return the full path of the checkpoint replaced by the last one written.
+ */
+std::string IO::CheckpointIO::getPreviousFilename()
+{
+    return getFilename() + ".prev";
+}
+
+/*!
+ * \brief IO::CheckpointIO::checkpointExists checks if the batch has a checkpoint to restore from.
+ * \return true if either the last or the previous checkpoint exists, on all processors.
+ */
+bool IO::CheckpointIO::checkpointExists()
+{
+    int exists = 0;
+    if (Parallel::Communicator::getProcessRank() == 0) {
+        std::FILE *file = std::fopen(getFilename().c_str(), "rb");
+        if (file == nullptr) file = std::fopen(getPreviousFilename().c_str(), "rb");
+        if (file != nullptr) {
+            exists = 1;
+            std::fclose(file);
+        }
+    }
+    MPI_Bcast(&exists, 1, MPI_INT, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+    return exists == 1;
+}
+
+/*!
+ * \brief IO::CheckpointIO::resumeIfCheckpointed sets the run to restart from the checkpoint of the batch if autoResume is set and there is one.
+ * \return true if the run is to resume from the checkpoint.
+ *
+ * Must be called by all active processors before any object writing output is set up, as these start their files anew unless the
+ * run continues from a checkpoint.
+ */
+bool IO::CheckpointIO::resumeIfCheckpointed()
+{
+    if (!Parameters::getAutoResume() || Parameters::getRestartFromCheckpoint() || !checkpointExists()) return false;
+
+    Parameters::setRestartFromCheckpoint(true);
+    return true;
+}
+
+/*!
+ * \brief IO::CheckpointIO::fillHeader sets the header from the current parameters.
+ * \param header the header to fill.
+ */
+void IO::CheckpointIO::fillHeader(CheckpointHeader &header)
+{
+    std::memset(&header, 0, sizeof(CheckpointHeader));
+    std::memcpy(header.magic, m_magic, sizeof(m_magic));
+    header.version = m_version;
+    header.numberOfProcessors = unsigned(Parallel::Communicator::getNumProc());
+    for (int i = 0; i < 3; i++) {
+        header.dimensions[i] = Parameters::getNSpatial();
+    }
+    header.dimensions[3] = Parameters::getNTemporal();
+    for (int i = 0; i < 4; i++) {
+        header.subDimensions[i] = Parameters::getN()[i];
+    }
+    header.beta = Parameters::getBeta();
+    header.NCor = Parameters::getNCor();
+    header.NTherm = Parameters::getNTherm();
+    header.NUpdates = Parameters::getNUpdates();
+}
+
+/*!
+ * \brief IO::CheckpointIO::writeCheckpoint writes the state of each processor to the checkpoint of the batch.
+ * \param state the state of this processor.
+ *
+ * The checkpoint is written to a temporary file, which replaces the last checkpoint once all processors are done writing. The last
+ * checkpoint is kept as the previous one.
+ */
+void IO::CheckpointIO::writeCheckpoint(const std::vector<char> &state)
+{
+    Parallel::ScopedPhase fileIO(Parallel::FILE_IO);
+    MPI_File file;
+
+    const std::string filenamePath = getFilename();
+    const std::string temporaryPath = filenamePath + ".tmp";
+    const int numprocs = Parallel::Communicator::getNumProc();
+
+    CheckpointBlockIndex blockIndex;
+    std::memset(&blockIndex, 0, sizeof(CheckpointBlockIndex));
+    blockIndex.size = state.size();
+    blockIndex.checksum = crc32(state.data(), state.size());
+
+    // Finds the offset of each block from the sizes of the blocks before it
+    std::vector<unsigned long long> blockSizes(static_cast<unsigned int>(numprocs));
+    MPI_Allgather(&blockIndex.size, 1, MPI_UNSIGNED_LONG_LONG, blockSizes.data(), 1, MPI_UNSIGNED_LONG_LONG, Parallel::ParallelParameters::ACTIVE_COMM);
+
+    blockIndex.offset = sizeof(CheckpointHeader) + (unsigned long long)(numprocs)*sizeof(CheckpointBlockIndex);
+    for (int i = 0; i < Parallel::Communicator::getProcessRank(); i++) {
+        blockIndex.offset += blockSizes[unsigned(i)];
+    }
+
+    std::vector<CheckpointBlockIndex> blockIndices(static_cast<unsigned int>(numprocs));
+    MPI_Gather(&blockIndex, sizeof(CheckpointBlockIndex), MPI_BYTE, blockIndices.data(), sizeof(CheckpointBlockIndex), MPI_BYTE, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+
+    // Removes any temporary file left behind by an interrupted checkpoint
+    if (Parallel::Communicator::getProcessRank() == 0) {
+        MPI_File_delete(temporaryPath.c_str(), MPI_INFO_NULL);
+    }
+    MPI_Barrier(Parallel::ParallelParameters::ACTIVE_COMM);
+
+    MPI_File_open(Parallel::ParallelParameters::ACTIVE_COMM, temporaryPath.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &file);
+
+    if (Parallel::Communicator::getProcessRank() == 0) {
+        CheckpointHeader header;
+        fillHeader(header);
+        MPI_File_write_at(file, 0, &header, sizeof(CheckpointHeader), MPI_BYTE, MPI_STATUS_IGNORE);
+        MPI_File_write_at(file, sizeof(CheckpointHeader), blockIndices.data(), int(numprocs*sizeof(CheckpointBlockIndex)), MPI_BYTE, MPI_STATUS_IGNORE);
+    }
+
+    MPI_File_write_at(file, MPI_Offset(blockIndex.offset), state.data(), int(state.size()), MPI_BYTE, MPI_STATUS_IGNORE);
+
+    MPI_File_sync(file);
+    MPI_File_close(&file);
+
+    // Closing is collective, such that all blocks are written before the previous checkpoint is replaced
+    int renameFailed = 0;
+    if (Parallel::Communicator::getProcessRank() == 0) {
+        // Fails harmlessly for the first checkpoint of the batch
+        std::rename(filenamePath.c_str(), getPreviousFilename().c_str());
+        renameFailed = std::rename(temporaryPath.c_str(), filenamePath.c_str());
+    }
+    MPI_Bcast(&renameFailed, 1, MPI_INT, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+    if (renameFailed != 0) {
+        Parallel::Communicator::MPIExit("Error: failed to replace checkpoint " + filenamePath);
+    }
+}
+
+/*!
+ * \brief IO::CheckpointIO::readCheckpoint reads the state of this processor from a checkpoint.
+ * \param filenamePath the checkpoint file.
+ * \param state vector filled with the state of this processor.
+ * \return false if the file does not exist, is not a checkpoint, or the block of any processor is corrupt, on all processors.
+ *
+ * Exits if the checkpoint was written with a different lattice, number of processors or run parameters, as it then belongs to another run.
+ */
+bool IO::CheckpointIO::readCheckpoint(const std::string &filenamePath, std::vector<char> &state)
+{
+    MPI_File file;
+
+    if (MPI_File_open(Parallel::ParallelParameters::ACTIVE_COMM, filenamePath.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &file) != MPI_SUCCESS) {
+        return false;
+    }
+
+    CheckpointHeader header, expectedHeader;
+    fillHeader(expectedHeader);
+    MPI_File_read_at(file, 0, &header, sizeof(CheckpointHeader), MPI_BYTE, MPI_STATUS_IGNORE);
+
+    if (std::memcmp(header.magic, m_magic, sizeof(m_magic)) != 0 || header.version != m_version) {
+        MPI_File_close(&file);
+        if (Parallel::Communicator::getProcessRank() == 0 && !Parameters::getUnitTesting()) {
+            printf("\nWarning: %s is not a checkpoint of a known version", filenamePath.c_str());
+        }
+        return false;
+    }
+    if (header.numberOfProcessors != expectedHeader.numberOfProcessors) {
+        Parallel::Communicator::MPIExit("Error: checkpoint " + filenamePath + " was written with "
+                                        + std::to_string(header.numberOfProcessors) + " processors, and must be restored with the same number");
+    }
+    if (std::memcmp(header.dimensions, expectedHeader.dimensions, sizeof(header.dimensions)) != 0
+            || std::memcmp(header.subDimensions, expectedHeader.subDimensions, sizeof(header.subDimensions)) != 0
+            || header.beta != expectedHeader.beta || header.NCor != expectedHeader.NCor
+            || header.NTherm != expectedHeader.NTherm || header.NUpdates != expectedHeader.NUpdates) {
+        Parallel::Communicator::MPIExit("Error: checkpoint " + filenamePath + " was written with a different lattice or run parameters");
+    }
+
+    CheckpointBlockIndex blockIndex;
+    MPI_File_read_at(file, MPI_Offset(sizeof(CheckpointHeader) + unsigned(Parallel::Communicator::getProcessRank())*sizeof(CheckpointBlockIndex)),
+                     &blockIndex, sizeof(CheckpointBlockIndex), MPI_BYTE, MPI_STATUS_IGNORE);
+
+    // A truncated file leaves the index or block short
+    MPI_Offset fileSize = 0;
+    MPI_File_get_size(file, &fileSize);
+    int corruptBlocks = 0;
+    if (blockIndex.size == 0 || blockIndex.offset + blockIndex.size > (unsigned long long)(fileSize)) {
+        corruptBlocks = 1;
+        state.clear();
+    } else {
+        state.resize(blockIndex.size);
+        MPI_File_read_at(file, MPI_Offset(blockIndex.offset), state.data(), int(state.size()), MPI_BYTE, MPI_STATUS_IGNORE);
+        corruptBlocks = (crc32(state.data(), state.size()) != blockIndex.checksum) ? 1 : 0;
+    }
+
+    MPI_File_close(&file);
+
+    // All processors must agree on the checkpoint being intact before any of them restores from it
+    MPI_Allreduce(MPI_IN_PLACE, &corruptBlocks, 1, MPI_INT, MPI_SUM, Parallel::ParallelParameters::ACTIVE_COMM);
+    if (corruptBlocks != 0) {
+        if (Parallel::Communicator::getProcessRank() == 0 && !Parameters::getUnitTesting()) {
+            printf("\nWarning: checkpoint %s has %d corrupt processor blocks", filenamePath.c_str(), corruptBlocks);
+        }
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief IO::CheckpointIO::loadCheckpoint reads the state of this processor from the checkpoint of the batch.
+ * \param state vector filled with the state of this processor.
+ *
+ * Falls back on the previous checkpoint if the last one is missing or damaged, and exits if neither can be restored.
+ */
+void IO::CheckpointIO::loadCheckpoint(std::vector<char> &state)
+{
+    Parallel::ScopedPhase fileIO(Parallel::FILE_IO);
+
+    std::string filenamePath = getFilename();
+    if (!readCheckpoint(filenamePath, state)) {
+        filenamePath = getPreviousFilename();
+        if (!readCheckpoint(filenamePath, state)) {
+            Parallel::Communicator::MPIExit("Error: no intact checkpoint " + getFilename() + " or " + filenamePath + " to restore from");
+        }
+    }
+
+    if (Parallel::Communicator::getProcessRank() == 0 && !Parameters::getUnitTesting()) {
+        printf("\nCheckpoint %s loaded", filenamePath.c_str());
+    }
+}
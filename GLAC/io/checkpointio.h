@@ -0,0 +1,92 @@
+/*!
+ * \class CheckpointIO
+ *
+ * \brief Class for writing and reading checkpoints of the Markov chain state.
+ *
+ * The state of each processor is passed as an opaque block of bytes, such that System alone decides what goes into a checkpoint.
+ * All blocks are written to a single file in the output folder of the batch,
+ * - a CheckpointHeader holding the lattice and run parameters the checkpoint was made with,
+ * - one CheckpointBlockIndex for each processor, in processor rank order,
+ * - the state blocks, one for each processor.
+ *
+ * A checkpoint is first written to a temporary file and then renamed, such that an interrupted write leaves the previous checkpoint intact.
+ * The checkpoint it replaces is kept as the previous checkpoint, which is restored from if the last one is missing or damaged, e.g. by
+ * a node failing while the file system was flushing it.
+ * Since the random number generators are per processor, a checkpoint may only be restored with the same number of processors.
+ *
+ * \author Mathias M. Vege
+ * \version 1.0
+ * \date 2017-2019
+ * \copyright MIT Licence
+ */
+#ifndef CHECKPOINTIO_H
+#define CHECKPOINTIO_H
+
+#include <string>
+#include <vector>
+
+namespace IO
+{
+struct CheckpointHeader
+{
+    //! Identifies a file as a GLAC checkpoint, "GLACCHK\0".
+    char magic[8];
+
+    //! Version of the file layout.
+    unsigned int version;
+
+    //! Number of processors, and thereby state blocks, the checkpoint was written with.
+    unsigned int numberOfProcessors;
+
+    //! Global lattice dimensions, x, y, z, t.
+    unsigned int dimensions[4];
+
+    //! Sub-lattice dimensions of each processor, x, y, z, t.
+    unsigned int subDimensions[4];
+
+    double beta;
+    unsigned int NCor;
+    unsigned int NTherm;
+    unsigned int NUpdates;
+
+    //! Pads header to 128 bytes.
+    char padding[60];
+};
+
+struct CheckpointBlockIndex
+{
+    //! Offset of the block from the start of the file in bytes.
+    unsigned long long offset;
+
+    //! Size of the block in bytes.
+    unsigned long long size;
+
+    //! CRC-32 of the block.
+    unsigned int checksum;
+
+    //! Pads index to 24 bytes.
+    unsigned int padding;
+};
+
+static_assert(sizeof(CheckpointHeader) == 128, "CheckpointHeader is required to be 128 bytes.");
+static_assert(sizeof(CheckpointBlockIndex) == 24, "CheckpointBlockIndex is required to be 24 bytes.");
+
+class CheckpointIO
+{
+private:
+    static const char m_magic[8];
+    static const unsigned int m_version;
+
+    static void fillHeader(CheckpointHeader &header);
+    static bool readCheckpoint(const std::string &filenamePath, std::vector<char> &state);
+public:
+    static std::string getFilename();
+    static std::string getPreviousFilename();
+    static bool checkpointExists();
+    static bool resumeIfCheckpointed();
+    static void writeCheckpoint(const std::vector<char> &state);
+    static void loadCheckpoint(std::vector<char> &state);
+};
+}
+
+#endif // CHECKPOINTIO_H
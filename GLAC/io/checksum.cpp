@@ -0,0 +1,77 @@
+#include "checksum.h"
+
+namespace IO
+{
+namespace
+    {
+        // Namespace unaccessible outside of the checksum methods.
+        struct CRC32Tables
+        {
+            //! Slicing-by-4 lookup tables for the reflected CRC-32 polynomial 0xEDB88320.
+            unsigned int table[4][256];
+
+            CRC32Tables()
+            {
+                for (unsigned int i = 0; i < 256; i++) {
+                    unsigned int c = i;
+                    for (int k = 0; k < 8; k++) {
+                        c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+                    }
+                    table[0][i] = c;
+                }
+                for (unsigned int i = 0; i < 256; i++) {
+                    for (int s = 1; s < 4; s++) {
+                        table[s][i] = (table[s-1][i] >> 8) ^ table[0][table[s-1][i] & 0xFF];
+                    }
+                }
+            }
+        };
+
+        const CRC32Tables crcTables;
+    }
+}
+
+/*!
+ * \brief IO::crc32 computes the CRC-32 (IEEE 802.3) checksum of a block of memory.
+ * \param data pointer to the first byte of the block.
+ * \param length number of bytes in the block.
+ * \param crc previous checksum value, allowing a checksum to be continued over several blocks.
+ * \return the updated checksum.
+ *
+ * Uses slicing-by-4 table lookups, such that the checksum can be left on when writing and loading gauge fields.
+ */
+unsigned int IO::crc32(const void *data, const std::size_t length, const unsigned int crc)
+{
+    const unsigned char *bytes = static_cast<const unsigned char*>(data);
+    const unsigned int (&T)[4][256] = crcTables.table;
+    unsigned int c = ~crc;
+    std::size_t n = length;
+
+    while (n >= 4) {
+        c ^= static_cast<unsigned int>(bytes[0])
+                | (static_cast<unsigned int>(bytes[1]) << 8)
+                | (static_cast<unsigned int>(bytes[2]) << 16)
+                | (static_cast<unsigned int>(bytes[3]) << 24);
+        c = T[3][c & 0xFF] ^ T[2][(c >> 8) & 0xFF] ^ T[1][(c >> 16) & 0xFF] ^ T[0][c >> 24];
+        bytes += 4;
+        n -= 4;
+    }
+    while (n-- > 0) {
+        c = T[0][(c ^ *bytes++) & 0xFF] ^ (c >> 8);
+    }
+
+    return ~c;
+}
+
+/*!
+ * \brief IO::rotateLeft rotates the bits of a 32 bit unsigned integer.
+ * \param value to rotate.
+ * \param shift number of bits to rotate by. Taken modulo 32.
+ * \return the rotated value.
+ */
+unsigned int IO::rotateLeft(const unsigned int value, const unsigned int shift)
+{
+    const unsigned int s = shift % 32;
+    if (s == 0) return value;
+    return (value << s) | (value >> (32 - s));
+}
@@ -0,0 +1,12 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <cstddef>
+
+namespace IO
+{
+        unsigned int crc32(const void *data, const std::size_t length, const unsigned int crc = 0);
+        unsigned int rotateLeft(const unsigned int value, const unsigned int shift);
+}
+
+#endif // CHECKSUM_H
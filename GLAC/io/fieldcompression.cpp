@@ -0,0 +1,128 @@
+#include "fieldcompression.h"
+#include <cmath>
+#include <cstring>
+
+namespace IO
+{
+namespace
+    {
+        // Namespace unaccessible outside of the compression methods.
+        inline void writeVarint(unsigned long long value, std::vector<unsigned char> &out)
+        {
+            while (value >= 0x80) {
+                out.push_back(static_cast<unsigned char>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<unsigned char>(value));
+        }
+
+        inline unsigned long long readVarint(const unsigned char *&in)
+        {
+            unsigned long long value = 0;
+            int shift = 0;
+            while (*in & 0x80) {
+                value |= static_cast<unsigned long long>(*in++ & 0x7F) << shift;
+                shift += 7;
+            }
+            value |= static_cast<unsigned long long>(*in++) << shift;
+            return value;
+        }
+
+        inline unsigned long long zigZagEncode(const long long value)
+        {
+            return (static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63);
+        }
+
+        inline long long zigZagDecode(const unsigned long long value)
+        {
+            return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+        }
+    }
+}
+
+/*!
+ * \brief IO::compressBlock compresses a block of doubles.
+ * \param values the doubles to compress.
+ * \param quantizationBits number of bits to quantize to, relative to the largest absolute value. Zero gives lossless compression.
+ * \param compressed vector the compressed bytes are written to. Cleared before use.
+ * \param scale largest absolute value of the block, which is needed for decompression.
+ */
+void IO::compressBlock(const std::vector<double> &values, const int quantizationBits,
+                       std::vector<unsigned char> &compressed, double &scale)
+{
+    compressed.clear();
+    compressed.reserve(values.size() * 2);
+
+    scale = 0;
+    for (unsigned long i = 0; i < values.size(); i++) {
+        if (std::fabs(values[i]) > scale) {
+            scale = std::fabs(values[i]);
+        }
+    }
+
+    if (quantizationBits > 0) {
+        // Lossy: quantizes relative to the block maximum, and stores the differences as variable length integers
+        const double levels = std::ldexp(1.0, quantizationBits - 1) - 1.0;
+        const double inverseStep = (scale > 0) ? levels / scale : 0;
+        long long previous = 0;
+        for (unsigned long i = 0; i < values.size(); i++) {
+            const long long quantized = std::llround(values[i] * inverseStep);
+            writeVarint(zigZagEncode(quantized - previous), compressed);
+            previous = quantized;
+        }
+    } else {
+        // Lossless: XOR with previous value, storing a byte count followed by the significant bytes
+        unsigned long long previous = 0;
+        for (unsigned long i = 0; i < values.size(); i++) {
+            unsigned long long bits;
+            std::memcpy(&bits, &values[i], sizeof(double));
+            unsigned long long residual = bits ^ previous;
+            previous = bits;
+
+            unsigned char numberOfBytes = 0;
+            for (unsigned long long r = residual; r != 0; r >>= 8) {
+                numberOfBytes++;
+            }
+            compressed.push_back(numberOfBytes);
+            for (unsigned char b = 0; b < numberOfBytes; b++) {
+                compressed.push_back(static_cast<unsigned char>(residual >> (8*b)));
+            }
+        }
+    }
+}
+
+/*!
+ * \brief IO::decompressBlock decompresses a block compressed by IO::compressBlock.
+ * \param compressed pointer to the compressed bytes.
+ * \param compressedSize number of compressed bytes.
+ * \param quantizationBits number of bits used when compressing.
+ * \param scale largest absolute value of the block, as given by IO::compressBlock.
+ * \param values vector to fill, sized to the number of values in the block.
+ */
+void IO::decompressBlock(const unsigned char *compressed, const unsigned long long compressedSize,
+                         const int quantizationBits, const double scale, std::vector<double> &values)
+{
+    const unsigned char *in = compressed;
+    const unsigned char *end = compressed + compressedSize;
+
+    if (quantizationBits > 0) {
+        const double levels = std::ldexp(1.0, quantizationBits - 1) - 1.0;
+        const double step = scale / levels;
+        long long previous = 0;
+        for (unsigned long i = 0; i < values.size() && in < end; i++) {
+            previous += zigZagDecode(readVarint(in));
+            values[i] = double(previous) * step;
+        }
+    } else {
+        unsigned long long previous = 0;
+        for (unsigned long i = 0; i < values.size() && in < end; i++) {
+            const unsigned char numberOfBytes = *in++;
+            unsigned long long residual = 0;
+            for (unsigned char b = 0; b < numberOfBytes; b++) {
+                residual |= static_cast<unsigned long long>(*in++) << (8*b);
+            }
+            previous ^= residual;
+            std::memcpy(&values[i], &previous, sizeof(double));
+        }
+    }
+}
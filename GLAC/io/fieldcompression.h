@@ -0,0 +1,83 @@
+/*!
+ * \class CompressedFieldHeader
+ *
+ * \brief Header and block index of compressed scalar field files, as well as the methods for compressing and decompressing a block.
+ *
+ * A compressed field file(.cbin) is laid out as,
+ * - a CompressedFieldHeader,
+ * - one CompressedBlockIndex for each processor block, in processor rank order,
+ * - the compressed blocks, one for each processor.
+ *
+ * Each block holds the sub-lattice of a single processor in its local lexicographic order(x fastest), such that
+ * a block may be located through the index and decompressed without reading the rest of the file.
+ *
+ * For a positive number of quantization bits b, each value is rounded to the nearest multiple of scale/(2^(b-1) - 1),
+ * with scale being the largest absolute value of the block. The difference to the previous quantized value is
+ * then zig-zag encoded and stored as a variable length integer. The absolute error is at most scale/(2^b - 2).
+ *
+ * For zero quantization bits the doubles are stored lossless, as the XOR with the previous value where leading zero bytes are dropped.
+ *
+ * \author Mathias M. Vege
+ * \version 1.0
+ * \date 2017-2019
+ * \copyright MIT Licence
+ */
+#ifndef FIELDCOMPRESSION_H
+#define FIELDCOMPRESSION_H
+
+#include <vector>
+
+namespace IO
+{
+struct CompressedFieldHeader
+{
+    //! Identifies a file as a GLAC compressed scalar field, "GLACCSF\0".
+    char magic[8];
+
+    //! Version of the file layout.
+    unsigned int version;
+
+    //! Number of quantization bits. Zero for lossless compression.
+    int quantizationBits;
+
+    //! Global lattice dimensions, x, y, z, t.
+    unsigned int dimensions[4];
+
+    //! Sub-lattice dimensions of each block, x, y, z, t.
+    unsigned int subDimensions[4];
+
+    //! Number of blocks, equal to the number of processors written with.
+    unsigned int numberOfBlocks;
+
+    //! Configuration or flow step number of the field.
+    unsigned int configNumber;
+
+    //! Pads header to 64 bytes.
+    char padding[8];
+};
+
+struct CompressedBlockIndex
+{
+    //! Offset of the block from the start of the file in bytes.
+    unsigned long long offset;
+
+    //! Size of the compressed block in bytes.
+    unsigned long long size;
+
+    //! Largest absolute value of the block, used for dequantization.
+    double scale;
+
+    //! Position of the block in the processor grid, x, y, z, t.
+    unsigned int position[4];
+};
+
+static_assert(sizeof(CompressedFieldHeader) == 64, "CompressedFieldHeader is required to be 64 bytes.");
+static_assert(sizeof(CompressedBlockIndex) == 40, "CompressedBlockIndex is required to be 40 bytes.");
+
+        void compressBlock(const std::vector<double> &values, const int quantizationBits,
+                           std::vector<unsigned char> &compressed, double &scale);
+        void decompressBlock(const unsigned char *compressed, const unsigned long long compressedSize,
+                             const int quantizationBits, const double scale, std::vector<double> &values);
+}
+
+#endif // FIELDCOMPRESSION_H
@@ -0,0 +1,58 @@
+/*!
+ * \class FieldHeader
+ *
+ * \brief Fixed size header placed at the start of every gauge field configuration written by FieldIO.
+ *
+ * Makes the configuration self-describing, such that a wrong size, wrong precision or corrupted file is caught upon loading.
+ *
+ * The checksums are built from a CRC-32 of the four links of each site, rotated by the global site index modulo 29 and 31 respectively,
+ * and combined with XOR. They may therefore be computed in parallel by each processor on its own sub-lattice, and do not depend
+ * on the processor layout used when writing or loading.
+ *
+ * \author Mathias M. Vege
+ * \version 1.0
+ * \date 2017-2019
+ * \copyright MIT Licence
+ */
+#ifndef FIELDHEADER_H
+#define FIELDHEADER_H
+
+namespace IO
+{
+struct FieldHeader
+{
+    //! Identifies a file as a GLAC field configuration, "GLACFLD\0".
+    char magic[8];
+
+    //! Version of the header layout.
+    unsigned int version;
+
+    //! Number of bytes in each real number of the link variables.
+    unsigned int precision;
+
+    //! Global lattice dimensions, x, y, z, t.
+    unsigned int dimensions[4];
+
+    //! Number of processors the configuration was written with.
+    unsigned int numberOfProcessors;
+
+    //! Configuration number, including the configuration start number.
+    unsigned int configNumber;
+
+    double beta;
+    double plaquette;
+
+    //! Checksum with site rotations modulo 29.
+    unsigned int checksum29;
+
+    //! Checksum with site rotations modulo 31.
+    unsigned int checksum31;
+
+    //! Pads header to 128 bytes, leaving room for later additions.
+    char padding[64];
+};
+
+static_assert(sizeof(FieldHeader) == 128, "FieldHeader is required to be 128 bytes.");
+}
+
+#endif // FIELDHEADER_H
@@ -1,10 +1,20 @@
 #include "fieldio.h"
+#include "checksum.h"
+#include "fieldcompression.h"
 #include "config/parameters.h"
+#include "observables/plaquette.h"
 #include "parallelization/index.h"
 #include "parallelization/communicator.h"
+#include "parallelization/phasetimer.h"
+#include "instrumentation/timers.h"
 #include <mpi.h>
 #include <cmath>
+#include <cstring>
 #include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using std::cout;
 using std::endl;
@@ -13,6 +23,10 @@ const long long IO::FieldIO::m_SU3Doubles = 18;
 const long long IO::FieldIO::m_SU3Size = m_SU3Doubles*sizeof(double);
 const long long IO::FieldIO::m_linkDoubles = m_SU3Doubles*4;
 const long long IO::FieldIO::m_linkSize = m_linkDoubles*sizeof(double);
+const long long IO::FieldIO::m_headerSize = sizeof(IO::FieldHeader);
+const unsigned int IO::FieldIO::m_headerVersion = 1;
+const char IO::FieldIO::m_headerMagic[8] = {'G','L','A','C','F','L','D','\0'};
+const char IO::FieldIO::m_compressedMagic[8] = {'G','L','A','C','C','S','F','\0'};
 std::vector<unsigned int> IO::FieldIO::m_N;
 
 /*!
@@ -54,7 +68,10 @@ void IO::FieldIO::init()
  * \param lattice is a pointer of four lattice objects, one for each Lorentz index.
  * \param configNumber the configuration number to name the file with.
  *
- * Uses MPI_File_write_at to write the configuration to a file.
+ * Uses MPI_File_write_at to write the configuration to a file. If fieldConfigurationHeader is set, the configuration is preceded by
+ * a FieldHeader holding the lattice dimensions, beta, configuration number, precision, plaquette and checksums. The checksums
+ * are accumulated by each processor over its own sub-lattice while filling the write buffer, and then combined with a single reduction.
+ * Otherwise only the links are written, as expected by raw readers of the configurations.
  *
  * If debug is true in the passed .json parameter file, it will perform a check for lattice corruption.
  */
@@ -66,6 +83,8 @@ void IO::FieldIO::writeFieldToFile(Lattice<SU3> *lattice, const unsigned int con
      * Arguments:
      *  configNumber   : (int) configuration number
      */
+    GLAC_TIMER(FIELD_IO_WRITE);
+    Parallel::ScopedPhase fileIO(Parallel::FILE_IO);
     MPI_File file;
 
     // Converting config number to a more machine friendly layout
@@ -84,11 +103,23 @@ void IO::FieldIO::writeFieldToFile(Lattice<SU3> *lattice, const unsigned int con
         Parallel::Communicator::checkLattice(lattice, "Configuration is corrupt in IO::FieldIO write field before");
     }
 
+    const bool writeHeader = Parameters::getFieldConfigurationHeader();
+    const long long headerSize = writeHeader ? m_headerSize : 0;
+
+    // Plaquette is stored in the header as a quick physical sanity check of the configuration
+    const double plaquette = writeHeader ? Plaquette::computePlaquette(lattice) : 0;
+
     MPI_File_open(Parallel::ParallelParameters::ACTIVE_COMM, filenamePath.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &file);
-    long long nt = 0, nz = 0, ny = 0;
+    // Truncates an earlier configuration of the same name, which may have been written with a different header setting
+    MPI_File_set_size(file, headerSize + Parameters::getLatticeSize()*m_linkSize);
+    long long nt = 0, nz = 0, ny = 0, nx = 0;
     MPI_Offset offset = 0;
+    unsigned int checksums[2] = {0, 0};
+    unsigned int totalChecksums[2] = {0, 0};
+
+    SU3 writeBuffer[4 * m_N[0]];
 
-    SU3 writeBuffer[4 * Parameters::getNSpatial()];
+    nx = (Parallel::Neighbours::getProcessorDimensionPosition(0) * m_N[0]);
 
     for (long long t = 0; t < m_N[3]; t++) {
         nt = (Parallel::Neighbours::getProcessorDimensionPosition(3) * m_N[3] + t);
@@ -97,19 +128,45 @@ void IO::FieldIO::writeFieldToFile(Lattice<SU3> *lattice, const unsigned int con
             for (long long y = 0; y < m_N[1]; y++) {
                 ny = (Parallel::Neighbours::getProcessorDimensionPosition(1) * m_N[1] + y);
 
-
-                for (long long mu = 0; mu < 4; mu++) {
-                    for (long long x = 0; x < m_N[0]; x++) {
+                for (long long x = 0; x < m_N[0]; x++) {
+                    for (long long mu = 0; mu < 4; mu++) {
                         writeBuffer[4*x + mu] = lattice[mu][Parallel::Index::getIndex(x,y,z,t)];
                     }
+                    if (writeHeader) {
+                        addSiteChecksum(&writeBuffer[4*x], Parallel::Index::getGlobalIndex(nx + x,ny,nz,nt), checksums[0], checksums[1]);
+                    }
                 }
 
-                offset = Parallel::Index::getGlobalIndex(0,ny,nz,nt)*m_linkSize;
-                MPI_File_write_at(file, offset, &writeBuffer, m_linkDoubles*Parameters::getNSpatial(), MPI_DOUBLE, MPI_STATUS_IGNORE);
+                offset = headerSize + Parallel::Index::getGlobalIndex(nx,ny,nz,nt)*m_linkSize;
+                MPI_File_write_at(file, offset, &writeBuffer, m_linkDoubles*m_N[0], MPI_DOUBLE, MPI_STATUS_IGNORE);
             }
         }
     }
 
+    if (writeHeader) {
+        // Combines the sub-lattice checksums
+        MPI_Reduce(checksums, totalChecksums, 2, MPI_UNSIGNED, MPI_BXOR, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+    }
+
+    if (writeHeader && Parallel::Communicator::getProcessRank() == 0) {
+        FieldHeader header;
+        std::memset(&header, 0, sizeof(FieldHeader));
+        std::memcpy(header.magic, m_headerMagic, sizeof(m_headerMagic));
+        header.version = m_headerVersion;
+        header.precision = sizeof(double);
+        for (int i = 0; i < 3; i++) {
+            header.dimensions[i] = Parameters::getNSpatial();
+        }
+        header.dimensions[3] = Parameters::getNTemporal();
+        header.numberOfProcessors = unsigned(Parallel::Communicator::getNumProc());
+        header.configNumber = configNumber + unsigned(Parameters::getConfigStartNumber());
+        header.beta = Parameters::getBeta();
+        header.plaquette = plaquette;
+        header.checksum29 = totalChecksums[0];
+        header.checksum31 = totalChecksums[1];
+        MPI_File_write_at(file, 0, &header, int(m_headerSize), MPI_BYTE, MPI_STATUS_IGNORE);
+    }
+
     MPI_File_close(&file);
 
     if (Parameters::getDebug()) {
@@ -143,6 +200,8 @@ void IO::FieldIO::writeDoublesFieldToFile(const Lattice<double> &lattice, const
      *  lattice: Lattice<double>, single field of doubles
      *  configNumber   : (int) configuration number
      */
+    GLAC_TIMER(FIELD_IO_WRITE);
+    Parallel::ScopedPhase fileIO(Parallel::FILE_IO);
     MPI_File file;
 
     // Converting config number to a more machine friendly layout
@@ -163,7 +222,8 @@ void IO::FieldIO::writeDoublesFieldToFile(const Lattice<double> &lattice, const
     MPI_Offset offset = 0;
     long long nt = 0, nz = 0, ny = 0, nx = 0;
 
-    // Writes each element of x directly.
+    // Writes each line of x at once.
+    std::vector<double> writeBuffer(m_N[0]);
     nx = (Parallel::Neighbours::getProcessorDimensionPosition(0) * m_N[0]);
 
     for (long long t = 0; t < m_N[3]; t++) {
@@ -173,8 +233,11 @@ void IO::FieldIO::writeDoublesFieldToFile(const Lattice<double> &lattice, const
             for (long long y = 0; y < m_N[1]; y++) {
                 ny = (Parallel::Neighbours::getProcessorDimensionPosition(1) * m_N[1] + y);
 
+                for (long long x = 0; x < m_N[0]; x++) {
+                    writeBuffer[x] = lattice.m_sites[Parallel::Index::getIndex(x,y,z,t)];
+                }
                 offset = Parallel::Index::getGlobalIndex(nx,ny,nz,nt)*sizeof(double);
-                MPI_File_write_at(file, offset, &lattice.m_sites[Parallel::Index::getIndex(0,y,z,t)], m_N[0], MPI_DOUBLE, MPI_STATUS_IGNORE);
+                MPI_File_write_at(file, offset, writeBuffer.data(), m_N[0], MPI_DOUBLE, MPI_STATUS_IGNORE);
             }
         }
     }
@@ -185,11 +248,171 @@ void IO::FieldIO::writeDoublesFieldToFile(const Lattice<double> &lattice, const
     }
 }
 
+/*!
+ * \brief IO::FieldIO::writeCompressedDoublesFieldToFile writes a lattice of doubles to file in compressed form.
+ * \param lattice the lattice of doubles to write.
+ * \param configNumber configuration number.
+ * \param observable name of the observable.
+ *
+ * Each processor compresses its own sub-lattice as a single block using IO::compressBlock, with the number of
+ * quantization bits given by Parameters::getFieldDensityQuantizationBits(). The block sizes are then gathered in order
+ * to find the offsets, and the blocks are written in parallel after the header and block index.
+ * See CompressedFieldHeader for the file layout.
+ *
+ * The file is written to the same folder as writeDoublesFieldToFile(), with the .cbin extension.
+ */
+void IO::FieldIO::writeCompressedDoublesFieldToFile(const Lattice<double> &lattice, const unsigned int configNumber, const std::string &observable)
+{
+    GLAC_TIMER(FIELD_IO_WRITE);
+    Parallel::ScopedPhase fileIO(Parallel::FILE_IO);
+    MPI_File file;
+
+    // Converting config number to a more machine friendly layout
+    char cfg_number[6];
+    sprintf(cfg_number, "%05d", configNumber + Parameters::getConfigStartNumber());
+
+    std::string filename = Parameters::getBatchName() + "_b" + std::to_string(Parameters::getBeta())
+            + "_N" + std::to_string(Parameters::getNSpatial())
+            + "_NT" + std::to_string(Parameters::getNTemporal())
+            + "_np" + std::to_string(Parallel::Communicator::getNumProc())
+            + "_config" + std::string(cfg_number) + ".cbin";
+
+    std::string filenamePath = Parameters::getFilePath() + Parameters::getOutputFolder() + Parameters::getBatchName()
+            + "/scalar_fields/" + observable + "/" + filename;
+
+    const int numprocs = Parallel::Communicator::getNumProc();
+    const int quantizationBits = Parameters::getFieldDensityQuantizationBits();
+
+    // Compresses the sub-lattice of this processor
+    CompressedBlockIndex blockIndex;
+    std::vector<unsigned char> compressed;
+    std::vector<double> lexicographicSites(lattice.m_latticeSize);
+    for (unsigned long iSite = 0; iSite < lattice.m_latticeSize; iSite++) {
+        lexicographicSites[iSite] = lattice.m_sites[Parallel::Index::getSiteIndex(iSite)];
+    }
+    compressBlock(lexicographicSites, quantizationBits, compressed, blockIndex.scale);
+    blockIndex.size = compressed.size();
+    for (int i = 0; i < 4; i++) {
+        blockIndex.position[i] = unsigned(Parallel::Neighbours::getProcessorDimensionPosition(i));
+    }
+
+    // Finds the offset of each block from the sizes of the blocks before it
+    std::vector<unsigned long long> blockSizes(static_cast<unsigned int>(numprocs));
+    MPI_Allgather(&blockIndex.size, 1, MPI_UNSIGNED_LONG_LONG, blockSizes.data(), 1, MPI_UNSIGNED_LONG_LONG, Parallel::ParallelParameters::ACTIVE_COMM);
+
+    blockIndex.offset = sizeof(CompressedFieldHeader) + (unsigned long long)(numprocs)*sizeof(CompressedBlockIndex);
+    for (int i = 0; i < Parallel::Communicator::getProcessRank(); i++) {
+        blockIndex.offset += blockSizes[unsigned(i)];
+    }
+
+    std::vector<CompressedBlockIndex> blockIndices(static_cast<unsigned int>(numprocs));
+    MPI_Gather(&blockIndex, sizeof(CompressedBlockIndex), MPI_BYTE, blockIndices.data(), sizeof(CompressedBlockIndex), MPI_BYTE, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+
+    // Removes any previous file of the same name, as the compressed size may have changed
+    if (Parallel::Communicator::getProcessRank() == 0) {
+        MPI_File_delete(filenamePath.c_str(), MPI_INFO_NULL);
+    }
+    MPI_Barrier(Parallel::ParallelParameters::ACTIVE_COMM);
+
+    MPI_File_open(Parallel::ParallelParameters::ACTIVE_COMM, filenamePath.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &file);
+
+    if (Parallel::Communicator::getProcessRank() == 0) {
+        CompressedFieldHeader header;
+        std::memset(&header, 0, sizeof(CompressedFieldHeader));
+        std::memcpy(header.magic, m_compressedMagic, sizeof(m_compressedMagic));
+        header.version = 1;
+        header.quantizationBits = quantizationBits;
+        for (int i = 0; i < 3; i++) {
+            header.dimensions[i] = Parameters::getNSpatial();
+        }
+        header.dimensions[3] = Parameters::getNTemporal();
+        for (int i = 0; i < 4; i++) {
+            header.subDimensions[i] = m_N[i];
+        }
+        header.numberOfBlocks = unsigned(numprocs);
+        header.configNumber = configNumber + unsigned(Parameters::getConfigStartNumber());
+
+        MPI_File_write_at(file, 0, &header, sizeof(CompressedFieldHeader), MPI_BYTE, MPI_STATUS_IGNORE);
+        MPI_File_write_at(file, sizeof(CompressedFieldHeader), blockIndices.data(), int(numprocs*sizeof(CompressedBlockIndex)), MPI_BYTE, MPI_STATUS_IGNORE);
+    }
+
+    MPI_File_write_at(file, MPI_Offset(blockIndex.offset), compressed.data(), int(compressed.size()), MPI_BYTE, MPI_STATUS_IGNORE);
+
+    MPI_File_close(&file);
+
+    if (Parallel::Communicator::getProcessRank() == 0 && !Parameters::getUnitTesting()) {
+        printf("\n    %s written.", filenamePath.c_str());
+    }
+}
+
+/*!
+ * \brief IO::FieldIO::loadCompressedDoublesField loads a compressed field written by writeCompressedDoublesFieldToFile().
+ * \param filenamePath full path of the .cbin file.
+ * \param lattice the lattice of doubles to fill.
+ *
+ * Each processor looks up the block at its own position in the processor grid through the block index, and reads and decompresses only that block.
+ * Requires the file to have been written with the same sub-lattice dimensions.
+ */
+void IO::FieldIO::loadCompressedDoublesField(const std::string &filenamePath, Lattice<double> &lattice)
+{
+    GLAC_TIMER(FIELD_IO_READ);
+    Parallel::ScopedPhase fileIO(Parallel::FILE_IO);
+    if (!check_file_existence(filenamePath.c_str())) {
+        Parallel::Communicator::MPIExit("File " + filenamePath + " does not exist");
+    }
+
+    MPI_File file;
+    MPI_File_open(Parallel::ParallelParameters::ACTIVE_COMM, filenamePath.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &file);
+
+    CompressedFieldHeader header;
+    MPI_File_read_at(file, 0, &header, sizeof(CompressedFieldHeader), MPI_BYTE, MPI_STATUS_IGNORE);
+
+    if (std::memcmp(header.magic, m_compressedMagic, sizeof(m_compressedMagic)) != 0) {
+        Parallel::Communicator::MPIExit("Error: " + filenamePath + " is not a compressed field file.");
+    }
+    for (int i = 0; i < 4; i++) {
+        if (header.subDimensions[i] != m_N[i]) {
+            Parallel::Communicator::MPIExit("Error: compressed field " + filenamePath + " was written with different sub-lattice dimensions.");
+        }
+    }
+
+    std::vector<CompressedBlockIndex> blockIndices(header.numberOfBlocks);
+    MPI_File_read_at(file, sizeof(CompressedFieldHeader), blockIndices.data(), int(header.numberOfBlocks*sizeof(CompressedBlockIndex)), MPI_BYTE, MPI_STATUS_IGNORE);
+
+    // Finds the block holding this sub-lattice
+    unsigned int iBlock = 0;
+    for (; iBlock < header.numberOfBlocks; iBlock++) {
+        bool match = true;
+        for (int i = 0; i < 4; i++) {
+            match = match && (blockIndices[iBlock].position[i] == unsigned(Parallel::Neighbours::getProcessorDimensionPosition(i)));
+        }
+        if (match) break;
+    }
+    if (iBlock == header.numberOfBlocks) {
+        Parallel::Communicator::MPIExit("Error: no block found for sub-lattice in compressed field " + filenamePath);
+    }
+
+    std::vector<unsigned char> compressed(blockIndices[iBlock].size);
+    MPI_File_read_at(file, MPI_Offset(blockIndices[iBlock].offset), compressed.data(), int(compressed.size()), MPI_BYTE, MPI_STATUS_IGNORE);
+    MPI_File_close(&file);
+
+    // The block holds the sites in lexicographic order
+    std::vector<double> lexicographicSites(lattice.m_latticeSize);
+    decompressBlock(compressed.data(), compressed.size(), header.quantizationBits, blockIndices[iBlock].scale, lexicographicSites);
+    for (unsigned long iSite = 0; iSite < lattice.m_latticeSize; iSite++) {
+        lattice.m_sites[Parallel::Index::getSiteIndex(iSite)] = lexicographicSites[iSite];
+    }
+}
+
 /*!
  * \brief IO::FieldIO::loadFieldConfiguration loads a regular configuration into memory.
  * \param filename
  * \param lattice is a pointer of four lattice objects, one for each Lorentz index, that will filled with the configuration read from file.
  *
+ * If the file starts with a FieldHeader, the lattice dimensions, precision and file size are verified before reading,
+ * and the checksums are recomputed in parallel and compared after reading. Configurations without a header are still
+ * accepted, but are then only checked for having the expected file size.
+ *
  * If debug is true in the passed .json parameter file, it will perform a check for lattice corruption.
  */
 void IO::FieldIO::loadFieldConfiguration(const std::string &filename, Lattice<SU3> *lattice)
@@ -201,6 +424,8 @@ void IO::FieldIO::loadFieldConfiguration(const std::string &filename, Lattice<SU
      * - filename
      * - lattice
      */
+    GLAC_TIMER(FIELD_IO_READ);
+    Parallel::ScopedPhase fileIO(Parallel::FILE_IO);
     MPI_File file;
 
     // Sets up file name
@@ -213,10 +438,23 @@ void IO::FieldIO::loadFieldConfiguration(const std::string &filename, Lattice<SU
 
     MPI_File_open(Parallel::ParallelParameters::ACTIVE_COMM, fname.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &file);
 
+    // Verifies the header and size of the file before reading anything into the lattice
+    FieldHeader header;
+    const bool hasHeader = readFieldHeader(file, header);
+    const long long headerSize = hasHeader ? m_headerSize : 0;
+
+    MPI_Offset fileSize = 0;
+    MPI_File_get_size(file, &fileSize);
+    verifyFieldHeader(header, hasHeader, fileSize, fname);
+
     MPI_Offset offset = 0;
-    long long nt = 0, nz = 0, ny = 0;
+    long long nt = 0, nz = 0, ny = 0, nx = 0;
+    unsigned int checksums[2] = {0, 0};
+    unsigned int totalChecksums[2] = {0, 0};
 
-    SU3 readBuffer[4*Parameters::getNSpatial()];
+    SU3 readBuffer[4*m_N[0]];
+
+    nx = (Parallel::Neighbours::getProcessorDimensionPosition(0) * m_N[0]);
 
     for (long long t = 0; t < m_N[3]; t++) {
         nt = (Parallel::Neighbours::getProcessorDimensionPosition(3) * m_N[3] + t);
@@ -225,28 +463,117 @@ void IO::FieldIO::loadFieldConfiguration(const std::string &filename, Lattice<SU
             for (long long y = 0; y < m_N[1]; y++) {
                 ny = (Parallel::Neighbours::getProcessorDimensionPosition(1) * m_N[1] + y);
 
-                offset = Parallel::Index::getGlobalIndex(0,ny,nz,nt)*m_linkSize;
-                MPI_File_read_at(file, offset, &readBuffer, m_linkDoubles*Parameters::getNSpatial(), MPI_DOUBLE, MPI_STATUS_IGNORE);
+                offset = headerSize + Parallel::Index::getGlobalIndex(nx,ny,nz,nt)*m_linkSize;
+                MPI_File_read_at(file, offset, &readBuffer, m_linkDoubles*m_N[0], MPI_DOUBLE, MPI_STATUS_IGNORE);
                 for (long long x = 0; x < m_N[0]; x++) {
                     for (long long mu = 0; mu < 4; mu++) {
                         lattice[mu][Parallel::Index::getIndex(x,y,z,t)] = readBuffer[4*x + mu];
                     }
+                    if (hasHeader) {
+                        addSiteChecksum(&readBuffer[4*x], Parallel::Index::getGlobalIndex(nx + x,ny,nz,nt), checksums[0], checksums[1]);
+                    }
                 }
             }
         }
     }
 
+    MPI_File_close(&file);
+
+    if (hasHeader) {
+        MPI_Allreduce(checksums, totalChecksums, 2, MPI_UNSIGNED, MPI_BXOR, Parallel::ParallelParameters::ACTIVE_COMM);
+        verifyFieldChecksums(header, totalChecksums, fname);
+    }
+
     if (Parameters::getDebug()) {
         Parallel::Communicator::checkLattice(lattice, "Configuration is corrupt in IO::FieldIO load field after loaded");
     }
 
-    MPI_File_close(&file);
     if (Parallel::Communicator::getProcessRank() == 0 && !Parameters::getUnitTesting()) {
         printf("\nConfiguration %s loaded", fname.c_str());
     }
 
 }
 
+/*!
+ * \brief IO::FieldIO::loadMappedFieldConfiguration loads a regular configuration into memory by mapping the file directly.
+ * \param filename
+ * \param lattice is a pointer of four lattice objects, one for each Lorentz index, that will filled with the configuration read from file.
+ *
+ * Intended for analysis runs on a single processor, where the sub-lattice is the full lattice. The file is mapped read-only with mmap,
+ * and the links are copied straight from the mapped pages into the lattice in a single sequential pass, without any intermediate
+ * read buffers or MPI-IO calls. The header, file size and checksums are verified as in loadFieldConfiguration().
+ *
+ * The file stores the four links of a site contiguously, while the lattice holds one Lattice object per Lorentz index, so the links
+ * still have to be copied once.
+ *
+ * If debug is true in the passed .json parameter file, it will perform a check for lattice corruption.
+ */
+void IO::FieldIO::loadMappedFieldConfiguration(const std::string &filename, Lattice<SU3> *lattice)
+{
+    GLAC_TIMER(FIELD_IO_READ);
+    Parallel::ScopedPhase fileIO(Parallel::FILE_IO);
+    if (Parallel::Communicator::getNumProc() != 1) {
+        Parallel::Communicator::MPIExit("Error: memory mapped loading of configurations requires a single processor.");
+    }
+
+    // Sets up file name
+    std::string fname = Parameters::getFilePath() + Parameters::getInputFolder() + filename;
+
+    int fileDescriptor = open(fname.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        Parallel::Communicator::MPIExit("File " + fname + " does not exist");
+    }
+
+    struct stat fileStatus;
+    fstat(fileDescriptor, &fileStatus);
+    const long long fileSize = fileStatus.st_size;
+
+    const char *mappedFile = static_cast<const char*>(mmap(nullptr, std::size_t(fileSize), PROT_READ, MAP_PRIVATE, fileDescriptor, 0));
+    close(fileDescriptor);
+    if (mappedFile == MAP_FAILED) {
+        Parallel::Communicator::MPIExit("Error: failed to memory map " + fname);
+    }
+    madvise(const_cast<char*>(mappedFile), std::size_t(fileSize), MADV_SEQUENTIAL);
+
+    // Verifies the header and size of the file before reading anything into the lattice
+    FieldHeader header;
+    std::memset(&header, 0, sizeof(FieldHeader));
+    bool hasHeader = false;
+    if (fileSize >= m_headerSize) {
+        std::memcpy(&header, mappedFile, sizeof(FieldHeader));
+        hasHeader = (std::memcmp(header.magic, m_headerMagic, sizeof(m_headerMagic)) == 0);
+    }
+    verifyFieldHeader(header, hasHeader, fileSize, fname);
+
+    const SU3 *links = reinterpret_cast<const SU3*>(mappedFile + (hasHeader ? m_headerSize : 0));
+    unsigned int checksums[2] = {0, 0};
+    const unsigned long latticeSize = Parameters::getLatticeSize();
+
+    // With a single processor the local and global site indices coincide
+    for (unsigned long iSite = 0; iSite < latticeSize; iSite++) {
+        for (unsigned int mu = 0; mu < 4; mu++) {
+            lattice[mu][Parallel::Index::getSiteIndex(iSite)] = links[4*iSite + mu];
+        }
+        if (hasHeader) {
+            addSiteChecksum(&links[4*iSite], (long long)(iSite), checksums[0], checksums[1]);
+        }
+    }
+
+    munmap(const_cast<char*>(mappedFile), std::size_t(fileSize));
+
+    if (hasHeader) {
+        verifyFieldChecksums(header, checksums, fname);
+    }
+
+    if (Parameters::getDebug()) {
+        Parallel::Communicator::checkLattice(lattice, "Configuration is corrupt in IO::FieldIO mapped load field after loaded");
+    }
+
+    if (!Parameters::getUnitTesting()) {
+        printf("\nConfiguration %s loaded", fname.c_str());
+    }
+}
+
 /*!
  * \brief IO::FieldIO::loadChromaFieldConfiguration loads a configuration from Chroma into memory.
  * \param filename
@@ -263,6 +590,8 @@ void IO::FieldIO::loadChromaFieldConfiguration(const std::string &filename, Latt
      * Arguments:
      * - filename
      */
+    GLAC_TIMER(FIELD_IO_READ);
+    Parallel::ScopedPhase fileIO(Parallel::FILE_IO);
     MPI_File file;
 
     // Sets up file name
@@ -309,6 +638,102 @@ void IO::FieldIO::loadChromaFieldConfiguration(const std::string &filename, Latt
 
 }
 
+/*!
+ * \brief IO::FieldIO::readFieldHeader reads the header of a field configuration.
+ * \param file an opened MPI file.
+ * \param header FieldHeader to fill.
+ * \return true if the file starts with a FieldHeader, false if it is a configuration without a header.
+ *
+ * Only the root processor reads, and the header is then broadcasted to the rest.
+ */
+bool IO::FieldIO::readFieldHeader(MPI_File file, FieldHeader &header)
+{
+    int hasHeader = 0;
+    std::memset(&header, 0, sizeof(FieldHeader));
+
+    if (Parallel::Communicator::getProcessRank() == 0) {
+        MPI_Offset fileSize = 0;
+        MPI_File_get_size(file, &fileSize);
+        if (fileSize >= m_headerSize) {
+            MPI_File_read_at(file, 0, &header, int(m_headerSize), MPI_BYTE, MPI_STATUS_IGNORE);
+            hasHeader = (std::memcmp(header.magic, m_headerMagic, sizeof(m_headerMagic)) == 0);
+        }
+    }
+
+    MPI_Bcast(&hasHeader, 1, MPI_INT, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+    if (hasHeader) {
+        MPI_Bcast(&header, int(m_headerSize), MPI_BYTE, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+    }
+
+    return bool(hasHeader);
+}
+
+/*!
+ * \brief IO::FieldIO::verifyFieldHeader verifies that a configuration matches the lattice being run.
+ * \param header FieldHeader read from the file.
+ * \param hasHeader false if the file is a configuration without a header.
+ * \param fileSize size of the file in bytes.
+ * \param fname name of the file, used in error messages.
+ *
+ * Exits if the header version, precision or dimensions are wrong, or if the file is truncated.
+ */
+void IO::FieldIO::verifyFieldHeader(const FieldHeader &header, const bool hasHeader, const long long fileSize, const std::string &fname)
+{
+    const long long expectedFileSize = (hasHeader ? m_headerSize : 0) + Parameters::getLatticeSize()*m_linkSize;
+
+    if (hasHeader) {
+        if (header.version != m_headerVersion) {
+            Parallel::Communicator::MPIExit("Error: unknown field header version " + std::to_string(header.version) + " in " + fname);
+        }
+        if (header.precision != sizeof(double)) {
+            Parallel::Communicator::MPIExit("Error: field configuration " + fname + " has precision of "
+                                            + std::to_string(header.precision) + " bytes, expected " + std::to_string(sizeof(double)));
+        }
+        if (header.dimensions[0] != Parameters::getNSpatial() || header.dimensions[1] != Parameters::getNSpatial()
+                || header.dimensions[2] != Parameters::getNSpatial() || header.dimensions[3] != Parameters::getNTemporal()) {
+            Parallel::Communicator::MPIExit("Error: field configuration " + fname + " has dimensions "
+                                            + std::to_string(header.dimensions[0]) + "^3 x " + std::to_string(header.dimensions[3])
+                                            + ", expected " + std::to_string(Parameters::getNSpatial()) + "^3 x " + std::to_string(Parameters::getNTemporal()));
+        }
+    }
+
+    if (fileSize != expectedFileSize) {
+        Parallel::Communicator::MPIExit("Error: field configuration " + fname + " has size " + std::to_string(fileSize)
+                                        + " bytes, expected " + std::to_string(expectedFileSize) + " bytes. File is truncated or of wrong dimensions.");
+    }
+}
+
+/*!
+ * \brief IO::FieldIO::verifyFieldChecksums compares the checksums of a loaded configuration with the ones stored in its header.
+ * \param header FieldHeader read from the file.
+ * \param checksums the checksums computed over the full lattice, modulo 29 and 31 respectively.
+ * \param fname name of the file, used in error messages.
+ */
+void IO::FieldIO::verifyFieldChecksums(const FieldHeader &header, const unsigned int *checksums, const std::string &fname)
+{
+    if (checksums[0] != header.checksum29 || checksums[1] != header.checksum31) {
+        char checksumMessage[128];
+        sprintf(checksumMessage, "computed %08x %08x, header %08x %08x", checksums[0], checksums[1], header.checksum29, header.checksum31);
+        Parallel::Communicator::MPIExit("Error: checksum mismatch for field configuration " + fname + ": " + std::string(checksumMessage));
+    }
+}
+
+/*!
+ * \brief IO::FieldIO::addSiteChecksum adds the links of a single site to the running checksums.
+ * \param siteLinks pointer to the four links of the site, stored contiguously as in the file.
+ * \param globalSiteIndex global index of the site, used to rotate the site CRC-32.
+ * \param checksum29 checksum accumulated with rotations modulo 29.
+ * \param checksum31 checksum accumulated with rotations modulo 31.
+ *
+ * Since the sites are combined with XOR, the result is independent of the order and processor layout the sites are visited in.
+ */
+inline void IO::FieldIO::addSiteChecksum(const SU3 *siteLinks, const long long globalSiteIndex, unsigned int &checksum29, unsigned int &checksum31)
+{
+    const unsigned int siteCRC = crc32(siteLinks, std::size_t(m_linkSize));
+    checksum29 ^= rotateLeft(siteCRC, unsigned(globalSiteIndex % 29));
+    checksum31 ^= rotateLeft(siteCRC, unsigned(globalSiteIndex % 31));
+}
+
 bool IO::FieldIO::check_file_existence (const std::string &fname) {
     std::ifstream infile(fname);
     return infile.good();
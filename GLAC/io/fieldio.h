@@ -12,8 +12,10 @@
 #define FIELDIO_H
 
 #include <string>
+#include <mpi.h>
 #include "math/matrices/su3.h"
 #include "math/lattice.h"
+#include "fieldheader.h"
 
 namespace IO
 {
@@ -26,16 +28,29 @@ private:
     static const long long m_SU3Doubles;
     static const long long m_SU3Size;
 
+    // Field configuration header
+    static const long long m_headerSize;
+    static const unsigned int m_headerVersion;
+    static const char m_headerMagic[8];
+    static const char m_compressedMagic[8];
+
     static std::vector<unsigned int> m_N;
     static inline double reverseDouble(const double inDouble);
     static inline bool check_file_existence (const std::string &fname);
+    static inline void addSiteChecksum(const SU3 *siteLinks, const long long globalSiteIndex, unsigned int &checksum29, unsigned int &checksum31);
+    static bool readFieldHeader(MPI_File file, FieldHeader &header);
+    static void verifyFieldHeader(const FieldHeader &header, const bool hasHeader, const long long fileSize, const std::string &fname);
+    static void verifyFieldChecksums(const FieldHeader &header, const unsigned int *checksums, const std::string &fname);
 public:
     FieldIO();
     ~FieldIO();
     static void init();
     static void writeFieldToFile(Lattice<SU3> *lattice, const unsigned int configNumber);
     static void writeDoublesFieldToFile(const Lattice<double> &lattice, const unsigned int configNumber, const std::string &observable);
+    static void writeCompressedDoublesFieldToFile(const Lattice<double> &lattice, const unsigned int configNumber, const std::string &observable);
+    static void loadCompressedDoublesField(const std::string &filenamePath, Lattice<double> &lattice);
     static void loadFieldConfiguration(const std::string &filename, Lattice<SU3> *lattice);
+    static void loadMappedFieldConfiguration(const std::string &filename, Lattice<SU3> *lattice);
     static void loadChromaFieldConfiguration(const std::string &filename, Lattice<SU3> *lattice);
 };
 }
@@ -0,0 +1,220 @@
+#include "observablescontainer.h"
+#include "checksum.h"
+#include "config/parameters.h"
+#include "parallelization/communicator.h"
+#include "parallelization/phasetimer.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+
+std::map<std::string, IO::ObservablesContainer::Buffer> IO::ObservablesContainer::m_buffers;
+const char IO::ObservablesContainer::m_magic[8] = {'G','L','A','C','O','B','S','\0'};
+bool IO::ObservablesContainer::m_restored = false;
+std::map<std::string, unsigned long long> IO::ObservablesContainer::m_restoredRecordCounts;
+
+/*!
+ * \brief IO::ObservablesContainer::getFilename
+ * \param observableName name of the observable.
+ * \return the full path of the container file of the observable.
+ */
+std::string IO::ObservablesContainer::getFilename(const std::string &observableName)
+{
+    return Parameters::getFilePath() + Parameters::getOutputFolder()
+            + Parameters::getBatchName() + "/"
+            + "flow_observables/" + observableName + "/"
+            + Parameters::getBatchName() + "_"
+            + observableName + "_flow.bdat";
+}
+
+/*!
+ * \brief IO::ObservablesContainer::countRecords
+ * \param fname the full path of a container file.
+ * \param recordSize set to the size of each record in bytes, or 0 if the file does not exist.
+ * \return the number of complete records in the container.
+ */
+unsigned long long IO::ObservablesContainer::countRecords(const std::string &fname, unsigned int &recordSize)
+{
+    recordSize = 0;
+    std::ifstream file(fname, std::ios::binary);
+    if (!file.good()) return 0;
+
+    ContainerHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(ContainerHeader));
+    if (!file || std::memcmp(header.magic, m_magic, sizeof(m_magic)) != 0 || header.recordSize == 0) {
+        Parallel::Communicator::MPIExit("Error: " + fname + " is not an observables container.");
+    }
+    recordSize = header.recordSize;
+
+    file.seekg(0, std::ios::end);
+    const long long fileSize = file.tellg();
+    return (unsigned long long)(fileSize - (long long)sizeof(ContainerHeader)) / recordSize;
+}
+
+/*!
+ * \brief IO::ObservablesContainer::append adds the flow observables of a configuration to the buffer of the observable.
+ * \param observables the observables, with rows(NFlows + 1) times columns elements.
+ * \param observableName name of the observable.
+ * \param configNumber the configuration number, the configuration start number is added.
+ * \param columns number of columns of the observables, 1 for a scalar observable.
+ *
+ * Only the root processor buffers and writes. The buffer is appended to file once it holds flowObservablesBatchSize configurations.
+ */
+void IO::ObservablesContainer::append(const std::vector<double> &observables, const std::string &observableName,
+                                      const unsigned int configNumber, const unsigned int columns)
+{
+    if (Parallel::Communicator::getProcessRank() != 0) return;
+
+    Buffer &buffer = m_buffers[observableName];
+    const unsigned int rows = Parameters::getNFlows() + 1;
+
+    if (buffer.configNumbers.size() == 0) {
+        buffer.rows = rows;
+        buffer.columns = columns;
+    }
+
+    buffer.configNumbers.push_back(configNumber + unsigned(Parameters::getConfigStartNumber()));
+    buffer.observables.insert(buffer.observables.end(), observables.begin(), observables.begin() + rows*columns);
+
+    if (buffer.configNumbers.size() >= Parameters::getFlowObservablesBatchSize()) {
+        flush(observableName, buffer);
+    }
+}
+
+/*!
+ * \brief IO::ObservablesContainer::flushAll appends all buffered observables to file.
+ *
+ * Must be called at the end of a run, as well as before writing a checkpoint.
+ */
+void IO::ObservablesContainer::flushAll()
+{
+    if (Parallel::Communicator::getProcessRank() != 0) return;
+
+    for (auto it = m_buffers.begin(); it != m_buffers.end(); it++) {
+        flush(it->first, it->second);
+    }
+}
+
+/*!
+ * \brief IO::ObservablesContainer::getRecordCounts
+ * \return the number of records in the container of each observable appended to, on the root processor. Empty on the other processors.
+ *
+ * Must be called after flushAll, when writing a checkpoint.
+ */
+std::map<std::string, unsigned long long> IO::ObservablesContainer::getRecordCounts()
+{
+    std::map<std::string, unsigned long long> recordCounts;
+    if (Parallel::Communicator::getProcessRank() != 0) return recordCounts;
+
+    unsigned int recordSize;
+    for (auto it = m_buffers.begin(); it != m_buffers.end(); it++) {
+        recordCounts[it->first] = countRecords(getFilename(it->first), recordSize);
+    }
+    return recordCounts;
+}
+
+/*!
+ * \brief IO::ObservablesContainer::restoreRecordCounts drops the records written after a checkpoint.
+ * \param recordCounts the number of records of each container when the checkpoint was written, as given by getRecordCounts.
+ *
+ * The containers listed are truncated at once. A container not listed was not appended to before the checkpoint, and is emptied of
+ * records the first time it is appended to.
+ */
+void IO::ObservablesContainer::restoreRecordCounts(const std::map<std::string, unsigned long long> &recordCounts)
+{
+    if (Parallel::Communicator::getProcessRank() != 0) return;
+
+    m_restored = true;
+    m_restoredRecordCounts = recordCounts;
+    for (auto it = m_buffers.begin(); it != m_buffers.end(); it++) {
+        it->second.restored = false;
+    }
+
+    Parallel::ScopedPhase fileIO(Parallel::FILE_IO);
+    for (auto it = recordCounts.begin(); it != recordCounts.end(); it++) {
+        const std::string fname = getFilename(it->first);
+        unsigned int recordSize;
+        if (countRecords(fname, recordSize) > it->second
+                && truncate(fname.c_str(), (off_t)(sizeof(ContainerHeader) + it->second*recordSize)) != 0) {
+            Parallel::Communicator::MPIExit("Error: failed to drop the records after the checkpoint from observables container " + fname);
+        }
+    }
+}
+
+/*!
+ * \brief IO::ObservablesContainer::flush appends the buffered records of an observable to its container file.
+ * \param observableName name of the observable.
+ * \param buffer the buffered records, emptied after writing.
+ *
+ * Creates the file with a ContainerHeader if it does not exist. If it does exist, the header must match the records to append.
+ * The first time a container is appended to after restoring a checkpoint, the records written after the checkpoint are dropped.
+ */
+void IO::ObservablesContainer::flush(const std::string &observableName, Buffer &buffer)
+{
+    Parallel::ScopedPhase fileIO(Parallel::FILE_IO);
+    if (buffer.configNumbers.size() == 0) return;
+
+    const std::string fname = getFilename(observableName);
+    const unsigned int dataSize = buffer.rows * buffer.columns * sizeof(double);
+    const unsigned int recordSize = 2*sizeof(unsigned int) + dataSize;
+
+    ContainerHeader header;
+    std::memset(&header, 0, sizeof(ContainerHeader));
+
+    std::ifstream existingFile(fname, std::ios::binary);
+    const bool newFile = !existingFile.good();
+    if (!newFile) {
+        existingFile.read(reinterpret_cast<char*>(&header), sizeof(ContainerHeader));
+        if (!existingFile || std::memcmp(header.magic, m_magic, sizeof(m_magic)) != 0
+                || header.rows != buffer.rows || header.columns != buffer.columns) {
+            Parallel::Communicator::MPIExit("Error: observables container " + fname + " does not match the observables to append.");
+        }
+
+        // Drops a record only partially written by an interrupted run, such that the records stay aligned
+        existingFile.seekg(0, std::ios::end);
+        const long long fileSize = existingFile.tellg();
+        long long records = (fileSize - (long long)sizeof(ContainerHeader)) / recordSize;
+        if (m_restored && !buffer.restored) {
+            const auto restoredRecords = m_restoredRecordCounts.find(observableName);
+            records = std::min(records, restoredRecords == m_restoredRecordCounts.end() ? 0LL : (long long)restoredRecords->second);
+        }
+        const long long completeSize = sizeof(ContainerHeader) + records * recordSize;
+        if (completeSize != fileSize && truncate(fname.c_str(), completeSize) != 0) {
+            Parallel::Communicator::MPIExit("Error: failed to remove records from observables container " + fname);
+        }
+    } else {
+        std::memcpy(header.magic, m_magic, sizeof(m_magic));
+        header.version = 1;
+        header.rows = buffer.rows;
+        header.columns = buffer.columns;
+        header.recordSize = recordSize;
+        header.beta = Parameters::getBeta();
+        header.flowEpsilon = Parameters::getFlowEpsilon();
+    }
+    existingFile.close();
+    buffer.restored = true;
+
+    std::vector<char> records(recordSize * buffer.configNumbers.size());
+    for (unsigned long i = 0; i < buffer.configNumbers.size(); i++) {
+        char *record = &records[i * recordSize];
+        const double *data = &buffer.observables[i * buffer.rows * buffer.columns];
+        const unsigned int crc = crc32(data, dataSize);
+        std::memcpy(record, &buffer.configNumbers[i], sizeof(unsigned int));
+        std::memcpy(record + sizeof(unsigned int), &crc, sizeof(unsigned int));
+        std::memcpy(record + 2*sizeof(unsigned int), data, dataSize);
+    }
+
+    std::ofstream file(fname, std::ios::binary | std::ios::app);
+    if (newFile) {
+        file.write(reinterpret_cast<const char*>(&header), sizeof(ContainerHeader));
+    }
+    file.write(records.data(), std::streamsize(records.size()));
+    file.close();
+
+    if (Parameters::getVerbose() && !Parameters::getUnitTesting()) {
+        printf("\n%s: %lu configurations appended.", fname.c_str(), buffer.configNumbers.size());
+    }
+
+    buffer.configNumbers.clear();
+    buffer.observables.clear();
+}
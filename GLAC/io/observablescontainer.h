@@ -0,0 +1,93 @@
+/*!
+ * \class ObservablesContainer
+ *
+ * \brief Class for writing flow observables of all configurations of a run to a single binary, append-only file per observable.
+ *
+ * Replaces the per configuration text files of IO::writeFlowObservableToFile and IO::writeMatrixToFile when binaryFlowObservables is set.
+ * The observables are buffered on the root processor, and appended to file in batches of flowObservablesBatchSize configurations.
+ *
+ * A container file(.bdat) is laid out as,
+ * - a ContainerHeader holding the number of rows(flow steps) and columns of each record, beta and the flow epsilon,
+ * - fixed size records, each holding the configuration number, a CRC-32 of the data and rows x columns doubles.
+ *
+ * Since every record has the same size, the configuration numbers form an index that may be read directly, and
+ * a record that was only partially written when a run was interrupted is detected from the file size or checksum.
+ *
+ * The number of records in each container is stored in a checkpoint. When a run is restored from it, the records written after the
+ * checkpoint are dropped, as the configurations they belong to are generated again.
+ *
+ * \author Mathias M. Vege
+ * \version 1.0
+ * \date 2017-2019
+ * \copyright MIT Licence
+ */
+#ifndef OBSERVABLESCONTAINER_H
+#define OBSERVABLESCONTAINER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace IO
+{
+struct ContainerHeader
+{
+    //! Identifies a file as a GLAC observables container, "GLACOBS\0".
+    char magic[8];
+
+    //! Version of the file layout.
+    unsigned int version;
+
+    //! Number of rows in each record, i.e. the number of flow steps plus one.
+    unsigned int rows;
+
+    //! Number of columns in each record, 1 for scalar observables and e.g. NT for Euclidean time observables.
+    unsigned int columns;
+
+    //! Size of each record in bytes.
+    unsigned int recordSize;
+
+    double beta;
+    double flowEpsilon;
+
+    //! Pads header to 64 bytes.
+    char padding[24];
+};
+
+static_assert(sizeof(ContainerHeader) == 64, "ContainerHeader is required to be 64 bytes.");
+
+class ObservablesContainer
+{
+private:
+    struct Buffer
+    {
+        unsigned int rows;
+        unsigned int columns;
+        // Whether records written after a restored checkpoint have been dropped
+        bool restored = false;
+        std::vector<unsigned int> configNumbers;
+        std::vector<double> observables;
+    };
+
+    static std::map<std::string, Buffer> m_buffers;
+    static const char m_magic[8];
+
+    // Number of records of each container when the checkpoint restored from was written
+    static bool m_restored;
+    static std::map<std::string, unsigned long long> m_restoredRecordCounts;
+
+    static std::string getFilename(const std::string &observableName);
+    static unsigned long long countRecords(const std::string &fname, unsigned int &recordSize);
+    static void flush(const std::string &observableName, Buffer &buffer);
+public:
+    static void append(const std::vector<double> &observables, const std::string &observableName,
+                       const unsigned int configNumber, const unsigned int columns);
+    static void flushAll();
+
+    // Records written at a checkpoint
+    static std::map<std::string, unsigned long long> getRecordCounts();
+    static void restoreRecordCounts(const std::map<std::string, unsigned long long> &recordCounts);
+};
+}
+
+#endif // OBSERVABLESCONTAINER_H
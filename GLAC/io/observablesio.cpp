@@ -1,6 +1,8 @@
 #include "observablesio.h"
+#include "observablescontainer.h"
 #include "config/parameters.h"
 #include "parallelization/communicator.h"
+#include "parallelization/phasetimer.h"
 #include <cmath>
 #include <fstream>
 #include <iomanip>
@@ -37,6 +39,7 @@ void IO::writeObservablesToFile(const double acceptanceRate,
     /*
      * Function to write thermalization and configuration observables to file.
      */
+    Parallel::ScopedPhase fileIO(Parallel::FILE_IO);
     if (Parallel::Communicator::getProcessRank() == 0)
     {
         auto oldPrecision = cout.precision(15);
@@ -76,6 +79,8 @@ void IO::writeObservablesToFile(const double acceptanceRate,
  * - NFlows,
  * - FlowEpsilon,
  * with the rest containing the flowed observable.
+ *
+ * If binaryFlowObservables is set, the observable is instead appended to the binary container of the observable, see ObservablesContainer.
  */
 void IO::writeFlowObservableToFile(const std::vector<double> &observables,
                                    const std::string &observableName,
@@ -84,6 +89,13 @@ void IO::writeFlowObservableToFile(const std::vector<double> &observables,
     /*
      * Method for writing a flow variable to file.
      */
+    Parallel::ScopedPhase fileIO(Parallel::FILE_IO);
+    if (Parameters::getBinaryFlowObservables())
+    {
+        ObservablesContainer::append(observables, observableName, configNumber, 1);
+        return;
+    }
+
     if (Parallel::Communicator::getProcessRank() == 0)
     {
         auto oldPrecision = cout.precision(15);
@@ -137,6 +149,8 @@ void IO::writeFlowObservableToFile(const std::vector<double> &observables,
  * - NFlows,
  * - FlowEpsilon,
  * with the rest containing the flowed observable.
+ *
+ * If binaryFlowObservables is set, the observables are instead appended to the binary container of the observable, see ObservablesContainer.
  */
 void IO::writeMatrixToFile(const std::vector<double> &observables, const std::string &observableName,
                            const unsigned int configNumber, const unsigned int N)
@@ -144,6 +158,12 @@ void IO::writeMatrixToFile(const std::vector<double> &observables, const std::st
     /*
      * Function for writing out a matrix of observables to file, e.g. the topc in euclidean time.
      */
+    Parallel::ScopedPhase fileIO(Parallel::FILE_IO);
+    if (Parameters::getBinaryFlowObservables())
+    {
+        ObservablesContainer::append(observables, observableName, configNumber, N);
+        return;
+    }
 
     // Writes to file
     if (Parallel::Communicator::getProcessRank() == 0)
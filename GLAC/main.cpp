@@ -3,6 +3,7 @@
 #include "config/parameters.h"
 #include "config/configloader.h"
 #include "tests/test.h"
+#include "instrumentation/timers.h"
 
 using std::chrono::steady_clock;
 using std::chrono::duration_cast;
@@ -53,11 +54,18 @@ int main(int numberOfArguments, char* cmdLineArguments[])
 
     ConfigLoader::load(std::string(cmdLineArguments[1]));
 
+    // Splits the processors between the chains of an ensemble or between flow groups, if more than one is run
+    Parallel::Communicator::initializeGroups();
+
+    // Divides the lattice between the processors, leaving those the lattice can not be divided between inactive
+    Parallel::Communicator::initializeProcessGrid();
+
     // Initialises lattice sharing in the communicator
 //    Parallel::Communicator::initializeSubLattice();
 
-    // Unit and performance tests
+    // Unit and performance tests, and component benchmarks
     runUnitTests(Parameters::getUnitTesting());
+    runBenchmarks(Parameters::getBenchmarking());
     runPerformanceTests(Parameters::getPerformanceTesting());
 
     // Program timers
@@ -72,6 +80,9 @@ int main(int numberOfArguments, char* cmdLineArguments[])
     // Finalizing and printing time taken
     duration<double> programTime = duration_cast<duration<double>>(steady_clock::now() - programStart);
 
+    // Prints the time spent in each instrumented region, if built with CONFIG+=instrumentation
+    Instrumentation::Timers::printSummary(programTime.count());
+
     if (Parallel::Communicator::getProcessRank() == 0) {
         printf("\nProgram complete. Time used: %f hours (%f seconds)", double(programTime.count())/3600.0, programTime.count());
     }
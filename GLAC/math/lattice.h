@@ -15,9 +15,12 @@
 
 #include <vector>
 #include <mpi.h>
+#include "parallelization/haloexchange.h"
 #include "parallelization/index.h"
 #include "parallelization/neighbours.h"
 #include "parallelization/parallelparameters.h"
+#include "parallelization/phasetimer.h"
+#include "instrumentation/timers.h"
 #include "functions.h"
 
 template <class T>
@@ -835,634 +838,39 @@ inline Lattice<SU3> shift(const Lattice<SU3> &L, const DIR direction, const unsi
      *  [x31 x32 x33] [y31 y32 y33]    [x32 x33 y31] [y32 y33 x31]
      * The shifted lattice, is then returned.
      */
+    GLAC_TIMER(LATTICE_SHIFT);
     Lattice<SU3> _L;
     _L.allocate(L.m_dim); // MOVE THIS TO INITIALIZATION/HEADER-THING?
-    std::vector<SU3> sendCube; // Move indexes to index in order to avoid 2 integer multiplications)
-    std::vector<SU3> recvCube; // MOVE THIS TO HEADER; SO WE DONT ALLOCATE EVERY TIME!
-    // INSTEAD OF CUBE INDEX, JUST DO INDEX WITH DIMENSION SET TO ZERO
-    MPI_Request sendReq,recvReq;
-    switch(direction) {
-    case BACKWARDS: {
-        switch(lorentzVector) {
-        case 0: {
-            sendCube.resize(L.m_dim[1]*L.m_dim[2]*L.m_dim[3]); // Four of these can actually be stored globally
-            recvCube.resize(L.m_dim[1]*L.m_dim[2]*L.m_dim[3]);
-            /* Max memory usage: 48*48*48*96 /w 512 procs -->  12 12 12 12 --> 4 cubes of size 12^3 = 1728*18 bytes
-             * --> 1728*28 / 1024(to kilobytes) / 1024(to megabytes) = 0.03 MB per processor.
-             * Maximum use of 4 volumes, one for each direction(assuming that spatial directionality may vary) --> 0.12 MB in total for this part
-             */
-            // Populates package to send
-            for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) { // Ensure cube indexes match before and after in order to map correctly!!
-                        sendCube[Parallel::Index::cubeIndex(iy,iz,it,L.m_dim[1],L.m_dim[2])] = L.m_sites[Parallel::Index::getIndex(L.m_dim[0]-1,iy,iz,it)];
-                    }
-                }
-            }
-            // Sends and receives packages
-            MPI_Isend(&sendCube.front(),18*(L.m_dim[1]*L.m_dim[2]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(1),0,Parallel::ParallelParameters::ACTIVE_COMM,&sendReq);
-            MPI_Irecv(&recvCube.front(),18*(L.m_dim[1]*L.m_dim[2]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(0),0,Parallel::ParallelParameters::ACTIVE_COMM,&recvReq);
-            // Populates shifted lattice by elements not required to share
-            for (unsigned int ix = 1; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                        for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                           _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it)] = L.m_sites[Parallel::Index::getIndex(ix-1,iy,iz,it)];
-                        }
-                    }
-                }
-            }
-            // Ensures all results have been sent and received, then populates face cube with remaining results.
-            MPI_Wait(&sendReq,MPI_STATUS_IGNORE);
-            MPI_Wait(&recvReq,MPI_STATUS_IGNORE);
-            // Repopulates the lattice with missing cube
-            for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                       _L.m_sites[Parallel::Index::getIndex(0,iy,iz,it)] = recvCube[Parallel::Index::cubeIndex(iy,iz,it,L.m_dim[1],L.m_dim[2])];
-                    }
-                }
-            }
-            return _L;
-        }
-        case 1: {
-            sendCube.resize(L.m_dim[0]*L.m_dim[2]*L.m_dim[3]);
-            recvCube.resize(L.m_dim[0]*L.m_dim[2]*L.m_dim[3]);
-            // Populates package to send
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                        sendCube[Parallel::Index::cubeIndex(ix,iz,it,L.m_dim[0],L.m_dim[2])] = L.m_sites[Parallel::Index::getIndex(ix,L.m_dim[1]-1,iz,it)];
-                    }
-                }
-            }
-            MPI_Isend(&sendCube.front(),18*(L.m_dim[0]*L.m_dim[2]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(3),0,Parallel::ParallelParameters::ACTIVE_COMM,&sendReq);
-            MPI_Irecv(&recvCube.front(),18*(L.m_dim[0]*L.m_dim[2]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(2),0,Parallel::ParallelParameters::ACTIVE_COMM,&recvReq);
-            // Populates shifted lattice by elements not required to share
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 1; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                        for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                            _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it)] = L.m_sites[Parallel::Index::getIndex(ix,iy-1,iz,it)];
-                        }
-                    }
-                }
-            }
-            // Ensures all results have been sent and received
-            MPI_Wait(&sendReq,MPI_STATUS_IGNORE);
-            MPI_Wait(&recvReq,MPI_STATUS_IGNORE);
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                        _L.m_sites[Parallel::Index::getIndex(ix,0,iz,it)] = recvCube[Parallel::Index::cubeIndex(ix,iz,it,L.m_dim[0],L.m_dim[2])];
-                    }
-                }
-            }
-            return _L;
-        }
-        case 2: {
-            sendCube.resize(L.m_dim[0]*L.m_dim[1]*L.m_dim[3]);
-            recvCube.resize(L.m_dim[0]*L.m_dim[1]*L.m_dim[3]);
-            // Populates package to send
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                        sendCube[Parallel::Index::cubeIndex(ix,iy,it,L.m_dim[0],L.m_dim[1])] = L.m_sites[Parallel::Index::getIndex(ix,iy,L.m_dim[2]-1,it)];
-                    }
-                }
-            }
-            MPI_Isend(&sendCube.front(),18*(L.m_dim[0]*L.m_dim[1]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(5),0,Parallel::ParallelParameters::ACTIVE_COMM,&sendReq);
-            MPI_Irecv(&recvCube.front(),18*(L.m_dim[0]*L.m_dim[1]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(4),0,Parallel::ParallelParameters::ACTIVE_COMM,&recvReq);
-            // Populates shifted lattice by elements not required to share
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 1; iz < L.m_dim[2]; iz++) {
-                        for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                            _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it)] = L.m_sites[Parallel::Index::getIndex(ix,iy,iz-1,it)];
-                        }
-                    }
-                }
-            }
-            // Ensures all results have been sent and received
-            MPI_Wait(&recvReq,MPI_STATUS_IGNORE);
-            MPI_Wait(&sendReq,MPI_STATUS_IGNORE);
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                        _L.m_sites[Parallel::Index::getIndex(ix,iy,0,it)] = recvCube[Parallel::Index::cubeIndex(ix,iy,it,L.m_dim[0],L.m_dim[1])];
-                    }
-                }
-            }
-            return _L;
-        }
-        case 3: {
-            sendCube.resize(L.m_dim[0]*L.m_dim[1]*L.m_dim[2]);
-            recvCube.resize(L.m_dim[0]*L.m_dim[1]*L.m_dim[2]);
-            // Populates package to send
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                        sendCube[Parallel::Index::cubeIndex(ix,iy,iz,L.m_dim[0],L.m_dim[1])] = L.m_sites[Parallel::Index::getIndex(ix,iy,iz,L.m_dim[3]-1)];
-                    }
-                }
-            }
-            MPI_Isend(&sendCube.front(),18*(L.m_dim[0]*L.m_dim[1]*L.m_dim[2]),MPI_DOUBLE,Parallel::Neighbours::get(7),0,Parallel::ParallelParameters::ACTIVE_COMM,&sendReq);
-            MPI_Irecv(&recvCube.front(),18*(L.m_dim[0]*L.m_dim[1]*L.m_dim[2]),MPI_DOUBLE,Parallel::Neighbours::get(6),0,Parallel::ParallelParameters::ACTIVE_COMM,&recvReq);
-            // Populates shifted lattice by elements not required to share
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                        for (unsigned int it = 1; it < L.m_dim[3]; it++) {
-                            _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it)] = L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it-1)];
-                        }
-                    }
-                }
-            }
-            // Ensures all results have been sent and received
-            MPI_Wait(&recvReq,MPI_STATUS_IGNORE);
-            MPI_Wait(&sendReq,MPI_STATUS_IGNORE);
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                       _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,0)] = recvCube[Parallel::Index::cubeIndex(ix,iy,iz,L.m_dim[0],L.m_dim[1])];
-                    }
-                }
-            }
-            return _L;
-        }
-        }
-        break;
-    }
-    case FORWARDS: {
-        switch(lorentzVector) {
-        case 0: { // x direction
-            sendCube.resize(L.m_dim[1]*L.m_dim[2]*L.m_dim[3]);
-            recvCube.resize(L.m_dim[1]*L.m_dim[2]*L.m_dim[3]);
-            // Populates package to send
-            for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                        sendCube[Parallel::Index::cubeIndex(iy,iz,it,L.m_dim[1],L.m_dim[2])] = L.m_sites[Parallel::Index::getIndex(0,iy,iz,it)];
-                    }
-                }
-            }
-            // Sends and receives packages
-            MPI_Isend(&sendCube.front(),18*(L.m_dim[1]*L.m_dim[2]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(0),0,Parallel::ParallelParameters::ACTIVE_COMM,&sendReq);
-            MPI_Irecv(&recvCube.front(),18*(L.m_dim[1]*L.m_dim[2]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(1),0,Parallel::ParallelParameters::ACTIVE_COMM,&recvReq);
-            // Populates shifted lattice by elements not required to share
-            for (unsigned int ix = 0; ix < L.m_dim[0] - 1; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                        for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                           _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it)] = L.m_sites[Parallel::Index::getIndex(ix+1,iy,iz,it)];
-                        }
-                    }
-                }
-            }
-            // Ensures all results have been sent and received, then populates face cube with remaining results.
-            MPI_Wait(&sendReq,MPI_STATUS_IGNORE);
-            MPI_Wait(&recvReq,MPI_STATUS_IGNORE);
-            for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                       _L.m_sites[Parallel::Index::getIndex(L.m_dim[0]-1,iy,iz,it)] = recvCube[Parallel::Index::cubeIndex(iy,iz,it,L.m_dim[1],L.m_dim[2])];
-                    }
-                }
-            }
-            return _L;
-        }
-        case 1: { // y direction
-            sendCube.resize(L.m_dim[0]*L.m_dim[2]*L.m_dim[3]);
-            recvCube.resize(L.m_dim[0]*L.m_dim[2]*L.m_dim[3]);
-            // Populates package to send
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                        sendCube[Parallel::Index::cubeIndex(ix,iz,it,L.m_dim[0],L.m_dim[2])] = L.m_sites[Parallel::Index::getIndex(ix,0,iz,it)];
-                    }
-                }
-            }
-            MPI_Isend(&sendCube.front(),18*(L.m_dim[0]*L.m_dim[2]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(2),0,Parallel::ParallelParameters::ACTIVE_COMM,&sendReq);
-            MPI_Irecv(&recvCube.front(),18*(L.m_dim[0]*L.m_dim[2]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(3),0,Parallel::ParallelParameters::ACTIVE_COMM,&recvReq);
-            // Populates shifted lattice by elements not required to share
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1] - 1; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                        for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                           _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it)] = L.m_sites[Parallel::Index::getIndex(ix,iy+1,iz,it)];
-                        }
-                    }
-                }
-            }
-            // Ensures all results have been sent and received
-            MPI_Wait(&sendReq,MPI_STATUS_IGNORE);
-            MPI_Wait(&recvReq,MPI_STATUS_IGNORE);
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                       _L.m_sites[Parallel::Index::getIndex(ix,L.m_dim[1]-1,iz,it)] = recvCube[Parallel::Index::cubeIndex(ix,iz,it,L.m_dim[0],L.m_dim[2])];
-                    }
-                }
-            }
-            return _L;
-        }
-        case 2: { // z direction
-            sendCube.resize(L.m_dim[0]*L.m_dim[1]*L.m_dim[3]);
-            recvCube.resize(L.m_dim[0]*L.m_dim[1]*L.m_dim[3]);
-            // Populates package to send
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                        sendCube[Parallel::Index::cubeIndex(ix,iy,it,L.m_dim[0],L.m_dim[1])] = L.m_sites[Parallel::Index::getIndex(ix,iy,0,it)];
-                    }
-                }
-            }
-            MPI_Isend(&sendCube.front(),18*(L.m_dim[0]*L.m_dim[1]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(4),0,Parallel::ParallelParameters::ACTIVE_COMM,&sendReq);
-            MPI_Irecv(&recvCube.front(),18*(L.m_dim[0]*L.m_dim[1]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(5),0,Parallel::ParallelParameters::ACTIVE_COMM,&recvReq);
-            // Populates shifted lattice by elements not required to share
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2] - 1; iz++) {
-                        for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                            _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it)] = L.m_sites[Parallel::Index::getIndex(ix,iy,iz+1,it)];
-                        }
-                    }
-                }
-            }
-            // Ensures all results have been sent and received
-            MPI_Wait(&recvReq,MPI_STATUS_IGNORE);
-            MPI_Wait(&sendReq,MPI_STATUS_IGNORE);
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                        _L.m_sites[Parallel::Index::getIndex(ix,iy,L.m_dim[2]-1,it)] = recvCube[Parallel::Index::cubeIndex(ix,iy,it,L.m_dim[0],L.m_dim[1])];
-                    }
-                }
-            }
-            return _L;
-        }
-        case 3: { // t direction
-            sendCube.resize(L.m_dim[0]*L.m_dim[1]*L.m_dim[2]);
-            recvCube.resize(L.m_dim[0]*L.m_dim[1]*L.m_dim[2]);
-            // Populates package to send
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                        sendCube[Parallel::Index::cubeIndex(ix,iy,iz,L.m_dim[0],L.m_dim[1])] = L.m_sites[Parallel::Index::getIndex(ix,iy,iz,0)];
-                    }
-                }
-            }
-            MPI_Isend(&sendCube.front(),18*(L.m_dim[0]*L.m_dim[1]*L.m_dim[2]),MPI_DOUBLE,Parallel::Neighbours::get(6),0,Parallel::ParallelParameters::ACTIVE_COMM,&sendReq);
-            MPI_Irecv(&recvCube.front(),18*(L.m_dim[0]*L.m_dim[1]*L.m_dim[2]),MPI_DOUBLE,Parallel::Neighbours::get(7),0,Parallel::ParallelParameters::ACTIVE_COMM,&recvReq);
-            // Populates shifted lattice by elements not required to share
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                        for (unsigned int it = 0; it < L.m_dim[3] - 1; it++) {
-                            _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it)] = L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it+1)];
-                        }
-                    }
-                }
-            }
-            // Ensures all results have been sent and received
-            MPI_Wait(&recvReq,MPI_STATUS_IGNORE);
-            MPI_Wait(&sendReq,MPI_STATUS_IGNORE);
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                        _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,L.m_dim[3]-1)] = recvCube[Parallel::Index::cubeIndex(ix,iy,iz,L.m_dim[0],L.m_dim[1])];
-                    }
-                }
-            }
-            return _L;
-        }
-        }
-        break;
-    }
+
+    // The face received is the one towards the processor the sites are taken from, and the opposite face is sent
+    const int receiveDirection = 2*int(lorentzVector) + (direction == FORWARDS ? 1 : 0);
+    const int sendDirection = 2*int(lorentzVector) + (direction == FORWARDS ? 0 : 1);
+    const std::vector<unsigned int> &sendSites = Parallel::Index::getFaceSites(sendDirection);
+    const std::vector<unsigned int> &receiveSites = Parallel::Index::getFaceSites(receiveDirection);
+
+    Parallel::HaloExchange exchange(sendSites.size(), sendDirection, receiveDirection);
+    SU3 *sendFace = exchange.sendFace();
+    // Populates package to send, ordered by the halo index of the sites
+    for (unsigned long iFace = 0; iFace < sendSites.size(); iFace++) {
+        sendFace[iFace] = L.m_sites[sendSites[iFace]];
+    }
+    // Sends and receives packages
+    exchange.start();
+    // Populates shifted lattice from the neighbouring sites. The neighbours of the received face wrap around, and are replaced below.
+    for (unsigned long iSite = 0; iSite < L.m_latticeSize; iSite++) {
+        _L.m_sites[iSite] = L.m_sites[Parallel::Index::getNeighbourIndex(iSite, receiveDirection)];
+    }
+    // Ensures all results have been sent and received, then populates face cube with remaining results.
+    const SU3 *recvFace = exchange.receiveFace();
+    for (unsigned long iFace = 0; iFace < receiveSites.size(); iFace++) {
+        _L.m_sites[receiveSites[iFace]] = recvFace[iFace];
     }
     return _L;
 }
 
 inline Lattice<SU3> shift(Lattice<SU3> &&L, const DIR direction, const unsigned int lorentzVector)
 {
-    /*
-     * Function for shifting lattice in on or another direction.
-     * The direction of the matrix is taken care if in what lattice we are passing.
-     *
-     * The FORWADS/BACKWARDS semantic is quite confusing, but consider this:
-     * When shifting e.g. BACKWARDS, we want to update the current lattice at processor P
-     * with the lattice from the processor in-front, i.e. shifting it one step backwards,
-     *  [x11 x12 x13] [y11 y12 y13]    [x12 x13 y11] [y12 y13 x11]
-     *  [x21 x22 x23] [y21 y22 y23] -> [x22 x23 y21] [y22 y23 x21]
-     *  [x31 x32 x33] [y31 y32 y33]    [x32 x33 y31] [y32 y33 x31]
-     * The shifted lattice, is then returned.
-     */
-    Lattice<SU3> _L;
-    _L.allocate(L.m_dim);// MOVE THIS TO INITIALIZATION/HEADER-THING?
-    std::vector<SU3> sendCube; // Move indexes to index in order to avoid 2 integer multiplications)
-    std::vector<SU3> recvCube; // MOVE THIS TO HEADER; SO WE DONT ALLOCATE EVERY TIME!
-    // INSTEAD OF CUBE INDEX, JUST DO INDEX WITH DIMENSION SET TO ZERO
-    MPI_Request sendReq,recvReq;
-    switch(direction) {
-    case BACKWARDS: {
-        switch(lorentzVector) {
-        case 0: {
-            sendCube.resize(L.m_dim[1]*L.m_dim[2]*L.m_dim[3]); // Four of these can actually be stored globally
-            recvCube.resize(L.m_dim[1]*L.m_dim[2]*L.m_dim[3]);
-            /* Max memory usage: 48*48*48*96 /w 512 procs -->  12 12 12 12 --> 4 cubes of size 12^3 = 1728*18 bytes
-             * --> 1728*28 / 1024(to kilobytes) / 1024(to megabytes) = 0.03 MB per processor.
-             * Maximum use of 4 volumes, one for each direction(assuming that spatial directionality may vary) --> 0.12 MB in total for this part
-             */
-            // Populates package to send
-            for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) { // Ensure cube indexes match before and after in order to map correctly!!
-                        sendCube[Parallel::Index::cubeIndex(iy,iz,it,L.m_dim[1],L.m_dim[2])] = L.m_sites[Parallel::Index::getIndex(L.m_dim[0]-1,iy,iz,it)];
-                    }
-                }
-            }
-            // Sends and receives packages
-            MPI_Isend(&sendCube.front(),18*(L.m_dim[1]*L.m_dim[2]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(1),0,Parallel::ParallelParameters::ACTIVE_COMM,&sendReq);
-            MPI_Irecv(&recvCube.front(),18*(L.m_dim[1]*L.m_dim[2]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(0),0,Parallel::ParallelParameters::ACTIVE_COMM,&recvReq);
-            // Populates shifted lattice by elements not required to share
-            for (unsigned int ix = 1; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                        for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                           _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it)] = L.m_sites[Parallel::Index::getIndex(ix-1,iy,iz,it)];
-                        }
-                    }
-                }
-            }
-            // Ensures all results have been sent and received, then populates face cube with remaining results.
-            MPI_Wait(&sendReq,MPI_STATUS_IGNORE);
-            MPI_Wait(&recvReq,MPI_STATUS_IGNORE);
-            // Repopulates the lattice with missing cube
-            for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                       _L.m_sites[Parallel::Index::getIndex(0,iy,iz,it)] = recvCube[Parallel::Index::cubeIndex(iy,iz,it,L.m_dim[1],L.m_dim[2])];
-                    }
-                }
-            }
-            return _L;
-        }
-        case 1: {
-            sendCube.resize(L.m_dim[0]*L.m_dim[2]*L.m_dim[3]);
-            recvCube.resize(L.m_dim[0]*L.m_dim[2]*L.m_dim[3]);
-            // Populates package to send
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                        sendCube[Parallel::Index::cubeIndex(ix,iz,it,L.m_dim[0],L.m_dim[2])] = L.m_sites[Parallel::Index::getIndex(ix,L.m_dim[1]-1,iz,it)];
-                    }
-                }
-            }
-            MPI_Isend(&sendCube.front(),18*(L.m_dim[0]*L.m_dim[2]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(3),0,Parallel::ParallelParameters::ACTIVE_COMM,&sendReq);
-            MPI_Irecv(&recvCube.front(),18*(L.m_dim[0]*L.m_dim[2]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(2),0,Parallel::ParallelParameters::ACTIVE_COMM,&recvReq);
-            // Populates shifted lattice by elements not required to share
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 1; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                        for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                            _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it)] = L.m_sites[Parallel::Index::getIndex(ix,iy-1,iz,it)];
-                        }
-                    }
-                }
-            }
-            // Ensures all results have been sent and received
-            MPI_Wait(&sendReq,MPI_STATUS_IGNORE);
-            MPI_Wait(&recvReq,MPI_STATUS_IGNORE);
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                        _L.m_sites[Parallel::Index::getIndex(ix,0,iz,it)] = recvCube[Parallel::Index::cubeIndex(ix,iz,it,L.m_dim[0],L.m_dim[2])];
-                    }
-                }
-            }
-            return _L;
-        }
-        case 2: {
-            sendCube.resize(L.m_dim[0]*L.m_dim[1]*L.m_dim[3]);
-            recvCube.resize(L.m_dim[0]*L.m_dim[1]*L.m_dim[3]);
-            // Populates package to send
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                        sendCube[Parallel::Index::cubeIndex(ix,iy,it,L.m_dim[0],L.m_dim[1])] = L.m_sites[Parallel::Index::getIndex(ix,iy,L.m_dim[2]-1,it)];
-                    }
-                }
-            }
-            MPI_Isend(&sendCube.front(),18*(L.m_dim[0]*L.m_dim[1]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(5),0,Parallel::ParallelParameters::ACTIVE_COMM,&sendReq);
-            MPI_Irecv(&recvCube.front(),18*(L.m_dim[0]*L.m_dim[1]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(4),0,Parallel::ParallelParameters::ACTIVE_COMM,&recvReq);
-            // Populates shifted lattice by elements not required to share
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 1; iz < L.m_dim[2]; iz++) {
-                        for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                            _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it)] = L.m_sites[Parallel::Index::getIndex(ix,iy,iz-1,it)];
-                        }
-                    }
-                }
-            }
-            // Ensures all results have been sent and received
-            MPI_Wait(&recvReq,MPI_STATUS_IGNORE);
-            MPI_Wait(&sendReq,MPI_STATUS_IGNORE);
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                        _L.m_sites[Parallel::Index::getIndex(ix,iy,0,it)] = recvCube[Parallel::Index::cubeIndex(ix,iy,it,L.m_dim[0],L.m_dim[1])];
-                    }
-                }
-            }
-            return _L;
-        }
-        case 3: {
-            sendCube.resize(L.m_dim[0]*L.m_dim[1]*L.m_dim[2]);
-            recvCube.resize(L.m_dim[0]*L.m_dim[1]*L.m_dim[2]);
-            // Populates package to send
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                        sendCube[Parallel::Index::cubeIndex(ix,iy,iz,L.m_dim[0],L.m_dim[1])] = L.m_sites[Parallel::Index::getIndex(ix,iy,iz,L.m_dim[3]-1)];
-                    }
-                }
-            }
-            MPI_Isend(&sendCube.front(),18*(L.m_dim[0]*L.m_dim[1]*L.m_dim[2]),MPI_DOUBLE,Parallel::Neighbours::get(7),0,Parallel::ParallelParameters::ACTIVE_COMM,&sendReq);
-            MPI_Irecv(&recvCube.front(),18*(L.m_dim[0]*L.m_dim[1]*L.m_dim[2]),MPI_DOUBLE,Parallel::Neighbours::get(6),0,Parallel::ParallelParameters::ACTIVE_COMM,&recvReq);
-            // Populates shifted lattice by elements not required to share
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                        for (unsigned int it = 1; it < L.m_dim[3]; it++) {
-                            _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it)] = L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it-1)];
-                        }
-                    }
-                }
-            }
-            // Ensures all results have been sent and received
-            MPI_Wait(&recvReq,MPI_STATUS_IGNORE);
-            MPI_Wait(&sendReq,MPI_STATUS_IGNORE);
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                       _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,0)] = recvCube[Parallel::Index::cubeIndex(ix,iy,iz,L.m_dim[0],L.m_dim[1])];
-                    }
-                }
-            }
-            return _L;
-        }
-        }
-        break;
-    }
-    case FORWARDS: {
-        switch(lorentzVector) {
-        case 0: { // x direction
-            sendCube.resize(L.m_dim[1]*L.m_dim[2]*L.m_dim[3]);
-            recvCube.resize(L.m_dim[1]*L.m_dim[2]*L.m_dim[3]);
-            // Populates package to send
-            for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                        sendCube[Parallel::Index::cubeIndex(iy,iz,it,L.m_dim[1],L.m_dim[2])] = L.m_sites[Parallel::Index::getIndex(0,iy,iz,it)];
-                    }
-                }
-            }
-            // Sends and receives packages
-            MPI_Isend(&sendCube.front(),18*(L.m_dim[1]*L.m_dim[2]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(0),0,Parallel::ParallelParameters::ACTIVE_COMM,&sendReq);
-            MPI_Irecv(&recvCube.front(),18*(L.m_dim[1]*L.m_dim[2]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(1),0,Parallel::ParallelParameters::ACTIVE_COMM,&recvReq);
-            // Populates shifted lattice by elements not required to share
-            for (unsigned int ix = 0; ix < L.m_dim[0] - 1; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                        for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                           _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it)] = L.m_sites[Parallel::Index::getIndex(ix+1,iy,iz,it)];
-                        }
-                    }
-                }
-            }
-            // Ensures all results have been sent and received, then populates face cube with remaining results.
-            MPI_Wait(&sendReq,MPI_STATUS_IGNORE);
-            MPI_Wait(&recvReq,MPI_STATUS_IGNORE);
-            for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                       _L.m_sites[Parallel::Index::getIndex(L.m_dim[0]-1,iy,iz,it)] = recvCube[Parallel::Index::cubeIndex(iy,iz,it,L.m_dim[1],L.m_dim[2])];
-                    }
-                }
-            }
-            return _L;
-        }
-        case 1: { // y direction
-            sendCube.resize(L.m_dim[0]*L.m_dim[2]*L.m_dim[3]);
-            recvCube.resize(L.m_dim[0]*L.m_dim[2]*L.m_dim[3]);
-            // Populates package to send
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                        sendCube[Parallel::Index::cubeIndex(ix,iz,it,L.m_dim[0],L.m_dim[2])] = L.m_sites[Parallel::Index::getIndex(ix,0,iz,it)];
-                    }
-                }
-            }
-            MPI_Isend(&sendCube.front(),18*(L.m_dim[0]*L.m_dim[2]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(2),0,Parallel::ParallelParameters::ACTIVE_COMM,&sendReq);
-            MPI_Irecv(&recvCube.front(),18*(L.m_dim[0]*L.m_dim[2]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(3),0,Parallel::ParallelParameters::ACTIVE_COMM,&recvReq);
-            // Populates shifted lattice by elements not required to share
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1] - 1; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                        for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                           _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it)] = L.m_sites[Parallel::Index::getIndex(ix,iy+1,iz,it)];
-                        }
-                    }
-                }
-            }
-            // Ensures all results have been sent and received
-            MPI_Wait(&sendReq,MPI_STATUS_IGNORE);
-            MPI_Wait(&recvReq,MPI_STATUS_IGNORE);
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                       _L.m_sites[Parallel::Index::getIndex(ix,L.m_dim[1]-1,iz,it)] = recvCube[Parallel::Index::cubeIndex(ix,iz,it,L.m_dim[0],L.m_dim[2])];
-                    }
-                }
-            }
-            return _L;
-        }
-        case 2: { // z direction
-            sendCube.resize(L.m_dim[0]*L.m_dim[1]*L.m_dim[3]);
-            recvCube.resize(L.m_dim[0]*L.m_dim[1]*L.m_dim[3]);
-            // Populates package to send
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                        sendCube[Parallel::Index::cubeIndex(ix,iy,it,L.m_dim[0],L.m_dim[1])] = L.m_sites[Parallel::Index::getIndex(ix,iy,0,it)];
-                    }
-                }
-            }
-            MPI_Isend(&sendCube.front(),18*(L.m_dim[0]*L.m_dim[1]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(4),0,Parallel::ParallelParameters::ACTIVE_COMM,&sendReq);
-            MPI_Irecv(&recvCube.front(),18*(L.m_dim[0]*L.m_dim[1]*L.m_dim[3]),MPI_DOUBLE,Parallel::Neighbours::get(5),0,Parallel::ParallelParameters::ACTIVE_COMM,&recvReq);
-            // Populates shifted lattice by elements not required to share
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2] - 1; iz++) {
-                        for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                            _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it)] = L.m_sites[Parallel::Index::getIndex(ix,iy,iz+1,it)];
-                        }
-                    }
-                }
-            }
-            // Ensures all results have been sent and received
-            MPI_Wait(&recvReq,MPI_STATUS_IGNORE);
-            MPI_Wait(&sendReq,MPI_STATUS_IGNORE);
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int it = 0; it < L.m_dim[3]; it++) {
-                        _L.m_sites[Parallel::Index::getIndex(ix,iy,L.m_dim[2]-1,it)] = recvCube[Parallel::Index::cubeIndex(ix,iy,it,L.m_dim[0],L.m_dim[1])];
-                    }
-                }
-            }
-            return _L;
-        }
-        case 3: { // t direction
-            sendCube.resize(L.m_dim[0]*L.m_dim[1]*L.m_dim[2]);
-            recvCube.resize(L.m_dim[0]*L.m_dim[1]*L.m_dim[2]);
-            // Populates package to send
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                        sendCube[Parallel::Index::cubeIndex(ix,iy,iz,L.m_dim[0],L.m_dim[1])] = L.m_sites[Parallel::Index::getIndex(ix,iy,iz,0)];
-                    }
-                }
-            }
-            MPI_Isend(&sendCube.front(),18*(L.m_dim[0]*L.m_dim[1]*L.m_dim[2]),MPI_DOUBLE,Parallel::Neighbours::get(6),0,Parallel::ParallelParameters::ACTIVE_COMM,&sendReq);
-            MPI_Irecv(&recvCube.front(),18*(L.m_dim[0]*L.m_dim[1]*L.m_dim[2]),MPI_DOUBLE,Parallel::Neighbours::get(7),0,Parallel::ParallelParameters::ACTIVE_COMM,&recvReq);
-            // Populates shifted lattice by elements not required to share
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                        for (unsigned int it = 0; it < L.m_dim[3] - 1; it++) {
-                            _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it)] = L.m_sites[Parallel::Index::getIndex(ix,iy,iz,it+1)];
-                        }
-                    }
-                }
-            }
-            // Ensures all results have been sent and received
-            MPI_Wait(&recvReq,MPI_STATUS_IGNORE);
-            MPI_Wait(&sendReq,MPI_STATUS_IGNORE);
-            for (unsigned int ix = 0; ix < L.m_dim[0]; ix++) {
-                for (unsigned int iy = 0; iy < L.m_dim[1]; iy++) {
-                    for (unsigned int iz = 0; iz < L.m_dim[2]; iz++) {
-                        _L.m_sites[Parallel::Index::getIndex(ix,iy,iz,L.m_dim[3]-1)] = recvCube[Parallel::Index::cubeIndex(ix,iy,iz,L.m_dim[0],L.m_dim[1])];
-                    }
-                }
-            }
-            return _L;
-        }
-        }
-        break;
-    }
-    }
-    return _L;
+    return shift(static_cast<const Lattice<SU3> &>(L), direction, lorentzVector);
 }
 
 #endif // LATTICE_H
@@ -71,7 +71,7 @@ public:
     SU3 makeAntiHermitian();
 
     // Returns the inverse of the matrix(the conjugate transpose)
-    SU3 inv();
+    SU3 inv() const;
 
     // Sets the matrix to zero
     void zeros();
@@ -304,7 +304,7 @@ inline SU3 &SU3::operator =(const double& other)
  * \brief SU3::inv performs a matrix inversion.
  * \return a copy of the inverse of itself.
  */
-inline SU3 SU3::inv()
+inline SU3 SU3::inv() const
 {
     /*
      * Takes the inverse of the matrix(which is transpose and conjugate).
@@ -2,6 +2,7 @@
 #include <random>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
 #include "math/functions.h"
 #include "complex.h"
 #include "config/parameters.h"
@@ -37,3 +38,24 @@ SU3MatrixGenerator::SU3MatrixGenerator()
 SU3MatrixGenerator::~SU3MatrixGenerator()
 {
 }
+
+/*!
+ * \brief SU3MatrixGenerator::getState
+ * \return the state of the random number generator as a string.
+ */
+std::string SU3MatrixGenerator::getState()
+{
+    std::ostringstream state;
+    state << m_generator;
+    return state.str();
+}
+
+/*!
+ * \brief SU3MatrixGenerator::setState restores the random number generator.
+ * \param state a string as given by SU3MatrixGenerator::getState().
+ */
+void SU3MatrixGenerator::setState(const std::string &state)
+{
+    std::istringstream stateStream(state);
+    stateStream >> m_generator;
+}
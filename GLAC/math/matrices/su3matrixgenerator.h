@@ -14,6 +14,7 @@
 #define SU3MATRIXGENERATOR_H
 
 #include <random>
+#include <string>
 #include "su3.h"
 #include "su2.h"
 
@@ -67,6 +68,10 @@ public:
     SU3 generateRST();
     SU2 generateSU2();
 
+    // RNG state, used for checkpointing
+    std::string getState();
+    void setState(const std::string &state);
+
 //    /*!
 //     * \brief testRSTMultiplication wrapper for testing the RSTMatrixMultiplication method.
 //     *
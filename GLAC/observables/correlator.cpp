@@ -74,17 +74,71 @@ void Correlator::printObservable(const unsigned int iObs)
 /*!
  * \brief Correlator::runStatistics
  *
- * Gathers results and performs statistics in the ObservableStorer object.
+ * Gathers results, unless they were copied from the already gathered flow observables, and performs statistics in the ObservableStorer object.
  */
 void Correlator::runStatistics()
 {
     /*
      * Used before writeObservableToFile()
      */
-    m_observable->gatherResults();
+    // When flowing, the observables are copied from the flow observables, which are already gathered
+    if (Parameters::getNFlows() == 0) {
+        m_observable->gatherResults();
+    }
     m_observable->runStatistics();
 }
 
+/*!
+ * \brief Correlator::accumulateStatistics adds an observable to the statistics accumulated during the run.
+ * \param iObs observable number.
+ *
+ * Reduces the observables over all processors in a single reduction, and must thus be called by all of them. Samplers of several
+ * observables override it to pass all their scalar observables at once.
+ */
+void Correlator::accumulateStatistics(const unsigned int iObs)
+{
+    m_observable->accumulate(iObs);
+}
+
+/*!
+ * \brief Correlator::getIntegratedAutocorrelationTime
+ * \return the integrated autocorrelation time of the observables accumulated since the last reset, in units of configurations.
+ */
+double Correlator::getIntegratedAutocorrelationTime()
+{
+    return m_observable->getAutocorrelation().getIntegratedAutocorrelationTime();
+}
+
+/*!
+ * \brief Correlator::getObservableStorers
+ * \return the storers of all observables sampled by the correlator.
+ */
+std::vector<ObservableStorer *> Correlator::getObservableStorers()
+{
+    return {m_observable};
+}
+
+/*!
+ * \brief Correlator::getObservableStorer
+ * \param observableName name of the observable, e.g. plaq or topc.
+ * \return the storer of the observable, or a nullptr if the correlator does not sample it.
+ */
+ObservableStorer * Correlator::getObservableStorer(const std::string &observableName)
+{
+    for (auto observable : getObservableStorers()) {
+        if (observable->getObservableName() == observableName) return observable;
+    }
+    return nullptr;
+}
+
+/*!
+ * \brief Correlator::resetAutocorrelation restarts the autocorrelation estimate, e.g. after the number of updates between configurations has changed.
+ */
+void Correlator::resetAutocorrelation()
+{
+    m_observable->resetAutocorrelation();
+}
+
 /*!
  * \brief Correlator::writeFlowObservablesToFile
  * \param iFlow
@@ -163,6 +217,16 @@ std::vector<double> Correlator::getObservablesVector(const unsigned int iObs)
     return obs;
 }
 
+/*!
+ * \brief Correlator::printRunningStatistics prints the mean and binned error of the observables accumulated during the run so far.
+ */
+void Correlator::printRunningStatistics()
+{
+    for (auto observable : getObservableStorers()) {
+        observable->printRunningStatistics();
+    }
+}
+
 /*!
  * \brief Correlator::printStatistics prints statistics from ObservableStorer.
  */
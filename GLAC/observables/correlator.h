@@ -48,10 +48,16 @@ public:
     virtual void writeFlowObservablesToFile(const unsigned int iFlow);
     virtual void runStatistics();
 
+    // Statistics during the run
+    virtual void accumulateStatistics(const unsigned int iObs);
+    virtual double getIntegratedAutocorrelationTime();
+    virtual void resetAutocorrelation();
+
     // Printers
     virtual void printObservable(const unsigned int iObs);
     virtual void printHeader();
     virtual void printStatistics();
+    void printRunningStatistics();
 
     // Observable copyer
     virtual void copyObservable(const unsigned int iObs, const std::vector<double> &obs);
@@ -59,6 +65,8 @@ public:
 
     // Getters
     virtual double getObservable(const unsigned int iObs);
+    virtual std::vector<ObservableStorer *> getObservableStorers();
+    ObservableStorer * getObservableStorer(const std::string &observableName);
     virtual std::string getObservableName() { return m_observableName; }
     virtual int getHeaderWidth() { return m_headerWidth; }
 
@@ -1,4 +1,5 @@
 #include "energydensity.h"
+#include "instrumentation/timers.h"
 
 EnergyDensity::EnergyDensity(const bool storeFlowObservable) : Correlator(storeFlowObservable)
 {
@@ -23,6 +24,7 @@ EnergyDensity::~EnergyDensity()
 
 void EnergyDensity::calculate(Lattice<SU3> *lattice, const unsigned int iObs)
 {
+    GLAC_TIMER(OBSERVABLE_ENERGY_DENSITY);
     m_energyDensity = 0;
     mu = 0;
 
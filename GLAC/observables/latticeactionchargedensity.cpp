@@ -1,8 +1,11 @@
 #include "latticeactionchargedensity.h"
 #include <cmath>
+#include <algorithm>
 #include "parallelization/communicator.h"
+#include "parallelization/reductionbuffer.h"
 #include "config/parameters.h"
 #include "io/fieldio.h"
+#include "instrumentation/timers.h"
 
 LatticeActionChargeDensity::LatticeActionChargeDensity(const bool flow) : Correlator()
 {
@@ -28,6 +31,7 @@ LatticeActionChargeDensity::LatticeActionChargeDensity(const bool flow) : Correl
 
     // Initialize the sampling frequency
     m_samplingFrequency = Parameters::getSamplingFrequency();
+    m_compressFieldDensities = Parameters::getCompressFieldDensities();
 }
 
 LatticeActionChargeDensity::~LatticeActionChargeDensity()
@@ -63,16 +67,30 @@ void LatticeActionChargeDensity::initializeObservableStorer(const bool storeFlow
     m_energyObservable->setObservableName("energy");
 }
 
+/*!
+ * \brief LatticeActionChargeDensity::writeDensityField writes a density field to file, compressed if specified in the parameters.
+ * \param field the density field.
+ * \param iObs flow step or configuration number of the field.
+ * \param observable name of the observable.
+ */
+void LatticeActionChargeDensity::writeDensityField(const Lattice<double> &field, const unsigned int iObs, const std::string &observable)
+{
+    if (m_compressFieldDensities) {
+        IO::FieldIO::writeCompressedDoublesFieldToFile(field, iObs, observable);
+    } else {
+        IO::FieldIO::writeDoublesFieldToFile(field, iObs, observable);
+    }
+}
+
 void LatticeActionChargeDensity::writeFlowObservablesToFile(const unsigned int iFlow)
 {
-    // Gathers and writes plaquette results to file
-    m_plaqObservable->gatherResults();
+    // Gathers all results in a single reduction
+    ObservableStorer::gatherResults({m_plaqObservable, m_topcObservable, m_energyObservable});
+    // Writes plaquette results to file
     m_plaqObservable->writeFlowObservableToFile(iFlow);
-    // Gathers and writes topological charge results to file
-    m_topcObservable->gatherResults();
+    // Writes topological charge results to file
     m_topcObservable->writeFlowObservableToFile(iFlow);
-    // Gathers and writes energy results to file
-    m_energyObservable->gatherResults();
+    // Writes energy results to file
     m_energyObservable->writeFlowObservableToFile(iFlow);
 }
 
@@ -96,11 +114,42 @@ void LatticeActionChargeDensity::reset()
 
 void LatticeActionChargeDensity::runStatistics()
 {
+    // When flowing, the observables are copied from the flow observables, which are already gathered
+    if (Parameters::getNFlows() == 0) {
+        ObservableStorer::gatherResults({m_plaqObservable, m_topcObservable, m_energyObservable});
+    }
+
     m_plaqObservable->runStatistics();
     m_topcObservable->runStatistics();
     m_energyObservable->runStatistics();
 }
 
+void LatticeActionChargeDensity::accumulateStatistics(const unsigned int iObs)
+{
+    ObservableStorer::accumulate({m_plaqObservable, m_topcObservable, m_energyObservable}, iObs);
+}
+
+double LatticeActionChargeDensity::getIntegratedAutocorrelationTime()
+{
+    /*
+     * The slowest of the plaquette and the topological charge decides the decorrelation
+     */
+    return std::max(m_plaqObservable->getAutocorrelation().getIntegratedAutocorrelationTime(),
+                    m_topcObservable->getAutocorrelation().getIntegratedAutocorrelationTime());
+}
+
+void LatticeActionChargeDensity::resetAutocorrelation()
+{
+    m_plaqObservable->resetAutocorrelation();
+    m_topcObservable->resetAutocorrelation();
+    m_energyObservable->resetAutocorrelation();
+}
+
+std::vector<ObservableStorer *> LatticeActionChargeDensity::getObservableStorers()
+{
+    return {m_plaqObservable, m_topcObservable, m_energyObservable};
+}
+
 void LatticeActionChargeDensity::printHeader()
 {
     if (!m_storeFlowObservable) {
@@ -129,9 +178,11 @@ void LatticeActionChargeDensity::printObservable(const unsigned int iObs)
         double plaqObs = m_plaqObservable->getObservable(iObs); // TEMP TEMP TEMP!
         double topcObs = m_topcObservable->getObservable(iObs);
         double energyObs = m_energyObservable->getObservable(iObs);
-        Parallel::Communicator::gatherDoubleResults(&plaqObs,1);
-        Parallel::Communicator::gatherDoubleResults(&topcObs,1);
-        Parallel::Communicator::gatherDoubleResults(&energyObs,1);
+        Parallel::ReductionBuffer reduction;
+        reduction.add(&plaqObs);
+        reduction.add(&topcObs);
+        reduction.add(&energyObs);
+        reduction.reduce(0);
         if (Parallel::Communicator::getProcessRank() == 0) {
             printf("\n%-4d %-3.3f  %-*.15f %-*.15f %-*.15f",
                    iObs,
@@ -168,6 +219,7 @@ std::vector<double> LatticeActionChargeDensity::getObservablesVector(const unsig
 
 void LatticeActionChargeDensity::calculate(Lattice<SU3> *lattice, const unsigned int iObs)
 {
+    GLAC_TIMER(OBSERVABLE_LATTICE_ACTION_CHARGE_DENSITY);
     ///////////////////////////
     //// SYMMETRIC CLOVER /////
     ///////////////////////////
@@ -286,10 +338,10 @@ void LatticeActionChargeDensity::calculate(Lattice<SU3> *lattice, const unsigned
     ///////////////////////////
     m_topCharge *= m_topcMultiplicationFactor;
     if (m_storeFlowObservable && (iObs % m_samplingFrequency) == 0) {
-        IO::FieldIO::writeDoublesFieldToFile(m_topCharge, iObs, m_topcObservable->getObservableName());
+        writeDensityField(m_topCharge, iObs, m_topcObservable->getObservableName());
     }
     if (!m_storeFlowObservable) {
-        IO::FieldIO::writeDoublesFieldToFile(m_topCharge, iObs, m_topcObservable->getObservableName());
+        writeDensityField(m_topCharge, iObs, m_topcObservable->getObservableName());
     }
     (*m_topcObservable)[iObs] = sum(m_topCharge);
 
@@ -297,10 +349,10 @@ void LatticeActionChargeDensity::calculate(Lattice<SU3> *lattice, const unsigned
     ///////// ENERGY //////////
     ///////////////////////////
     if (m_storeFlowObservable && (iObs % m_samplingFrequency) == 0) {
-        IO::FieldIO::writeDoublesFieldToFile(m_energy, iObs, m_energyObservable->getObservableName());
+        writeDensityField(m_energy, iObs, m_energyObservable->getObservableName());
     }
     if (!m_storeFlowObservable) {
-        IO::FieldIO::writeDoublesFieldToFile(m_energy, iObs, m_energyObservable->getObservableName());
+        writeDensityField(m_energy, iObs, m_energyObservable->getObservableName());
     }
     (*m_energyObservable)[iObs] = m_energyMultiplicationFactor * sum(m_energy);
 }
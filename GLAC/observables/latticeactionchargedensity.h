@@ -28,6 +28,7 @@ class LatticeActionChargeDensity : public Correlator
 {
 private:
     int m_samplingFrequency = 25;
+    bool m_compressFieldDensities = false;
     int mu, rho, sigma;
     double m_plaqMultiplicationFactor, m_topcMultiplicationFactor, m_energyMultiplicationFactor;
     double m_plaquette;
@@ -38,6 +39,8 @@ private:
     ObservableStorer * m_plaqObservable = nullptr;
     ObservableStorer * m_topcObservable = nullptr;
     ObservableStorer * m_energyObservable = nullptr;
+
+    void writeDensityField(const Lattice<double> &field, const unsigned int iObs, const std::string &observable);
 public:
     LatticeActionChargeDensity(const bool flow);
     ~LatticeActionChargeDensity();
@@ -48,6 +51,10 @@ public:
     void writeFlowObservablesToFile(const unsigned int iFlow);
     void reset();
     void runStatistics();
+    void accumulateStatistics(const unsigned int iObs);
+    double getIntegratedAutocorrelationTime();
+    void resetAutocorrelation();
+    std::vector<ObservableStorer *> getObservableStorers();
     void printHeader();
     void printObservable(const unsigned int iObs);
     void printStatistics();
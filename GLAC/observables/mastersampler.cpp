@@ -1,8 +1,11 @@
 #include "mastersampler.h"
 
 #include <cmath>
+#include <algorithm>
 #include "parallelization/communicator.h"
+#include "parallelization/reductionbuffer.h"
 #include "config/parameters.h"
+#include "instrumentation/timers.h"
 
 MasterSampler::MasterSampler(const bool flow) : Correlator()
 {
@@ -57,14 +60,13 @@ void MasterSampler::initializeObservableStorer(const bool storeFlowObservable)
 
 void MasterSampler::writeFlowObservablesToFile(const unsigned int iFlow)
 {
-    // Gathers and writes plaquette results to file
-    m_plaqObservable->gatherResults();
+    // Gathers all results in a single reduction
+    ObservableStorer::gatherResults({m_plaqObservable, m_topcObservable, m_energyObservable});
+    // Writes plaquette results to file
     m_plaqObservable->writeFlowObservableToFile(iFlow);
-    // Gathers and writes topological charge results to file
-    m_topcObservable->gatherResults();
+    // Writes topological charge results to file
     m_topcObservable->writeFlowObservableToFile(iFlow);
-    // Gathers and writes energy results to file
-    m_energyObservable->gatherResults();
+    // Writes energy results to file
     m_energyObservable->writeFlowObservableToFile(iFlow);
 }
 
@@ -88,11 +90,42 @@ void MasterSampler::reset()
 
 void MasterSampler::runStatistics()
 {
+    // When flowing, the observables are copied from the flow observables, which are already gathered
+    if (Parameters::getNFlows() == 0) {
+        ObservableStorer::gatherResults({m_plaqObservable, m_topcObservable, m_energyObservable});
+    }
+
     m_plaqObservable->runStatistics();
     m_topcObservable->runStatistics();
     m_energyObservable->runStatistics();
 }
 
+void MasterSampler::accumulateStatistics(const unsigned int iObs)
+{
+    ObservableStorer::accumulate({m_plaqObservable, m_topcObservable, m_energyObservable}, iObs);
+}
+
+double MasterSampler::getIntegratedAutocorrelationTime()
+{
+    /*
+     * The slowest of the plaquette and the topological charge decides the decorrelation
+     */
+    return std::max(m_plaqObservable->getAutocorrelation().getIntegratedAutocorrelationTime(),
+                    m_topcObservable->getAutocorrelation().getIntegratedAutocorrelationTime());
+}
+
+void MasterSampler::resetAutocorrelation()
+{
+    m_plaqObservable->resetAutocorrelation();
+    m_topcObservable->resetAutocorrelation();
+    m_energyObservable->resetAutocorrelation();
+}
+
+std::vector<ObservableStorer *> MasterSampler::getObservableStorers()
+{
+    return {m_plaqObservable, m_topcObservable, m_energyObservable};
+}
+
 void MasterSampler::printHeader()
 {
     if (!m_storeFlowObservable) {
@@ -121,9 +154,11 @@ void MasterSampler::printObservable(const unsigned int iObs)
         double plaqObs = m_plaqObservable->getObservable(iObs); // TEMP TEMP TEMP!
         double topcObs = m_topcObservable->getObservable(iObs);
         double energyObs = m_energyObservable->getObservable(iObs);
-        Parallel::Communicator::gatherDoubleResults(&plaqObs,1);
-        Parallel::Communicator::gatherDoubleResults(&topcObs,1);
-        Parallel::Communicator::gatherDoubleResults(&energyObs,1);
+        Parallel::ReductionBuffer reduction;
+        reduction.add(&plaqObs);
+        reduction.add(&topcObs);
+        reduction.add(&energyObs);
+        reduction.reduce(0);
         if (Parallel::Communicator::getProcessRank() == 0) {
             printf("\n%-4d %-3.3f  %-*.15f %-*.15f %-*.15f",
                    iObs,
@@ -158,8 +193,36 @@ std::vector<double> MasterSampler::getObservablesVector(const unsigned int iObs)
     return obs;
 }
 
+void MasterSampler::calculatePlaquette(Lattice<SU3> *lattice, const unsigned int iObs)
+{
+    /*
+     * Plaquette only, for flow times where neither the topological charge nor the energy is scheduled.
+     */
+    m_plaquette = 0;
+    for (int iMu = 0; iMu < 4; iMu++) {
+        for (int iNu = iMu + 1; iNu < 4; iNu++) {
+            m_temp = lattice[iMu];
+            m_temp *= shift(lattice[iNu],FORWARDS,iMu);
+            m_temp *= inv(shift(lattice[iMu],FORWARDS,iNu));
+            m_temp *= inv(lattice[iNu]);
+            m_plaquette += sumRealTrace(m_temp);
+        }
+    }
+    m_plaquette *= m_plaqMultiplicationFactor;
+    (*m_plaqObservable)[iObs] = m_plaquette;
+}
+
 void MasterSampler::calculate(Lattice<SU3> *lattice, const unsigned int iObs)
 {
+    GLAC_TIMER(OBSERVABLE_MASTER_SAMPLER);
+
+    // The clovers are only needed for the topological charge and energy
+    if (!m_topcObservable->isScheduled() && !m_energyObservable->isScheduled()) {
+        if (m_plaqObservable->isScheduled()) {
+            calculatePlaquette(lattice, iObs);
+        }
+        return;
+    }
     ///////////////////////////
     //// SYMMETRIC CLOVER /////
     ///////////////////////////
@@ -46,6 +46,8 @@ private:
     ObservableStorer * m_plaqObservable = nullptr;
     ObservableStorer * m_topcObservable = nullptr;
     ObservableStorer * m_energyObservable = nullptr;
+
+    void calculatePlaquette(Lattice<SU3> * lattice, const unsigned int iObs);
 public:
     MasterSampler(const bool flow);
     ~MasterSampler();
@@ -56,6 +58,10 @@ public:
     void writeFlowObservablesToFile(const unsigned int iFlow);
     void reset();
     void runStatistics();
+    void accumulateStatistics(const unsigned int iObs);
+    double getIntegratedAutocorrelationTime();
+    void resetAutocorrelation();
+    std::vector<ObservableStorer *> getObservableStorers();
     void printHeader();
     void printObservable(const unsigned int iObs);
     void printStatistics();
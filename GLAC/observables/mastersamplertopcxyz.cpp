@@ -1,9 +1,12 @@
 #include "mastersamplertopcxyz.h"
 
 #include <cmath>
+#include <algorithm>
 #include "parallelization/communicator.h"
+#include "parallelization/reductionbuffer.h"
 #include "config/parameters.h"
 #include "io/observablesio.h"
+#include "instrumentation/timers.h"
 
 MasterSamplerTopcXYZ::MasterSamplerTopcXYZ(const bool flow) : Correlator()
 {
@@ -74,16 +77,16 @@ void MasterSamplerTopcXYZ::initializeObservableStorer(const bool storeFlowObserv
 
 void MasterSamplerTopcXYZ::writeFlowObservablesToFile(const unsigned int configNumber)
 {
-    // Gathers and writes plaquette results to file
-    m_plaqObservable->gatherResults();
+    // Gathers the scalar results in a single reduction
+    ObservableStorer::gatherResults({m_plaqObservable, m_topcObservable, m_energyObservable});
+
+    // Writes plaquette results to file
     m_plaqObservable->writeFlowObservableToFile(configNumber);
 
-    // Gathers and writes topological charge results to file
-    m_topcObservable->gatherResults();
+    // Writes topological charge results to file
     m_topcObservable->writeFlowObservableToFile(configNumber);
 
-    // Gathers and writes energy results to file
-    m_energyObservable->gatherResults();
+    // Writes energy results to file
     m_energyObservable->writeFlowObservableToFile(configNumber);
 
     // Flattens topct to t direction and gathers topct results into a single array
@@ -127,16 +130,42 @@ void MasterSamplerTopcXYZ::reset()
 
 void MasterSamplerTopcXYZ::runStatistics()
 {
-    m_plaqObservable->gatherResults();
-    m_plaqObservable->runStatistics();
+    // When flowing, the observables are copied from the flow observables, which are already gathered
+    if (Parameters::getNFlows() == 0) {
+        ObservableStorer::gatherResults({m_plaqObservable, m_topcObservable, m_energyObservable});
+    }
 
-    m_topcObservable->gatherResults();
+    m_plaqObservable->runStatistics();
     m_topcObservable->runStatistics();
-
-    m_energyObservable->gatherResults();
     m_energyObservable->runStatistics();
 }
 
+void MasterSamplerTopcXYZ::accumulateStatistics(const unsigned int iObs)
+{
+    ObservableStorer::accumulate({m_plaqObservable, m_topcObservable, m_energyObservable}, iObs);
+}
+
+double MasterSamplerTopcXYZ::getIntegratedAutocorrelationTime()
+{
+    /*
+     * The slowest of the plaquette and the topological charge decides the decorrelation
+     */
+    return std::max(m_plaqObservable->getAutocorrelation().getIntegratedAutocorrelationTime(),
+                    m_topcObservable->getAutocorrelation().getIntegratedAutocorrelationTime());
+}
+
+void MasterSamplerTopcXYZ::resetAutocorrelation()
+{
+    m_plaqObservable->resetAutocorrelation();
+    m_topcObservable->resetAutocorrelation();
+    m_energyObservable->resetAutocorrelation();
+}
+
+std::vector<ObservableStorer *> MasterSamplerTopcXYZ::getObservableStorers()
+{
+    return {m_plaqObservable, m_topcObservable, m_energyObservable, m_topctObservable};
+}
+
 void MasterSamplerTopcXYZ::printHeader()
 {
     if (!m_storeFlowObservable) {
@@ -165,10 +194,12 @@ void MasterSamplerTopcXYZ::printObservable(const unsigned int iObs)
         double topcObs = 0;
         topcObs = m_topcObservable->getObservable(iObs);
 
+        Parallel::ReductionBuffer reduction;
         if (Parameters::getNFlows() != 0) {
-            Parallel::Communicator::gatherDoubleResults(&topcObs,1);
+            reduction.add(&topcObs);
         }
-        Parallel::Communicator::gatherDoubleResults(&topctObs,1);
+        reduction.add(&topctObs);
+        reduction.reduce(0);
 
         if (Parallel::Communicator::getProcessRank() == 0) {
             printf("%-*.8f %-*.8f %-*.8f %-*.8f",
@@ -186,10 +217,12 @@ void MasterSamplerTopcXYZ::printObservable(const unsigned int iObs)
             topctObs += (*m_topctObservable)[iObs*m_N[3] + it];
         }
 
-        Parallel::Communicator::gatherDoubleResults(&plaqObs,1);
-        Parallel::Communicator::gatherDoubleResults(&topcObs,1);
-        Parallel::Communicator::gatherDoubleResults(&energyObs,1);
-        Parallel::Communicator::gatherDoubleResults(&topctObs,1);
+        Parallel::ReductionBuffer reduction;
+        reduction.add(&plaqObs);
+        reduction.add(&topcObs);
+        reduction.add(&energyObs);
+        reduction.add(&topctObs);
+        reduction.reduce(0);
 
         if (Parallel::Communicator::getProcessRank() == 0) {
             printf("\n%-4d %-3.3f  %-*.15f %-*.15f %-*.15f %-*.15f",
@@ -235,6 +268,7 @@ std::vector<double> MasterSamplerTopcXYZ::getObservablesVector(const unsigned in
 
 void MasterSamplerTopcXYZ::calculate(Lattice<SU3> *lattice, const unsigned int iObs)
 {
+    GLAC_TIMER(OBSERVABLE_MASTER_SAMPLER_TOPC_XYZ);
     ///////////////////////////
     //// SYMMETRIC CLOVER /////
     ///////////////////////////
@@ -61,6 +61,10 @@ public:
     void writeFlowObservablesToFile(const unsigned int configNumber);
     void reset();
     void runStatistics();
+    void accumulateStatistics(const unsigned int iObs);
+    double getIntegratedAutocorrelationTime();
+    void resetAutocorrelation();
+    std::vector<ObservableStorer *> getObservableStorers();
     void printHeader();
     void printObservable(const unsigned int iObs);
     void printStatistics();
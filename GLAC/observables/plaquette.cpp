@@ -2,6 +2,7 @@
 #include "math/functions.h"
 #include "parallelization/parallel.h"
 #include "config/parameters.h"
+#include "instrumentation/timers.h"
 #include <vector>
 #include <cmath>
 
@@ -25,6 +26,7 @@ void Plaquette::setLatticeSize(const unsigned long latticeSize)
 
 void Plaquette::calculate(Lattice<SU3> *lattice, const unsigned int iObs)
 {
+    GLAC_TIMER(OBSERVABLE_PLAQUETTE);
     m_tempObservable = 0;
     for (unsigned int mu = 0; mu < 4; mu++) {
         for (unsigned int nu = mu+1; nu < 4; nu++) {
@@ -39,6 +41,31 @@ void Plaquette::calculate(Lattice<SU3> *lattice, const unsigned int iObs)
     (*m_observable)[iObs] = m_tempObservable;
 }
 
+/*!
+ * \brief Plaquette::computePlaquette computes the plaquette of the full lattice, without storing it.
+ * \param lattice is a pointer of four lattice objects, one for each Lorentz index.
+ * \return the plaquette summed over all active processors, normalized such that a unit configuration gives 1.
+ *
+ * Must be called by all active processors.
+ */
+double Plaquette::computePlaquette(Lattice<SU3> *lattice)
+{
+    GLAC_TIMER(OBSERVABLE_PLAQUETTE);
+    double plaquette = 0;
+    Lattice<SU3> temp(lattice[0].m_dim);
+    for (unsigned int mu = 0; mu < 4; mu++) {
+        for (unsigned int nu = mu+1; nu < 4; nu++) {
+            temp = lattice[mu];
+            temp *= shift(lattice[nu],FORWARDS,mu);
+            temp *= inv(shift(lattice[mu],FORWARDS,nu));
+            temp *= inv(lattice[nu]);
+            plaquette += sumRealTrace(temp);
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &plaquette, 1, MPI_DOUBLE, MPI_SUM, Parallel::ParallelParameters::ACTIVE_COMM);
+    return plaquette / (18.0*double(Parameters::getLatticeSize()));
+}
+
 void Plaquette::runStatistics()
 {
     /*
@@ -37,6 +37,7 @@ public:
     Plaquette(const bool storeFlowObservable);
     ~Plaquette();
     void calculate(Lattice<SU3> *lattice, const unsigned int iObs);
+    static double computePlaquette(Lattice<SU3> *lattice);
     // Statistics getter
     void runStatistics();
     // Setters
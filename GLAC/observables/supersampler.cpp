@@ -1,8 +1,11 @@
 #include "supersampler.h"
 #include <cmath>
+#include <algorithm>
 #include "parallelization/communicator.h"
+#include "parallelization/reductionbuffer.h"
 #include "config/parameters.h"
 #include "io/observablesio.h"
+#include "instrumentation/timers.h"
 //#include <map>
 
 SuperSampler::SuperSampler(const bool flow) : Correlator()
@@ -102,20 +105,19 @@ void SuperSampler::initializeObservableStorer(const bool storeFlowObservable)
 
 void SuperSampler::writeFlowObservablesToFile(const unsigned int configNumber)
 {
-    // Gathers and writes plaquette results to file
-    m_plaqObservable->gatherResults();
+    // Gathers the scalar results in a single reduction
+    ObservableStorer::gatherResults({m_plaqObservable, m_topcObservable, m_wObservable, m_energyObservable});
+
+    // Writes plaquette results to file
     m_plaqObservable->writeFlowObservableToFile(configNumber);
 
-    // Gathers and writes topological charge results to file
-    m_topcObservable->gatherResults();
+    // Writes topological charge results to file
     m_topcObservable->writeFlowObservableToFile(configNumber);
 
-    // Gathers and writes the weinberg operator results to file
-    m_wObservable->gatherResults();
+    // Writes the weinberg operator results to file
     m_wObservable->writeFlowObservableToFile(configNumber);
 
-    // Gathers and writes energy results to file
-    m_energyObservable->gatherResults();
+    // Writes energy results to file
     m_energyObservable->writeFlowObservableToFile(configNumber);
 
     // Flattens topct to t direction and gathers topct results into a single array, and then writes to file
@@ -160,19 +162,43 @@ void SuperSampler::reset()
 
 void SuperSampler::runStatistics()
 {
-    m_plaqObservable->gatherResults();
-    m_plaqObservable->runStatistics();
+    // When flowing, the observables are copied from the flow observables, which are already gathered
+    if (Parameters::getNFlows() == 0) {
+        ObservableStorer::gatherResults({m_plaqObservable, m_topcObservable, m_wObservable, m_energyObservable});
+    }
 
-    m_topcObservable->gatherResults();
+    m_plaqObservable->runStatistics();
     m_topcObservable->runStatistics();
-
-    m_wObservable->gatherResults();
     m_wObservable->runStatistics();
-
-    m_energyObservable->gatherResults();
     m_energyObservable->runStatistics();
 }
 
+void SuperSampler::accumulateStatistics(const unsigned int iObs)
+{
+    ObservableStorer::accumulate({m_plaqObservable, m_topcObservable, m_energyObservable, m_wObservable}, iObs);
+}
+
+double SuperSampler::getIntegratedAutocorrelationTime()
+{
+    /*
+     * The slowest of the plaquette and the topological charge decides the decorrelation
+     */
+    return std::max(m_plaqObservable->getAutocorrelation().getIntegratedAutocorrelationTime(),
+                    m_topcObservable->getAutocorrelation().getIntegratedAutocorrelationTime());
+}
+
+void SuperSampler::resetAutocorrelation()
+{
+    m_plaqObservable->resetAutocorrelation();
+    m_topcObservable->resetAutocorrelation();
+    m_energyObservable->resetAutocorrelation();
+}
+
+std::vector<ObservableStorer *> SuperSampler::getObservableStorers()
+{
+    return {m_plaqObservable, m_topcObservable, m_energyObservable, m_topctObservable, m_wObservable, m_wtObservable};
+}
+
 void SuperSampler::printHeader()
 {
     if (!m_storeFlowObservable) {
@@ -209,12 +235,14 @@ void SuperSampler::printObservable(const unsigned int iObs)
         topcObs = m_topcObservable->getObservable(iObs);
         wObs = m_wObservable->getObservable(iObs);
 
+        Parallel::ReductionBuffer reduction;
         if (Parameters::getNFlows() != 0) {
-            Parallel::Communicator::gatherDoubleResults(&topcObs,1);
-            Parallel::Communicator::gatherDoubleResults(&wObs,1);
+            reduction.add(&topcObs);
+            reduction.add(&wObs);
         }
-        Parallel::Communicator::gatherDoubleResults(&topctObs,1);
-        Parallel::Communicator::gatherDoubleResults(&wtObs,1);
+        reduction.add(&topctObs);
+        reduction.add(&wtObs);
+        reduction.reduce(0);
 
         if (Parallel::Communicator::getProcessRank() == 0) {
             printf("%-*.8f %-*.8f %-*.8f %-*.8f %-*.8f %-*.8f",
@@ -237,12 +265,14 @@ void SuperSampler::printObservable(const unsigned int iObs)
             wtObs += (*m_wtObservable)[iObs*m_N[3] + it];
         }
 
-        Parallel::Communicator::gatherDoubleResults(&plaqObs,1);
-        Parallel::Communicator::gatherDoubleResults(&energyObs,1);
-        Parallel::Communicator::gatherDoubleResults(&topcObs,1);
-        Parallel::Communicator::gatherDoubleResults(&topctObs,1);
-        Parallel::Communicator::gatherDoubleResults(&wObs,1);
-        Parallel::Communicator::gatherDoubleResults(&wtObs,1);
+        Parallel::ReductionBuffer reduction;
+        reduction.add(&plaqObs);
+        reduction.add(&energyObs);
+        reduction.add(&topcObs);
+        reduction.add(&topctObs);
+        reduction.add(&wObs);
+        reduction.add(&wtObs);
+        reduction.reduce(0);
 
         if (Parallel::Communicator::getProcessRank() == 0) {
             printf("\n%-4d %-3.3f  %-*.15f %-*.15f %-*.15f %-*.15f %-*.15f %-*.15f",
@@ -297,6 +327,7 @@ std::vector<double> SuperSampler::getObservablesVector(const unsigned int iObs)
 
 void SuperSampler::calculate(Lattice<SU3> *lattice, const unsigned int iObs)
 {
+    GLAC_TIMER(OBSERVABLE_SUPER_SAMPLER);
     ///////////////////////////
     //// SYMMETRIC CLOVER /////
     ///////////////////////////
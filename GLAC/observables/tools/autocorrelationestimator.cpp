@@ -0,0 +1,143 @@
+#include "autocorrelationestimator.h"
+#include <cmath>
+
+/*!
+ * \brief AutocorrelationEstimator::AutocorrelationEstimator
+ * \param maximumLag the largest lag the autocorrelation function is accumulated for, in units of the series.
+ */
+AutocorrelationEstimator::AutocorrelationEstimator(const unsigned long maximumLag) : m_maximumLag(maximumLag)
+{
+    reset();
+}
+
+/*!
+ * \brief AutocorrelationEstimator::getRecentValue
+ * \param lag number of values back from the next value, between 1 and the maximum lag.
+ * \return the shifted value lag values back.
+ */
+inline double AutocorrelationEstimator::getRecentValue(const unsigned long lag) const
+{
+    return m_recentValues[(m_count - lag) % m_maximumLag];
+}
+
+/*!
+ * \brief AutocorrelationEstimator::push adds a value to the series.
+ * \param value the new value.
+ */
+void AutocorrelationEstimator::push(const double value)
+{
+    if (m_count == 0) {
+        m_reference = value;
+    }
+    const double shiftedValue = value - m_reference;
+
+    if (m_count < m_maximumLag) {
+        m_firstValues.push_back(shiftedValue);
+    }
+
+    m_lagProducts[0] += shiftedValue * shiftedValue;
+    const unsigned long NLags = (m_count < m_maximumLag) ? m_count : m_maximumLag;
+    for (unsigned long t = 1; t <= NLags; t++) {
+        m_lagProducts[t] += shiftedValue * getRecentValue(t);
+    }
+
+    m_recentValues[m_count % m_maximumLag] = shiftedValue;
+    m_sum += shiftedValue;
+    m_count++;
+}
+
+/*!
+ * \brief AutocorrelationEstimator::reset removes all values.
+ */
+void AutocorrelationEstimator::reset()
+{
+    m_count = 0;
+    m_reference = 0;
+    m_sum = 0;
+    m_firstValues.clear();
+    m_firstValues.reserve(m_maximumLag);
+    m_recentValues.assign(m_maximumLag, 0);
+    m_lagProducts.assign(m_maximumLag + 1, 0);
+}
+
+/*!
+ * \brief AutocorrelationEstimator::getAutocorrelation
+ * \return the normalized autocorrelation function rho(t) = Gamma(t)/Gamma(0), for lags up to the maximum lag or the length of the series.
+ *
+ * Gamma(t) is estimated with the mean of the full series, see Wolff 2004 eq. (31).
+ */
+std::vector<double> AutocorrelationEstimator::getAutocorrelation() const
+{
+    std::vector<double> rho;
+    if (m_count < 2) return rho;
+
+    const double mean = m_sum / double(m_count);
+    const unsigned long NLags = (m_count - 1 < m_maximumLag) ? m_count - 1 : m_maximumLag;
+
+    // Sums of the values x_0 ... x_{n-t-1} and x_t ... x_{n-1}
+    double sumFirst = m_sum;
+    double sumLast = m_sum;
+    double gamma0 = 0;
+    for (unsigned long t = 0; t <= NLags; t++) {
+        if (t > 0) {
+            sumFirst -= getRecentValue(t);
+            sumLast -= m_firstValues[t - 1];
+        }
+        const double NPairs = double(m_count - t);
+        const double gamma = (m_lagProducts[t] - mean*(sumFirst + sumLast) + NPairs*mean*mean) / NPairs;
+
+        if (t == 0) {
+            if (gamma <= 0) return rho;
+            gamma0 = gamma;
+        }
+        rho.push_back(gamma / gamma0);
+    }
+    return rho;
+}
+
+/*!
+ * \brief AutocorrelationEstimator::getWindow
+ * \param windowFactor the factor c of the window criterion W >= c tau_int(W).
+ * \return the summation window, or the largest available lag if the criterion is not met.
+ */
+unsigned long AutocorrelationEstimator::getWindow(const double windowFactor) const
+{
+    const std::vector<double> rho = getAutocorrelation();
+    if (rho.size() < 2) return 0;
+
+    double tau = 0.5;
+    for (unsigned long W = 1; W < rho.size(); W++) {
+        tau += rho[W];
+        if (double(W) >= windowFactor * tau) return W;
+    }
+    return rho.size() - 1;
+}
+
+/*!
+ * \brief AutocorrelationEstimator::getIntegratedAutocorrelationTime
+ * \param windowFactor the factor c of the window criterion W >= c tau_int(W).
+ * \return the integrated autocorrelation time in units of the series, 0.5 for uncorrelated values.
+ */
+double AutocorrelationEstimator::getIntegratedAutocorrelationTime(const double windowFactor) const
+{
+    const std::vector<double> rho = getAutocorrelation();
+    const unsigned long W = getWindow(windowFactor);
+
+    double tau = 0.5;
+    for (unsigned long t = 1; t <= W; t++) {
+        tau += rho[t];
+    }
+    return tau;
+}
+
+/*!
+ * \brief AutocorrelationEstimator::getIntegratedAutocorrelationTimeError
+ * \param windowFactor the factor c of the window criterion W >= c tau_int(W).
+ * \return the statistical error of the integrated autocorrelation time, as given by Madras and Sokal.
+ */
+double AutocorrelationEstimator::getIntegratedAutocorrelationTimeError(const double windowFactor) const
+{
+    if (m_count == 0) return 0;
+    const double W = double(getWindow(windowFactor));
+    return getIntegratedAutocorrelationTime(windowFactor) * sqrt(2.0*(2.0*W + 1.0) / double(m_count));
+}
@@ -0,0 +1,56 @@
+/*!
+ * \class AutocorrelationEstimator
+ *
+ * \brief Estimates the integrated autocorrelation time of a series one value at a time.
+ *
+ * The autocorrelation function is accumulated for lags up to a maximum, keeping only the first and the most recent values of the series.
+ * The integrated autocorrelation time is summed up to the window given by the self-consistent criterion of Madras and Sokal 1988, as used by
+ * Wolff 2004, i.e. the smallest window W with W >= c tau_int(W).
+ *
+ * Memory and the cost of each value are proportional to the maximum lag, and independent of the length of the series.
+ *
+ * \author Mathias M. Vege
+ * \version 1.0
+ * \date 2017-2019
+ * \copyright MIT Licence
+ */
+#ifndef AUTOCORRELATIONESTIMATOR_H
+#define AUTOCORRELATIONESTIMATOR_H
+
+#include <vector>
+
+class AutocorrelationEstimator
+{
+private:
+    unsigned long m_maximumLag;
+    unsigned long m_count = 0;
+
+    // Values are shifted by the first value, such that the sums do not lose precision for observables with a large mean
+    double m_reference = 0;
+    double m_sum = 0;
+
+    // The first and the most recent values, the latter stored as a ring buffer
+    std::vector<double> m_firstValues;
+    std::vector<double> m_recentValues;
+
+    // Sum of products of values separated by each lag
+    std::vector<double> m_lagProducts;
+
+    inline double getRecentValue(const unsigned long lag) const;
+public:
+    AutocorrelationEstimator(const unsigned long maximumLag = 128);
+
+    void push(const double value);
+    void reset();
+
+    std::vector<double> getAutocorrelation() const;
+    double getIntegratedAutocorrelationTime(const double windowFactor = 6.0) const;
+    unsigned long getWindow(const double windowFactor = 6.0) const;
+    double getIntegratedAutocorrelationTimeError(const double windowFactor = 6.0) const;
+
+    // Getters
+    unsigned long getCount() const { return m_count; }
+    unsigned long getMaximumLag() const { return m_maximumLag; }
+};
+
+#endif // AUTOCORRELATIONESTIMATOR_H
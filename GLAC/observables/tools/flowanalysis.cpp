@@ -0,0 +1,336 @@
+#include "flowanalysis.h"
+#include "resampling.h"
+#include "observables/correlator.h"
+#include "parallelization/parallel.h"
+#include "config/parameters.h"
+#include "lib/json.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <mpi.h>
+
+using nlohmann::json;
+
+const std::vector<std::string> FlowAnalysis::m_estimateNames = {"t0", "w0", "chi", "sqrtT0Fm", "w0Fm", "chiQuarticRootGeV"};
+
+/*!
+ * \brief FlowAnalysis::FlowAnalysis
+ * \param flowCorrelator the correlator of the flow observables. Must hold an energy or a topc observable for the analysis to give results.
+ * \param NFlows the number of flow steps of each configuration.
+ * \param flowEpsilon the flow time step.
+ */
+FlowAnalysis::FlowAnalysis(Correlator *flowCorrelator, const unsigned int NFlows, const double flowEpsilon) :
+    m_flowCorrelator(flowCorrelator), m_NFlowTimes(NFlows + 1), m_flowEpsilon(flowEpsilon)
+{
+    m_hasEnergy = m_flowCorrelator->getObservableStorer("energy") != nullptr;
+    m_hasTopologicalCharge = m_flowCorrelator->getObservableStorer("topc") != nullptr;
+}
+
+/*!
+ * \brief FlowAnalysis::addConfiguration stores E(t) and Q(t)^2 of the configuration just flowed.
+ *
+ * Must be called after the flow observables have been gathered, i.e. after Correlator::writeFlowObservablesToFile.
+ */
+void FlowAnalysis::addConfiguration()
+{
+    if (Parallel::Communicator::getProcessRank() != 0) return;
+
+    const unsigned long offset = m_samples.size();
+    m_samples.resize(offset + 2*m_NFlowTimes, 0);
+
+    if (m_hasEnergy) {
+        // The clover energy sums tr(C_{mu nu}^2) over mu < nu, with C = 8 i F to lowest order
+        std::vector<double> energy = m_flowCorrelator->getObservableStorer("energy")->getObservableArray();
+        fillGaps(energy);
+        for (unsigned long i = 0; i < m_NFlowTimes; i++) {
+            m_samples[offset + i] = - energy[i] / 64.0;
+        }
+    }
+    if (m_hasTopologicalCharge) {
+        std::vector<double> topc = m_flowCorrelator->getObservableStorer("topc")->getObservableArray();
+        fillGaps(topc);
+        for (unsigned long i = 0; i < m_NFlowTimes; i++) {
+            m_samples[offset + m_NFlowTimes + i] = topc[i] * topc[i];
+        }
+    }
+}
+
+/*!
+ * \brief FlowAnalysis::gatherGroups gathers the samples of all flow groups on the root processor of the first group.
+ * \param configurations the configuration of each sample added by the group, in the order they were added.
+ *
+ * Only has an effect on the leaders of the groups, which must all call it. The samples are ordered by configuration, such that the blocks
+ * of the resampling are the same as if all configurations were flowed by a single group.
+ */
+void FlowAnalysis::gatherGroups(const std::vector<unsigned long> &configurations)
+{
+    if (Parallel::ParallelParameters::LEADER_COMM == MPI_COMM_NULL) return;
+
+    int leaderRank = 0;
+    int NLeaders = 0;
+    MPI_Comm_rank(Parallel::ParallelParameters::LEADER_COMM, &leaderRank);
+    MPI_Comm_size(Parallel::ParallelParameters::LEADER_COMM, &NLeaders);
+
+    const int width = int(2*m_NFlowTimes);
+    const int NConfigurations = int(configurations.size());
+    std::vector<int> NGroupConfigurations(static_cast<unsigned long>(NLeaders), 0);
+    MPI_Gather(&NConfigurations, 1, MPI_INT, NGroupConfigurations.data(), 1, MPI_INT, 0, Parallel::ParallelParameters::LEADER_COMM);
+
+    std::vector<int> configurationCounts(NGroupConfigurations.size(), 0);
+    std::vector<int> configurationOffsets(NGroupConfigurations.size(), 0);
+    std::vector<int> sampleCounts(NGroupConfigurations.size(), 0);
+    std::vector<int> sampleOffsets(NGroupConfigurations.size(), 0);
+    int NTotal = 0;
+    for (unsigned long i = 0; i < NGroupConfigurations.size(); i++) {
+        configurationCounts[i] = NGroupConfigurations[i];
+        configurationOffsets[i] = NTotal;
+        sampleCounts[i] = NGroupConfigurations[i]*width;
+        sampleOffsets[i] = NTotal*width;
+        NTotal += NGroupConfigurations[i];
+    }
+
+    std::vector<unsigned long> allConfigurations(static_cast<unsigned long>(NTotal));
+    std::vector<double> allSamples(static_cast<unsigned long>(NTotal*width));
+    {
+        Parallel::ScopedPhase reduction(Parallel::REDUCTION);
+        MPI_Gatherv(configurations.data(), NConfigurations, MPI_UNSIGNED_LONG, allConfigurations.data(), configurationCounts.data(),
+                    configurationOffsets.data(), MPI_UNSIGNED_LONG, 0, Parallel::ParallelParameters::LEADER_COMM);
+        MPI_Gatherv(m_samples.data(), NConfigurations*width, MPI_DOUBLE, allSamples.data(), sampleCounts.data(),
+                    sampleOffsets.data(), MPI_DOUBLE, 0, Parallel::ParallelParameters::LEADER_COMM);
+    }
+
+    if (leaderRank != 0) return;
+
+    m_samples.assign(allSamples.size(), 0);
+    for (unsigned long i = 0; i < allConfigurations.size(); i++) {
+        std::copy(allSamples.begin() + long(i*unsigned(width)), allSamples.begin() + long((i + 1)*unsigned(width)),
+                  m_samples.begin() + long(allConfigurations[i]*unsigned(width)));
+    }
+}
+
+/*!
+ * \brief FlowAnalysis::interpolate
+ * \param values a value at each flow time.
+ * \param flowTime the flow time to interpolate to.
+ * \param flowEpsilon the flow time step.
+ * \return the linear interpolation of the values at flowTime, NaN if outside the flow times.
+ */
+double FlowAnalysis::interpolate(const std::vector<double> &values, const double flowTime, const double flowEpsilon)
+{
+    if (std::isnan(flowTime) || flowTime < 0 || values.size() < 2) return std::numeric_limits<double>::quiet_NaN();
+
+    const unsigned long i = static_cast<unsigned long>(flowTime / flowEpsilon);
+    if (i + 1 >= values.size()) {
+        return (i + 1 == values.size() && flowTime == double(i)*flowEpsilon) ? values[i] : std::numeric_limits<double>::quiet_NaN();
+    }
+    const double fraction = flowTime / flowEpsilon - double(i);
+    return values[i] + fraction * (values[i + 1] - values[i]);
+}
+
+/*!
+ * \brief FlowAnalysis::fillGaps linearly interpolates the values at flow times that were not measured.
+ * \param values a value at each flow time, NaN where not measured.
+ *
+ * Only the gaps between two measured flow times are filled, such that flow times beyond the end of the flow are left as NaN.
+ */
+void FlowAnalysis::fillGaps(std::vector<double> &values)
+{
+    unsigned long iLast = values.size();
+    for (unsigned long i = 0; i < values.size(); i++) {
+        if (std::isnan(values[i])) continue;
+
+        if (iLast < i) {
+            for (unsigned long iSkipped = iLast + 1; iSkipped < i; iSkipped++) {
+                const double fraction = double(iSkipped - iLast) / double(i - iLast);
+                values[iSkipped] = values[iLast] + fraction*(values[i] - values[iLast]);
+            }
+        }
+        iLast = i;
+    }
+}
+
+/*!
+ * \brief FlowAnalysis::findT0
+ * \param energy the energy density at each flow time.
+ * \param flowEpsilon the flow time step.
+ * \return the first flow time where t^2 E(t) = 0.3 by linear interpolation, NaN if it is not reached.
+ */
+double FlowAnalysis::findT0(const std::vector<double> &energy, const double flowEpsilon)
+{
+    for (unsigned long i = 0; i + 1 < energy.size(); i++) {
+        const double t1 = double(i)*flowEpsilon;
+        const double t2 = double(i + 1)*flowEpsilon;
+        const double F1 = t1*t1*energy[i] - 0.3;
+        const double F2 = t2*t2*energy[i + 1] - 0.3;
+        if (F1 < 0 && F2 >= 0) {
+            return t1 - F1 * (t2 - t1) / (F2 - F1);
+        }
+    }
+    return std::numeric_limits<double>::quiet_NaN();
+}
+
+/*!
+ * \brief FlowAnalysis::findW0
+ * \param energy the energy density at each flow time.
+ * \param flowEpsilon the flow time step.
+ * \return w0, where W(t) = t d/dt (t^2 E(t)) = 0.3 at t = w0^2, with a central difference for the derivative. NaN if it is not reached.
+ */
+double FlowAnalysis::findW0(const std::vector<double> &energy, const double flowEpsilon)
+{
+    std::vector<double> W(energy.size(), 0);
+    for (unsigned long i = 1; i + 1 < energy.size(); i++) {
+        const double tPrevious = double(i - 1)*flowEpsilon;
+        const double tNext = double(i + 1)*flowEpsilon;
+        W[i] = double(i)*flowEpsilon * (tNext*tNext*energy[i + 1] - tPrevious*tPrevious*energy[i - 1]) / (2*flowEpsilon);
+    }
+
+    for (unsigned long i = 1; i + 2 < energy.size(); i++) {
+        const double W1 = W[i] - 0.3;
+        const double W2 = W[i + 1] - 0.3;
+        if (W1 < 0 && W2 >= 0) {
+            const double t = double(i)*flowEpsilon - W1 * flowEpsilon / (W2 - W1);
+            return sqrt(t);
+        }
+    }
+    return std::numeric_limits<double>::quiet_NaN();
+}
+
+/*!
+ * \brief FlowAnalysis::estimate
+ * \param means the ensemble average of E(t) followed by Q(t)^2.
+ * \return t0, w0 and chi_t in lattice units, followed by sqrt(t0) and w0 in fm and chi_t^(1/4) in GeV.
+ */
+std::vector<double> FlowAnalysis::estimate(const std::vector<double> &means) const
+{
+    const double NaN = std::numeric_limits<double>::quiet_NaN();
+    const std::vector<double> energy(means.begin(), means.begin() + long(m_NFlowTimes));
+    const std::vector<double> topcSquared(means.begin() + long(m_NFlowTimes), means.end());
+
+    const double t0 = m_hasEnergy ? findT0(energy, m_flowEpsilon) : NaN;
+    const double w0 = m_hasEnergy ? findW0(energy, m_flowEpsilon) : NaN;
+    const double chi = m_hasTopologicalCharge ? interpolate(topcSquared, t0, m_flowEpsilon) / double(Parameters::getLatticeSize()) : NaN;
+
+    const double a = Parameters::getLatticeSpacing();
+    const double hbarc = 0.19732697; // GeV fm
+    return {t0, w0, chi, sqrt(t0)*a, w0*a, hbarc/a * std::pow(chi, 0.25)};
+}
+
+/*!
+ * \brief FlowAnalysis::analyze resamples the configurations gathered and writes t0, w0 and chi_t with jackknife and bootstrap errors.
+ *
+ * Must be called by all processors, as the resamples are split between them.
+ */
+void FlowAnalysis::analyze()
+{
+    if (!m_hasEnergy && !m_hasTopologicalCharge) {
+        if (Parallel::Communicator::getProcessRank() == 0) {
+            printf("\nFlow analysis requires the energy or topc flow observable, skipping.");
+        }
+        return;
+    }
+
+    // Every processor resamples, and thus requires all samples
+    unsigned long long NSamples = m_samples.size();
+    MPI_Bcast(&NSamples, 1, MPI_UNSIGNED_LONG_LONG, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+    std::vector<double> samples(m_samples);
+    samples.resize(NSamples);
+    MPI_Bcast(samples.data(), int(NSamples), MPI_DOUBLE, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+
+    const Resampling resampling(samples, 2*m_NFlowTimes, Parameters::getResamplingBlockSize());
+    const unsigned long NBlocks = resampling.getNumberOfBlocks();
+    if (NBlocks < 2) {
+        if (Parallel::Communicator::getProcessRank() == 0) {
+            printf("\nFlow analysis requires at least two blocks of %d configurations, skipping.", Parameters::getResamplingBlockSize());
+        }
+        return;
+    }
+
+    const unsigned long NEstimates = m_estimateNames.size();
+    const unsigned long NBootstraps = Parameters::getNBootstraps();
+    const unsigned long long seed = static_cast<unsigned long long>(Parameters::getMetropolisSeed());
+    const unsigned long rank = static_cast<unsigned long>(Parallel::Communicator::getProcessRank());
+    const unsigned long numprocs = static_cast<unsigned long>(Parallel::Communicator::getNumProc());
+
+    // Estimates of each resample, stored estimate by estimate. Each processor fills its share, and the rest are summed in
+    std::vector<double> jackknifeEstimates(NEstimates*NBlocks, 0);
+    std::vector<double> bootstrapEstimates(NEstimates*NBootstraps, 0);
+    for (unsigned long iBlock = rank; iBlock < NBlocks; iBlock += numprocs) {
+        const std::vector<double> estimates = estimate(resampling.getJackknifeMean(iBlock));
+        for (unsigned long iEst = 0; iEst < NEstimates; iEst++) {
+            jackknifeEstimates[iEst*NBlocks + iBlock] = estimates[iEst];
+        }
+    }
+    for (unsigned long iBoot = rank; iBoot < NBootstraps; iBoot += numprocs) {
+        const std::vector<double> estimates = estimate(resampling.getBootstrapMean(iBoot, seed));
+        for (unsigned long iEst = 0; iEst < NEstimates; iEst++) {
+            bootstrapEstimates[iEst*NBootstraps + iBoot] = estimates[iEst];
+        }
+    }
+    {
+        Parallel::ScopedPhase reduction(Parallel::REDUCTION);
+        MPI_Reduce(rank == 0 ? MPI_IN_PLACE : jackknifeEstimates.data(), jackknifeEstimates.data(), int(jackknifeEstimates.size()),
+                   MPI_DOUBLE, MPI_SUM, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+        MPI_Reduce(rank == 0 ? MPI_IN_PLACE : bootstrapEstimates.data(), bootstrapEstimates.data(), int(bootstrapEstimates.size()),
+                   MPI_DOUBLE, MPI_SUM, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+    }
+
+    if (rank != 0) return;
+
+    const std::vector<double> central = estimate(resampling.getMean());
+    std::vector<double> jackknifeErrors(NEstimates), bootstrapMeans(NEstimates), bootstrapErrors(NEstimates);
+    for (unsigned long iEst = 0; iEst < NEstimates; iEst++) {
+        double jackknifeMean;
+        Resampling::getJackknifeStatistics(std::vector<double>(jackknifeEstimates.begin() + long(iEst*NBlocks),
+                                                               jackknifeEstimates.begin() + long((iEst + 1)*NBlocks)),
+                                           jackknifeMean, jackknifeErrors[iEst]);
+        Resampling::getBootstrapStatistics(std::vector<double>(bootstrapEstimates.begin() + long(iEst*NBootstraps),
+                                                               bootstrapEstimates.begin() + long((iEst + 1)*NBootstraps)),
+                                           bootstrapMeans[iEst], bootstrapErrors[iEst]);
+    }
+
+    writeResults(central, jackknifeErrors, bootstrapMeans, bootstrapErrors, NBlocks);
+}
+
+/*!
+ * \brief FlowAnalysis::writeResults prints the estimates, and writes them to <batch>_flow_analysis.json in the observables folder.
+ */
+void FlowAnalysis::writeResults(const std::vector<double> &central, const std::vector<double> &jackknifeErrors,
+                                const std::vector<double> &bootstrapMeans, const std::vector<double> &bootstrapErrors, const unsigned long NBlocks)
+{
+    json j;
+    j["NConfigurations"] = m_samples.size() / (2*m_NFlowTimes);
+    j["blockSize"] = Parameters::getResamplingBlockSize();
+    j["NBlocks"] = NBlocks;
+    j["NBootstraps"] = Parameters::getNBootstraps();
+    j["flowEpsilon"] = m_flowEpsilon;
+    j["latticeSpacing"] = Parameters::getLatticeSpacing();
+
+    printf("\n\nFlow analysis of %lu configurations in %lu blocks:", m_samples.size() / (2*m_NFlowTimes), NBlocks);
+    printf("\n%-20s %20s %20s %20s %20s", "Estimate", "Value", "Jackknife error", "Bootstrap mean", "Bootstrap error");
+    for (unsigned long iEst = 0; iEst < m_estimateNames.size(); iEst++) {
+        // JSON has no NaN, so estimates that are not reached are written as null
+        json estimate;
+        if (std::isnan(central[iEst])) {
+            printf("\n%-20s %20s", m_estimateNames[iEst].c_str(), "not reached");
+            estimate["value"] = nullptr;
+        } else {
+            printf("\n%-20s %20.10f %20.10f %20.10f %20.10f", m_estimateNames[iEst].c_str(),
+                   central[iEst], jackknifeErrors[iEst], bootstrapMeans[iEst], bootstrapErrors[iEst]);
+            estimate["value"] = central[iEst];
+            estimate["jackknifeError"] = std::isnan(jackknifeErrors[iEst]) ? json(nullptr) : json(jackknifeErrors[iEst]);
+            estimate["bootstrapMean"] = std::isnan(bootstrapMeans[iEst]) ? json(nullptr) : json(bootstrapMeans[iEst]);
+            estimate["bootstrapError"] = std::isnan(bootstrapErrors[iEst]) ? json(nullptr) : json(bootstrapErrors[iEst]);
+        }
+        j["estimates"][m_estimateNames[iEst]] = estimate;
+    }
+
+    const std::string filename = Parameters::getFilePath() + Parameters::getOutputFolder() + Parameters::getBatchName()
+            + "/observables/" + Parameters::getBatchName() + "_flow_analysis.json";
+    Parallel::ScopedPhase fileIO(Parallel::FILE_IO);
+    std::ofstream file(filename);
+    file << std::setw(4) << j << std::endl;
+    file.close();
+    printf("\n%s written.\n", filename.c_str());
+}
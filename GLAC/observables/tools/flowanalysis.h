@@ -0,0 +1,68 @@
+/*!
+ * \class FlowAnalysis
+ *
+ * \brief Estimates the scales t0 and w0 and the topological susceptibility from the flow observables of all configurations of a run.
+ *
+ * After each configuration is flowed, the energy density E(t) and the squared topological charge Q(t)^2 at every flow time are taken from the
+ * flow correlator and kept by the root processor, with the flow times skipped by a flowSchedule interpolated from the measured ones. At the end of the run the ensemble averages are resampled with a blocked jackknife and
+ * a blocked bootstrap, and from each resample
+ * - t0 is found from t^2 <E(t)> = 0.3,
+ * - w0 is found from t d/dt (t^2 <E(t)>) = 0.3 at t = w0^2,
+ * - chi_t = <Q(t0)^2>/V is found at the flow time t0 of the resample.
+ *
+ * The resamples are split between the processors. Results are printed and written to <batch>_flow_analysis.json in the observables folder.
+ * When the configurations are flowed by several groups, the samples of each group are gathered in order of configuration by gatherGroups, and
+ * the analysis is done by the first group.
+ * Flow times are in lattice units, and physical units are given through the lattice spacing set by beta.
+ *
+ * \author Mathias M. Vege
+ * \version 1.0
+ * \date 2017-2019
+ * \copyright MIT Licence
+ */
+#ifndef FLOWANALYSIS_H
+#define FLOWANALYSIS_H
+
+#include <string>
+#include <vector>
+
+class Correlator;
+
+class FlowAnalysis
+{
+private:
+    // Correlator holding the flow observables of the current configuration
+    Correlator *m_flowCorrelator;
+
+    // Number of flow times, including t=0, and the flow time step
+    unsigned long m_NFlowTimes;
+    double m_flowEpsilon;
+
+    // E(t) followed by Q(t)^2 for each configuration, only held by the root processor
+    std::vector<double> m_samples;
+    bool m_hasEnergy = false;
+    bool m_hasTopologicalCharge = false;
+
+    static const std::vector<std::string> m_estimateNames;
+
+    std::vector<double> estimate(const std::vector<double> &means) const;
+    void writeResults(const std::vector<double> &central, const std::vector<double> &jackknifeErrors,
+                      const std::vector<double> &bootstrapMeans, const std::vector<double> &bootstrapErrors, const unsigned long NBlocks);
+public:
+    FlowAnalysis(Correlator *flowCorrelator, const unsigned int NFlows, const double flowEpsilon);
+
+    void addConfiguration();
+    void gatherGroups(const std::vector<unsigned long> &configurations);
+    void analyze();
+
+    static double findT0(const std::vector<double> &energy, const double flowEpsilon);
+    static double findW0(const std::vector<double> &energy, const double flowEpsilon);
+    static double interpolate(const std::vector<double> &values, const double flowTime, const double flowEpsilon);
+    static void fillGaps(std::vector<double> &values);
+
+    // Getters and setters of the samples, used for checkpointing
+    const std::vector<double> &getSamples() const { return m_samples; }
+    void setSamples(const std::vector<double> &samples) { m_samples = samples; }
+};
+
+#endif // FLOWANALYSIS_H
@@ -0,0 +1,165 @@
+#include "flowschedule.h"
+#include "observables/correlator.h"
+#include "parallelization/parallel.h"
+#include <cmath>
+#include <limits>
+
+/*!
+ * \brief FlowSchedule::FlowSchedule
+ * \param flowCorrelator the correlator of the flow observables.
+ * \param entries the schedule of each observable. Observables without an entry are measured at every flow step.
+ * \param NFlows the number of flow steps.
+ * \param flowEpsilon the flow time step.
+ * \param adaptiveWidth the distance in t^2 E(t) from 0.3 within which adaptive observables are measured at every flow step.
+ */
+FlowSchedule::FlowSchedule(Correlator *flowCorrelator, const std::vector<FlowScheduleEntry> &entries, const unsigned int NFlows,
+                           const double flowEpsilon, const double adaptiveWidth) :
+    m_NFlows(NFlows), m_flowEpsilon(flowEpsilon), m_adaptiveWidth(adaptiveWidth)
+{
+    for (auto &entry : entries) {
+        Rule rule;
+        rule.observable = flowCorrelator->getObservableStorer(entry.observable);
+        if (rule.observable == nullptr) {
+            Parallel::Communicator::MPIExit("Error: flow schedule given for " + entry.observable + ", which is not a flow observable.");
+        }
+        rule.interval = entry.interval;
+        rule.adaptive = entry.adaptive;
+        rule.flowSteps.assign(m_NFlows + 1, false);
+        for (auto flowTime : entry.flowTimes) {
+            const long iFlow = std::lround(flowTime / m_flowEpsilon);
+            if (iFlow >= 0 && iFlow <= long(m_NFlows)) {
+                rule.flowSteps[static_cast<unsigned long>(iFlow)] = true;
+            }
+        }
+        rule.measured.assign(m_NFlows + 1, false);
+        m_adaptive = m_adaptive || rule.adaptive;
+        m_rules.push_back(rule);
+    }
+
+    for (auto observable : flowCorrelator->getObservableStorers()) {
+        bool scheduled = false;
+        for (auto &rule : m_rules) {
+            if (rule.observable == observable) scheduled = true;
+        }
+        m_hasUnscheduled = m_hasUnscheduled || !scheduled;
+    }
+
+    if (m_adaptive) {
+        m_energy = flowCorrelator->getObservableStorer("energy");
+        if (m_energy == nullptr) {
+            Parallel::Communicator::MPIExit("Error: adaptive flow schedule requires energy as a flow observable.");
+        }
+        for (auto &rule : m_rules) {
+            if (rule.observable == m_energy) m_energyInterval = rule.interval;
+        }
+    }
+}
+
+/*!
+ * \brief FlowSchedule::reset prepares the schedule for a new configuration.
+ */
+void FlowSchedule::reset()
+{
+    m_dense = false;
+    m_hasPrevious = false;
+    for (auto &rule : m_rules) {
+        rule.measured.assign(m_NFlows + 1, false);
+    }
+}
+
+/*!
+ * \brief FlowSchedule::isDue
+ * \param rule the schedule of the observable.
+ * \param iFlow the flow step.
+ * \return true if the observable is to be measured at the flow step. While in the adaptive window the energy is measured as well, as it
+ * decides when the window is left.
+ */
+bool FlowSchedule::isDue(const Rule &rule, const unsigned int iFlow) const
+{
+    return iFlow == 0 || iFlow == m_NFlows || iFlow % rule.interval == 0 || rule.flowSteps[iFlow]
+            || (m_dense && (rule.adaptive || rule.observable == m_energy));
+}
+
+/*!
+ * \brief FlowSchedule::schedule flags the observables due at a flow step in their storers.
+ * \param iFlow the flow step.
+ * \return true if any observable is to be measured at the flow step.
+ */
+bool FlowSchedule::schedule(const unsigned int iFlow)
+{
+    bool anyDue = m_hasUnscheduled;
+    for (auto &rule : m_rules) {
+        rule.measured[iFlow] = isDue(rule, iFlow);
+        rule.observable->setScheduled(rule.measured[iFlow]);
+        anyDue = anyDue || rule.measured[iFlow];
+    }
+    return anyDue;
+}
+
+/*!
+ * \brief FlowSchedule::scheduleAll flags every observable at a flow step, e.g. when the flow is ended early at that step.
+ * \param iFlow the flow step.
+ * \return true if any observable was not already measured at the flow step, such that the observables must be calculated again.
+ */
+bool FlowSchedule::scheduleAll(const unsigned int iFlow)
+{
+    bool anyMissing = false;
+    for (auto &rule : m_rules) {
+        anyMissing = anyMissing || !rule.measured[iFlow];
+        rule.measured[iFlow] = true;
+        rule.observable->setScheduled(true);
+    }
+    return anyMissing;
+}
+
+/*!
+ * \brief FlowSchedule::update opens or closes the adaptive window from the energy measured at a flow step.
+ * \param iFlow the flow step just measured.
+ * \param energy the energy at the flow step, summed over all processors.
+ *
+ * The window is opened once t^2 E(t) is within the width of 0.3, or is expected to be so at the next regular measurement of the energy,
+ * and closed once t^2 E(t) has passed 0.3 by more than the width. Must only be called at flow steps where the energy was measured.
+ */
+void FlowSchedule::update(const unsigned int iFlow, const double energy)
+{
+    if (!m_adaptive) return;
+
+    // The clover energy sums tr(C_{mu nu}^2) over mu < nu, with C = 8 i F to lowest order
+    const double flowTime = double(iFlow)*m_flowEpsilon;
+    const double value = - flowTime*flowTime*energy / 64.0;
+
+    if (value > 0.3 + m_adaptiveWidth) {
+        m_dense = false;
+    } else if (value >= 0.3 - m_adaptiveWidth) {
+        m_dense = true;
+    } else if (m_hasPrevious && iFlow > m_iPrevious) {
+        const double slope = (value - m_previousValue) / double(iFlow - m_iPrevious);
+        m_dense = value + slope*double(m_energyInterval) >= 0.3 - m_adaptiveWidth;
+    }
+
+    m_hasPrevious = true;
+    m_iPrevious = iFlow;
+    m_previousValue = value;
+}
+
+/*!
+ * \brief FlowSchedule::markSkipped sets the values of the flow times skipped to NaN, and flags all observables for measurement again.
+ * \param iFlowLast the last flow step reached, at which all observables have been measured.
+ */
+void FlowSchedule::markSkipped(const unsigned int iFlowLast)
+{
+    for (auto &rule : m_rules) {
+        // Observables such as topct hold several values per flow time
+        const unsigned long width = rule.observable->getObservableArray().size() / (m_NFlows + 1);
+
+        for (unsigned int iFlow = 1; iFlow <= iFlowLast; iFlow++) {
+            if (rule.measured[iFlow]) continue;
+
+            for (unsigned long i = 0; i < width; i++) {
+                (*rule.observable)[iFlow*width + i] = std::numeric_limits<double>::quiet_NaN();
+            }
+        }
+
+        rule.observable->setScheduled(true);
+    }
+}
@@ -0,0 +1,72 @@
+/*!
+ * \class FlowSchedule
+ *
+ * \brief Decides at which flow times each flow observable is measured.
+ *
+ * Each observable given in the flowSchedule parameter is measured every interval flow steps, at the steps closest to a list of flow times,
+ * and, if adaptive, at every step while t^2 E(t) is within flowScheduleAdaptiveWidth of 0.3, such that t0 and w0 are resolved. Observables
+ * without an entry are measured at every step, and the first and last flow times are always measured.
+ *
+ * Before each flow step the observables due are flagged in their ObservableStorer, and the samplers leave out the work of observables not
+ * flagged. Nothing is calculated at a flow step where no observable is due. When the flow is done, the values at the flow times skipped are
+ * set to NaN, such that the flow observables keep one value per flow time and the files written tell the measured flow times from the
+ * skipped ones. If the flow is ended early, the last flow step reached takes the place of the last flow time.
+ *
+ * \author Mathias M. Vege
+ * \version 1.0
+ * \date 2017-2019
+ * \copyright MIT Licence
+ */
+#ifndef FLOWSCHEDULE_H
+#define FLOWSCHEDULE_H
+
+#include "config/parameters.h"
+#include <vector>
+
+class Correlator;
+class ObservableStorer;
+
+class FlowSchedule
+{
+private:
+    struct Rule
+    {
+        ObservableStorer *observable;
+        unsigned int interval;
+        bool adaptive;
+        // Flow steps closest to the flow times given, and flow steps measured for the current configuration
+        std::vector<bool> flowSteps;
+        std::vector<bool> measured;
+    };
+
+    std::vector<Rule> m_rules;
+    bool m_hasUnscheduled = false;
+    unsigned int m_NFlows;
+    double m_flowEpsilon;
+
+    // Adaptive measurements around t0, driven by the energy density
+    ObservableStorer *m_energy = nullptr;
+    unsigned int m_energyInterval = 1;
+    bool m_adaptive = false;
+    double m_adaptiveWidth;
+    bool m_dense = false;
+    bool m_hasPrevious = false;
+    unsigned int m_iPrevious = 0;
+    double m_previousValue = 0;
+
+    bool isDue(const Rule &rule, const unsigned int iFlow) const;
+public:
+    FlowSchedule(Correlator *flowCorrelator, const std::vector<FlowScheduleEntry> &entries, const unsigned int NFlows,
+                 const double flowEpsilon, const double adaptiveWidth);
+
+    void reset();
+    bool schedule(const unsigned int iFlow);
+    bool scheduleAll(const unsigned int iFlow);
+    void update(const unsigned int iFlow, const double energy);
+    void markSkipped(const unsigned int iFlowLast);
+
+    // Getters
+    bool isAdaptive() const { return m_adaptive; }
+};
+
+#endif // FLOWSCHEDULE_H
@@ -2,6 +2,7 @@
 #include "io/observablesio.h"
 #include "parallelization/parallel.h"
 #include "config/parameters.h"
+#include "instrumentation/timers.h"
 #include <cmath>
 #include <mpi.h>
 
@@ -9,7 +10,7 @@
  * \brief ObservableStorer::ObservableStorer
  * \param NSize the number of observables to allow storage for.
  *
- * Stores two arrays, one for observables, and one for observables squared.
+ * Stores an array of the observables, and their streaming statistics.
  */
 ObservableStorer::ObservableStorer(const unsigned long NSize)
 {
@@ -22,7 +23,6 @@ ObservableStorer::ObservableStorer(const unsigned long NSize)
 
     // Initializes arrays for storing the observables
     m_observables.resize(m_NObs);
-    m_observablesSquared.resize(m_NObs);
     for (unsigned long iObs = 0; iObs < m_NObs; iObs++) m_observables[iObs] = 0;
 }
 
@@ -36,35 +36,41 @@ ObservableStorer::~ObservableStorer()
  * Performs a MPI reduce between all the data gathered and, if set - divides by the number of processors.
  */
 void ObservableStorer::gatherResults()
+{
+    gatherResults({this});
+}
+
+/*!
+ * \brief ObservableStorer::gatherResults gathers several observables at once.
+ * \param observables the observables to gather.
+ *
+ * The observables are summed to the root processor in a single MPI reduce, after which each is divided by the number of processors if set.
+ * Must be called by all processors, with the observables in the same order.
+ */
+void ObservableStorer::gatherResults(const std::vector<ObservableStorer *> &observables)
 {
     /*
      * Gather all observable data from all of the processors
      */
-
-    // Temporary buffer for summing the observables
-    double tempBuffer[m_NObs];
-
-    for (unsigned long iObs = 0; iObs < m_NObs; iObs++)
-    {
-        tempBuffer[iObs] = 0;
-    }
+    GLAC_TIMER(OBSERVABLE_GATHER_RESULTS);
 
     // Performing an average over the Monte Carlo obtained values
-    MPI_Reduce(&m_observables.front(), tempBuffer, m_NObs, MPI_DOUBLE, MPI_SUM, 0, Parallel::ParallelParameters::ACTIVE_COMM);
-
-    // Retrieving observable from temporary buffer
-    for (unsigned long iBuffer = 0; iBuffer < m_NObs; iBuffer++)
+    Parallel::ReductionBuffer reduction;
+    for (auto observable : observables)
     {
-        m_observables[iBuffer] = tempBuffer[iBuffer];
+        reduction.add(observable->m_observables);
     }
+    reduction.reduce(0);
 
     // Normalizing by the number of processors if specified
-    if (m_normalizeObservableByProcessor)
+    const double numprocs = double(Parallel::Communicator::getNumProc());
+    for (auto observable : observables)
     {
-        double numprocs = double(Parallel::Communicator::getNumProc());
-        for (unsigned long  i = 0; i < m_NObs; i++)
+        if (!observable->m_normalizeObservableByProcessor) continue;
+
+        for (unsigned long i = 0; i < observable->m_NObs; i++)
         {
-            m_observables[i] /= double(numprocs);
+            observable->m_observables[i] /= numprocs;
         }
     }
 }
@@ -72,7 +78,9 @@ void ObservableStorer::gatherResults()
 /*!
  * \brief ObservableStorer::runStatistics
  *
- * Performs simple statistics such as mean, variance and standard deviation.
+ * Performs simple statistics such as mean, variance, standard deviation and the binned standard deviation. These are taken from the
+ * statistics accumulated during the run, or from the stored observables if nothing was accumulated. Observables that are not finite,
+ * such as the flow times skipped by a FlowSchedule, are left out.
  */
 void ObservableStorer::runStatistics()
 {
@@ -80,21 +88,75 @@ void ObservableStorer::runStatistics()
      * Performs the statistics on the observables.
      * Best used in conjecture with ObservableStorer::gatherResults().
      */
-    for (unsigned long i = 0; i < m_NObs; i++)
+    if (m_statistics.getCount() == 0)
     {
-        m_observablesSquared[i] = m_observables[i]*m_observables[i];
+        for (unsigned long i = 0; i < m_NObs; i++)
+        {
+            if (!std::isfinite(m_observables[i])) continue;
+            m_statistics.push(m_observables[i]);
+        }
     }
 
-    // Gets average of the observable
-    for (unsigned long i = 0; i < m_NObs; i++)
+    m_averagedObservable = m_statistics.getMean();
+    m_varianceObservable = m_statistics.getCount() == 0 ? 0 : m_statistics.getVariance()/double(m_statistics.getCount());
+    m_stdObservable = sqrt(m_varianceObservable);
+    m_binnedStdObservable = m_statistics.getBinnedStandardError();
+}
+
+/*!
+ * \brief ObservableStorer::accumulate adds a single observable, summed over all processors, to the streaming statistics and the autocorrelation estimate.
+ * \param iObs the observable to add.
+ *
+ * Must be called by all processors. The stored observable itself is left as is, such that gatherResults may be used at the end of the run.
+ */
+void ObservableStorer::accumulate(const unsigned long iObs)
+{
+    accumulate({this}, iObs);
+}
+
+/*!
+ * \brief ObservableStorer::accumulate adds an observable of several storers at once to their statistics.
+ * \param observables the observables to accumulate.
+ * \param iObs the observable to add from each.
+ *
+ * The observables are summed over all processors in a single allreduce, after which each is divided by the number of processors if set.
+ * When flowing, the observables of a configuration are copied from the flow observables at zero flow time, which are already gathered
+ * to the root processor, and are instead broadcast from it. Observables that are not finite are left out, as in runStatistics.
+ * Must be called by all processors, with the observables in the same order.
+ */
+void ObservableStorer::accumulate(const std::vector<ObservableStorer *> &observables, const unsigned long iObs)
+{
+    std::vector<double> values(observables.size());
+    for (unsigned long i = 0; i < observables.size(); i++)
     {
-        m_averagedObservable += m_observables[i];
-        m_averagedObservableSquared += m_observablesSquared[i];
+        values[i] = observables[i]->m_observables[iObs];
+    }
+
+    const bool gathered = Parameters::getNFlows() != 0;
+    if (gathered)
+    {
+        MPI_Bcast(values.data(), int(values.size()), MPI_DOUBLE, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+    }
+    else
+    {
+        Parallel::ReductionBuffer reduction;
+        reduction.add(values);
+        reduction.allreduce();
+    }
+
+    const double numprocs = double(Parallel::Communicator::getNumProc());
+    for (unsigned long i = 0; i < observables.size(); i++)
+    {
+        double observable = values[i];
+        if (!std::isfinite(observable)) continue;
+        if (!gathered && observables[i]->m_normalizeObservableByProcessor)
+        {
+            observable /= numprocs;
+        }
+
+        observables[i]->m_statistics.push(observable);
+        observables[i]->m_autocorrelation.push(observable);
     }
-    m_averagedObservable /= double(m_NObs);
-    m_averagedObservableSquared /= double(m_NObs);
-    m_varianceObservable = (m_averagedObservableSquared - m_averagedObservable*m_averagedObservable)/double(m_NObs);
-    m_stdObservable = sqrt(m_varianceObservable);
 }
 
 void ObservableStorer::printStatistics()
@@ -108,6 +170,20 @@ void ObservableStorer::printStatistics()
         printf("%-25.15f ", m_averagedObservable);
         printf("%-25.15f ", m_varianceObservable);
         printf("%-25.15f ", m_stdObservable);
+        printf("%-25.15f ", m_binnedStdObservable);
+    }
+}
+
+/*!
+ * \brief ObservableStorer::printRunningStatistics prints the mean and binned standard error of the observables accumulated so far.
+ *
+ * Prints nothing if no observables have been accumulated.
+ */
+void ObservableStorer::printRunningStatistics()
+{
+    if (Parallel::Communicator::getProcessRank() == 0 && m_statistics.getCount() != 0)
+    {
+        printf(" %s %.8f +/- %.8f", m_observableName.c_str(), m_statistics.getMean(), m_statistics.getBinnedStandardError());
     }
 }
 
@@ -151,10 +227,11 @@ void ObservableStorer::reset()
     for (unsigned long i = 0; i < m_NObs; i++)
     {
         m_observables[i] = 0;
-        m_observablesSquared[i] = 0;
     }
     m_averagedObservable = 0;
-    m_averagedObservableSquared = 0;
     m_varianceObservable = 0;
     m_stdObservable = 0;
+    m_binnedStdObservable = 0;
+    m_statistics.reset();
+    m_autocorrelation.reset();
 }
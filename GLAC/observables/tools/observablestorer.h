@@ -5,6 +5,13 @@
  *
  * Contains methods for printing statistics, writing to file, setting observables and reseting ect.
  *
+ * Statistics are accumulated by a StreamingStatistics one value at a time by accumulate, as each configuration is made, such that the mean
+ * and binned error may be monitored during the run by printRunningStatistics. Values added by accumulate also update an estimate of the
+ * integrated autocorrelation time. runStatistics then uses the statistics accumulated, or the stored observables if none were, e.g. when
+ * measuring loaded configurations.
+ *
+ * The observables themselves are still stored, as they are written in full to the observable files and kept in checkpoints.
+ *
  * \author Mathias M. Vege
  * \version 1.0
  * \date 2017-2019
@@ -13,6 +20,8 @@
 #ifndef OBSERVABLESTORER_H
 #define OBSERVABLESTORER_H
 
+#include "streamingstatistics.h"
+#include "autocorrelationestimator.h"
 #include <string>
 #include <vector>
 
@@ -23,15 +32,20 @@ private:
     std::string m_observableName;
     // Bool to store if we are to normalize the data by number of processors
     bool m_normalizeObservableByProcessor = false;
+    // Bool to store if the observable is to be measured at the current flow time
+    bool m_scheduled = true;
 
     // Observable data
     unsigned long m_NObs;
     double m_averagedObservable = 0;
     double m_varianceObservable = 0;
-    double m_averagedObservableSquared = 0;
     double m_stdObservable = 0;
+    double m_binnedStdObservable = 0;
     std::vector<double> m_observables;
-    std::vector<double> m_observablesSquared;
+
+    // Streaming statistics of the observable
+    StreamingStatistics m_statistics;
+    AutocorrelationEstimator m_autocorrelation;
 public:
     ObservableStorer(const unsigned long int NSize);
     ~ObservableStorer();
@@ -42,10 +56,14 @@ public:
 
     // Runs statistics, perhaps create its own class? But that increases overhead, so maybe not
     void gatherResults();
+    static void gatherResults(const std::vector<ObservableStorer *> &observables);
     void runStatistics();
+    void accumulate(const unsigned long int iObs);
+    static void accumulate(const std::vector<ObservableStorer *> &observables, const unsigned long int iObs);
 
     // Printers
     void printStatistics();
+    void printRunningStatistics();
 
     // File writers
     void writeObservableToFile(const double acceptanceRatio);
@@ -55,11 +73,16 @@ public:
     std::vector<double> getObservableArray() { return m_observables; }
     double getObservable(const unsigned long int iObs) { return m_observables[iObs]; }
     std::string getObservableName() { return m_observableName; }
+    const StreamingStatistics &getStatistics() const { return m_statistics; }
+    const AutocorrelationEstimator &getAutocorrelation() const { return m_autocorrelation; }
+    bool isScheduled() const { return m_scheduled; }
 
     // Setters
     void setObservableName(const std::string &observableName) { m_observableName = observableName; }
     void setNormalizeObservableByProcessor(const bool norm) { m_normalizeObservableByProcessor = norm; }
+    void setScheduled(const bool scheduled) { m_scheduled = scheduled; }
     void reset();
+    void resetAutocorrelation() { m_autocorrelation.reset(); }
 };
 
 #endif // OBSERVABLESTORER_H
@@ -0,0 +1,117 @@
+#include "resampling.h"
+#include <cmath>
+#include <random>
+
+/*!
+ * \brief Resampling::Resampling
+ * \param samples the values of all samples, stored sample by sample.
+ * \param NValues the number of values in each sample.
+ * \param blockSize the number of consecutive samples in a block. Samples beyond the last complete block are left out.
+ */
+Resampling::Resampling(const std::vector<double> &samples, const unsigned long NValues, const unsigned long blockSize) :
+    m_NValues(NValues), m_blockSize(blockSize)
+{
+    const unsigned long NSamples = (NValues == 0) ? 0 : samples.size() / NValues;
+    m_NBlocks = (blockSize == 0) ? 0 : NSamples / blockSize;
+
+    m_blockSums.assign(m_NBlocks * m_NValues, 0);
+    m_totalSums.assign(m_NValues, 0);
+    for (unsigned long iBlock = 0; iBlock < m_NBlocks; iBlock++) {
+        for (unsigned long iSample = iBlock*m_blockSize; iSample < (iBlock + 1)*m_blockSize; iSample++) {
+            for (unsigned long i = 0; i < m_NValues; i++) {
+                m_blockSums[iBlock*m_NValues + i] += samples[iSample*m_NValues + i];
+            }
+        }
+        for (unsigned long i = 0; i < m_NValues; i++) {
+            m_totalSums[i] += m_blockSums[iBlock*m_NValues + i];
+        }
+    }
+}
+
+/*!
+ * \brief Resampling::getMean
+ * \return the mean of each value over all samples in complete blocks.
+ */
+std::vector<double> Resampling::getMean() const
+{
+    std::vector<double> mean(m_totalSums);
+    const double NSamples = double(m_NBlocks * m_blockSize);
+    for (auto &value : mean) value /= NSamples;
+    return mean;
+}
+
+/*!
+ * \brief Resampling::getJackknifeMean
+ * \param iBlock the block to leave out.
+ * \return the mean of each value over all blocks but iBlock.
+ */
+std::vector<double> Resampling::getJackknifeMean(const unsigned long iBlock) const
+{
+    std::vector<double> mean(m_NValues);
+    const double NSamples = double((m_NBlocks - 1) * m_blockSize);
+    for (unsigned long i = 0; i < m_NValues; i++) {
+        mean[i] = (m_totalSums[i] - m_blockSums[iBlock*m_NValues + i]) / NSamples;
+    }
+    return mean;
+}
+
+/*!
+ * \brief Resampling::getBootstrapMean
+ * \param iBootstrap the number of the bootstrap resample.
+ * \param seed seed of the resampling, shared by all resamples.
+ * \return the mean of each value over as many blocks as there are, drawn with replacement.
+ */
+std::vector<double> Resampling::getBootstrapMean(const unsigned long iBootstrap, const unsigned long long seed) const
+{
+    // The resample is given by its own generator, such that it does not depend on which resamples were drawn before it
+    std::seed_seq seedSequence{seed, static_cast<unsigned long long>(iBootstrap)};
+    std::mt19937_64 generator(seedSequence);
+    std::uniform_int_distribution<unsigned long> blockDistribution(0, m_NBlocks - 1);
+
+    std::vector<double> mean(m_NValues, 0);
+    for (unsigned long iDraw = 0; iDraw < m_NBlocks; iDraw++) {
+        const unsigned long iBlock = blockDistribution(generator);
+        for (unsigned long i = 0; i < m_NValues; i++) {
+            mean[i] += m_blockSums[iBlock*m_NValues + i];
+        }
+    }
+    const double NSamples = double(m_NBlocks * m_blockSize);
+    for (auto &value : mean) value /= NSamples;
+    return mean;
+}
+
+/*!
+ * \brief Resampling::getJackknifeStatistics
+ * \param estimates the estimate of each jackknife resample.
+ * \param mean the mean of the estimates.
+ * \param error the jackknife error, sqrt((N-1)/N sum (estimate - mean)^2).
+ */
+void Resampling::getJackknifeStatistics(const std::vector<double> &estimates, double &mean, double &error)
+{
+    const double N = double(estimates.size());
+    mean = 0;
+    for (auto estimate : estimates) mean += estimate;
+    mean /= N;
+
+    error = 0;
+    for (auto estimate : estimates) error += (estimate - mean)*(estimate - mean);
+    error = sqrt(error * (N - 1) / N);
+}
+
+/*!
+ * \brief Resampling::getBootstrapStatistics
+ * \param estimates the estimate of each bootstrap resample.
+ * \param mean the mean of the estimates.
+ * \param error the standard deviation of the estimates.
+ */
+void Resampling::getBootstrapStatistics(const std::vector<double> &estimates, double &mean, double &error)
+{
+    const double N = double(estimates.size());
+    mean = 0;
+    for (auto estimate : estimates) mean += estimate;
+    mean /= N;
+
+    error = 0;
+    for (auto estimate : estimates) error += (estimate - mean)*(estimate - mean);
+    error = sqrt(error / (N - 1));
+}
@@ -0,0 +1,49 @@
+/*!
+ * \class Resampling
+ *
+ * \brief Blocked jackknife and bootstrap resampling of the means of a set of samples.
+ *
+ * Each sample, e.g. a configuration, holds a fixed number of values, e.g. an observable at every flow time. The samples are grouped into blocks
+ * of consecutive samples, such that autocorrelations shorter than a block are accounted for, and resampling is done on the blocks. A derived
+ * quantity is estimated by applying a function to the means of each resample, and its error is found from the spread of the estimates with
+ * getJackknifeStatistics or getBootstrapStatistics.
+ *
+ * Each resample is independent of the others, and a bootstrap resample is given by its number and a seed only, such that resamples may be
+ * split between processors without changing the result.
+ *
+ * \author Mathias M. Vege
+ * \version 1.0
+ * \date 2017-2019
+ * \copyright MIT Licence
+ */
+#ifndef RESAMPLING_H
+#define RESAMPLING_H
+
+#include <vector>
+
+class Resampling
+{
+private:
+    unsigned long m_NValues;
+    unsigned long m_blockSize;
+    unsigned long m_NBlocks;
+
+    // Sum of the values over the samples of each block, and over all blocks
+    std::vector<double> m_blockSums;
+    std::vector<double> m_totalSums;
+public:
+    Resampling(const std::vector<double> &samples, const unsigned long NValues, const unsigned long blockSize);
+
+    std::vector<double> getMean() const;
+    std::vector<double> getJackknifeMean(const unsigned long iBlock) const;
+    std::vector<double> getBootstrapMean(const unsigned long iBootstrap, const unsigned long long seed) const;
+
+    static void getJackknifeStatistics(const std::vector<double> &estimates, double &mean, double &error);
+    static void getBootstrapStatistics(const std::vector<double> &estimates, double &mean, double &error);
+
+    // Getters
+    unsigned long getNumberOfBlocks() const { return m_NBlocks; }
+    unsigned long getNumberOfValues() const { return m_NValues; }
+};
+
+#endif // RESAMPLING_H
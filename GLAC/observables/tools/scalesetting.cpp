@@ -0,0 +1,144 @@
+#include "scalesetting.h"
+#include "flowanalysis.h"
+#include "observables/correlator.h"
+#include "parallelization/parallel.h"
+#include "config/parameters.h"
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <vector>
+
+/*!
+ * \brief ScaleSetting::ScaleSetting
+ * \param flowCorrelator the correlator of the flow observables, which must hold the energy.
+ * \param NFlows the largest number of flow steps.
+ * \param flowEpsilon the flow time step.
+ * \param margin the amount t^2 E(t) and W(t) must exceed 0.3 by before the flow is ended.
+ *
+ * The file of the scales is started anew, unless the run continues from a checkpoint.
+ */
+ScaleSetting::ScaleSetting(Correlator *flowCorrelator, const unsigned int NFlows, const double flowEpsilon, const double margin) :
+    m_flowCorrelator(flowCorrelator), m_NFlows(NFlows), m_flowEpsilon(flowEpsilon), m_margin(margin)
+{
+    m_energy = m_flowCorrelator->getObservableStorer("energy");
+    if (m_energy == nullptr) {
+        Parallel::Communicator::MPIExit("Error: scaleSetting requires energy as a flow observable.");
+    }
+
+    m_filename = Parameters::getFilePath() + Parameters::getOutputFolder() + Parameters::getBatchName()
+            + "/observables/" + Parameters::getBatchName() + "_scale_setting.dat";
+    if (Parallel::Communicator::getProcessRank() == 0 && !Parameters::getRestartFromCheckpoint()) {
+        std::ofstream file(m_filename);
+        file << "config t0 w0 NFlows" << std::endl;
+        file.close();
+    }
+}
+
+/*!
+ * \brief ScaleSetting::reset prepares for the flow of a new configuration.
+ */
+void ScaleSetting::reset()
+{
+    m_hasPrevious = false;
+    m_iFlowLast = m_NFlows;
+}
+
+/*!
+ * \brief ScaleSetting::update checks the energy measured at a flow step against the reference values.
+ * \param iFlow the flow step just measured.
+ * \param energy the energy at the flow step, summed over all processors.
+ * \return true if both t0 and w0 have been passed by the margin, and the flow may be ended.
+ *
+ * Must only be called at flow steps where the energy was measured.
+ */
+bool ScaleSetting::update(const unsigned int iFlow, const double energy)
+{
+    // The clover energy sums tr(C_{mu nu}^2) over mu < nu, with C = 8 i F to lowest order
+    const double flowTime = double(iFlow)*m_flowEpsilon;
+    const double value = - flowTime*flowTime*energy / 64.0;
+
+    bool passed = false;
+    if (m_hasPrevious) {
+        const double W = 0.5*(flowTime + m_previousFlowTime) * (value - m_previousValue) / (flowTime - m_previousFlowTime);
+        passed = value >= 0.3 + m_margin && W >= 0.3 + m_margin;
+    }
+
+    m_hasPrevious = true;
+    m_previousFlowTime = flowTime;
+    m_previousValue = value;
+
+    return passed;
+}
+
+/*!
+ * \brief ScaleSetting::finish sets the flow observables beyond the last flow step to NaN.
+ * \param iFlowLast the last flow step of the configuration.
+ *
+ * Must be called before the flow observables are gathered.
+ */
+void ScaleSetting::finish(const unsigned int iFlowLast)
+{
+    m_iFlowLast = iFlowLast;
+    for (auto observable : m_flowCorrelator->getObservableStorers()) {
+        // Observables such as topct hold several values per flow time
+        const unsigned long NValues = observable->getObservableArray().size();
+        const unsigned long width = NValues / (m_NFlows + 1);
+        for (unsigned long i = (iFlowLast + 1)*width; i < NValues; i++) {
+            (*observable)[i] = std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+}
+
+/*!
+ * \brief ScaleSetting::writeScales finds t0 and w0 of the configuration, and appends them to the file of the scales.
+ * \param iConfig the configuration number.
+ *
+ * Must be called after the flow observables have been gathered, and only has an effect on the root processor.
+ */
+void ScaleSetting::writeScales(const unsigned int iConfig)
+{
+    if (Parallel::Communicator::getProcessRank() != 0) return;
+
+    std::vector<double> energyDensity = m_energy->getObservableArray();
+    energyDensity.resize(m_iFlowLast + 1);
+    FlowAnalysis::fillGaps(energyDensity);
+    for (auto &value : energyDensity) value /= -64.0;
+
+    m_t0 = FlowAnalysis::findT0(energyDensity, m_flowEpsilon);
+    m_w0 = FlowAnalysis::findW0(energyDensity, m_flowEpsilon);
+
+    Parallel::ScopedPhase fileIO(Parallel::FILE_IO);
+    std::ofstream file(m_filename, std::ios::app);
+    file << std::setprecision(15) << iConfig + Parameters::getConfigStartNumber() << " " << m_t0 << " " << m_w0 << " " << m_iFlowLast << std::endl;
+    file.close();
+    m_NScales++;
+}
+
+/*!
+ * \brief ScaleSetting::restoreScales drops the scales written after a checkpoint from the file of the scales.
+ * \param NScales the number of configurations with scales in the file when the checkpoint was written.
+ *
+ * Only has an effect on the root processor.
+ */
+void ScaleSetting::restoreScales(const unsigned int NScales)
+{
+    if (Parallel::Communicator::getProcessRank() != 0) return;
+
+    Parallel::ScopedPhase fileIO(Parallel::FILE_IO);
+    std::ifstream inFile(m_filename);
+    std::vector<std::string> lines;
+    std::string line;
+    // The header and the scales of each configuration
+    while (lines.size() < NScales + 1 && std::getline(inFile, line)) {
+        lines.push_back(line);
+    }
+    inFile.close();
+
+    std::ofstream outFile(m_filename);
+    for (auto &restoredLine : lines) {
+        outFile << restoredLine << std::endl;
+    }
+    outFile.close();
+    m_NScales = NScales;
+}
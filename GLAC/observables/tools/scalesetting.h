@@ -0,0 +1,62 @@
+/*!
+ * \class ScaleSetting
+ *
+ * \brief Ends the flow of a configuration once t0 and w0 have been passed, and writes them for each configuration.
+ *
+ * Each time the energy density is measured, t^2 E(t) and W(t) = t d/dt (t^2 E(t)) are found from the energy summed over the processors,
+ * with W(t) from the difference of the two most recent measurements. The flow is ended once both have passed the reference value 0.3 by
+ * the margin given by scaleSettingMargin. The flow observables at the flow times not reached are set to NaN, and t0 and w0 are found from
+ * the energy density of the configuration as in FlowAnalysis and appended to <batch>_scale_setting.dat in the observables folder.
+ * The number of scales written is stored in a checkpoint, such that the scales written after it are dropped when it is restored.
+ *
+ * \author Mathias M. Vege
+ * \version 1.0
+ * \date 2017-2019
+ * \copyright MIT Licence
+ */
+#ifndef SCALESETTING_H
+#define SCALESETTING_H
+
+#include <string>
+
+class Correlator;
+class ObservableStorer;
+
+class ScaleSetting
+{
+private:
+    Correlator *m_flowCorrelator;
+    ObservableStorer *m_energy;
+    unsigned int m_NFlows;
+    double m_flowEpsilon;
+    double m_margin;
+    std::string m_filename;
+
+    // t^2 E(t) at the previous measurement of the energy
+    bool m_hasPrevious = false;
+    double m_previousFlowTime = 0;
+    double m_previousValue = 0;
+
+    // Scales of the last configuration, in lattice units
+    unsigned int m_iFlowLast = 0;
+    double m_t0 = 0;
+    double m_w0 = 0;
+
+    // Number of configurations with scales in the file
+    unsigned int m_NScales = 0;
+public:
+    ScaleSetting(Correlator *flowCorrelator, const unsigned int NFlows, const double flowEpsilon, const double margin);
+
+    void reset();
+    bool update(const unsigned int iFlow, const double energy);
+    void finish(const unsigned int iFlowLast);
+    void writeScales(const unsigned int iConfig);
+    void restoreScales(const unsigned int NScales);
+
+    // Getters
+    double getT0() const { return m_t0; }
+    double getW0() const { return m_w0; }
+    unsigned int getNumberOfScales() const { return m_NScales; }
+};
+
+#endif // SCALESETTING_H
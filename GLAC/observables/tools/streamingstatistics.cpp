@@ -0,0 +1,125 @@
+#include "streamingstatistics.h"
+#include <cmath>
+
+StreamingStatistics::StreamingStatistics()
+{
+    m_levels.resize(1);
+}
+
+/*!
+ * \brief StreamingStatistics::addToMoments adds a value to the running mean and variance.
+ * \param moments the moments to update.
+ * \param value the new value.
+ */
+void StreamingStatistics::addToMoments(Moments &moments, const double value)
+{
+    const double delta = value - moments.mean;
+    moments.count++;
+
+    // Kahan compensated update of the mean
+    const double increment = delta / double(moments.count) - moments.meanCompensation;
+    const double mean = moments.mean + increment;
+    moments.meanCompensation = (mean - moments.mean) - increment;
+    moments.mean = mean;
+
+    moments.M2 += delta * (value - moments.mean);
+}
+
+/*!
+ * \brief StreamingStatistics::standardError
+ * \param moments the moments of a series.
+ * \return the standard error of the mean of the series, assuming uncorrelated values. Zero if there are fewer than two values.
+ */
+double StreamingStatistics::standardError(const Moments &moments)
+{
+    if (moments.count < 2) return 0;
+    return sqrt(moments.M2 / (double(moments.count) * double(moments.count - 1)));
+}
+
+/*!
+ * \brief StreamingStatistics::push adds a value to the series.
+ * \param value the new value.
+ *
+ * Each completed pair of a level is averaged and carried to the next level, such that a push costs on average two updates.
+ */
+void StreamingStatistics::push(const double value)
+{
+    double blockValue = value;
+    for (unsigned long iLevel = 0;; iLevel++)
+    {
+        if (iLevel == m_levels.size()) {
+            m_levels.emplace_back();
+        }
+        BlockingLevel &level = m_levels[iLevel];
+        addToMoments(level.moments, blockValue);
+
+        if (!level.hasPending) {
+            level.pending = blockValue;
+            level.hasPending = true;
+            return;
+        }
+
+        blockValue = 0.5 * (level.pending + blockValue);
+        level.hasPending = false;
+    }
+}
+
+/*!
+ * \brief StreamingStatistics::reset removes all values.
+ */
+void StreamingStatistics::reset()
+{
+    m_levels.clear();
+    m_levels.resize(1);
+}
+
+/*!
+ * \brief StreamingStatistics::getVariance
+ * \return the variance of the values, normalized by the number of values.
+ */
+double StreamingStatistics::getVariance() const
+{
+    if (getCount() == 0) return 0;
+    return m_levels[0].moments.M2 / double(getCount());
+}
+
+/*!
+ * \brief StreamingStatistics::getStandardError
+ * \return the standard error of the mean, assuming uncorrelated values.
+ */
+double StreamingStatistics::getStandardError() const
+{
+    return standardError(m_levels[0].moments);
+}
+
+/*!
+ * \brief StreamingStatistics::getBinnedStandardErrors
+ * \param minimumBlocks the number of blocks a level must have to be included.
+ * \return the standard error of the mean at each blocking level, starting from blocks of a single value.
+ */
+std::vector<double> StreamingStatistics::getBinnedStandardErrors(const unsigned long minimumBlocks) const
+{
+    std::vector<double> errors;
+    for (auto &level : m_levels) {
+        if (level.moments.count < minimumBlocks) break;
+        errors.push_back(standardError(level.moments));
+    }
+    return errors;
+}
+
+/*!
+ * \brief StreamingStatistics::getBinnedStandardError
+ * \param minimumBlocks the number of blocks a level must have to be included.
+ * \return the largest standard error over the blocking levels, or the unbinned standard error if the series is too short to be blocked.
+ *
+ * The error grows with the block length until the blocks are uncorrelated, after which it reaches a plateau. The largest error among the
+ * levels with enough blocks to be trusted is thus a conservative estimate of the plateau.
+ */
+double StreamingStatistics::getBinnedStandardError(const unsigned long minimumBlocks) const
+{
+    double error = getStandardError();
+    for (auto levelError : getBinnedStandardErrors(minimumBlocks)) {
+        if (levelError > error) error = levelError;
+    }
+    return error;
+}
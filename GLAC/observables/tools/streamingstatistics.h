@@ -0,0 +1,61 @@
+/*!
+ * \class StreamingStatistics
+ *
+ * \brief Accumulates the mean, variance and binned errors of a series of values one value at a time.
+ *
+ * The mean and variance are updated with the algorithm of Welford, with the update of the mean compensated as in Kahan summation,
+ * such that long series do not lose precision as a naive sum of squares does. The values are also averaged pairwise into blocks of
+ * 2, 4, 8, ... values, keeping the mean and variance of each blocking level. The standard error of the mean at a level where the blocks
+ * are longer than the autocorrelation time is a reliable error estimate for correlated Monte Carlo data, see Flyvbjerg and Petersen 1989.
+ *
+ * Memory is independent of the length of the series.
+ *
+ * \author Mathias M. Vege
+ * \version 1.0
+ * \date 2017-2019
+ * \copyright MIT Licence
+ */
+#ifndef STREAMINGSTATISTICS_H
+#define STREAMINGSTATISTICS_H
+
+#include <vector>
+
+class StreamingStatistics
+{
+private:
+    // Running mean and variance of a series, as given by Welford
+    struct Moments {
+        unsigned long count = 0;
+        double mean = 0;
+        double meanCompensation = 0;
+        double M2 = 0;
+    };
+
+    // A blocking level holds the moments of its blocks, and the first half of a block not yet completed
+    struct BlockingLevel {
+        Moments moments;
+        double pending = 0;
+        bool hasPending = false;
+    };
+
+    // Levels of block length 1, 2, 4, ...
+    std::vector<BlockingLevel> m_levels;
+
+    static void addToMoments(Moments &moments, const double value);
+    static double standardError(const Moments &moments);
+public:
+    StreamingStatistics();
+
+    void push(const double value);
+    void reset();
+
+    // Getters
+    unsigned long getCount() const { return m_levels[0].moments.count; }
+    double getMean() const { return m_levels[0].moments.mean; }
+    double getVariance() const;
+    double getStandardError() const;
+    std::vector<double> getBinnedStandardErrors(const unsigned long minimumBlocks = 32) const;
+    double getBinnedStandardError(const unsigned long minimumBlocks = 32) const;
+};
+
+#endif // STREAMINGSTATISTICS_H
@@ -0,0 +1,81 @@
+#include "thermalizationdetector.h"
+#include "autocorrelationestimator.h"
+#include <cmath>
+
+/*!
+ * \brief ThermalizationDetector::ThermalizationDetector
+ * \param window the number of values in each of the two windows compared.
+ * \param tolerance the largest difference of the window means, in units of its standard error, for the chain to be considered thermalized.
+ */
+ThermalizationDetector::ThermalizationDetector(const unsigned int window, const double tolerance) : m_window(window), m_tolerance(tolerance)
+{
+}
+
+/*!
+ * \brief ThermalizationDetector::push adds a value, discarding values older than the two windows.
+ * \param value the new value.
+ */
+void ThermalizationDetector::push(const double value)
+{
+    m_values.push_back(value);
+    if (m_values.size() > 2*m_window) {
+        m_values.pop_front();
+    }
+}
+
+/*!
+ * \brief ThermalizationDetector::windowStatistics
+ * \param first index of the first value of the window.
+ * \param mean the mean of the window.
+ * \param squaredError the squared standard error of the mean, corrected by the integrated autocorrelation time of the window.
+ */
+void ThermalizationDetector::windowStatistics(const unsigned long first, double &mean, double &squaredError) const
+{
+    // Lags beyond a quarter of the window are too noisy to be of use
+    AutocorrelationEstimator autocorrelation(m_window/4 > 0 ? m_window/4 : 1);
+
+    mean = 0;
+    for (unsigned long i = first; i < first + m_window; i++) {
+        mean += m_values[i];
+        autocorrelation.push(m_values[i]);
+    }
+    mean /= double(m_window);
+
+    double variance = 0;
+    for (unsigned long i = first; i < first + m_window; i++) {
+        variance += (m_values[i] - mean)*(m_values[i] - mean);
+    }
+    variance /= double(m_window - 1);
+
+    squaredError = 2.0 * autocorrelation.getIntegratedAutocorrelationTime() * variance / double(m_window);
+}
+
+/*!
+ * \brief ThermalizationDetector::isThermalized
+ * \return true if both windows are filled and their means agree within the tolerance.
+ */
+bool ThermalizationDetector::isThermalized()
+{
+    if (m_values.size() < 2*m_window) return false;
+
+    double oldMean, oldSquaredError, newMean, newSquaredError;
+    windowStatistics(0, oldMean, oldSquaredError);
+    windowStatistics(m_window, newMean, newSquaredError);
+
+    m_difference = newMean - oldMean;
+    m_differenceError = sqrt(oldSquaredError + newSquaredError);
+
+    return fabs(m_difference) <= m_tolerance * m_differenceError;
+}
+
+/*!
+ * \brief ThermalizationDetector::setValues restores the values, e.g. from a checkpoint.
+ * \param values the values, oldest first.
+ */
+void ThermalizationDetector::setValues(const std::vector<double> &values)
+{
+    m_values.clear();
+    for (auto value : values) {
+        push(value);
+    }
+}
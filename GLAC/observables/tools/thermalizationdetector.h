@@ -0,0 +1,51 @@
+/*!
+ * \class ThermalizationDetector
+ *
+ * \brief Decides when a Markov chain has thermalized from the series of an observable, e.g. the plaquette after each update.
+ *
+ * The most recent values are split into two windows of equal length. The chain is considered thermalized when the means of the two windows
+ * agree within a tolerance given in units of the standard error of their difference. The standard error of each window is corrected with its
+ * integrated autocorrelation time, such that correlated fluctuations are not mistaken for a drift. A remaining drift within a window inflates the
+ * variance far less than it separates the means, so a chain that is still drifting is not considered thermalized.
+ *
+ * \author Mathias M. Vege
+ * \version 1.0
+ * \date 2017-2019
+ * \copyright MIT Licence
+ */
+#ifndef THERMALIZATIONDETECTOR_H
+#define THERMALIZATIONDETECTOR_H
+
+#include <deque>
+#include <vector>
+
+class ThermalizationDetector
+{
+private:
+    unsigned int m_window;
+    double m_tolerance;
+
+    // The values of the two most recent windows, oldest first
+    std::deque<double> m_values;
+
+    // Difference of the window means, and its standard error
+    double m_difference = 0;
+    double m_differenceError = 0;
+
+    void windowStatistics(const unsigned long first, double &mean, double &squaredError) const;
+public:
+    ThermalizationDetector(const unsigned int window, const double tolerance);
+
+    void push(const double value);
+    bool isThermalized();
+
+    // Getters
+    double getDifference() const { return m_difference; }
+    double getDifferenceError() const { return m_differenceError; }
+    std::vector<double> getValues() const { return std::vector<double>(m_values.begin(), m_values.end()); }
+
+    // Setters
+    void setValues(const std::vector<double> &values);
+};
+
+#endif // THERMALIZATIONDETECTOR_H
@@ -2,6 +2,7 @@
 #include "math/functions.h"
 #include "parallelization/parallel.h"
 #include "config/parameters.h"
+#include "instrumentation/timers.h"
 #include <cmath>
 
 TopologicalCharge::TopologicalCharge(const bool storeFlowObservable) : Correlator(storeFlowObservable)
@@ -28,6 +29,7 @@ void TopologicalCharge::calculate(Lattice<SU3> *lattice, const unsigned int iObs
     /*
      * Function to be used when no clover is provided. SHOULD BE TESTED
      */
+    GLAC_TIMER(OBSERVABLE_TOPOLOGICAL_CHARGE);
     m_topCharge = 0;
     mu = 0;
 
@@ -1,10 +1,17 @@
 #include "communicator.h"
+#include "haloexchange.h"
 #include "neighbours.h"
 #include "index.h"
+#include "linkwindow.h"
 #include "parallelparameters.h"
+#include "phasetimer.h"
+#include "processgrid.h"
 #include "config/parameters.h"
 #include <mpi.h>
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <string>
 #include "math/lattice.h"
 
 // Internal variables
@@ -16,6 +23,7 @@ std::vector<unsigned int> Parallel::Communicator::m_N = {0,0,0,0};
 int Parallel::Communicator::m_processRank = 0;
 int Parallel::Communicator::m_numprocs = 0;
 int Parallel::Communicator::m_processorsPerDimension[4] = {0,0,0,0};
+int Parallel::Communicator::m_group = 0;
 
 using Parallel::Neighbours;
 
@@ -30,104 +38,93 @@ Parallel::Communicator::~Communicator()
 /*!
  * \brief Parallel::Communicator::MPIfetchSU3Positive fetches a SU3 matrix in the from the neighboring processor in front.
  * \param lattice a lattice pointer for all four dimensions.
- * \param n position in lattice to fetch link from.
+ * \param iSite storage index of the link to send to the processor behind, the same link is received from the processor in front.
  * \param mu direction to shift in. Always positive in x, y, z and t directions.
  * \param SU3Dir the dimension we are to shift lattice in, i.e. the index of the Lattice pointer.
  */
-void Parallel::Communicator::MPIfetchSU3Positive(Lattice<SU3> *lattice, std::vector<int> n, const int mu, const int SU3Dir)
+void Parallel::Communicator::MPIfetchSU3Positive(Lattice<SU3> *lattice, const unsigned long iSite, const int mu, const int SU3Dir)
 {
     /*
      * Performs an MPI call to retrieve matrix in the positive direction.
      * Arguments:
      *  lattice     : the entire lattice passed
-     *  n           : position vector
+     *  iSite       : storage index of the link to send
      *  mu          : lorentz index for shift direction(always positive in either x,y,z or t direction)
      *  SU3Dir      : SU3 matrix direction at link
      */
-    MPI_Sendrecv(&lattice[SU3Dir][Index::getIndex(n[0],n[1],n[2],n[3])],18,MPI_DOUBLE,Neighbours::getNeighbours(m_processRank)->list[2*mu],0, // Send
-            &exchangeU,18,MPI_DOUBLE,Neighbours::getNeighbours(m_processRank)->list[2*mu+1],0,                                               // Receive
+    ScopedPhase haloExchange(HALO_EXCHANGE);
+    MPI_Sendrecv(&lattice[SU3Dir][iSite],18,MPI_DOUBLE,Neighbours::getNeighbours(m_processRank)->list[2*mu],0, // Send
+            &exchangeU,18,MPI_DOUBLE,Neighbours::getNeighbours(m_processRank)->list[2*mu+1],0,               // Receive
             Parallel::ParallelParameters::ACTIVE_COMM,MPI_STATUS_IGNORE);
 }
 
 /*!
  * \brief Parallel::Communicator::MPIfetchSU3Negative fetches a SU3 matrix in the from the neighboring processor in front.
  * \param lattice a lattice pointer for all four dimensions.
- * \param n position in lattice to fetch link from.
+ * \param iSite storage index of the link to send to the processor in front, the same link is received from the processor behind.
  * \param mu direction to shift in. Always negative in x, y, z and t directions.
  * \param SU3Dir the dimension we are to shift lattice in, i.e. index of the Lattice pointer.
  */
-void Parallel::Communicator::MPIfetchSU3Negative(Lattice<SU3> *lattice, std::vector<int> n, const int mu, const int SU3Dir)
+void Parallel::Communicator::MPIfetchSU3Negative(Lattice<SU3> *lattice, const unsigned long iSite, const int mu, const int SU3Dir)
 {
     /*
      * Performs an MPI call to retrieve matrix in the negative direction.
      * Arguments:
      *  lattice     : the entire lattice passed
-     *  n           : position vector
+     *  iSite       : storage index of the link to send
      *  mu          : lorentz index for shift direction(always negative in either x,y,z or t direction)
      *  SU3Dir      : SU3 matrix direction at link
      */
-    MPI_Sendrecv(&lattice[SU3Dir][Index::getIndex(n[0],n[1],n[2],n[3])],18,MPI_DOUBLE,Neighbours::getNeighbours(m_processRank)->list[2*mu+1],0,  // Send
-            &exchangeU,18,MPI_DOUBLE,Neighbours::getNeighbours(m_processRank)->list[2*mu],0,                                            // Receive
+    ScopedPhase haloExchange(HALO_EXCHANGE);
+    MPI_Sendrecv(&lattice[SU3Dir][iSite],18,MPI_DOUBLE,Neighbours::getNeighbours(m_processRank)->list[2*mu+1],0,  // Send
+            &exchangeU,18,MPI_DOUBLE,Neighbours::getNeighbours(m_processRank)->list[2*mu],0,                    // Receive
             Parallel::ParallelParameters::ACTIVE_COMM,MPI_STATUS_IGNORE);
 }
 
 /*!
  * \brief Parallel::Communicator::getPositiveLink fetches a link in the positive direction.
  * \param lattice a lattice pointer for all four dimensions.
- * \param n position in lattice to fetch link from.
- * \param mu direction to shift in. Always negative in x, y, z and t directions. Index is the same as the step direction of muIndex.
- * \param muIndex is a unit vector containing a step in the direction of sharing. It is \f$\hat{\mu}\f$ in \f$U_\nu (n + \hat{\mu}) \f$.
+ * \param iSite storage index of the site \f$n\f$.
+ * \param mu direction to step in. It is \f$\hat{\mu}\f$ in \f$U_\nu (n + \hat{\mu}) \f$.
  * \param SU3Dir is the index of the tensor \f$\mu\f$ in link \f$U_{\mu}\f$.
  * \return fetched SU3 matrix.
+ *
+ * The neighbouring site is looked up in the neighbour tables of Index. On the face, it wraps around to the site whose link the
+ * processor sends to the processor behind, as all processors step in the same direction at the same time.
  */
-SU3 Parallel::Communicator::getPositiveLink(Lattice<SU3> *lattice, std::vector<int> n, const int mu, int *muIndex, const int SU3Dir)
+const SU3 &Parallel::Communicator::getPositiveLink(Lattice<SU3> *lattice, const unsigned long iSite, const int mu, const int SU3Dir)
 {
-    /*
-     * Function for retrieving link in positive direction.
-     * Takes:
-     *  lattice     : constisting of links
-     *  n           : position vector in lattice
-     *  mu          : lorentz index mu
-     *  muIndex     : lorentz "vector"
-     *  SU3Dir      : which of the four SU3 matrices which we need
-     */
-    if ((n[mu]+muIndex[mu]) % m_N[mu] == 0) {
-        n[mu] = 0;
-        MPIfetchSU3Positive(lattice,n,mu,SU3Dir);
+    if (Index::isOnFace(iSite, 2*mu+1)) {
+        if (LinkWindow::isAttached(lattice)) {
+            return LinkWindow::getFaceLink(SU3Dir, 2*mu+1, Index::getHaloIndex(iSite, mu));
+        }
+        MPIfetchSU3Positive(lattice,Index::getNeighbourIndex(iSite, 2*mu+1),mu,SU3Dir);
         return exchangeU;
     }
     else {
-        return lattice[SU3Dir][Index::getIndex(n[0]+muIndex[0], n[1]+muIndex[1], n[2]+muIndex[2], n[3]+muIndex[3])];
+        return lattice[SU3Dir][Index::getNeighbourIndex(iSite, 2*mu+1)];
     }
 }
 
 /*!
  * \brief Parallel::Communicator::getNegativeLink fetches a link in the negative direction.
  * \param lattice a lattice pointer for all four dimensions.
- * \param n position in lattice to fetch link from.
- * \param mu direction to shift in. Always negative in x, y, z and t directions. Index is the same as the step direction of muIndex.
- * \param muIndex is a unit vector containing a step in the direction of sharing. It is \f$\hat{\mu}\f$ in \f$U_\nu (n + \hat{\mu}) \f$.
+ * \param iSite storage index of the site \f$n\f$.
+ * \param mu direction to step in. It is \f$\hat{\mu}\f$ in \f$U_\nu (n - \hat{\mu}) \f$.
  * \param SU3Dir is the index of the tensor \f$\mu\f$ in link \f$U_{\mu}\f$.
  * \return fetched SU3 matrix.
  */
-SU3 Parallel::Communicator::getNegativeLink(Lattice<SU3> *lattice, std::vector<int> n, const int mu, int *muIndex, const int SU3Dir)
+const SU3 &Parallel::Communicator::getNegativeLink(Lattice<SU3> *lattice, const unsigned long iSite, const int mu, const int SU3Dir)
 {
-    /*
-     * Function for retrieving link in negative direction.
-     * Takes:
-     *  lattice     : constisting of links
-     *  n           : position vector in lattice
-     *  mu          : lorentz index mu
-     *  muIndex     : lorentz "vector"
-     *  SU3Dir      : which of the four SU3 matrices which we need
-     */
-    if ((n[mu] - muIndex[mu] + m_N[mu]) % m_N[mu] == (m_N[mu] - 1)) {
-        n[mu] = m_N[mu] - 1;
-        MPIfetchSU3Negative(lattice,n,mu,SU3Dir);
+    if (Index::isOnFace(iSite, 2*mu)) {
+        if (LinkWindow::isAttached(lattice)) {
+            return LinkWindow::getFaceLink(SU3Dir, 2*mu, Index::getHaloIndex(iSite, mu));
+        }
+        MPIfetchSU3Negative(lattice,Index::getNeighbourIndex(iSite, 2*mu),mu,SU3Dir);
         return exchangeU;
     }
     else {
-        return lattice[SU3Dir][Index::getIndex(n[0]-muIndex[0], n[1]-muIndex[1], n[2]-muIndex[2], n[3]-muIndex[3])];
+        return lattice[SU3Dir][Index::getNeighbourIndex(iSite, 2*mu)];
     }
 }
 
@@ -137,165 +134,94 @@ SU3 Parallel::Communicator::getNegativeLink(Lattice<SU3> *lattice, std::vector<i
  * Fetches the link when it is given as \f$U_\mu(n + \hat{\mu} - \hat{\nu})\f$.
  *
  * \param lattice a lattice pointer for all four dimensions.
- * \param n position in lattice to fetch link from.
- * \param mu index of the muIndex vector we are sharing.
- * \param muIndex is a unit vector containing a step in the direction of sharing.
- * \param nu index of the nuIndex vector we are sharing.
- * \param nuIndex is a unit vector containing a step in the direction of sharing.
+ * \param iSite storage index of the site \f$n\f$.
+ * \param mu the direction of the positive step.
+ * \param nu the direction of the negative step.
  * \param SU3Dir is the index of the tensor \f$\mu\f$ in link \f$U_{\mu}\f$.
  * \return the fetched SU3 matrix.
  */
-SU3 Parallel::Communicator::getNeighboursNeighbourLink(Lattice<SU3> * lattice, std::vector<int> n, const int mu, int *muIndex, const int nu, int *nuIndex, const int SU3Dir)
+const SU3 &Parallel::Communicator::getNeighboursNeighbourLink(Lattice<SU3> * lattice, const unsigned long iSite, const int mu, const int nu, const int SU3Dir)
 {
     /*
      * Gets the neighbours neighbour link.
      * mu: positive direction
      * nu: negative direction
-     *
-     * Takes:
-     *  lattice     : constisting of links
-     *  n           : position vector in lattice
-     *  mu          : lorentz index mu
-     *  muIndex     : lorentz "vector"
-     *  nu          : lorentz index nu
-     *  nuIndex     : lorentz "vector"
-     *  SU3Dir      : which of the four SU3 matrices which we need
      */
-    muDir = (n[mu] + muIndex[mu]) % m_N[mu] == 0;
-    nuDir = (n[nu] - nuIndex[nu] + m_N[nu]) % m_N[nu] == (m_N[nu] - 1);
-    if (muDir && (!nuDir)) { // (muDir & ~nuDir)
-        // Positive mu direction
-        n[mu] = 0;
-        MPI_Sendrecv(&lattice[SU3Dir][Index::getIndex(n[0]-nuIndex[0],n[1]-nuIndex[1],n[2]-nuIndex[2],n[3]-nuIndex[3])],18,MPI_DOUBLE, Neighbours::getNeighbours(m_processRank)->list[2*mu],0,   // Send
-                &exchangeU,18,MPI_DOUBLE,Neighbours::getNeighbours(m_processRank)->list[2*mu+1],0,                                                                                              // Receive
-                Parallel::ParallelParameters::ACTIVE_COMM,MPI_STATUS_IGNORE);
-        return exchangeU;
-    }
-    else if (nuDir && (!muDir)) { // (nuDir & ~muDir)
-        // Negative nu direction
-        n[nu] = m_N[nu] - 1;
-        MPI_Sendrecv(&lattice[SU3Dir][Index::getIndex(n[0]+muIndex[0],n[1]+muIndex[1],n[2]+muIndex[2],n[3]+muIndex[3])],18,MPI_DOUBLE, Neighbours::getNeighbours(m_processRank)->list[2*nu+1],0, // Send
-                &exchangeU,18,MPI_DOUBLE,Neighbours::getNeighbours(m_processRank)->list[2*nu],0,                                                                                        // Receive
-                Parallel::ParallelParameters::ACTIVE_COMM,MPI_STATUS_IGNORE);
-        return exchangeU;
-    }
-    else if (muDir && nuDir) { // muDir & nuDir
-        // True edge case
-        n[mu] = 0;
-        n[nu] = m_N[nu] - 1;
-        MPI_Sendrecv(&lattice[SU3Dir][Index::getIndex(n[0],n[1],n[2],n[3])],18,MPI_DOUBLE, Neighbours::getNeighbours((Neighbours::getNeighbours(m_processRank)->list[2*mu]))->list[2*nu+1],0,// Send
-                &exchangeU,18,MPI_DOUBLE,Neighbours::getNeighbours((Neighbours::getNeighbours(m_processRank)->list[2*mu+1]))->list[2*nu],0,                                             // Receive
-                Parallel::ParallelParameters::ACTIVE_COMM,MPI_STATUS_IGNORE);
-        return exchangeU;
-    }
-    else {
-        return lattice[SU3Dir][Index::getIndex(n[0]+muIndex[0]-nuIndex[0], n[1]+muIndex[1]-nuIndex[1], n[2]+muIndex[2]-nuIndex[2], n[3]+muIndex[3]-nuIndex[3])];
+    muDir = Index::isOnFace(iSite, 2*mu+1);
+    nuDir = Index::isOnFace(iSite, 2*nu);
+    // The site wrapped around the sub lattice in the directions it leaves it, which is the link to send in either case
+    const unsigned long iNeighbour = Index::getNeighbourIndex(Index::getNeighbourIndex(iSite, 2*nu), 2*mu+1);
+    if ((muDir || nuDir) && LinkWindow::isAttached(lattice)) {
+        // Links of other processors fetched in advance
+        if (muDir && nuDir) {
+            return LinkWindow::getEdgeLink(SU3Dir, mu, nu, Index::getHaloIndex(iSite, mu));
+        }
+        else if (muDir) {
+            return LinkWindow::getFaceLink(SU3Dir, 2*mu+1, Index::getHaloIndex(Index::getNeighbourIndex(iSite, 2*nu), mu));
+        }
+        else {
+            return LinkWindow::getFaceLink(SU3Dir, 2*nu, Index::getHaloIndex(Index::getNeighbourIndex(iSite, 2*mu+1), nu));
+        }
     }
-}
-
-/*!
- * \brief Parallel::Communicator::getNeighboursNeighbourNegativeLink
- *
- * Fetches the link when it is given as \f$U_\mu(n - \hat{\mu} - \hat{\nu})\f$.
- *
- * \param lattice a lattice pointer for all four dimensions.
- * \param n position in lattice to fetch link from.
- * \param mu index of the muIndex vector we are sharing.
- * \param muIndex is a unit vector containing a step in the direction of sharing.
- * \param nu index of the nuIndex vector we are sharing.
- * \param nuIndex is a unit vector containing a step in the direction of sharing.
- * \param SU3Dir is the index of the tensor \f$\mu\f$ in link \f$U_{\mu}\f$.
- * \return the fetched SU3 matrix.
- *
- * \todo Should probably pass n by reference, and set all elements as const.
- */
-SU3 Parallel::Communicator::getNeighboursNeighbourNegativeLink(Lattice<SU3> * lattice, std::vector<int> &n, const int mu, int *muIndex, const int nu, int *nuIndex, const int SU3Dir)
-{
-    /*
-     * Gets the neighbours neighbour link.
-     * mu: negative direction
-     * nu: negative direction
-     *
-     * Takes:
-     *  lattice     : constisting of links
-     *  n           : position vector in lattice
-     *  mu          : lorentz index mu
-     *  muIndex     : lorentz "vector"
-     *  nu          : lorentz index nu
-     *  nuIndex     : lorentz "vector"
-     *  SU3Dir      : which of the four SU3 matrices which we need
-     */
-    muDir = (n[mu] - muIndex[mu] + m_N[mu]) % m_N[mu] == (m_N[mu] - 1);
-    nuDir = (n[nu] - nuIndex[nu] + m_N[nu]) % m_N[nu] == (m_N[nu] - 1);
-    if (muDir && (!nuDir)) { // (muDir & ~nuDir)
+    else if (muDir && (!nuDir)) { // (muDir & ~nuDir)
         // Positive mu direction
-        n[mu] = m_N[mu] - 1;
-        MPI_Sendrecv(&lattice[SU3Dir][Index::getIndex(n[0]-nuIndex[0],n[1]-nuIndex[1],n[2]-nuIndex[2],n[3]-nuIndex[3])],18,MPI_DOUBLE, Neighbours::getNeighbours(m_processRank)->list[2*mu],0,   // Send
-                &exchangeU,18,MPI_DOUBLE,Neighbours::getNeighbours(m_processRank)->list[2*mu+1],0,                                                                                               // Receive
+        ScopedPhase haloExchange(HALO_EXCHANGE);
+        MPI_Sendrecv(&lattice[SU3Dir][iNeighbour],18,MPI_DOUBLE, Neighbours::getNeighbours(m_processRank)->list[2*mu],0,   // Send
+                &exchangeU,18,MPI_DOUBLE,Neighbours::getNeighbours(m_processRank)->list[2*mu+1],0,                          // Receive
                 Parallel::ParallelParameters::ACTIVE_COMM,MPI_STATUS_IGNORE);
         return exchangeU;
     }
     else if (nuDir && (!muDir)) { // (nuDir & ~muDir)
         // Negative nu direction
-        n[nu] = m_N[nu] - 1;
-        MPI_Sendrecv(&lattice[SU3Dir][Index::getIndex(n[0]-muIndex[0],n[1]-muIndex[1],n[2]-muIndex[2],n[3]-muIndex[3])],18,MPI_DOUBLE, Neighbours::getNeighbours(m_processRank)->list[2*nu+1],0, // Send
-                &exchangeU,18,MPI_DOUBLE,Neighbours::getNeighbours(m_processRank)->list[2*nu],0,                                                                                        // Receive
+        ScopedPhase haloExchange(HALO_EXCHANGE);
+        MPI_Sendrecv(&lattice[SU3Dir][iNeighbour],18,MPI_DOUBLE, Neighbours::getNeighbours(m_processRank)->list[2*nu+1],0, // Send
+                &exchangeU,18,MPI_DOUBLE,Neighbours::getNeighbours(m_processRank)->list[2*nu],0,                            // Receive
                 Parallel::ParallelParameters::ACTIVE_COMM,MPI_STATUS_IGNORE);
         return exchangeU;
     }
     else if (muDir && nuDir) { // muDir & nuDir
         // True edge case
-        n[mu] = m_N[mu] - 1;
-        n[nu] = m_N[nu] - 1;
-        MPI_Sendrecv(&lattice[SU3Dir][Index::getIndex(n[0],n[1],n[2],n[3])],18,MPI_DOUBLE, Neighbours::getNeighbours((Neighbours::getNeighbours(m_processRank)->list[2*mu]))->list[2*nu+1],0,// Send
-                &exchangeU,18,MPI_DOUBLE,Neighbours::getNeighbours((Neighbours::getNeighbours(m_processRank)->list[2*mu+1]))->list[2*nu],0,                                             // Receive
+        ScopedPhase haloExchange(HALO_EXCHANGE);
+        MPI_Sendrecv(&lattice[SU3Dir][iNeighbour],18,MPI_DOUBLE, Neighbours::getNeighbours((Neighbours::getNeighbours(m_processRank)->list[2*mu]))->list[2*nu+1],0,// Send
+                &exchangeU,18,MPI_DOUBLE,Neighbours::getNeighbours((Neighbours::getNeighbours(m_processRank)->list[2*mu+1]))->list[2*nu],0,                 // Receive
                 Parallel::ParallelParameters::ACTIVE_COMM,MPI_STATUS_IGNORE);
         return exchangeU;
     }
     else {
-        return lattice[SU3Dir][Index::getIndex(n[0]-muIndex[0]-nuIndex[0], n[1]-muIndex[1]-nuIndex[1], n[2]-muIndex[2]-nuIndex[2], n[3]-muIndex[3]-nuIndex[3])];
+        return lattice[SU3Dir][iNeighbour];
     }
 }
 
 /*!
  * \brief Parallel::Communicator::reduceToTemporalDimension reduces the results to the temporal dimensions, i.e. Euclidean time.
- * \param obsResults contigious vector that results will be placed in.
- * \param obs vector we are gathering results in.
+ * \param obsResults contigious vector that results will be placed in, of NT values per flow time.
+ * \param obs vector we are gathering results in, of the sub lattice temporal extent per flow time.
+ *
+ * All flow times are placed in a single (NFlows+1) x NT buffer, such that the results are summed with one MPI_Reduce.
  *
- * \todo Should probably pass by the obs by reference.
- * \todo Should probably set obs as const.
+ * \note The result is only valid on the root, i.e. rank 0 of ParallelParameters::ACTIVE_COMM. obsResults is left as it
+ * was on all other processors, so a caller that needs the result elsewhere must broadcast it.
  */
 void Parallel::Communicator::reduceToTemporalDimension(std::vector<double> &obsResults, const std::vector<double> &obs)
 {
     /*
      * Reduces flow results in matrix format to a the temporal dimension
      */
-    // Sets up the temporary buffers
-    double tempSend[Parameters::getNTemporal()];
-    double tempRecv[Parameters::getNTemporal()];
-    for (unsigned long int it = 0; it < Parameters::getNTemporal(); it++) {
-        tempSend[it] = 0;
-        tempRecv[it] = 0;
-    }
+    ScopedPhase reduction(REDUCTION);
 
-    for (unsigned long int iFlow = 0; iFlow < Parameters::getNFlows() + 1; iFlow++) {
-        // Places obs values into temporary buffer
-        for (unsigned long int it = 0; it < m_N[3]; it++) {
-            tempSend[it + m_N[3]*Neighbours::getProcessorDimensionPosition(3)] = obs[iFlow * m_N[3] + it];
-        }
-
-        MPI_Reduce(tempSend, tempRecv, Parameters::getNTemporal(), MPI_DOUBLE, MPI_SUM, 0, ParallelParameters::ACTIVE_COMM);
-
-        for (unsigned long int it = 0; it < Parameters::getNTemporal(); it++) {
-            obsResults[iFlow * Parameters::getNTemporal() + it] = tempRecv[it];
-        }
+    const unsigned long NT = Parameters::getNTemporal();
+    const unsigned long NFlowTimes = Parameters::getNFlows() + 1;
+    const unsigned long tOffset = m_N[3]*Neighbours::getProcessorDimensionPosition(3);
 
-        // Resets temporary buffer
-        for (unsigned long int it = 0; it < Parameters::getNTemporal(); it++) {
-            tempSend[it] = 0;
-            tempRecv[it] = 0;
+    // Places obs values at the Euclidean times of the sub lattice, leaving the rest zero
+    std::vector<double> tempSend(NFlowTimes*NT, 0);
+    for (unsigned long int iFlow = 0; iFlow < NFlowTimes; iFlow++) {
+        for (unsigned long int it = 0; it < m_N[3]; it++) {
+            tempSend[iFlow*NT + tOffset + it] = obs[iFlow * m_N[3] + it];
         }
     }
+
+    MPI_Reduce(tempSend.data(), obsResults.data(), int(NFlowTimes*NT), MPI_DOUBLE, MPI_SUM, 0, ParallelParameters::ACTIVE_COMM);
 }
 
 /*!
@@ -331,7 +257,7 @@ void Parallel::Communicator::checkSubLatticeValidity()
 }
 
 /*!
- * \brief Parallel::Communicator::init initializes the communicater and sets up the lattice geometry.
+ * \brief Parallel::Communicator::init initializes the communicater. All processors are active until the process grid is set up.
  * \param numberOfArguments number of command line arguments.
  * \param cmdLineArguments command line arguments.
  */
@@ -342,62 +268,258 @@ void Parallel::Communicator::init(int *numberOfArguments, char ***cmdLineArgumen
     MPI_Comm_size (MPI_COMM_WORLD, &m_numprocs);
     MPI_Comm_rank (MPI_COMM_WORLD, &m_processRank);
 
+    // Creating world group
+    MPI_Comm_group(MPI_COMM_WORLD, &Parallel::ParallelParameters::WORLD_GROUP);
+
     if ((*numberOfArguments) != 2) {
         MPIExit("Error: please provide a json file to parse.");
     }
 
-    int maxProcRank = m_numprocs;
-    int binaryCounter = 1;
-    int counter = 0;
-    int rest = 0;
+    setActiveProcessors(m_numprocs);
+}
+
+/*!
+ * \brief Parallel::Communicator::initializeGroups splits the processors between an ensemble of independent Markov chains, or between groups
+ * flowing the loaded configurations.
+ *
+ * The processors are split evenly into NChains or NFlowGroups consecutive blocks, each with its own communicator. From here on the rank and
+ * number of processors are those of the group.
+ *
+ * Each chain of an ensemble writes to the batch <batchName>_chain<i>, and the Metropolis seeds are offset by the chain, such that chain 0
+ * is the same as a single chain run on the same number of processors. Flow groups share the batch, and take the configurations to flow from
+ * a WorkQueue. The standard output of all groups but the first is written to a log file in the output folder. Must be called before the
+ * process grid is set up.
+ */
+void Parallel::Communicator::initializeGroups()
+{
+    const int NChains = int(Parameters::getNChains());
+    const int NFlowGroups = int(Parameters::getNFlowGroups());
+    if (NChains == 1 && NFlowGroups == 1) return;
+
+    if (NChains > 1 && NFlowGroups > 1) {
+        MPIExit("Error: an ensemble of chains can not be combined with flow groups --> exiting.");
+    }
+    if (Parameters::getUnitTesting() || Parameters::getPerformanceTesting() || Parameters::getBenchmarking()) {
+        MPIExit("Error: tests and benchmarks can not be split between chains or flow groups --> exiting.");
+    }
+    if (NChains > 1 && Parameters::getLoadFieldConfigurations()) {
+        MPIExit("Error: an ensemble of chains may only be used for generating configurations --> exiting.");
+    }
+    if (NFlowGroups > 1 && (!Parameters::getLoadFieldConfigurations() || Parameters::getNFlows() == 0)) {
+        MPIExit("Error: flow groups may only be used for flowing loaded configurations --> exiting.");
+    }
+    if (NFlowGroups > 1 && Parameters::getBinaryFlowObservables()) {
+        MPIExit("Error: flow groups can not write binary flow observables, as each group writes its own configurations --> exiting.");
+    }
 
-    while ((maxProcRank - binaryCounter) != 0) {
-        binaryCounter = pow(2,counter);
-        counter++;
+    const int NGroups = std::max(NChains, NFlowGroups);
+    const std::string groupName = NChains > 1 ? "chains" : "flow groups";
+    if (m_numprocs % NGroups != 0) {
+        MPIExit("Error: the " + std::to_string(m_numprocs) + " processors can not be split evenly between "
+                + std::to_string(NGroups) + " " + groupName + " --> exiting.");
+    }
 
-        rest = maxProcRank % binaryCounter;
-        if (rest != 0) {
-            maxProcRank -= rest;
+    const int worldRank = m_processRank;
+    const int worldSize = m_numprocs;
+    const int groupSize = worldSize / NGroups;
+    m_group = worldRank / groupSize;
+
+    if (worldRank == 0) {
+        if (NChains > 1) {
+            cout << "\nRunning an ensemble of " << NChains << " chains of " << groupSize << " processors, as batches "
+                 << Parameters::getBatchName() << "_chain0 to " << Parameters::getBatchName() << "_chain" << NChains - 1 << "." << endl;
+        } else {
+            cout << "\nFlowing the configurations in " << NFlowGroups << " groups of " << groupSize << " processors." << endl;
         }
     }
 
-    if (m_processRank >= maxProcRank) {
-        Parallel::ParallelParameters::active = false;
-    } else {
-        Parallel::ParallelParameters::active = true;
+    MPI_Comm_split(MPI_COMM_WORLD, m_group, worldRank, &ParallelParameters::GROUP_COMM);
+    MPI_Comm_rank(ParallelParameters::GROUP_COMM, &m_processRank);
+    MPI_Comm_size(ParallelParameters::GROUP_COMM, &m_numprocs);
+    setActiveProcessors(m_numprocs);
+
+    // Seeds are set per processor of the world when loading, and are made those of the processor in the group
+    Parameters::setMetropolisSeed(Parameters::getMetropolisSeed() - double(worldRank) - double(worldSize) + double(m_group*groupSize));
+    Parameters::setRandomMatrixSeed(Parameters::getRandomMatrixSeed() - double(worldRank) + double(m_group*groupSize));
+
+    std::string logName = Parameters::getBatchName() + "_group" + std::to_string(m_group);
+    if (NChains > 1) {
+        Parameters::setBatchName(Parameters::getBatchName() + "_chain" + std::to_string(m_group));
+        logName = Parameters::getBatchName();
     }
 
-    m_numprocs = maxProcRank;
+    if (m_group != 0 && m_processRank == 0) {
+        const std::string logFile = Parameters::getFilePath() + Parameters::getOutputFolder() + Parameters::getBatchName()
+                + "/" + logName + ".log";
+        if (std::freopen(logFile.c_str(), "w", stdout) == nullptr) {
+            MPIExit("Error: could not open " + logFile + " for the output of the group --> exiting.");
+        }
+    }
+}
 
-    // Creating world group
-    MPI_Comm_group(MPI_COMM_WORLD, &Parallel::ParallelParameters::WORLD_GROUP);
+/*!
+ * \brief Parallel::Communicator::setActiveProcessors creates the communicator of the active processors, which are the lowest ranks.
+ * \param numActive number of active processors.
+ */
+void Parallel::Communicator::setActiveProcessors(const int numActive)
+{
+    // Frees a previous group of active processors
+    if (Parallel::ParallelParameters::ACTIVE_GROUP != MPI_GROUP_NULL) {
+        MPI_Group_free(&Parallel::ParallelParameters::ACTIVE_GROUP);
+    }
+    if (Parallel::ParallelParameters::ACTIVE_COMM != MPI_COMM_NULL) {
+        MPI_Comm_free(&Parallel::ParallelParameters::ACTIVE_COMM);
+    }
+
+    Parallel::ParallelParameters::active = m_processRank < numActive;
+    m_numprocs = numActive;
 
-    // Create group based on active processors
-    int activeProcs[m_numprocs];
-    for (int i = 0; i < m_numprocs; i++) activeProcs[i] = i;
-    MPI_Group_incl(Parallel::ParallelParameters::WORLD_GROUP, m_numprocs,activeProcs, &Parallel::ParallelParameters::ACTIVE_GROUP);
+    // Create group based on active processors of the chain
+    MPI_Group chainGroup;
+    MPI_Comm_group(Parallel::ParallelParameters::GROUP_COMM, &chainGroup);
+    std::vector<int> activeProcs(static_cast<unsigned long>(m_numprocs));
+    for (int i = 0; i < m_numprocs; i++) activeProcs[static_cast<unsigned long>(i)] = i;
+    MPI_Group_incl(chainGroup, m_numprocs, activeProcs.data(), &Parallel::ParallelParameters::ACTIVE_GROUP);
+    MPI_Group_free(&chainGroup);
 
     // Creates a new communications group for all the active processors
-    MPI_Comm_create_group(MPI_COMM_WORLD, Parallel::ParallelParameters::ACTIVE_GROUP, 0, &Parallel::ParallelParameters::ACTIVE_COMM);
+    MPI_Comm_create_group(Parallel::ParallelParameters::GROUP_COMM, Parallel::ParallelParameters::ACTIVE_GROUP, 0, &Parallel::ParallelParameters::ACTIVE_COMM);
+}
+
+/*!
+ * \brief Parallel::Communicator::initializeProcessGrid decides how many processors are used, and how they divide the lattice.
+ *
+ * Unless the sub lattice dimensions are preset, the processors are factorised over the four dimensions by ProcessGrid, such that the
+ * sub-lattices have the smallest surface-to-volume ratio. If the lattice can not be divided between all processors, the largest number
+ * of processors that can is used, and the remaining processors are left inactive. Must be called once the lattice dimensions are known.
+ */
+void Parallel::Communicator::initializeProcessGrid()
+{
+    int worldSize = 0;
+    MPI_Comm_size(ParallelParameters::GROUP_COMM, &worldSize);
+
+    std::vector<unsigned int> N = {Parameters::getNSpatial(), Parameters::getNSpatial(), Parameters::getNSpatial(), Parameters::getNTemporal()};
+    std::vector<unsigned int> grid(4, 1);
+
+    if (Parameters::getSubLatticePreset()) {
+        for (int i = 0; i < 4; i++) {
+            if (m_N[i] == 0 || N[i] % m_N[i] != 0) {
+                MPIExit("Error: sub lattice dimensions do not divide the lattice --> exiting.");
+            }
+            grid[i] = N[i] / m_N[i];
+        }
+    } else {
+        grid = ProcessGrid::largestDecomposition(static_cast<unsigned int>(worldSize), N);
+        if (grid.empty()) {
+            MPIExit("Error: the lattice can not be divided between the processors --> exiting.");
+        }
+    }
+
+    int numActive = 1;
+    for (int i = 0; i < 4; i++) {
+        m_processorsPerDimension[i] = int(grid[i]);
+        numActive *= m_processorsPerDimension[i];
+    }
+
+    if (numActive > worldSize) {
+        MPIExit("Error: sub lattice dimensions require " + std::to_string(numActive) + " processors, but only "
+                + std::to_string(worldSize) + " are available --> exiting.");
+    }
 
-    checkProcessorValidity();
+    if (numActive != m_numprocs) {
+        if (m_processRank == 0) {
+            cout << "\nThe lattice is divided between " << numActive << " of " << worldSize << " processors, "
+                 << worldSize - numActive << " are left inactive." << endl;
+        }
+        setActiveProcessors(numActive);
+    }
+
+    if (Parameters::getCartesianTopology() && Parallel::ParallelParameters::active) {
+        createCartesianCommunicator();
+    }
+
+    // Connects the first active processor of each group, once the ranks within the groups are final
+    if (Parameters::getNChains() > 1 || Parameters::getNFlowGroups() > 1) {
+        const int leader = Parallel::ParallelParameters::active && m_processRank == 0 ? 0 : MPI_UNDEFINED;
+        MPI_Comm_split(MPI_COMM_WORLD, leader, m_group, &ParallelParameters::LEADER_COMM);
+    }
 }
 
 /*!
- * \brief Parallel::Communicator::checkProcessorValidity checks that we do not have an odd number of processors.
+ * \brief Parallel::Communicator::createCartesianCommunicator replaces the communicator of the active processors by a Cartesian communicator.
  *
- * \todo: this could probably be changed such that it just leaves out one processor that is left over.
+ * The active processors are grouped by the node they run on. If each node holds the same number of processors, and the process grid can
+ * be tiled by blocks of that size, the ranks are ordered such that each node holds a block of the grid, spanning the dimensions with the
+ * largest faces first, as given by ProcessGrid::nodeBlock. The halo exchanges across those faces then stay within the node. Otherwise the
+ * placement is left to MPI_Cart_create. The seeds follow the new rank, such that a rank draws the same random numbers wherever it is placed.
  */
-void Parallel::Communicator::checkProcessorValidity()
+void Parallel::Communicator::createCartesianCommunicator()
 {
-    /*
-     * Exits if number of processors are odd.
-     */
-    if (m_numprocs >= 2) {
-        if (m_numprocs % 2 != 0) {
-            MPIExit("Error: odd number of processors --> exiting.");
+    std::vector<unsigned int> N = {Parameters::getNSpatial(), Parameters::getNSpatial(), Parameters::getNSpatial(), Parameters::getNTemporal()};
+    std::vector<unsigned int> grid(4);
+    for (unsigned int i = 0; i < 4; i++) grid[i] = unsigned(m_processorsPerDimension[i]);
+
+    // Groups the processors by node
+    MPI_Comm nodeComm;
+    MPI_Comm_split_type(ParallelParameters::ACTIVE_COMM, MPI_COMM_TYPE_SHARED, m_processRank, MPI_INFO_NULL, &nodeComm);
+    int localRank = 0;
+    int ranksPerNode = 0;
+    MPI_Comm_rank(nodeComm, &localRank);
+    MPI_Comm_size(nodeComm, &ranksPerNode);
+
+    int minRanksPerNode = 0;
+    int maxRanksPerNode = 0;
+    MPI_Allreduce(&ranksPerNode, &minRanksPerNode, 1, MPI_INT, MPI_MIN, ParallelParameters::ACTIVE_COMM);
+    MPI_Allreduce(&ranksPerNode, &maxRanksPerNode, 1, MPI_INT, MPI_MAX, ParallelParameters::ACTIVE_COMM);
+
+    // The nodes are numbered by the rank of their lowest processor among the lowest processors of all nodes
+    MPI_Comm leaderComm;
+    MPI_Comm_split(ParallelParameters::ACTIVE_COMM, localRank == 0 ? 0 : MPI_UNDEFINED, m_processRank, &leaderComm);
+    int node = 0;
+    if (leaderComm != MPI_COMM_NULL) {
+        MPI_Comm_rank(leaderComm, &node);
+        MPI_Comm_free(&leaderComm);
+    }
+    MPI_Bcast(&node, 1, MPI_INT, 0, nodeComm);
+    MPI_Comm_free(&nodeComm);
+
+    std::vector<unsigned int> block;
+    if (minRanksPerNode == maxRanksPerNode) {
+        block = ProcessGrid::nodeBlock(unsigned(ranksPerNode), N, grid);
+    }
+
+    // Reversed, as the last dimension runs fastest in a Cartesian communicator, while x runs fastest in the neighbour lists
+    int dims[4] = {m_processorsPerDimension[3], m_processorsPerDimension[2], m_processorsPerDimension[1], m_processorsPerDimension[0]};
+    int periods[4] = {1, 1, 1, 1};
+    MPI_Comm cartComm;
+    if (!block.empty()) {
+        MPI_Comm orderedComm;
+        const int gridRank = int(ProcessGrid::nodeMappedRank(unsigned(node), unsigned(localRank), grid, block));
+        MPI_Comm_split(ParallelParameters::ACTIVE_COMM, 0, gridRank, &orderedComm);
+        MPI_Cart_create(orderedComm, 4, dims, periods, 0, &cartComm);
+        MPI_Comm_free(&orderedComm);
+    } else {
+        MPI_Cart_create(ParallelParameters::ACTIVE_COMM, 4, dims, periods, 1, &cartComm);
+    }
+
+    if (m_processRank == 0) {
+        if (!block.empty()) {
+            cout << "\nThe process grid is placed on " << m_numprocs / ranksPerNode << " node(s), in blocks of "
+                 << block[0] << " " << block[1] << " " << block[2] << " " << block[3] << " processors." << endl;
+        } else {
+            cout << "\nThe process grid can not be tiled by the nodes, its placement is left to MPI." << endl;
         }
     }
+
+    MPI_Group_free(&ParallelParameters::ACTIVE_GROUP);
+    MPI_Comm_free(&ParallelParameters::ACTIVE_COMM);
+    ParallelParameters::ACTIVE_COMM = cartComm;
+    MPI_Comm_group(ParallelParameters::ACTIVE_COMM, &ParallelParameters::ACTIVE_GROUP);
+
+    const int previousRank = m_processRank;
+    MPI_Comm_rank(ParallelParameters::ACTIVE_COMM, &m_processRank);
+    Parameters::setMetropolisSeed(Parameters::getMetropolisSeed() - double(previousRank) - double(m_numprocs));
+    Parameters::setRandomMatrixSeed(Parameters::getRandomMatrixSeed() - double(previousRank));
 }
 
 /*!
@@ -429,25 +551,14 @@ void Parallel::Communicator::checkSubLatticeDimensionsValidity()
  */
 void Parallel::Communicator::initializeSubLattice()
 {
-    int restProc = m_numprocs;
     unsigned long int subLatticeSize = 1;
 
-    // Only finds the sub lattice size iteratively if no preset value has been defined.
+    // Only divides the lattice by the process grid if no preset value has been defined.
     if (!Parameters::getSubLatticePreset()) {
-        // Sets up sub lattice dimensionality without any splitting
         for (int i = 0; i < 3; i++) {
-            m_N[i] = Parameters::getNSpatial();
-        }
-        m_N[3] = Parameters::getNTemporal();
-
-        // Iteratively finds and sets the sub-lattice dimensions
-        while (restProc >= 2) {
-            for (int i = 0; i < 4; i++) { // Counts from x to t
-                m_N[i] /= 2;
-                restProc /= 2;
-                if (restProc < 2) break;
-            }
+            m_N[i] = Parameters::getNSpatial() / unsigned(m_processorsPerDimension[i]);
         }
+        m_N[3] = Parameters::getNTemporal() / unsigned(m_processorsPerDimension[3]);
 
         // Sets the sub lattice dimensions in case they have not been set in the loading of the configuration.
         Parallel::Index::setN(m_N);
@@ -467,16 +578,31 @@ void Parallel::Communicator::initializeSubLattice()
     // If has a size of 2, we exit as that may produce poor results.
     checkSubLatticeDimensionsValidity();
 
-    // Sets up number of processors per dimension
-    for (int i = 0; i < 3; i++) {
-        m_processorsPerDimension[i] = Parameters::getNSpatial() / m_N[i];
-    }
-    m_processorsPerDimension[3] = Parameters::getNTemporal() / m_N[3];
-
     // Initializes the neighbour lists
     Parallel::Neighbours::initialize(m_processRank, m_numprocs, m_processorsPerDimension);
     Parameters::setProcessorsPerDimension(m_processorsPerDimension);
 
+    // The neighbours of a Cartesian communicator must agree with the neighbour lists
+    int topology = MPI_UNDEFINED;
+    if (Parallel::ParallelParameters::active) {
+        MPI_Topo_test(Parallel::ParallelParameters::ACTIVE_COMM, &topology);
+    }
+    if (topology == MPI_CART) {
+        for (int dim = 0; dim < 4; dim++) {
+            int previous = 0;
+            int next = 0;
+            MPI_Cart_shift(Parallel::ParallelParameters::ACTIVE_COMM, 3 - dim, 1, &previous, &next);
+            if (previous != Neighbours::get(2*dim) || next != Neighbours::get(2*dim + 1)) {
+                MPIExit("Error: the Cartesian communicator does not match the neighbour lists --> exiting.");
+            }
+        }
+    }
+
+    // The shared window of the node, once the neighbours are known
+    if (Parameters::getSharedMemoryHalo() && Parallel::ParallelParameters::active) {
+        HaloExchange::initialize(m_N);
+    }
+
     // Initialize sub-lattices
 
 //    initializseLatticeSharing(Parameters::getN());
@@ -485,11 +611,11 @@ void Parallel::Communicator::initializeSubLattice()
 /*!
  * \brief Parallel::Communicator::setBarrier
  *
- * A MPI_Barrier for all processors.
+ * A MPI_Barrier for all processors of the chain.
  */
 void Parallel::Communicator::setBarrier()
 {
-    MPI_Barrier(MPI_COMM_WORLD);
+    MPI_Barrier(Parallel::ParallelParameters::GROUP_COMM);
 }
 
 /*!
@@ -509,14 +635,25 @@ void Parallel::Communicator::setBarrierActive()
  */
 void Parallel::Communicator::freeMPIGroups()
 {
-    MPI_Group_free(&Parallel::ParallelParameters::WORLD_GROUP);
-    MPI_Group_free(&Parallel::ParallelParameters::ACTIVE_GROUP);
+    // The windows are freed before the communicator they were created from
+    HaloExchange::finalize();
+    LinkWindow::finalize();
+
+    if (Parallel::ParallelParameters::WORLD_GROUP != MPI_GROUP_NULL) {
+        MPI_Group_free(&Parallel::ParallelParameters::WORLD_GROUP);
+    }
+    if (Parallel::ParallelParameters::ACTIVE_GROUP != MPI_GROUP_NULL) {
+        MPI_Group_free(&Parallel::ParallelParameters::ACTIVE_GROUP);
+    }
 
     // Only freeing those who has an active comm, processors who are
     // inactive have MPI_COMM_NULL, are not need to be freed.
     if (Parallel::ParallelParameters::ACTIVE_COMM != MPI_COMM_NULL) {
         MPI_Comm_free(&Parallel::ParallelParameters::ACTIVE_COMM);
     }
+    if (Parallel::ParallelParameters::LEADER_COMM != MPI_COMM_NULL) {
+        MPI_Comm_free(&Parallel::ParallelParameters::LEADER_COMM);
+    }
 }
 
 /*!
@@ -554,6 +691,7 @@ void Parallel::Communicator::MPIPrint(const std::string &message)
 void Parallel::Communicator::gatherDoubleResults(double * data, const unsigned int N)
 {
     double tempData[N];
+    ScopedPhase reduction(REDUCTION);
     MPI_Allreduce(data,tempData,N,MPI_DOUBLE,MPI_SUM,Parallel::ParallelParameters::ACTIVE_COMM);
     for (unsigned long int i = 0; i < N; i++) data[i] = tempData[i];
 }
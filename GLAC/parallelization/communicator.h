@@ -22,6 +22,7 @@ private:
     static int m_processRank;
     static int m_numprocs;
     static int m_processorsPerDimension[4];
+    static int m_group;
 
     // Fetching variables
     static bool muDir;
@@ -32,25 +33,33 @@ private:
     static std::vector<unsigned int> m_N;
 
     // Private fetchSU3 functions
-    inline static void MPIfetchSU3Positive(Lattice<SU3> *lattice, std::vector<int> n, int mu, const int SU3Dir);
-    inline static void MPIfetchSU3Negative(Lattice<SU3> *lattice, std::vector<int> n, int mu, const int SU3Dir);
+    inline static void MPIfetchSU3Positive(Lattice<SU3> *lattice, const unsigned long iSite, const int mu, const int SU3Dir);
+    inline static void MPIfetchSU3Negative(Lattice<SU3> *lattice, const unsigned long iSite, const int mu, const int SU3Dir);
+
+    // Sets the lowest ranks as the active processors
+    static void setActiveProcessors(const int numActive);
+
+    // Replaces the active communicator by a Cartesian communicator placing the process grid on the nodes
+    static void createCartesianCommunicator();
 public:
     Communicator();
     ~Communicator();
 
     // Initializers
     static void init(int *numberOfArguments, char ***cmdLineArguments);
+    static void initializeGroups();
+    static void initializeProcessGrid();
     static void initializeSubLattice();
 
     // Link getters
-    static SU3 getPositiveLink(Lattice<SU3> *lattice, std::vector<int> n, int mu, int *muIndex, const int SU3Dir);
-    static SU3 getNegativeLink(Lattice<SU3> *lattice, std::vector<int> n, const int mu, int *muIndex, const int SU3Dir);
-    static SU3 getNeighboursNeighbourLink(Lattice<SU3> * lattice, std::vector<int> n , int mu, int *muIndex, const int nu, int *nuIndex, const int SU3Dir);
-    static SU3 getNeighboursNeighbourNegativeLink(Lattice<SU3> * lattice, std::vector<int> &n, const int mu, int *muIndex, const int nu, int *nuIndex, const int SU3Dir);
+    static const SU3 &getPositiveLink(Lattice<SU3> *lattice, const unsigned long iSite, const int mu, const int SU3Dir);
+    static const SU3 &getNegativeLink(Lattice<SU3> *lattice, const unsigned long iSite, const int mu, const int SU3Dir);
+    static const SU3 &getNeighboursNeighbourLink(Lattice<SU3> * lattice, const unsigned long iSite, const int mu, const int nu, const int SU3Dir);
 
     // Getters
     static int getProcessRank() { return m_processRank; }
     static int getNumProc() { return m_numprocs; }
+    static int getGroup() { return m_group; }
 
     // Setters
     static void setN(const std::vector<unsigned int> &N);
@@ -67,7 +76,6 @@ public:
     static void reduceToTemporalDimension(std::vector<double> &obsResults, const std::vector<double> &obs);
 
     // Validity checkers
-    static void checkProcessorValidity();
     static void checkSubLatticeDimensionsValidity();
     static void checkSubLatticeValidity();
 
@@ -0,0 +1,155 @@
+#include "haloexchange.h"
+#include "neighbours.h"
+#include "parallelparameters.h"
+#include "phasetimer.h"
+
+MPI_Comm Parallel::HaloExchange::m_nodeComm = MPI_COMM_NULL;
+MPI_Win Parallel::HaloExchange::m_window = MPI_WIN_NULL;
+SU3 *Parallel::HaloExchange::m_segment = nullptr;
+unsigned long Parallel::HaloExchange::m_segmentSize = 0;
+const SU3 *Parallel::HaloExchange::m_neighbourSegments[8] = {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
+
+/*!
+ * \brief Parallel::HaloExchange::initialize creates the shared window of the processors on each node, and finds the neighbours on the node.
+ * \param N the sub-lattice dimensions, deciding the largest face.
+ * \param ranksPerNode if positive, the processors of a node are split further into blocks of this many consecutive ranks, each sharing
+ * a window as if it were a node. Lets the passing between nodes be tested on a single node.
+ *
+ * Must be called by all active processors once the neighbour lists are set up.
+ */
+void Parallel::HaloExchange::initialize(const std::vector<unsigned int> &N, const int ranksPerNode)
+{
+    finalize();
+
+    m_segmentSize = 0;
+    for (unsigned int i = 0; i < 4; i++) {
+        const unsigned long faceSize = (N[0]*N[1]*N[2]*N[3]) / N[i];
+        if (faceSize > m_segmentSize) m_segmentSize = faceSize;
+    }
+
+    MPI_Comm_split_type(ParallelParameters::ACTIVE_COMM, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &m_nodeComm);
+    if (ranksPerNode > 0) {
+        int nodeRank = 0;
+        MPI_Comm_rank(m_nodeComm, &nodeRank);
+        MPI_Comm blockComm;
+        MPI_Comm_split(m_nodeComm, nodeRank / ranksPerNode, nodeRank, &blockComm);
+        MPI_Comm_free(&m_nodeComm);
+        m_nodeComm = blockComm;
+    }
+    MPI_Win_allocate_shared(MPI_Aint(m_segmentSize*sizeof(SU3)), int(sizeof(SU3)), MPI_INFO_NULL, m_nodeComm, &m_segment, &m_window);
+    // A single passive epoch for the lifetime of the window, synchronised by MPI_Win_sync and barriers
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, m_window);
+
+    // Finds the ranks of the neighbours on the node
+    MPI_Group activeGroup;
+    MPI_Group nodeGroup;
+    MPI_Comm_group(ParallelParameters::ACTIVE_COMM, &activeGroup);
+    MPI_Comm_group(m_nodeComm, &nodeGroup);
+    for (int i = 0; i < 8; i++) {
+        const int neighbour = Neighbours::get(i);
+        int nodeRank = MPI_UNDEFINED;
+        MPI_Group_translate_ranks(activeGroup, 1, &neighbour, nodeGroup, &nodeRank);
+
+        m_neighbourSegments[i] = nullptr;
+        if (nodeRank != MPI_UNDEFINED) {
+            MPI_Aint size = 0;
+            int displacementUnit = 0;
+            SU3 *segment = nullptr;
+            MPI_Win_shared_query(m_window, nodeRank, &size, &displacementUnit, &segment);
+            m_neighbourSegments[i] = segment;
+        }
+    }
+    MPI_Group_free(&activeGroup);
+    MPI_Group_free(&nodeGroup);
+}
+
+/*!
+ * \brief Parallel::HaloExchange::finalize frees the shared window, after which the faces are passed by MPI point-to-point.
+ */
+void Parallel::HaloExchange::finalize()
+{
+    if (m_window != MPI_WIN_NULL) {
+        MPI_Win_unlock_all(m_window);
+        MPI_Win_free(&m_window);
+        m_segment = nullptr;
+    }
+    if (m_nodeComm != MPI_COMM_NULL) {
+        MPI_Comm_free(&m_nodeComm);
+    }
+    for (int i = 0; i < 8; i++) m_neighbourSegments[i] = nullptr;
+}
+
+/*!
+ * \brief Parallel::HaloExchange::HaloExchange
+ * \param faceSize the number of sites of the face.
+ * \param sendDirection the index in the neighbour list of the processor to send the face to.
+ * \param receiveDirection the index in the neighbour list of the processor to receive the face from.
+ *
+ * Faces larger than the shared segments, e.g. of a lattice other than the sub-lattice, are passed by MPI point-to-point.
+ */
+Parallel::HaloExchange::HaloExchange(const unsigned long faceSize, const int sendDirection, const int receiveDirection) :
+    m_faceSize(faceSize), m_sendDirection(sendDirection), m_receiveDirection(receiveDirection),
+    m_shared(m_window != MPI_WIN_NULL && faceSize <= m_segmentSize)
+{
+    if (m_shared) {
+        // The neighbours must have read the faces of the previous exchange before the segment is written
+        ScopedPhase haloExchange(HALO_EXCHANGE);
+        MPI_Barrier(m_nodeComm);
+    }
+    if (!m_shared || m_neighbourSegments[m_sendDirection] == nullptr) {
+        m_sendBuffer.resize(m_faceSize);
+    }
+    if (!m_shared || m_neighbourSegments[m_receiveDirection] == nullptr) {
+        m_receiveBuffer.resize(m_faceSize);
+    }
+}
+
+/*!
+ * \brief Parallel::HaloExchange::sendFace
+ * \return the buffer to pack the face to send into, which is the shared segment if the receiver is on the node.
+ */
+SU3 *Parallel::HaloExchange::sendFace()
+{
+    if (m_shared && m_neighbourSegments[m_sendDirection] != nullptr) {
+        return m_segment;
+    }
+    return m_sendBuffer.data();
+}
+
+/*!
+ * \brief Parallel::HaloExchange::start starts passing the faces to and from other nodes, and makes the packed face visible to the node.
+ */
+void Parallel::HaloExchange::start()
+{
+    const int count = int(18*m_faceSize);
+    if (!m_sendBuffer.empty()) {
+        MPI_Isend(m_sendBuffer.data(), count, MPI_DOUBLE, Neighbours::get(m_sendDirection), 0, ParallelParameters::ACTIVE_COMM, &m_sendRequest);
+    }
+    if (!m_receiveBuffer.empty()) {
+        MPI_Irecv(m_receiveBuffer.data(), count, MPI_DOUBLE, Neighbours::get(m_receiveDirection), 0, ParallelParameters::ACTIVE_COMM, &m_receiveRequest);
+    }
+
+    if (m_shared) {
+        ScopedPhase haloExchange(HALO_EXCHANGE);
+        MPI_Win_sync(m_window);
+        MPI_Barrier(m_nodeComm);
+        MPI_Win_sync(m_window);
+    }
+}
+
+/*!
+ * \brief Parallel::HaloExchange::receiveFace completes the exchange.
+ * \return the face received, which is read directly from the segment of the sender if it is on the node.
+ */
+const SU3 *Parallel::HaloExchange::receiveFace()
+{
+    {
+        ScopedPhase haloExchange(HALO_EXCHANGE);
+        MPI_Wait(&m_sendRequest, MPI_STATUS_IGNORE);
+        MPI_Wait(&m_receiveRequest, MPI_STATUS_IGNORE);
+    }
+    if (m_receiveBuffer.empty()) {
+        return m_neighbourSegments[m_receiveDirection];
+    }
+    return m_receiveBuffer.data();
+}
@@ -0,0 +1,61 @@
+/*!
+ * \class HaloExchange
+ *
+ * \brief HaloExchange passes a face of the sub-lattice to a neighbouring processor, and receives the opposite face from the other neighbour.
+ *
+ * By default the faces are sent and received with MPI point-to-point. With the shared memory halo enabled, the processors on a node share
+ * an MPI-3 window holding a face per processor. A face sent to a neighbour on the node is then packed directly into the window, and read by
+ * the neighbour from the window without any message, while faces to and from other nodes are still passed by MPI point-to-point. The node
+ * synchronises once the faces are written, and again before the window is written to by the next exchange.
+ *
+ * An exchange is made by sendFace, start and receiveFace, and must be done by all active processors at the same time, as in shift.
+ *
+ * \author Mathias M. Vege
+ * \version 1.0
+ * \date 2017-2019
+ * \copyright MIT Licence
+ */
+#ifndef HALOEXCHANGE_H
+#define HALOEXCHANGE_H
+
+#include <mpi.h>
+#include <vector>
+#include "math/matrices/su3.h"
+
+namespace Parallel
+{
+class HaloExchange
+{
+private:
+    // Shared window of the processors on the node
+    static MPI_Comm m_nodeComm;
+    static MPI_Win m_window;
+    static SU3 *m_segment;
+    static unsigned long m_segmentSize;
+    // The segment of each neighbour in the neighbour list, or nullptr if it is on another node
+    static const SU3 *m_neighbourSegments[8];
+
+    unsigned long m_faceSize;
+    int m_sendDirection;
+    int m_receiveDirection;
+    bool m_shared;
+    std::vector<SU3> m_sendBuffer;
+    std::vector<SU3> m_receiveBuffer;
+    MPI_Request m_sendRequest = MPI_REQUEST_NULL;
+    MPI_Request m_receiveRequest = MPI_REQUEST_NULL;
+public:
+    HaloExchange(const unsigned long faceSize, const int sendDirection, const int receiveDirection);
+
+    SU3 *sendFace();
+    void start();
+    const SU3 *receiveFace();
+
+    // Setup of the shared window
+    static void initialize(const std::vector<unsigned int> &N, const int ranksPerNode = 0);
+    static void finalize();
+    static bool isShared() { return m_window != MPI_WIN_NULL; }
+    static bool isOnNode(const int direction) { return m_neighbourSegments[direction] != nullptr; }
+};
+}
+
+#endif // HALOEXCHANGE_H
@@ -1,7 +1,14 @@
 #include "index.h"
+#include <algorithm>
 
 std::vector<unsigned int> Parallel::Index::m_N;
 std::vector<long long> Parallel::Index::m_NTot;
+Parallel::SiteOrdering Parallel::Index::m_ordering = Parallel::LEXICOGRAPHIC;
+std::vector<unsigned long> Parallel::Index::m_siteIndex;
+std::vector<unsigned int> Parallel::Index::m_neighbourIndex[8];
+std::vector<unsigned char> Parallel::Index::m_faces;
+std::vector<unsigned int> Parallel::Index::m_haloIndex[4];
+std::vector<unsigned int> Parallel::Index::m_faceSites[8];
 
 Parallel::Index::Index()
 {
@@ -29,6 +36,152 @@ void Parallel::Index::setN(const std::vector<unsigned int> &N)
      *  N       : an array of ints of length 4, where each element is the dimension size of either x,y,z or t
      */
     m_N = N;
+    setupOrdering();
+    setupNeighbours();
+}
+
+/*!
+ * \brief Parallel::Index::setOrdering sets the order the sites of the sub lattice are stored in.
+ * \param ordering
+ *
+ * Must be set before any lattice is filled, as the sites already stored are not moved.
+ */
+void Parallel::Index::setOrdering(const SiteOrdering ordering)
+{
+    m_ordering = ordering;
+    setupOrdering();
+    setupNeighbours();
+}
+
+/*!
+ * \brief Parallel::Index::setOrdering sets the order the sites of the sub lattice are stored in from its name.
+ * \param orderingName lexicographic, blocked or morton.
+ * \return false if the name is not a known ordering, in which case the ordering is left as it was.
+ */
+bool Parallel::Index::setOrdering(const std::string &orderingName)
+{
+    if (orderingName == "lexicographic") {
+        setOrdering(LEXICOGRAPHIC);
+    } else if (orderingName == "blocked") {
+        setOrdering(BLOCKED);
+    } else if (orderingName == "morton") {
+        setOrdering(MORTON);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Parallel::Index::setupOrdering builds the table of storage indices of the sites, by sorting the sites by their key in the ordering.
+ *
+ * For the blocked ordering the key is the lexicographic index of the block, followed by the lexicographic index within the block, with
+ * blocks of four sites in each dimension the extent is divisible by four, else two or one. For the Morton ordering the key interleaves
+ * the bits of the four coordinates, such that the gaps of the curve in extents that are not powers of two are closed by the sorting.
+ */
+void Parallel::Index::setupOrdering()
+{
+    m_siteIndex.clear();
+    if (m_ordering == LEXICOGRAPHIC || m_N.size() != 4) return;
+
+    unsigned int blockSize[4];
+    unsigned int blocks[4];
+    for (int i = 0; i < 4; i++) {
+        blockSize[i] = m_N[i] % 4 == 0 ? 4 : (m_N[i] % 2 == 0 ? 2 : 1);
+        blocks[i] = m_N[i] / blockSize[i];
+    }
+
+    const unsigned long subLatticeSize = (unsigned long)(m_N[0])*m_N[1]*m_N[2]*m_N[3];
+    std::vector<std::pair<unsigned long long, unsigned long>> keys(subLatticeSize);
+    unsigned long lexicographicIndex = 0;
+    for (unsigned int l = 0; l < m_N[3]; l++) {
+        for (unsigned int k = 0; k < m_N[2]; k++) {
+            for (unsigned int j = 0; j < m_N[1]; j++) {
+                for (unsigned int i = 0; i < m_N[0]; i++) {
+                    const unsigned int n[4] = {i, j, k, l};
+                    unsigned long long key = 0;
+                    if (m_ordering == BLOCKED) {
+                        unsigned long long block = 0;
+                        unsigned long long withinBlock = 0;
+                        for (int mu = 3; mu >= 0; mu--) {
+                            block = block*blocks[mu] + n[mu] / blockSize[mu];
+                            withinBlock = withinBlock*blockSize[mu] + n[mu] % blockSize[mu];
+                        }
+                        key = block*(blockSize[0]*blockSize[1]*blockSize[2]*blockSize[3]) + withinBlock;
+                    } else {
+                        // x takes the lowest bit of each group of four
+                        for (unsigned int bit = 0; bit < 16; bit++) {
+                            for (int mu = 0; mu < 4; mu++) {
+                                key |= (unsigned long long)((n[mu] >> bit) & 1) << (4*bit + (unsigned int)(mu));
+                            }
+                        }
+                    }
+                    keys[lexicographicIndex] = std::make_pair(key, lexicographicIndex);
+                    lexicographicIndex++;
+                }
+            }
+        }
+    }
+
+    std::sort(keys.begin(), keys.end());
+    m_siteIndex.resize(subLatticeSize);
+    for (unsigned long iSite = 0; iSite < subLatticeSize; iSite++) {
+        m_siteIndex[keys[iSite].second] = iSite;
+    }
+}
+
+/*!
+ * \brief Parallel::Index::setupNeighbours builds the tables of neighbouring sites, faces and halo indices in the current ordering.
+ */
+void Parallel::Index::setupNeighbours()
+{
+    if (m_N.size() != 4) return;
+
+    const unsigned long subLatticeSize = (unsigned long)(m_N[0])*m_N[1]*m_N[2]*m_N[3];
+    m_faces.assign(subLatticeSize, 0);
+    for (int mu = 0; mu < 4; mu++) {
+        m_haloIndex[mu].resize(subLatticeSize);
+        for (int direction = 2*mu; direction < 2*mu + 2; direction++) {
+            m_neighbourIndex[direction].resize(subLatticeSize);
+            m_faceSites[direction].resize(subLatticeSize / m_N[mu]);
+        }
+    }
+
+    for (unsigned int l = 0; l < m_N[3]; l++) {
+        for (unsigned int k = 0; k < m_N[2]; k++) {
+            for (unsigned int j = 0; j < m_N[1]; j++) {
+                for (unsigned int i = 0; i < m_N[0]; i++) {
+                    const unsigned long iSite = getIndex(i,j,k,l);
+                    for (int mu = 0; mu < 4; mu++) {
+                        unsigned int n[4] = {i, j, k, l};
+                        const unsigned int position = n[mu];
+
+                        n[mu] = (position + m_N[mu] - 1) % m_N[mu];
+                        m_neighbourIndex[2*mu][iSite] = (unsigned int)(getIndex(n[0],n[1],n[2],n[3]));
+                        n[mu] = (position + 1) % m_N[mu];
+                        m_neighbourIndex[2*mu+1][iSite] = (unsigned int)(getIndex(n[0],n[1],n[2],n[3]));
+                        n[mu] = position;
+
+                        // Lexicographic within the face, skipping mu
+                        unsigned long haloIndex = 0;
+                        for (int nu = 3; nu >= 0; nu--) {
+                            if (nu != mu) haloIndex = haloIndex*m_N[nu] + n[nu];
+                        }
+                        m_haloIndex[mu][iSite] = (unsigned int)(haloIndex);
+
+                        if (position == 0) {
+                            m_faces[iSite] |= (unsigned char)(1 << (2*mu));
+                            m_faceSites[2*mu][haloIndex] = (unsigned int)(iSite);
+                        }
+                        if (position == m_N[mu] - 1) {
+                            m_faces[iSite] |= (unsigned char)(1 << (2*mu + 1));
+                            m_faceSites[2*mu+1][haloIndex] = (unsigned int)(iSite);
+                        }
+                    }
+                }
+            }
+        }
+    }
 }
 
 /*!
@@ -3,6 +3,17 @@
  *
  * \brief Class for contigious memory accessing.
  *
+ * The sites of the sub lattice are by default stored in lexicographic order, with x running fastest. As the neighbours in z and t are
+ * then far apart in memory, the sites may instead be stored in 4D blocks of 4^4 sites, or along a Morton(Z-order) curve, keeping the
+ * neighbours in all directions close. The storage index of each site is then looked up in a table, built whenever the sub lattice
+ * dimensions or the ordering are set.
+ *
+ * Along with the ordering, tables of the neighbouring sites are built, such that the stencils step through the sub lattice without
+ * integer division. The neighbours and faces are numbered as in the NeighbourList, 2*mu backwards and 2*mu+1 forwards, and the
+ * neighbours are periodic within the sub lattice, i.e. a site on a face has the site on the opposite face as its neighbour, which is
+ * the site the neighbouring processor holds the link of. The sites of a face are listed by their halo index, which orders them as
+ * the halo buffers of the lattice shifts and the LinkWindow faces, with x running fastest.
+ *
  * \author Mathias M. Vege
  * \version 1.0
  * \date 2017-2019
@@ -11,29 +22,79 @@
 #ifndef INDEX_H
 #define INDEX_H
 
+#include <string>
 #include <vector>
 
 namespace Parallel {
+    /*!
+     * \brief SiteOrdering is the order the sites of the sub lattice are stored in.
+     */
+    enum SiteOrdering {
+        LEXICOGRAPHIC,
+        BLOCKED,
+        MORTON
+    };
+
     class Index
     {
     private:
         static std::vector<unsigned int> m_N;
         static std::vector<long long> m_NTot;
+        static SiteOrdering m_ordering;
+        // The storage index of each site by its lexicographic index, empty for the lexicographic ordering
+        static std::vector<unsigned long> m_siteIndex;
+        static void setupOrdering();
+
+        // The storage index of the neighbouring site in each of the 8 directions, periodic within the sub lattice
+        static std::vector<unsigned int> m_neighbourIndex[8];
+        // The faces each site is on, one bit per direction
+        static std::vector<unsigned char> m_faces;
+        // The index of each site within the faces perpendicular to each dimension
+        static std::vector<unsigned int> m_haloIndex[4];
+        // The storage indices of the sites on each face, by their halo index
+        static std::vector<unsigned int> m_faceSites[8];
+        static void setupNeighbours();
     public:
         Index();
         ~Index();
 
         // Index getter
-        static inline unsigned long cubeIndex(unsigned long int i, unsigned long int j, unsigned long int k, unsigned long int Ni, unsigned long int Nj)
+        static inline unsigned long getIndex(const unsigned int i, const unsigned int j, const unsigned int k, const unsigned int l)
         {
-            return i + Ni*(j + Nj*k);
+            const unsigned long lexicographicIndex = i + m_N[0]*(j + m_N[1]*(k + m_N[2]*l));
+            if (m_ordering == LEXICOGRAPHIC) return lexicographicIndex;
+            return m_siteIndex[lexicographicIndex];
         }
 
-        static inline unsigned long getIndex(const unsigned int i, const unsigned int j, const unsigned int k, const unsigned int l)
+        static inline unsigned long getSiteIndex(const unsigned long lexicographicIndex)
         {
-            return i + m_N[0]*(j + m_N[1]*(k + m_N[2]*l));
+            if (m_ordering == LEXICOGRAPHIC) return lexicographicIndex;
+            return m_siteIndex[lexicographicIndex];
         }
 
+        /*!
+         * \brief getNeighbourIndex
+         * \param iSite storage index of a site.
+         * \param direction 2*mu for the site behind in mu, 2*mu+1 for the site in front.
+         * \return the storage index of the neighbouring site, wrapped around to the opposite face of the sub lattice.
+         */
+        static inline unsigned long getNeighbourIndex(const unsigned long iSite, const int direction)
+        {
+            return m_neighbourIndex[direction][iSite];
+        }
+
+        static inline bool isOnFace(const unsigned long iSite, const int direction)
+        {
+            return (m_faces[iSite] >> direction) & 1;
+        }
+
+        static inline unsigned long getHaloIndex(const unsigned long iSite, const int mu)
+        {
+            return m_haloIndex[mu][iSite];
+        }
+
+        static const std::vector<unsigned int> &getFaceSites(const int direction) { return m_faceSites[direction]; }
+
         static inline long long getGlobalIndex(const long long i, const long long j, const long long k, const long long l)
         {
             return i + m_NTot[0]*(j + m_NTot[1]*(k + m_NTot[2]*l)); // column-major
@@ -42,9 +103,12 @@ namespace Parallel {
         // Setters
         static void setN(const std::vector<unsigned int> &N);
         static void setNTot(const unsigned int NSpatial, const unsigned int NTemporal);
+        static void setOrdering(const SiteOrdering ordering);
+        static bool setOrdering(const std::string &orderingName);
 
         // Getter
         static const std::vector<unsigned int> getN() { return m_N; }
+        static SiteOrdering getOrdering() { return m_ordering; }
     };
 }
 #endif // INDEX_H
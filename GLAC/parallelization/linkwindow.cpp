@@ -0,0 +1,217 @@
+#include "linkwindow.h"
+#include "communicator.h"
+#include "index.h"
+#include "neighbours.h"
+#include "parallelparameters.h"
+#include "phasetimer.h"
+#include <algorithm>
+
+std::vector<Parallel::LinkWindow::Region> Parallel::LinkWindow::m_regions;
+int Parallel::LinkWindow::m_regionIndex[81];
+std::vector<unsigned int> Parallel::LinkWindow::m_N;
+MPI_Datatype Parallel::LinkWindow::m_SU3Type = MPI_DATATYPE_NULL;
+MPI_Group Parallel::LinkWindow::m_neighbourGroup = MPI_GROUP_NULL;
+unsigned long Parallel::LinkWindow::m_numberOfNeighbours = 0;
+MPI_Win Parallel::LinkWindow::m_windows[4] = {MPI_WIN_NULL, MPI_WIN_NULL, MPI_WIN_NULL, MPI_WIN_NULL};
+const SU3 *Parallel::LinkWindow::m_windowSites[4] = {nullptr, nullptr, nullptr, nullptr};
+Lattice<SU3> *Parallel::LinkWindow::m_lattice = nullptr;
+
+/*!
+ * \brief Parallel::LinkWindow::initialize sets up the faces and edges to fetch, and the group of neighbouring processors.
+ * \param N the sub-lattice dimensions.
+ *
+ * Must be called by all active processors once the neighbour lists are set up. The windows are created once a lattice is attached.
+ */
+void Parallel::LinkWindow::initialize(const std::vector<unsigned int> &N)
+{
+    finalize();
+    m_N = N;
+
+    MPI_Type_contiguous(18, MPI_DOUBLE, &m_SU3Type);
+    MPI_Type_commit(&m_SU3Type);
+
+    // The faces in each direction, and the edges n + mu - nu of the staples
+    std::vector<std::vector<int>> offsets;
+    for (int mu = 0; mu < 4; mu++) {
+        for (int sign = -1; sign <= 1; sign += 2) {
+            std::vector<int> offset(4, 0);
+            offset[mu] = sign;
+            offsets.push_back(offset);
+        }
+    }
+    for (int mu = 0; mu < 4; mu++) {
+        for (int nu = 0; nu < 4; nu++) {
+            if (mu == nu) continue;
+            std::vector<int> offset(4, 0);
+            offset[mu] = 1;
+            offset[nu] = -1;
+            offsets.push_back(offset);
+        }
+    }
+
+    const int processRank = Communicator::getProcessRank();
+    std::vector<int> neighbourRanks;
+    std::fill(m_regionIndex, m_regionIndex + 81, -1);
+    m_regions.resize(offsets.size());
+    for (unsigned int iRegion = 0; iRegion < offsets.size(); iRegion++) {
+        Region &region = m_regions[iRegion];
+        int key = 0;
+        unsigned long size = 1;
+        region.rank = processRank;
+        for (int i = 3; i >= 0; i--) {
+            region.offset[i] = offsets[iRegion][i];
+            key = 3*key + region.offset[i] + 1;
+        }
+        for (int i = 0; i < 4; i++) {
+            // The neighbour one step in each dimension of the offset, and the face of its sub-lattice adjacent to this one
+            if (region.offset[i] != 0) {
+                region.rank = Neighbours::getNeighbours(region.rank)->list[2*i + (region.offset[i] > 0 ? 1 : 0)];
+            }
+            region.start[i] = region.offset[i] < 0 ? m_N[i] - 1 : 0;
+            region.extent[i] = region.offset[i] == 0 ? m_N[i] : 1;
+            size *= region.extent[i];
+        }
+        m_regionIndex[key] = int(iRegion);
+
+        // The sites of the region in the cache are ordered with x running fastest, whatever the site ordering of the sub-lattice
+        std::vector<int> displacements;
+        displacements.reserve(size);
+        for (unsigned int t = 0; t < region.extent[3]; t++) {
+            for (unsigned int z = 0; z < region.extent[2]; z++) {
+                for (unsigned int y = 0; y < region.extent[1]; y++) {
+                    for (unsigned int x = 0; x < region.extent[0]; x++) {
+                        displacements.push_back(int(Index::getIndex(region.start[0] + x, region.start[1] + y,
+                                                                    region.start[2] + z, region.start[3] + t)));
+                    }
+                }
+            }
+        }
+        MPI_Type_create_indexed_block(int(size), 1, displacements.data(), m_SU3Type, &region.remoteType);
+        MPI_Type_commit(&region.remoteType);
+
+        for (int mu = 0; mu < 4; mu++) {
+            region.links[mu].resize(size);
+        }
+        if (region.rank != processRank) neighbourRanks.push_back(region.rank);
+    }
+
+    // Links held by this processor, e.g. in undivided dimensions, are copied rather than fetched
+    std::sort(neighbourRanks.begin(), neighbourRanks.end());
+    neighbourRanks.erase(std::unique(neighbourRanks.begin(), neighbourRanks.end()), neighbourRanks.end());
+    m_numberOfNeighbours = neighbourRanks.size();
+    MPI_Group activeGroup;
+    MPI_Comm_group(ParallelParameters::ACTIVE_COMM, &activeGroup);
+    MPI_Group_incl(activeGroup, int(neighbourRanks.size()), neighbourRanks.data(), &m_neighbourGroup);
+    MPI_Group_free(&activeGroup);
+}
+
+/*!
+ * \brief Parallel::LinkWindow::finalize frees the windows, datatypes and group.
+ */
+void Parallel::LinkWindow::finalize()
+{
+    freeWindows();
+    for (auto &region : m_regions) {
+        MPI_Type_free(&region.remoteType);
+    }
+    m_regions.clear();
+    if (m_SU3Type != MPI_DATATYPE_NULL) {
+        MPI_Type_free(&m_SU3Type);
+    }
+    if (m_neighbourGroup != MPI_GROUP_NULL && m_neighbourGroup != MPI_GROUP_EMPTY) {
+        MPI_Group_free(&m_neighbourGroup);
+    }
+}
+
+/*!
+ * \brief Parallel::LinkWindow::createWindows exposes the links of each direction of a lattice in a window.
+ * \param lattice a lattice pointer for all four dimensions.
+ *
+ * A single processor holds all the links itself, and needs no windows.
+ */
+void Parallel::LinkWindow::createWindows(Lattice<SU3> *lattice)
+{
+    freeWindows();
+    for (int mu = 0; mu < 4; mu++) {
+        if (m_numberOfNeighbours != 0) {
+            MPI_Win_create(lattice[mu].m_sites.data(), MPI_Aint(lattice[mu].m_latticeSize*sizeof(SU3)), int(sizeof(SU3)), MPI_INFO_NULL,
+                           ParallelParameters::ACTIVE_COMM, &m_windows[mu]);
+        }
+        m_windowSites[mu] = lattice[mu].m_sites.data();
+    }
+}
+
+/*!
+ * \brief Parallel::LinkWindow::freeWindows
+ */
+void Parallel::LinkWindow::freeWindows()
+{
+    for (int mu = 0; mu < 4; mu++) {
+        if (m_windows[mu] != MPI_WIN_NULL) {
+            MPI_Win_free(&m_windows[mu]);
+        }
+        m_windowSites[mu] = nullptr;
+    }
+    m_lattice = nullptr;
+}
+
+/*!
+ * \brief Parallel::LinkWindow::attach makes the link getters of the Communicator read the links of other processors from the cache.
+ * \param lattice a lattice pointer for all four dimensions.
+ *
+ * Must be called by all active processors. The windows are created again if the links of the lattice have been reallocated, e.g. by
+ * assigning another lattice to it.
+ */
+void Parallel::LinkWindow::attach(Lattice<SU3> *lattice)
+{
+    bool moved = false;
+    for (int mu = 0; mu < 4; mu++) {
+        moved = moved || m_windowSites[mu] != lattice[mu].m_sites.data();
+    }
+    if (moved) {
+        createWindows(lattice);
+    }
+    m_lattice = lattice;
+}
+
+/*!
+ * \brief Parallel::LinkWindow::fetch fetches the links of a direction held by neighbouring processors into the cache.
+ * \param SU3Dir the link direction.
+ *
+ * Must be called by all active processors, with a lattice attached.
+ */
+void Parallel::LinkWindow::fetch(const int SU3Dir)
+{
+    ScopedPhase haloExchange(HALO_EXCHANGE);
+    const int processRank = Communicator::getProcessRank();
+    const Lattice<SU3> &links = m_lattice[SU3Dir];
+
+    // Neighbours may read the links once their previous updates are done, and not change them until this processor has read them
+    if (m_numberOfNeighbours != 0) {
+        MPI_Win_post(m_neighbourGroup, MPI_MODE_NOPUT, m_windows[SU3Dir]);
+        MPI_Win_start(m_neighbourGroup, 0, m_windows[SU3Dir]);
+    }
+    for (auto &region : m_regions) {
+        if (region.rank != processRank) {
+            MPI_Get(region.links[SU3Dir].data(), int(region.links[SU3Dir].size()), m_SU3Type,
+                    region.rank, 0, 1, region.remoteType, m_windows[SU3Dir]);
+            continue;
+        }
+        // The processor is its own neighbour in the dimensions of the offset
+        unsigned long iLink = 0;
+        for (unsigned int t = 0; t < region.extent[3]; t++) {
+            for (unsigned int z = 0; z < region.extent[2]; z++) {
+                for (unsigned int y = 0; y < region.extent[1]; y++) {
+                    for (unsigned int x = 0; x < region.extent[0]; x++) {
+                        region.links[SU3Dir][iLink++] = links.m_sites[Index::getIndex(region.start[0] + x, region.start[1] + y,
+                                                                                       region.start[2] + z, region.start[3] + t)];
+                    }
+                }
+            }
+        }
+    }
+    if (m_numberOfNeighbours != 0) {
+        MPI_Win_complete(m_windows[SU3Dir]);
+        MPI_Win_wait(m_windows[SU3Dir]);
+    }
+}
@@ -0,0 +1,125 @@
+/*!
+ * \class LinkWindow
+ *
+ * \brief LinkWindow exposes the links of the sub-lattice through MPI windows, such that the links of neighbouring processors needed by
+ * the Metropolis staples are fetched with one-sided MPI_Get.
+ *
+ * The staple of \f$U_\mu(n)\f$ reads links at \f$n \pm \hat{\nu}\f$, \f$n + \hat{\mu}\f$ and \f$n + \hat{\mu} - \hat{\nu}\f$. The faces
+ * and edges of the neighbouring sub-lattices holding these are fetched into a cache by fetch, one link direction at a time, with each
+ * face or edge gathered by a single MPI_Get. The fetch is an access and exposure epoch shared with the neighbouring processors only,
+ * such that a processor waits for its neighbours rather than for every processor, and no processor changes its links while another
+ * reads them. While a lattice is attached, the link getters of the Communicator read the links of other processors from the cache.
+ *
+ * The links read must not change between the fetch and their use, as is the case for a checkerboard sweep where only the links of
+ * one direction and one parity are updated at a time, and the direction updated is fetched again before the next phase.
+ *
+ * \author Mathias M. Vege
+ * \version 1.0
+ * \date 2017-2019
+ * \copyright MIT Licence
+ */
+#ifndef LINKWINDOW_H
+#define LINKWINDOW_H
+
+#include <mpi.h>
+#include <vector>
+#include "math/lattice.h"
+
+namespace Parallel
+{
+class LinkWindow
+{
+private:
+    // A face or edge of a neighbouring sub-lattice
+    struct Region {
+        int offset[4]; // -1, 0 or 1 processors away in each dimension
+        int rank;
+        unsigned int start[4];
+        unsigned int extent[4];
+        MPI_Datatype remoteType;
+        std::vector<SU3> links[4];
+    };
+    static std::vector<Region> m_regions;
+    // Region of each offset, numbered in base 3, or -1 if it is not fetched
+    static int m_regionIndex[81];
+    static std::vector<unsigned int> m_N;
+
+    static MPI_Datatype m_SU3Type;
+    static MPI_Group m_neighbourGroup;
+    static unsigned long m_numberOfNeighbours;
+    static MPI_Win m_windows[4];
+    static const SU3 *m_windowSites[4];
+    static Lattice<SU3> *m_lattice;
+
+    static void createWindows(Lattice<SU3> *lattice);
+    static void freeWindows();
+public:
+    static void initialize(const std::vector<unsigned int> &N);
+    static void finalize();
+
+    static void attach(Lattice<SU3> *lattice);
+    static void detach() { m_lattice = nullptr; }
+    static bool isAttached(const Lattice<SU3> *lattice) { return lattice == m_lattice && lattice != nullptr; }
+
+    static void fetch(const int SU3Dir);
+
+    /*!
+     * \brief getLink
+     * \param SU3Dir the link direction.
+     * \param n position of the link, which may be one site outside the sub-lattice in up to two dimensions.
+     * \return the link of the neighbouring processor, as of the last fetch of the direction.
+     */
+    static inline const SU3 &getLink(const int SU3Dir, const int *n)
+    {
+        int key = 0;
+        unsigned long index = 0;
+        unsigned long stride = 1;
+        for (int i = 3; i >= 0; i--) {
+            const int offset = n[i] < 0 ? -1 : (n[i] >= int(m_N[i]) ? 1 : 0);
+            key = 3*key + offset + 1;
+        }
+        const Region &region = m_regions[m_regionIndex[key]];
+        for (int i = 0; i < 4; i++) {
+            if (region.offset[i] == 0) index += stride*n[i];
+            stride *= region.extent[i];
+        }
+        return region.links[SU3Dir][index];
+    }
+
+    /*!
+     * \brief getFaceLink
+     * \param SU3Dir the link direction.
+     * \param direction the face of the neighbouring processor, numbered as in the NeighbourList.
+     * \param haloIndex the index of the link within the face, as given by Index::getHaloIndex.
+     * \return the link of the neighbouring processor, as of the last fetch of the direction.
+     */
+    static inline const SU3 &getFaceLink(const int SU3Dir, const int direction, const unsigned long haloIndex)
+    {
+        // The faces are the first eight regions
+        return m_regions[direction].links[SU3Dir][haloIndex];
+    }
+
+    /*!
+     * \brief getEdgeLink
+     * \param SU3Dir the link direction.
+     * \param mu the dimension the link is one step in front of the sub-lattice in.
+     * \param nu the dimension the link is one step behind the sub-lattice in.
+     * \param haloIndex the index of the site on the face in front in mu, as given by Index::getHaloIndex.
+     * \return the link at \f$n + \hat{\mu} - \hat{\nu}\f$, as of the last fetch of the direction.
+     */
+    static inline const SU3 &getEdgeLink(const int SU3Dir, const int mu, const int nu, unsigned long haloIndex)
+    {
+        int n[4];
+        for (int i = 0; i < 4; i++) {
+            if (i == mu) continue;
+            n[i] = int(haloIndex % m_N[i]);
+            haloIndex /= m_N[i];
+        }
+        n[mu] = int(m_N[mu]);
+        n[nu] = -1;
+        return getLink(SU3Dir, n);
+    }
+};
+}
+
+#endif // LINKWINDOW_H
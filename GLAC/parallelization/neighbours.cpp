@@ -2,10 +2,7 @@
 
 int Parallel::Neighbours::m_processRank;
 int Parallel::Neighbours::m_numproc;
-int Parallel::Neighbours::m_Nx = 0;
-int Parallel::Neighbours::m_Ny = 0;
-int Parallel::Neighbours::m_Nz = 0;
-int Parallel::Neighbours::m_Nt = 0; // Prosessors per dimension
+int Parallel::Neighbours::m_processorsPerDimension[4] = {0,0,0,0}; // Prosessors per dimension
 long Parallel::Neighbours::m_P[4]; // Prosessor coordinate
 std::vector<NeighbourList> Parallel::Neighbours::m_neighbourLists;
 
@@ -27,16 +24,17 @@ void Parallel::Neighbours::initialize(const int processRank, const int numproc,
 {
     m_processRank = processRank;
     m_numproc = numproc;
-    m_Nx = processorsPerDim[0];
-    m_Ny = processorsPerDim[1];
-    m_Nz = processorsPerDim[2];
-    m_Nt = processorsPerDim[3];
+    for (int i = 0; i < 4; i++) {
+        m_processorsPerDimension[i] = processorsPerDim[i];
+    }
     m_neighbourLists.resize(m_numproc);
     generateNeighbourList();
-    m_P[0] = (long) processRank % m_Nx;
-    m_P[1] = (long) (processRank / m_Nx) % m_Ny;
-    m_P[2] = (long) (processRank / (m_Nx * m_Ny)) % m_Nz;
-    m_P[3] = (long) (processRank / (m_Nx * m_Ny * m_Nz)) % m_Nt;
+
+    int coordinates[4];
+    getCoordinates(processRank, coordinates);
+    for (int i = 0; i < 4; i++) {
+        m_P[i] = (long) coordinates[i];
+    }
 }
 
 /*!
@@ -54,14 +52,11 @@ void Parallel::Neighbours::generateNeighbourList()
     for (int Np = 0; Np < m_numproc; Np++)
     {
         m_neighbourLists[Np].rank = Np;
-        m_neighbourLists[Np].list[0] = getXMinusOne(Np);
-        m_neighbourLists[Np].list[1] = getXPlusOne(Np);
-        m_neighbourLists[Np].list[2] = getYMinusOne(Np);
-        m_neighbourLists[Np].list[3] = getYPlusOne(Np);
-        m_neighbourLists[Np].list[4] = getZMinusOne(Np);
-        m_neighbourLists[Np].list[5] = getZPlusOne(Np);
-        m_neighbourLists[Np].list[6] = getTMinusOne(Np);
-        m_neighbourLists[Np].list[7] = getTPlusOne(Np);
+        for (int dim = 0; dim < 4; dim++)
+        {
+            m_neighbourLists[Np].list[2*dim] = getShiftedRank(Np, dim, -1);
+            m_neighbourLists[Np].list[2*dim + 1] = getShiftedRank(Np, dim, 1);
+        }
     }
 }
 
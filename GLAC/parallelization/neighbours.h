@@ -3,6 +3,7 @@
  *
  * \brief Class for setting up the NeighbourList and stores them.
  *
+ * The processors form a periodic grid of any number of processors per dimension, with ranks ordered with x running fastest.
  *
  * \author Mathias M. Vege
  * \version 1.0
@@ -21,7 +22,7 @@ class Neighbours
 private:
     static int m_processRank;
     static int m_numproc;
-    static int m_Nx, m_Ny, m_Nz, m_Nt; // Prosessors per dimension
+    static int m_processorsPerDimension[4]; // Prosessors per dimension, x, y, z and t
     static long m_P[4]; // Prosessor coordinate
     static void generateNeighbourList();
     static std::vector<NeighbourList> m_neighbourLists;
@@ -35,94 +36,34 @@ private:
      * 6: t-1 | 7: t+1
      */
 
-    // Functions for finding correct direction of neighbouring lattices
-    static inline int getXPlusOne(const int Np)
+    // Ranks are ordered with x running fastest, for any number of processors per dimension
+    static inline void getCoordinates(const int Np, int *coordinates)
     {
-        if (((Np + 1) % m_Nx) == 0)
+        int rest = Np;
+        for (int i = 0; i < 4; i++)
         {
-            return (Np/m_Nx) * m_Nx;
-        }
-        else
-        {
-            return Np + 1;
-        }
-    }
-
-    static inline int getXMinusOne(const int Np)
-    {
-        int x_count = (Np - 1 + m_Nx) % m_Nx;
-        int y_count = (Np/m_Nx) * m_Nx;
-        return x_count + y_count;
-    }
-
-    static inline int getYPlusOne(const int Np)
-    {
-        if ((((Np / m_Nx) + 1) % m_Ny) == 0)
-        {
-            int x_count = Np % m_Nx;
-            int y_count = (Np / (m_Ny*m_Nx)) * (m_Nx*m_Ny);
-            return x_count + y_count;
-        }
-        else
-        {
-            return Np + m_Nx;
+            coordinates[i] = rest % m_processorsPerDimension[i];
+            rest /= m_processorsPerDimension[i];
         }
     }
 
-    static inline int getYMinusOne(const int Np)
+    static inline int getRank(const int *coordinates)
     {
-        int x_count = Np % m_Nx;
-        int y_count = (((Np/m_Nx) - 1 + m_Ny) % m_Ny) * m_Nx;
-        int z_count = (Np/(m_Nx * m_Ny)) * (m_Nx*m_Ny);
-        return x_count + y_count + z_count;
-    }
-
-    static inline int getZPlusOne(const int Np)
-    {
-        if (((Np/(m_Nx*m_Ny) + 1) % m_Nz) == 0)
-        {
-            int x_count = Np % m_Nx;
-            int y_count = ((Np/m_Nx) % m_Ny) * m_Nx;
-            int t_count = ((Np/(m_Nx*m_Ny*m_Nz)) % m_Nt) * (m_Nx*m_Ny*m_Nz);
-            return x_count + y_count + t_count;
-        }
-        else
-        {
-            return Np + m_Nx*m_Ny;
-        }
-    }
-
-    static inline int getZMinusOne(const int Np)
-    {
-        int x_count = Np % m_Nx;
-        int y_count = ((Np/m_Nx) % m_Ny) * m_Nx;
-        int z_count = ((Np/(m_Nx*m_Ny) - 1 + m_Nz) % m_Nz) * (m_Nx*m_Ny);
-        int t_count = (Np/(m_Nx*m_Ny*m_Nz)) * (m_Nx*m_Ny*m_Nz);
-        return x_count + y_count + z_count + t_count;
-    }
-
-    static inline int getTPlusOne(const int Np)
-    {
-        if ((((Np/(m_Nx*m_Ny*m_Nz)) + 1) % m_Nt) == 0)
-        {
-            int x_count = Np % m_Nx;
-            int y_count = ((Np/m_Nx) % m_Ny) * m_Nx;
-            int z_count = (Np/(m_Nx*m_Ny) % m_Nz) * (m_Nx*m_Ny);
-            return x_count + y_count + z_count;
-        }
-        else
+        int rank = 0;
+        for (int i = 3; i >= 0; i--)
         {
-            return Np + m_Nx*m_Ny*m_Nz;
+            rank = rank * m_processorsPerDimension[i] + coordinates[i];
         }
+        return rank;
     }
 
-    static inline int getTMinusOne(const int Np)
+    // Function for finding the neighbouring processor in a direction, with periodic boundaries
+    static inline int getShiftedRank(const int Np, const int dim, const int shift)
     {
-        int x_count = Np % m_Nx;
-        int y_count = ((Np/m_Nx) % m_Ny) * m_Nx;
-        int z_count = (Np/(m_Nx*m_Ny) % m_Nz) * (m_Nx*m_Ny);
-        int t_count = ((Np/(m_Nx*m_Ny*m_Nz) - 1 + m_Nt) % m_Nt) * (m_Nx*m_Ny*m_Nz);
-        return x_count + y_count + z_count + t_count;
+        int coordinates[4];
+        getCoordinates(Np, coordinates);
+        coordinates[dim] = (coordinates[dim] + shift + m_processorsPerDimension[dim]) % m_processorsPerDimension[dim];
+        return getRank(coordinates);
     }
 public:
     Neighbours();
@@ -12,7 +12,13 @@
 #pragma once
 
 #include "communicator.h"
+#include "haloexchange.h"
 #include "index.h"
+#include "linkwindow.h"
 #include "parallelparameters.h"
+#include "phasetimer.h"
+#include "processgrid.h"
+#include "reductionbuffer.h"
+#include "workqueue.h"
 
 #endif // PARALLEL_H
@@ -1,11 +1,13 @@
 #include "parallelparameters.h"
 
 // MPI Groups
-MPI_Group Parallel::ParallelParameters::ACTIVE_GROUP;
-MPI_Group Parallel::ParallelParameters::WORLD_GROUP;
-MPI_Comm Parallel::ParallelParameters::ACTIVE_COMM;
+MPI_Group Parallel::ParallelParameters::ACTIVE_GROUP = MPI_GROUP_NULL;
+MPI_Group Parallel::ParallelParameters::WORLD_GROUP = MPI_GROUP_NULL;
+MPI_Comm Parallel::ParallelParameters::ACTIVE_COMM = MPI_COMM_NULL;
+MPI_Comm Parallel::ParallelParameters::GROUP_COMM = MPI_COMM_WORLD;
+MPI_Comm Parallel::ParallelParameters::LEADER_COMM = MPI_COMM_NULL;
 
-// Variable for storing if processor is active(will always seek maximum possible of cores divisible to 2^n
+// Variable for storing if processor is active(will always seek the maximum number of processors the lattice can be divided between
 bool Parallel::ParallelParameters::active = true;
 
 Parallel::ParallelParameters::ParallelParameters()
@@ -3,7 +3,8 @@
  *
  * \brief ParallelParameters holds two groups and one communicator.
  *
- * MPI Groups used for communications. Needed in case some processors remain inactive(i.e. we are unable to have zero in remainder hven dividing by 2^n).
+ * MPI Groups used for communications. Needed in case some processors remain inactive, i.e. when the lattice can not be divided between all of them,
+ * and when the processors are split between an ensemble of independent Markov chains or between groups flowing configurations.
  *
  * \author Mathias M. Vege
  * \version 1.0
@@ -28,6 +29,10 @@ class ParallelParameters
 public:
     //! The WORLD_GROUP is the communicator used all processors allocated to the program.
     static MPI_Group WORLD_GROUP;
+    //! The communicator GROUP_COMM holds the processors of a chain or flow group. It is MPI_COMM_WORLD unless the processors are split in groups.
+    static MPI_Comm GROUP_COMM;
+    //! The communicator LEADER_COMM holds the first active processor of each group, and is MPI_COMM_NULL on the others or if there is a single group.
+    static MPI_Comm LEADER_COMM;
     /*!
      * The ACTIVE_GROUP is the communicator used for the processors involved directly in the calculation.
      *
@@ -37,7 +42,7 @@ public:
     //! The communicator ACTIVE_COMM is the communicator for the ACTIVE_GROUP.
     static MPI_Comm ACTIVE_COMM;
 
-    //! Variable for storing if processor is active(will always seek maximum possible of cores divisible to 2^n).
+    //! Variable for storing if processor is active(will always seek the maximum number of processors the lattice can be divided between).
     static bool active;
 
     ParallelParameters();
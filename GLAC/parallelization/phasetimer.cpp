@@ -0,0 +1,113 @@
+#include "phasetimer.h"
+#include "communicator.h"
+#include "parallelparameters.h"
+#include "config/parameters.h"
+#include "lib/json.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+using nlohmann::json;
+
+bool Parallel::PhaseTimer::m_enabled = false;
+int Parallel::PhaseTimer::m_depth = 0;
+double Parallel::PhaseTimer::m_phaseTimes[Parallel::PhaseTimer::m_NPhases] = {0, 0, 0};
+std::string Parallel::PhaseTimer::m_stageName = "";
+std::chrono::steady_clock::time_point Parallel::PhaseTimer::m_stageStart;
+std::vector<std::string> Parallel::PhaseTimer::m_stageNames = {};
+std::vector<double> Parallel::PhaseTimer::m_stageTimes = {};
+
+/*!
+ * \brief Parallel::PhaseTimer::beginStage resets the phase times and starts the wall time of a stage.
+ * \param stageName name of the stage, e.g. metropolis or flow.
+ */
+void Parallel::PhaseTimer::beginStage(const std::string &stageName)
+{
+    m_stageName = stageName;
+    for (unsigned int i = 0; i < m_NPhases; i++) {
+        m_phaseTimes[i] = 0;
+    }
+    m_stageStart = std::chrono::steady_clock::now();
+}
+
+/*!
+ * \brief Parallel::PhaseTimer::endStage stores the wall time and phase times of the current stage.
+ */
+void Parallel::PhaseTimer::endStage()
+{
+    m_stageNames.push_back(m_stageName);
+    m_stageTimes.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - m_stageStart).count());
+    for (unsigned int i = 0; i < m_NPhases; i++) {
+        m_stageTimes.push_back(m_phaseTimes[i]);
+    }
+}
+
+/*!
+ * \brief Parallel::PhaseTimer::writeReport gathers the stage times of all processors, prints a summary and writes them as JSON.
+ * \param filename the full path of the JSON file.
+ *
+ * Compute is the wall time of a stage not spent in any phase. For each stage and phase, the minimum, maximum and average over
+ * the processors are given, such that load imbalance shows as a maximum well above the average.
+ */
+void Parallel::PhaseTimer::writeReport(const std::string &filename)
+{
+    const int numprocs = Communicator::getNumProc();
+    const unsigned long NValues = m_stageTimes.size();
+
+    std::vector<double> allStageTimes(NValues * static_cast<unsigned long>(numprocs));
+    MPI_Gather(m_stageTimes.data(), int(NValues), MPI_DOUBLE, allStageTimes.data(), int(NValues), MPI_DOUBLE, 0, ParallelParameters::ACTIVE_COMM);
+
+    if (Communicator::getProcessRank() != 0) return;
+
+    const std::vector<std::string> timeNames = {"total", "compute", "haloExchange", "reduction", "io"};
+
+    json j;
+    j["numberOfProcessors"] = numprocs;
+    j["subDimensions"] = Parameters::getN();
+    j["NSpatial"] = Parameters::getNSpatial();
+    j["NTemporal"] = Parameters::getNTemporal();
+    j["stages"] = json::array();
+
+    printf("\n%-12s %-14s %12s %12s %12s %8s", "Stage", "Time", "Min(s)", "Avg(s)", "Max(s)", "Max/Avg");
+
+    for (unsigned long iStage = 0; iStage < m_stageNames.size(); iStage++) {
+        // Per processor total, compute and phase times
+        std::vector<std::vector<double>> times(timeNames.size(), std::vector<double>(static_cast<unsigned long>(numprocs)));
+        for (unsigned long iRank = 0; iRank < static_cast<unsigned long>(numprocs); iRank++) {
+            const double *rankTimes = &allStageTimes[iRank*NValues + iStage*(m_NPhases + 1)];
+            times[0][iRank] = rankTimes[0];
+            times[1][iRank] = rankTimes[0];
+            for (unsigned int iPhase = 0; iPhase < m_NPhases; iPhase++) {
+                times[2 + iPhase][iRank] = rankTimes[1 + iPhase];
+                times[1][iRank] -= rankTimes[1 + iPhase];
+            }
+        }
+
+        json stage;
+        stage["name"] = m_stageNames[iStage];
+        for (unsigned long iTime = 0; iTime < timeNames.size(); iTime++) {
+            const double minTime = *std::min_element(times[iTime].begin(), times[iTime].end());
+            const double maxTime = *std::max_element(times[iTime].begin(), times[iTime].end());
+            double avgTime = 0;
+            for (auto t : times[iTime]) avgTime += t;
+            avgTime /= double(numprocs);
+
+            stage[timeNames[iTime]]["perRank"] = times[iTime];
+            stage[timeNames[iTime]]["min"] = minTime;
+            stage[timeNames[iTime]]["max"] = maxTime;
+            stage[timeNames[iTime]]["avg"] = avgTime;
+
+            printf("\n%-12s %-14s %12.4E %12.4E %12.4E %8.3f", (iTime == 0 ? m_stageNames[iStage].c_str() : ""),
+                   timeNames[iTime].c_str(), minTime, avgTime, maxTime, (avgTime > 0 ? maxTime/avgTime : 1.0));
+        }
+        j["stages"].push_back(stage);
+    }
+    printf("\n");
+
+    std::ofstream file(filename);
+    file << std::setw(4) << j << std::endl;
+    file.close();
+
+    printf("\nScaling benchmark written to %s", filename.c_str());
+}
@@ -0,0 +1,93 @@
+/*!
+ * \class PhaseTimer
+ *
+ * \brief PhaseTimer accumulates the wall time each processor spends waiting on halo exchanges, in reductions and in file I/O.
+ *
+ * A run is divided into named stages, e.g. the Metropolis sweeps and the flow. For each stage the wall time is recorded together with
+ * the time spent in ScopedPhase blocks of each Phase, and the remainder is counted as compute. The times of all processors are
+ * gathered by writeReport, which prints the minimum, maximum and average of each stage and phase, and writes them per processor as JSON.
+ *
+ * Timing is only done when enabled, such that a disabled ScopedPhase costs a single branch.
+ *
+ * \author Mathias M. Vege
+ * \version 1.0
+ * \date 2017-2019
+ * \copyright MIT Licence
+ */
+#ifndef PHASETIMER_H
+#define PHASETIMER_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace Parallel
+{
+/*!
+ * \brief The Phase enum specifies what a processor is waiting on in a ScopedPhase.
+ */
+enum Phase {
+    HALO_EXCHANGE = 0,
+    REDUCTION = 1,
+    FILE_IO = 2
+};
+
+class PhaseTimer
+{
+private:
+    static const unsigned int m_NPhases = 3;
+
+    static bool m_enabled;
+    static int m_depth;
+    static double m_phaseTimes[m_NPhases];
+
+    static std::string m_stageName;
+    static std::chrono::steady_clock::time_point m_stageStart;
+
+    // Names of the completed stages, and for each the wall time followed by the time of each phase
+    static std::vector<std::string> m_stageNames;
+    static std::vector<double> m_stageTimes;
+
+    friend class ScopedPhase;
+public:
+    static void setEnabled(const bool enabled) { m_enabled = enabled; }
+    static bool getEnabled() { return m_enabled; }
+
+    static void beginStage(const std::string &stageName);
+    static void endStage();
+    static void writeReport(const std::string &filename);
+};
+
+/*!
+ * \brief The ScopedPhase class adds the time from its construction to its destruction to a Phase of the current stage.
+ *
+ * Nested ScopedPhases are counted once, in the phase of the outermost, such that e.g. a reduction within a file write is counted as file I/O.
+ */
+class ScopedPhase
+{
+private:
+    Phase m_phase;
+    bool m_active;
+    bool m_counting;
+    std::chrono::steady_clock::time_point m_start;
+public:
+    inline ScopedPhase(const Phase phase) : m_phase(phase), m_active(PhaseTimer::m_enabled), m_counting(false)
+    {
+        if (m_active && PhaseTimer::m_depth++ == 0) {
+            m_counting = true;
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    inline ~ScopedPhase()
+    {
+        if (!m_active) return;
+        if (m_counting) {
+            PhaseTimer::m_phaseTimes[m_phase] += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+        }
+        PhaseTimer::m_depth--;
+    }
+};
+}
+
+#endif // PHASETIMER_H
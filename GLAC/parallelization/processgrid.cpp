@@ -0,0 +1,160 @@
+#include "processgrid.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+/*!
+ * \brief fitsDimension checks that a number of processors may divide a lattice dimension.
+ * \param NDim the lattice extent in the dimension.
+ * \param processors the number of processors in the dimension.
+ * \return true if the processors divide the extent, and leave a sub-lattice extent larger than two if the dimension is split.
+ */
+bool fitsDimension(const unsigned int NDim, const unsigned int processors)
+{
+    return NDim % processors == 0 && (processors == 1 || NDim / processors > 2);
+}
+
+/*!
+ * \brief searchGrids tries every number of processors in a dimension that divides the processors left, and recurses to the next dimension.
+ * \param N the lattice extents.
+ * \param dim the dimension to place processors in.
+ * \param processorsLeft the processors not yet placed.
+ * \param grid the processors per dimension placed so far.
+ * \param bestGrid the valid grid with the smallest surface-to-volume ratio found so far, empty if none.
+ * \param bestRatio its surface-to-volume ratio.
+ */
+void searchGrids(const std::vector<unsigned int> &N, const unsigned int dim, const unsigned int processorsLeft,
+                 std::vector<unsigned int> &grid, std::vector<unsigned int> &bestGrid, double &bestRatio)
+{
+    if (dim == 3) {
+        if (!fitsDimension(N[3], processorsLeft)) return;
+
+        grid[3] = processorsLeft;
+        const double ratio = Parallel::ProcessGrid::surfaceToVolume(N, grid);
+        if (ratio < bestRatio) {
+            bestRatio = ratio;
+            bestGrid = grid;
+        }
+        return;
+    }
+
+    for (unsigned int processors = 1; processors <= processorsLeft; processors++) {
+        if (processorsLeft % processors != 0 || !fitsDimension(N[dim], processors)) continue;
+
+        grid[dim] = processors;
+        searchGrids(N, dim + 1, processorsLeft / processors, grid, bestGrid, bestRatio);
+    }
+}
+} // end anonymous namespace
+
+/*!
+ * \brief Parallel::ProcessGrid::decompose factorises a number of processors over the four dimensions.
+ * \param numprocs the number of processors.
+ * \param N the lattice extents, x, y, z and t.
+ * \return the number of processors per dimension with the smallest surface-to-volume ratio, or an empty vector if the processors can
+ * not divide the lattice.
+ *
+ * Of grids with the same ratio, the one splitting the later dimensions the most is chosen.
+ */
+std::vector<unsigned int> Parallel::ProcessGrid::decompose(const unsigned int numprocs, const std::vector<unsigned int> &N)
+{
+    std::vector<unsigned int> grid(4, 1);
+    std::vector<unsigned int> bestGrid;
+    double bestRatio = std::numeric_limits<double>::max();
+    if (numprocs == 0) return bestGrid;
+
+    searchGrids(N, 0, numprocs, grid, bestGrid, bestRatio);
+    return bestGrid;
+}
+
+/*!
+ * \brief Parallel::ProcessGrid::largestDecomposition finds the largest number of processors, not above a maximum, that divides the lattice.
+ * \param maxNumprocs the number of processors available.
+ * \param N the lattice extents, x, y, z and t.
+ * \return the number of processors per dimension, or an empty vector if not even a single processor is valid.
+ */
+std::vector<unsigned int> Parallel::ProcessGrid::largestDecomposition(const unsigned int maxNumprocs, const std::vector<unsigned int> &N)
+{
+    for (unsigned int numprocs = maxNumprocs; numprocs > 0; numprocs--) {
+        std::vector<unsigned int> grid = decompose(numprocs, N);
+        if (!grid.empty()) return grid;
+    }
+    return {};
+}
+
+/*!
+ * \brief Parallel::ProcessGrid::surfaceToVolume
+ * \param N the lattice extents, x, y, z and t.
+ * \param processorsPerDimension the number of processors in each dimension.
+ * \return the number of sites on the faces shared with other processors, per site of the sub-lattice.
+ */
+double Parallel::ProcessGrid::surfaceToVolume(const std::vector<unsigned int> &N, const std::vector<unsigned int> &processorsPerDimension)
+{
+    double ratio = 0;
+    for (unsigned int i = 0; i < 4; i++) {
+        // A split dimension has two faces, each of the sub-lattice volume divided by the sub-lattice extent
+        if (processorsPerDimension[i] > 1) {
+            ratio += 2.0 * double(processorsPerDimension[i]) / double(N[i]);
+        }
+    }
+    return ratio;
+}
+
+/*!
+ * \brief Parallel::ProcessGrid::nodeBlock finds the block of the process grid placed on each compute node.
+ * \param ranksPerNode the number of processors on each node.
+ * \param N the lattice extents, x, y, z and t.
+ * \param processorsPerDimension the number of processors in each dimension.
+ * \return the number of processors per dimension within a node, or an empty vector if the grid can not be tiled by blocks of the node size.
+ *
+ * The split dimensions are filled in order of their face size, largest first, the face being largest for the smallest sub-lattice extent.
+ */
+std::vector<unsigned int> Parallel::ProcessGrid::nodeBlock(const unsigned int ranksPerNode, const std::vector<unsigned int> &N,
+                                                           const std::vector<unsigned int> &processorsPerDimension)
+{
+    std::vector<unsigned int> dims = {0, 1, 2, 3};
+    std::stable_sort(dims.begin(), dims.end(), [&](const unsigned int a, const unsigned int b) {
+        return N[a] / processorsPerDimension[a] < N[b] / processorsPerDimension[b];
+    });
+
+    std::vector<unsigned int> block(4, 1);
+    unsigned int ranksLeft = ranksPerNode;
+    for (auto dim : dims) {
+        // The largest number of processors dividing both the processors in the dimension and the ranks left of the node
+        unsigned int processors = processorsPerDimension[dim];
+        while (ranksLeft % processors != 0 || processorsPerDimension[dim] % processors != 0) processors--;
+        block[dim] = processors;
+        ranksLeft /= processors;
+    }
+
+    if (ranksLeft != 1) return {};
+    return block;
+}
+
+/*!
+ * \brief Parallel::ProcessGrid::nodeMappedRank
+ * \param node the index of the compute node.
+ * \param localRank the rank of the processor within the node.
+ * \param processorsPerDimension the number of processors in each dimension.
+ * \param block the number of processors per dimension within a node, as given by nodeBlock.
+ * \return the rank in the process grid, ordered with x running fastest, such that the processors of a node form a block of the grid.
+ */
+unsigned int Parallel::ProcessGrid::nodeMappedRank(const unsigned int node, const unsigned int localRank,
+                                                   const std::vector<unsigned int> &processorsPerDimension, const std::vector<unsigned int> &block)
+{
+    unsigned int nodeRest = node;
+    unsigned int localRest = localRank;
+    unsigned int coordinates[4];
+    for (unsigned int i = 0; i < 4; i++) {
+        const unsigned int blocks = processorsPerDimension[i] / block[i];
+        coordinates[i] = (nodeRest % blocks) * block[i] + localRest % block[i];
+        nodeRest /= blocks;
+        localRest /= block[i];
+    }
+
+    unsigned int rank = 0;
+    for (int i = 3; i >= 0; i--) {
+        rank = rank * processorsPerDimension[i] + coordinates[i];
+    }
+    return rank;
+}
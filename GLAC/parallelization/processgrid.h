@@ -0,0 +1,42 @@
+/*!
+ * \class ProcessGrid
+ *
+ * \brief ProcessGrid finds how the lattice is divided between the processors.
+ *
+ * Any number of processors is factorised over the four dimensions, such that the number of processors in each dimension divides the
+ * lattice extent in that dimension, and leaves sub-lattice extents larger than two. Among the valid factorisations, the one with the
+ * smallest surface-to-volume ratio of the sub-lattice is chosen, as the surface decides the amount of halo communication. If no
+ * factorisation exists for the number of processors, largestDecomposition gives the largest number below it that has one.
+ *
+ * For placing the ranks on compute nodes, nodeBlock divides the grid into blocks of the size of a node, spanning the dimensions with the
+ * largest faces first, such that the halo exchanges across those faces stay within a node. nodeMappedRank gives the grid rank of a
+ * processor from its node and its rank within the node.
+ *
+ * \author Mathias M. Vege
+ * \version 1.0
+ * \date 2017-2019
+ * \copyright MIT Licence
+ */
+#ifndef PROCESSGRID_H
+#define PROCESSGRID_H
+
+#include <vector>
+
+namespace Parallel
+{
+class ProcessGrid
+{
+public:
+    static std::vector<unsigned int> decompose(const unsigned int numprocs, const std::vector<unsigned int> &N);
+    static std::vector<unsigned int> largestDecomposition(const unsigned int maxNumprocs, const std::vector<unsigned int> &N);
+    static double surfaceToVolume(const std::vector<unsigned int> &N, const std::vector<unsigned int> &processorsPerDimension);
+
+    // Placement of the grid on compute nodes
+    static std::vector<unsigned int> nodeBlock(const unsigned int ranksPerNode, const std::vector<unsigned int> &N,
+                                               const std::vector<unsigned int> &processorsPerDimension);
+    static unsigned int nodeMappedRank(const unsigned int node, const unsigned int localRank,
+                                       const std::vector<unsigned int> &processorsPerDimension, const std::vector<unsigned int> &block);
+};
+}
+
+#endif // PROCESSGRID_H
@@ -0,0 +1,135 @@
+#include "reductionbuffer.h"
+#include "communicator.h"
+#include "parallelparameters.h"
+#include "phasetimer.h"
+
+Parallel::ReductionBuffer::~ReductionBuffer()
+{
+    // A pending reduction must complete before its buffer is freed
+    if (m_request != MPI_REQUEST_NULL) {
+        MPI_Wait(&m_request, MPI_STATUS_IGNORE);
+    }
+}
+
+/*!
+ * \brief Parallel::ReductionBuffer::add adds values to be summed over the processors.
+ * \param data pointer to the values, which are replaced by their sums once the reduction is done.
+ * \param size number of values.
+ */
+void Parallel::ReductionBuffer::add(double *data, const unsigned long size)
+{
+    m_entries.push_back({data, size});
+}
+
+/*!
+ * \brief Parallel::ReductionBuffer::clear removes all values added, such that the buffer may be reused.
+ */
+void Parallel::ReductionBuffer::clear()
+{
+    if (m_request != MPI_REQUEST_NULL) {
+        wait();
+    }
+    m_entries.clear();
+}
+
+/*!
+ * \brief Parallel::ReductionBuffer::getSize
+ * \return the number of values added.
+ */
+unsigned long Parallel::ReductionBuffer::getSize() const
+{
+    unsigned long size = 0;
+    for (auto &entry : m_entries) {
+        size += entry.size;
+    }
+    return size;
+}
+
+/*!
+ * \brief Parallel::ReductionBuffer::pack copies the values added into the contiguous buffer.
+ */
+void Parallel::ReductionBuffer::pack()
+{
+    m_buffer.resize(getSize());
+    unsigned long iBuffer = 0;
+    for (auto &entry : m_entries) {
+        for (unsigned long i = 0; i < entry.size; i++) {
+            m_buffer[iBuffer++] = entry.data[i];
+        }
+    }
+}
+
+/*!
+ * \brief Parallel::ReductionBuffer::unpack copies the sums from the buffer back to the values added.
+ */
+void Parallel::ReductionBuffer::unpack()
+{
+    unsigned long iBuffer = 0;
+    for (auto &entry : m_entries) {
+        for (unsigned long i = 0; i < entry.size; i++) {
+            entry.data[i] = m_buffer[iBuffer++];
+        }
+    }
+}
+
+/*!
+ * \brief Parallel::ReductionBuffer::allreduce sums the values added over the active processors, with a single MPI_Allreduce.
+ *
+ * Must be called by all active processors, with values added in the same order.
+ */
+void Parallel::ReductionBuffer::allreduce()
+{
+    start();
+    wait();
+}
+
+/*!
+ * \brief Parallel::ReductionBuffer::reduce sums the values added over the active processors, with a single MPI_Reduce.
+ * \param root the processor to receive the sums. The values of the other processors are left as they were.
+ *
+ * Must be called by all active processors, with values added in the same order.
+ */
+void Parallel::ReductionBuffer::reduce(const int root)
+{
+    pack();
+    if (m_buffer.empty()) return;
+
+    ScopedPhase reduction(REDUCTION);
+    if (Communicator::getProcessRank() == root) {
+        MPI_Reduce(MPI_IN_PLACE, m_buffer.data(), int(m_buffer.size()), MPI_DOUBLE, MPI_SUM, root, ParallelParameters::ACTIVE_COMM);
+        unpack();
+    } else {
+        MPI_Reduce(m_buffer.data(), nullptr, int(m_buffer.size()), MPI_DOUBLE, MPI_SUM, root, ParallelParameters::ACTIVE_COMM);
+    }
+}
+
+/*!
+ * \brief Parallel::ReductionBuffer::start packs the values added and starts summing them over the active processors, with MPI_Iallreduce.
+ *
+ * Must be called by all active processors, with values added in the same order. The sums are available once wait has returned.
+ */
+void Parallel::ReductionBuffer::start()
+{
+    if (m_request != MPI_REQUEST_NULL) {
+        Communicator::MPIExit("Error: a reduction is already in progress in the ReductionBuffer.");
+    }
+    pack();
+    if (m_buffer.empty()) return;
+
+    ScopedPhase reduction(REDUCTION);
+    MPI_Iallreduce(MPI_IN_PLACE, m_buffer.data(), int(m_buffer.size()), MPI_DOUBLE, MPI_SUM, ParallelParameters::ACTIVE_COMM, &m_request);
+}
+
+/*!
+ * \brief Parallel::ReductionBuffer::wait completes the reduction started by start, and writes the sums back to the values added.
+ */
+void Parallel::ReductionBuffer::wait()
+{
+    if (m_request == MPI_REQUEST_NULL) return;
+
+    {
+        ScopedPhase reduction(REDUCTION);
+        MPI_Wait(&m_request, MPI_STATUS_IGNORE);
+    }
+    unpack();
+}
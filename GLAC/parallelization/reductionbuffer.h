@@ -0,0 +1,65 @@
+/*!
+ * \class ReductionBuffer
+ *
+ * \brief ReductionBuffer sums several observables over the active processors in a single collective.
+ *
+ * Scalars and arrays, e.g. the per-timeslice values of an observable, are added with add, and are packed into one contiguous buffer
+ * when the reduction is started. Once the reduction is done the sums are written back to where the values were added from. Instead of
+ * one MPI_Allreduce or MPI_Reduce per scalar, a flow step or a configuration then costs a single collective, whose latency dominates
+ * for the few doubles of an observable on many processors.
+ *
+ * The reduction may be blocking, by allreduce or reduce, or non-blocking, by start followed by wait, such that the reduction may overlap
+ * other work. The values added must not be changed or moved between start and wait.
+ *
+ * \author Mathias M. Vege
+ * \version 1.0
+ * \date 2017-2019
+ * \copyright MIT Licence
+ */
+#ifndef REDUCTIONBUFFER_H
+#define REDUCTIONBUFFER_H
+
+#include <mpi.h>
+#include <vector>
+
+namespace Parallel
+{
+class ReductionBuffer
+{
+private:
+    struct Entry
+    {
+        double *data;
+        unsigned long size;
+    };
+
+    std::vector<Entry> m_entries;
+    std::vector<double> m_buffer;
+    MPI_Request m_request = MPI_REQUEST_NULL;
+    // Rank to receive the sums, or -1 if all processors do
+    int m_root = -1;
+
+    void pack();
+    void unpack();
+public:
+    ReductionBuffer() {}
+    ~ReductionBuffer();
+
+    void add(double *data, const unsigned long size = 1);
+    void add(std::vector<double> &data) { add(data.data(), data.size()); }
+    void clear();
+
+    // Blocking reductions
+    void allreduce();
+    void reduce(const int root = 0);
+
+    // Non-blocking reduction to all processors
+    void start();
+    void wait();
+
+    // Getters
+    unsigned long getSize() const;
+};
+}
+
+#endif // REDUCTIONBUFFER_H
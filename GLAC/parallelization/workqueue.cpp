@@ -0,0 +1,56 @@
+#include "workqueue.h"
+#include "parallelparameters.h"
+
+/*!
+ * \brief Parallel::WorkQueue::WorkQueue sets up the queue, and must be called by the active processors of all groups.
+ * \param size the number of items in the queue.
+ */
+Parallel::WorkQueue::WorkQueue(const unsigned long size) :
+    m_size(size), m_grouped(ParallelParameters::GROUP_COMM != MPI_COMM_WORLD)
+{
+    if (ParallelParameters::LEADER_COMM == MPI_COMM_NULL) return;
+
+    int leaderRank = 0;
+    MPI_Comm_rank(ParallelParameters::LEADER_COMM, &leaderRank);
+    const MPI_Aint windowSize = leaderRank == 0 ? MPI_Aint(sizeof(long)) : 0;
+    MPI_Win_allocate(windowSize, sizeof(long), MPI_INFO_NULL, ParallelParameters::LEADER_COMM, &m_counter, &m_window);
+
+    if (leaderRank == 0) {
+        MPI_Win_lock(MPI_LOCK_EXCLUSIVE, 0, 0, m_window);
+        *m_counter = 0;
+        MPI_Win_unlock(0, m_window);
+    }
+    MPI_Barrier(ParallelParameters::LEADER_COMM);
+}
+
+Parallel::WorkQueue::~WorkQueue()
+{
+    if (m_window != MPI_WIN_NULL) {
+        MPI_Win_free(&m_window);
+    }
+}
+
+/*!
+ * \brief Parallel::WorkQueue::next takes the next item of the queue for the group, and must be called by all active processors of the group.
+ * \param item set to the item taken.
+ * \return false once the queue is empty.
+ */
+bool Parallel::WorkQueue::next(unsigned long &item)
+{
+    long taken = 0;
+    if (!m_grouped) {
+        taken = long(m_next++);
+    } else {
+        if (m_window != MPI_WIN_NULL) {
+            const long increment = 1;
+            MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, m_window);
+            MPI_Fetch_and_op(&increment, &taken, MPI_LONG, 0, 0, MPI_SUM, m_window);
+            MPI_Win_unlock(0, m_window);
+        }
+        // The leader of the group passes the item on to the rest of the group
+        MPI_Bcast(&taken, 1, MPI_LONG, 0, ParallelParameters::ACTIVE_COMM);
+    }
+
+    item = static_cast<unsigned long>(taken);
+    return item < m_size;
+}
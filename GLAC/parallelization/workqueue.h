@@ -0,0 +1,40 @@
+/*!
+ * \class WorkQueue
+ *
+ * \brief WorkQueue hands out the items of a list, e.g. configurations to flow, to the processor groups that are ready first.
+ *
+ * The next item is a counter held by the first group leader in an MPI window, and is taken by the leader of a group with an atomic
+ * MPI_Fetch_and_op, such that faster groups take more items without any group waiting for the others. The leader passes the item on to the
+ * active processors of its group. With a single group the items are simply handed out in order.
+ *
+ * \author Mathias M. Vege
+ * \version 1.0
+ * \date 2017-2019
+ * \copyright MIT Licence
+ */
+#ifndef WORKQUEUE_H
+#define WORKQUEUE_H
+
+#include <mpi.h>
+
+namespace Parallel
+{
+class WorkQueue
+{
+private:
+    unsigned long m_size;
+    // True if the processors are split in groups sharing the queue
+    bool m_grouped;
+    // The items handed out so far, only used with a single group
+    unsigned long m_next = 0;
+    MPI_Win m_window = MPI_WIN_NULL;
+    long *m_counter = nullptr;
+public:
+    WorkQueue(const unsigned long size);
+    ~WorkQueue();
+
+    bool next(unsigned long &item);
+};
+}
+
+#endif // WORKQUEUE_H
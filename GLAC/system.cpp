@@ -1,10 +1,17 @@
 #include "system.h"
 #include "config/parameters.h"
 #include "parallelization/parallel.h"
+#include "parallelization/neighbours.h"
 #include "io/fieldio.h"
+#include "io/observablescontainer.h"
+#include "io/checkpointio.h"
 #include <cmath>    // For exp()
+#include <algorithm>
+#include <cstring>
+#include <sstream>
 #include <mpi.h>
 #include "config/sysprint.h"
+#include "instrumentation/timers.h"
 
 using std::cout;
 using std::endl;
@@ -13,6 +20,58 @@ using std::chrono::duration_cast;
 
 using std::chrono::duration;
 
+namespace {
+    // Counters of the Markov chain, stored at the start of each checkpoint block
+    struct CheckpointCounters
+    {
+        unsigned int systemIsThermalized;
+        unsigned int storeThermalizationObservables;
+        unsigned int iThermStart;
+        unsigned int iConfigStart;
+        unsigned int NThermSteps;
+        unsigned int numberOfObservables;
+        unsigned int observablesLength;
+        unsigned int NCor;
+        unsigned int iAdaptiveStart;
+        unsigned int padding;
+        double acceptanceScore;
+        double updateStorer;
+        double updateStorerTherm;
+        unsigned long long NSweeps;
+    };
+
+    inline void packState(std::vector<char> &state, const void *data, const std::size_t size)
+    {
+        const char *bytes = static_cast<const char*>(data);
+        state.insert(state.end(), bytes, bytes + size);
+    }
+
+    inline void unpackState(const std::vector<char> &state, std::size_t &position, void *data, const std::size_t size)
+    {
+        if (position + size > state.size()) {
+            Parallel::Communicator::MPIExit("Error: checkpoint block is shorter than expected.");
+        }
+        std::memcpy(data, &state[position], size);
+        position += size;
+    }
+
+    inline void packString(std::vector<char> &state, const std::string &str)
+    {
+        const unsigned long long length = str.size();
+        packState(state, &length, sizeof(unsigned long long));
+        packState(state, str.data(), str.size());
+    }
+
+    inline std::string unpackString(const std::vector<char> &state, std::size_t &position)
+    {
+        unsigned long long length = 0;
+        unpackState(state, position, &length, sizeof(unsigned long long));
+        std::string str(length, '\0');
+        unpackState(state, position, &str[0], length);
+        return str;
+    }
+}
+
 System::System()
 {
     /*
@@ -39,6 +98,17 @@ System::System()
         // Initializing the Mersenne-Twister19937 RNG for the Metropolis algorithm
         m_generator                         = std::mt19937_64(Parameters::getMetropolisSeed());
         m_uniform_distribution              = std::uniform_real_distribution<double>(0,1);
+
+        // Checkpoint interval is given in minutes of wall time
+        m_checkpointInterval                = Parameters::getCheckpointInterval()*60.0;
+        m_lastCheckpoint                    = steady_clock::now();
+
+        // Detector for ending the thermalization once the plaquette has stabilized
+        if (Parameters::getAutoThermalization()) {
+            // The windows are given in updates, and hold a plaquette measured every thermalizationInterval updates
+            m_thermalizationDetector        = new ThermalizationDetector(Parameters::getThermalizationWindow() / Parameters::getThermalizationInterval(),
+                                                                         Parameters::getThermalizationTolerance());
+        }
     }
     Parallel::Communicator::setBarrier();
 }
@@ -135,12 +205,16 @@ System::~System()
     if (Parallel::ParallelParameters::active) {
         delete m_S;
         delete m_SU3Generator;
+        delete m_thermalizationDetector;
         delete [] m_lattice;
         delete m_correlator;
 
         // Deleting flow related variables - should strictly speaking not be necesseary.
         delete [] m_flowLattice;
         delete m_flowCorrelator;
+        delete m_flowAnalysis;
+        delete m_flowSchedule;
+        delete m_scaleSetting;
         delete m_flow;
     }
 }
@@ -160,6 +234,14 @@ void System::subLatticeSetup()
         m_lattice[mu].allocate(m_N);
     }
 
+    // Links of other processors are fetched one-sided for a checkerboard Metropolis sweep
+    if (Parameters::getOneSidedMetropolis()) {
+        if (Parameters::getNSpatial() % 2 != 0 || Parameters::getNTemporal() % 2 != 0) {
+            Parallel::Communicator::MPIExit("Error: oneSidedMetropolis requires even lattice dimensions.");
+        }
+        Parallel::LinkWindow::initialize(m_N);
+    }
+
     // Sets pointers
     setAction();
     setObservable(Parameters::getObservablesList(),false);
@@ -172,6 +254,19 @@ void System::subLatticeSetup()
         for (int mu = 0; mu < 4; mu++) {
             m_flowLattice[mu].allocate(m_N);
         }
+        if (Parameters::getFlowSchedule().size() != 0) {
+            m_flowSchedule = new FlowSchedule(m_flowCorrelator, Parameters::getFlowSchedule(), m_NFlows,
+                                              Parameters::getFlowEpsilon(), Parameters::getFlowScheduleAdaptiveWidth());
+        }
+        if (Parameters::getScaleSetting()) {
+            m_scaleSetting = new ScaleSetting(m_flowCorrelator, m_NFlows, Parameters::getFlowEpsilon(), Parameters::getScaleSettingMargin());
+        }
+        if (Parameters::getFlowAnalysis()) {
+            m_flowAnalysis = new FlowAnalysis(m_flowCorrelator, m_NFlows, Parameters::getFlowEpsilon());
+        }
+        if ((m_flowSchedule != nullptr && m_flowSchedule->isAdaptive()) || m_scaleSetting != nullptr) {
+            m_flowEnergy = m_flowCorrelator->getObservableStorer("energy");
+        }
     }
     IO::FieldIO::init();
 }
@@ -196,19 +291,24 @@ void System::latticeSetup()
      * Sets up the lattice and its matrices.
      */
     if (Parallel::ParallelParameters::active) {
+        // Continues from the last checkpoint of the batch if there is one, such that a failed run may be started again as it is.
+        // Decided before the observables are set up, as e.g. the file of the scales is only kept when continuing from a checkpoint.
+        if (IO::CheckpointIO::resumeIfCheckpointed() && m_processRank == 0) {
+            printf("\nResuming from the checkpoint of batch %s\n", Parameters::getBatchName().c_str());
+        }
         subLatticeSetup();
-        if (!Parameters::getLoadFieldConfigurations() && !Parameters::getLoadConfigAndRun()) {
+        if (!Parameters::getLoadFieldConfigurations() && !Parameters::getLoadConfigAndRun() && !Parameters::getRestartFromCheckpoint()) {
             if (Parameters::getHotStart()) {
-                // All starts with a completely random matrix.
+                // All starts with a completely random matrix, drawn in lexicographic order whatever the site ordering.
                 for (int mu = 0; mu < 4; mu++)
                 {
                     for (unsigned long iSite = 0; iSite < m_subLatticeSize; iSite++)
                     {
                         if (Parameters::getRSTHotStart())
                         {
-                            m_lattice[mu][iSite] = m_SU3Generator->generateRST(); // Random close to unity
+                            m_lattice[mu][Parallel::Index::getSiteIndex(iSite)] = m_SU3Generator->generateRST(); // Random close to unity
                         } else {
-                            m_lattice[mu][iSite] = m_SU3Generator->generateRandom(); // Fully random
+                            m_lattice[mu][Parallel::Index::getSiteIndex(iSite)] = m_SU3Generator->generateRandom(); // Fully random
                         }
                     }
                 }
@@ -231,7 +331,9 @@ void System::latticeSetup()
 }
 
 /*!
- * \brief System::run based on passed parameters, does one of three things:
+ * \brief System::run based on passed parameters, does one of five things:
+ *  - runs a scaling benchmark of a fixed number of sweeps and flow steps.
+ *  - restores the Markov chain from a checkpoint and continues generating configurations.
  *  - run regular metropolis to generate configurations.
  *  - load a thermalized configuration and run metropolis to generate configurations.
  *  - loads a set of configurations and flows them.
@@ -239,22 +341,40 @@ void System::latticeSetup()
 void System::run()
 {
     /*
-     * Overarching run function, which sets us of to three posibilities:
+     * Overarching run function, which sets us of to five posibilities:
+     *  - time sweeps and flow steps for a scaling benchmark
+     *  - restore a checkpoint and continue generating configurations
      *  - run regular metropolis to generate configurations
      *  - load a thermalized configuration and run metropolis to generate configurations
-     *  - loads a set of configurations and flows them
+     *  - loads a set of configurations and flows them, or only measures them if NFlows is zero
      */
     if (Parallel::ParallelParameters::active) {
-        if (!Parameters::getLoadFieldConfigurations() && !Parameters::getLoadConfigAndRun()) {
+        if (Parameters::getScalingBenchmark()) {
+            // Times a fixed number of sweeps and flow steps, split into compute, communication and I/O
+            runScalingBenchmark();
+        } else if (Parameters::getRestartFromCheckpoint()) {
+            // Restores the lattice, RNGs, counters and observables, and continues where the checkpoint was made
+            if (Parameters::getLoadConfigAndRun()) {
+                m_storeThermalizationObservables = false;
+            }
+            loadCheckpoint();
+            runMetropolis();
+        } else if (!Parameters::getLoadFieldConfigurations() && !Parameters::getLoadConfigAndRun()) {
             // Run regular metropolis
             runMetropolis();
         } else if (Parameters::getLoadConfigAndRun()) {
             // Loads a configuration(which is assumed to be thermalized), and then continue generating from that configuration
             loadConfigurationAndRunMetropolis();
+        } else if (m_NFlows == 0) {
+            // Measures the observables on the configurations without flowing them
+            measureConfigurations();
         } else {
             // Run flow on configurations;
             flowConfigurations();
         }
+
+        // Writes any flow observables still buffered for the binary containers
+        IO::ObservablesContainer::flushAll();
     }
     Parallel::Communicator::setBarrier(); // For waiting for all processors to finish at equal times
 }
@@ -269,17 +389,22 @@ void System::thermalize()
         // Storing the number of shifts that are needed in the observable storage container. Will be used for main for loop shifting.
         m_NThermSteps = 1 + m_NTherm;
 
-        // Calculating correlator before any updates have began.
-        m_correlator->calculate(m_lattice,0); // Averaging is done if specified for observable in statistics after run is done.
+        // Calculating correlator before any updates have began, unless continuing from a checkpoint.
+        if (m_iThermStart == 1) {
+            m_correlator->calculate(m_lattice,0); // Averaging is done if specified for observable in statistics after run is done.
+        }
         if (m_processRank == 0) {
             printf("\ni    ");
             m_correlator->printHeader();
-            printf("\n%-4d ",0);
+            if (m_iThermStart == 1) printf("\n%-4d ",0);
+        }
+        if (m_iThermStart == 1) {
+            m_correlator->printObservable(0);
         }
-        m_correlator->printObservable(0);
     }
-    // Running thermalization
-    for (unsigned int iTherm = 1; iTherm < m_NTherm + 1; iTherm++)
+    // Running thermalization. May end before NTherm updates if the thermalization detector is used
+    unsigned int NThermUpdates = m_NTherm;
+    for (unsigned int iTherm = m_iThermStart; iTherm < m_NTherm + 1; iTherm++)
     {
         // Pre update time
         m_preUpdate = steady_clock::now();
@@ -301,11 +426,32 @@ void System::thermalize()
             if (m_processRank == 0) printf("\n%-4d ", iTherm);
             m_correlator->printObservable(iTherm);
         }
+
+        // Ends the thermalization once the plaquette no longer drifts. Root decides, such that all processors agree
+        if (m_thermalizationDetector != nullptr && iTherm % Parameters::getThermalizationInterval() == 0) {
+            m_thermalizationDetector->push(Plaquette::computePlaquette(m_lattice));
+            int thermalized = 0;
+            if (m_processRank == 0) {
+                thermalized = iTherm >= Parameters::getNThermMin() && m_thermalizationDetector->isThermalized();
+            }
+            MPI_Bcast(&thermalized, 1, MPI_INT, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+            if (thermalized) {
+                NThermUpdates = iTherm;
+                if (m_processRank == 0) {
+                    printf("\nThermalized after %d updates. Plaquette windows of %d updates differ by %.4E, with a standard error of %.4E",
+                           iTherm, Parameters::getThermalizationWindow(), m_thermalizationDetector->getDifference(),
+                           m_thermalizationDetector->getDifferenceError());
+                }
+                break;
+            }
+        }
+
+        checkpoint(iTherm + 1, 0);
     }
 
     // Printing out the avg. update time one more time at the end, to avoid unfinnished percentage sign
     if (m_processRank == 0) {
-        printf("\n%6.2f %% done. Avg. update time: %10.6f sec", 100.0, m_updateStorerTherm/double(m_NTherm + 1));
+        printf("\n%6.2f %% done. Avg. update time: %10.6f sec", 100.0, m_updateStorerTherm/double(NThermUpdates + 1));
     }
 
     // Taking the average of the acceptance rate across the processors.
@@ -313,7 +459,7 @@ void System::thermalize()
         MPI_Allreduce(&m_acceptanceScore, &m_acceptanceScore, 1, MPI_DOUBLE, MPI_SUM, Parallel::ParallelParameters::ACTIVE_COMM);
         // Printing post-thermalization correlator and acceptance rate
         if (m_processRank == 0) {
-            printf("\nTermalization complete. Acceptance rate: %f", m_acceptanceScore/double(m_NTherm));
+            printf("\nTermalization complete. Acceptance rate: %f", m_acceptanceScore/double(NThermUpdates));
         }
     }
 }
@@ -335,29 +481,98 @@ void System::update()
     /*
      * Sweeps the entire Lattice, and gives every matrix a chance to update.
      */
+    GLAC_TIMER(SYSTEM_UPDATE);
+    if (Parameters::getOneSidedMetropolis()) {
+        sweepCheckerboard();
+    } else {
+        sweepLexicographic();
+    }
+    // Updates acceptance storer
+    m_acceptanceScore += double(m_acceptanceCounter)/double(4*m_NUpdates*Parameters::getSubLatticeSize());
+    m_acceptanceCounter = 0;
+}
+
+/*!
+ * \brief System::updateSite gives the link at a site a number of Metropolis updates.
+ * \param x
+ * \param y
+ * \param z
+ * \param t
+ * \param mu the link direction.
+ */
+void System::updateSite(const unsigned int x, const unsigned int y, const unsigned int z, const unsigned int t, const int mu)
+{
+    m_S->computeStaple(m_lattice, x, y, z, t, mu);
+    for (unsigned int n = 0; n < m_NUpdates; n++) // Runs avg 10 updates on link, as that is less costly than other parts
+    {
+        updateLink(Parallel::Index::getIndex(x,y,z,t), mu);
+        if (exp(-m_S->getDeltaAction(m_lattice[mu][Parallel::Index::getIndex(x,y,z,t)], m_updatedMatrix)) > m_uniform_distribution(m_generator))
+        {
+            m_lattice[mu][Parallel::Index::getIndex(x,y,z,t)] = m_updatedMatrix;
+            m_acceptanceCounter++;
+        }
+    }
+}
+
+/*!
+ * \brief System::sweepLexicographic updates the links site by site, with the processors fetching the links of each other in lock-step.
+ */
+void System::sweepLexicographic()
+{
     for (unsigned int x = 0; x < m_N[0]; x++) {
         for (unsigned int y = 0; y < m_N[1]; y++) {
             for (unsigned int z = 0; z < m_N[2]; z++) {
                 for (unsigned int t = 0; t < m_N[3]; t++) {
                     for (int mu = 0; mu < 4; mu++) {
-                        m_S->computeStaple(m_lattice, x, y, z, t, mu);
-                        for (unsigned int n = 0; n < m_NUpdates; n++) // Runs avg 10 updates on link, as that is less costly than other parts
-                        {
-                            updateLink(Parallel::Index::getIndex(x,y,z,t), mu);
-                            if (exp(-m_S->getDeltaAction(m_lattice[mu][Parallel::Index::getIndex(x,y,z,t)], m_updatedMatrix)) > m_uniform_distribution(m_generator))
-                            {
-                                m_lattice[mu][Parallel::Index::getIndex(x,y,z,t)] = m_updatedMatrix;
-                                m_acceptanceCounter++;
-                            }
+                        updateSite(x, y, z, t, mu);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/*!
+ * \brief System::sweepCheckerboard updates the links of one direction and one parity at a time, with the links of other processors
+ * fetched one-sided before each phase.
+ *
+ * The staple of a link only holds links of other directions, or of the same direction at sites of the other parity, such that the links
+ * of a phase may be updated in any order. The parity is that of the site in the full lattice.
+ */
+void System::sweepCheckerboard()
+{
+    Parallel::LinkWindow::attach(m_lattice);
+
+    unsigned int originParity = 0;
+    for (int i = 0; i < 4; i++) {
+        originParity += (unsigned int)(Parallel::Neighbours::getProcessorDimensionPosition(i)) * m_N[i];
+    }
+
+    for (int mu = 0; mu < 4; mu++) {
+        for (unsigned int parity = 0; parity < 2; parity++) {
+            // All directions at the start of the sweep, and after that the direction updated in the previous phase
+            if (mu == 0 && parity == 0) {
+                for (int nu = 0; nu < 4; nu++) {
+                    Parallel::LinkWindow::fetch(nu);
+                }
+            } else {
+                Parallel::LinkWindow::fetch(parity == 0 ? mu - 1 : mu);
+            }
+
+            for (unsigned int x = 0; x < m_N[0]; x++) {
+                for (unsigned int y = 0; y < m_N[1]; y++) {
+                    for (unsigned int z = 0; z < m_N[2]; z++) {
+                        for (unsigned int t = 0; t < m_N[3]; t++) {
+                            if ((originParity + x + y + z + t) % 2 != parity) continue;
+                            updateSite(x, y, z, t, mu);
                         }
                     }
                 }
             }
         }
     }
-    // Updates acceptance storer
-    m_acceptanceScore += double(m_acceptanceCounter)/double(4*m_NUpdates*Parameters::getSubLatticeSize());
-    m_acceptanceCounter = 0;
+
+    Parallel::LinkWindow::detach();
 }
 
 void System::runMetropolis()
@@ -365,12 +580,15 @@ void System::runMetropolis()
     /*
      * Runs the generation of gauge field configurations through the Metropolis algorithm.
      */
-    // Variables for checking performance of the thermalization update.
-    m_updateStorerTherm = 0;
+    // Variables for checking performance of the thermalization update. Restored instead when continuing from a checkpoint.
+    if (!Parameters::getRestartFromCheckpoint()) {
+        m_updateStorerTherm = 0;
+    }
 
     // System thermalization
     if (!m_systemIsThermalized) {
         thermalize();
+        m_systemIsThermalized = true;
     }
 
     // Printing header for main run
@@ -382,13 +600,25 @@ void System::runMetropolis()
 
     // Setting the System acceptance counter to 0 in order not to count the thermalization
     m_acceptanceCounter = 0;
-    m_acceptanceScore = 0;
+    if (m_iConfigStart == 0) {
+        m_acceptanceScore = 0;
+        m_NSweeps = 0;
+
+        // Variables for checking performance of the update.
+        m_updateStorer = 0;
+    }
 
-    // Variables for checking performance of the update.
-    m_updateStorer = 0;
+    // Feeds the statistics with the configurations made before continuing from a checkpoint, with the autocorrelation estimate
+    // restarted at the last adjustment of NCor
+    for (unsigned int iConfig = 0; iConfig < m_iConfigStart; iConfig++) {
+        if (iConfig == m_iAdaptiveStart) {
+            m_correlator->resetAutocorrelation();
+        }
+        m_correlator->accumulateStatistics(iConfig + m_NThermSteps);
+    }
 
     // Main part of algorithm
-    for (unsigned int iConfig = 0; iConfig < m_NCf; iConfig++)
+    for (unsigned int iConfig = m_iConfigStart; iConfig < m_NCf; iConfig++)
     {
         for (unsigned int i = 0; i < m_NCor; i++) // Updating NCor times before updating the lattice
         {
@@ -400,6 +630,7 @@ void System::runMetropolis()
             m_updateTime = duration_cast<duration<double>>(steady_clock::now() - m_preUpdate);
             m_updateStorer += m_updateTime.count();
         }
+        m_NSweeps += m_NCor;
 
         if (Parameters::getDebug()) {
             Parallel::Communicator::checkLattice(m_lattice, "Configuration is corrupt in system right before copying to flow lattice");
@@ -431,13 +662,19 @@ void System::runMetropolis()
         }
         m_correlator->printObservable(iConfig + m_NThermSteps);
 
+        // Adds the configuration to the statistics of the run
+        m_correlator->accumulateStatistics(iConfig + m_NThermSteps);
+
         if (m_processRank == 0) {
             // Adds time per cfg to output
-            printf(" %-12.8f",m_updateStorer/double((iConfig+1)*m_NCor));
+            printf(" %-12.8f",m_updateStorer/double(m_NSweeps));
 
-            // Adding the acceptance ratio
+            // Adding the acceptance ratio, and the running mean and error of the observables if verbose
             if (iConfig % 10 == 0) {
-                printf("     %-10.8f", m_acceptanceScore/double((iConfig+1)*m_NCor));
+                printf("     %-10.8f", m_acceptanceScore/double(m_NSweeps));
+                if (Parameters::getVerbose()) {
+                    m_correlator->printRunningStatistics();
+                }
             } else {
                 printf("               ");
             }
@@ -449,6 +686,11 @@ void System::runMetropolis()
             IO::FieldIO::writeFieldToFile(m_lattice,iConfig);
         }
 
+        if (Parameters::getAdaptiveNCor() && iConfig + 1 - m_iAdaptiveStart >= Parameters::getAdaptiveNCorInterval()) {
+            adaptNCor(iConfig + 1);
+        }
+
+        checkpoint(m_iThermStart, iConfig + 1);
     }
 
     // Taking the average of the acceptance rate across the processors.
@@ -458,14 +700,18 @@ void System::runMetropolis()
         SysPrint::printLine();
         printf("System completed.");
         printf("\nAcceptancerate: %.16f ", getAcceptanceRate());
-        printf("\nAverage update time: %.6f sec.", m_updateStorer/double(m_NCf*m_NCor));
-        printf("\nTotal update time for %d updates: %.6f sec.\n", m_NCf*m_NCor, m_updateStorer + m_updateStorerTherm);
+        printf("\nAverage update time: %.6f sec.", m_updateStorer/double(m_NSweeps));
+        printf("\nTotal update time for %llu updates: %.6f sec.\n", m_NSweeps, m_updateStorer + m_updateStorerTherm);
         SysPrint::printLine();
     }
 
     m_correlator->runStatistics();
     m_correlator->writeObservableToFile(getAcceptanceRate()); // Runs statistics, writes to file, and prints results (if verbose is on)
     m_correlator->printStatistics();
+
+    if (m_flowAnalysis != nullptr) {
+        m_flowAnalysis->analyze();
+    }
 }
 
 void System::flowConfiguration(const unsigned int iConfig)
@@ -473,21 +719,28 @@ void System::flowConfiguration(const unsigned int iConfig)
     /*
      * Flows configuration, performs flow statistics and writes it to a file.
      */
+    GLAC_TIMER(SYSTEM_FLOW_CONFIGURATION);
 
     // After each configuration has been flowed, the values must be resetted.
     m_flowCorrelator->reset();
+    if (m_flowSchedule != nullptr) {
+        m_flowSchedule->reset();
+        m_flowSchedule->schedule(0);
+    }
+    if (m_scaleSetting != nullptr) {
+        m_scaleSetting->reset();
+    }
 
     // Calculates the flow observables at zeroth flow time
     m_flowCorrelator->calculate(m_flowLattice, 0);
-    if (Parameters::getVerbose()) {
-        m_flowCorrelator->printObservable(0);
-    }
+    finishFlowStep(0);
 
     if (Parameters::getDebug()) {
         Parallel::Communicator::checkLattice(m_flowLattice, "Configuration is corrupt at flowConfiguration pt 2.");
     }
 
-    // Runs the flow
+    // Runs the flow, which may be ended early once the scales have been passed
+    unsigned int iFlowLast = m_NFlows;
     for (unsigned int iFlow = 0; iFlow < m_NFlows; iFlow++)
     {
         if (Parameters::getDebug()) {
@@ -500,13 +753,29 @@ void System::flowConfiguration(const unsigned int iConfig)
             Parallel::Communicator::checkLattice(m_flowLattice, "Configuration is corrupt at flowConfiguration pt 2.5, after flow.");
         }
 
+        // Flow times where no observable is scheduled are skipped
+        if (m_flowSchedule != nullptr && !m_flowSchedule->schedule(iFlow + 1)) continue;
+
         m_flowCorrelator->calculate(m_flowLattice,iFlow + 1);
 
-        if (Parameters::getVerbose()) {
-            m_flowCorrelator->printObservable(iFlow + 1);
+        if (finishFlowStep(iFlow + 1)) {
+            iFlowLast = iFlow + 1;
+            // The last flow step reached must hold every observable
+            if (m_flowSchedule != nullptr && m_flowSchedule->scheduleAll(iFlowLast)) {
+                m_flowCorrelator->calculate(m_flowLattice, iFlowLast);
+            }
+            break;
         }
     }
 
+    // Marks the observables at the flow times that were not measured
+    if (m_flowSchedule != nullptr) {
+        m_flowSchedule->markSkipped(iFlowLast);
+    }
+    if (m_scaleSetting != nullptr) {
+        m_scaleSetting->finish(iFlowLast);
+    }
+
     if (Parameters::getDebug()) {
         Parallel::Communicator::checkLattice(m_flowLattice, "Configuration is corrupt at flowConfiguration pt 3.");
     }
@@ -514,6 +783,108 @@ void System::flowConfiguration(const unsigned int iConfig)
     // Write flow data to file
     m_flowCorrelator->writeFlowObservablesToFile(iConfig);
 
+    if (m_scaleSetting != nullptr) {
+        m_scaleSetting->writeScales(iConfig);
+    }
+
+    // Keeps the gathered flow observables for the analysis at the end of the run
+    if (m_flowAnalysis != nullptr) {
+        m_flowAnalysis->addConfiguration();
+    }
+}
+
+/*!
+ * \brief System::finishFlowStep prints the flow observables of a flow step, and updates the flow schedule and the scale setting.
+ * \param iFlow the flow step just measured.
+ * \return true if the scale setting ends the flow at the flow step.
+ *
+ * The energy needed by the adaptive flow schedule and by the scale setting is summed over the processors once for both. The reduction is
+ * non-blocking, such that it overlaps the reduction and printing of the flow observables.
+ */
+bool System::finishFlowStep(const unsigned int iFlow)
+{
+    Parallel::ReductionBuffer reduction;
+    double energy = 0;
+    const bool energyMeasured = m_flowEnergy != nullptr && m_flowEnergy->isScheduled();
+    if (energyMeasured) {
+        energy = m_flowEnergy->getObservable(iFlow);
+        reduction.add(&energy);
+        reduction.start();
+    }
+
+    if (Parameters::getVerbose()) {
+        m_flowCorrelator->printObservable(iFlow);
+    }
+
+    if (!energyMeasured) return false;
+
+    reduction.wait();
+    if (m_flowSchedule != nullptr) {
+        m_flowSchedule->update(iFlow, energy);
+    }
+    return m_scaleSetting != nullptr && m_scaleSetting->update(iFlow, energy);
+}
+
+/*!
+ * \brief System::runScalingBenchmark times scalingBenchmarkSweeps Metropolis sweeps and NFlows flow steps.
+ *
+ * Each stage is split by Parallel::PhaseTimer into compute, halo exchange, reductions and file I/O for every processor,
+ * and written to <batch>_scaling_benchmark.json in the observables folder. A loaded configuration is timed as a load stage
+ * and used as the starting point, and the lattice is written as a stage of its own if configurations are to be stored.
+ */
+void System::runScalingBenchmark()
+{
+    Parallel::PhaseTimer::setEnabled(true);
+
+    if (Parameters::getLoadFieldConfigurations() || Parameters::getLoadConfigAndRun()) {
+        std::vector<std::string> configurationNames = Parameters::getFieldConfigurationFileNames();
+        if (configurationNames.size() == 0) {
+            Parallel::Communicator::MPIExit("Missing configuration to benchmark. Check input folder: " + Parameters::getInputFolder());
+        }
+
+        Parallel::PhaseTimer::beginStage("load");
+        if (!Parameters::getLoadChromaConfigurations()) {
+            load(configurationNames[0]);
+        } else {
+            loadChroma(configurationNames[0]);
+        }
+        Parallel::PhaseTimer::endStage();
+
+        // Configurations to be flowed are loaded into the flow lattice
+        if (m_NFlows != 0 && !Parameters::getLoadConfigAndRun()) {
+            for (int mu = 0; mu < 4; mu++) {
+                m_lattice[mu] = m_flowLattice[mu];
+            }
+        }
+    }
+
+    if (m_processRank == 0) printf("\nRunning scaling benchmark of %d sweeps and %d flow steps.", Parameters::getScalingBenchmarkSweeps(), m_NFlows);
+
+    Parallel::Communicator::setBarrierActive();
+    Parallel::PhaseTimer::beginStage("metropolis");
+    for (unsigned int iSweep = 0; iSweep < Parameters::getScalingBenchmarkSweeps(); iSweep++) {
+        update();
+    }
+    Parallel::PhaseTimer::endStage();
+
+    if (m_NFlows != 0) {
+        Parallel::Communicator::setBarrierActive();
+        Parallel::PhaseTimer::beginStage("flow");
+        copyToFlowLattice();
+        flowConfiguration(0);
+        Parallel::PhaseTimer::endStage();
+    }
+
+    if (m_writeConfigsToFile) {
+        Parallel::Communicator::setBarrierActive();
+        Parallel::PhaseTimer::beginStage("write");
+        IO::FieldIO::writeFieldToFile(m_lattice, 0);
+        Parallel::PhaseTimer::endStage();
+    }
+
+    Parallel::PhaseTimer::setEnabled(false);
+    Parallel::PhaseTimer::writeReport(Parameters::getFilePath() + Parameters::getOutputFolder() + Parameters::getBatchName()
+                                      + "/observables/" + Parameters::getBatchName() + "_scaling_benchmark.json");
 }
 
 void System::loadConfigurationAndRunMetropolis()
@@ -546,10 +917,17 @@ void System::load(const std::string &configurationName)
      */
     m_systemIsThermalized = true;
     m_storeThermalizationObservables = false;
+
+    Lattice<SU3> *lattice = m_lattice;
     if (m_NFlows != 0 && !Parameters::getLoadConfigAndRun()) {
-        IO::FieldIO::loadFieldConfiguration(configurationName,m_flowLattice);
+        lattice = m_flowLattice;
+    }
+
+    // On a single processor the configuration is mapped directly from file, bypassing MPI-IO
+    if (Parallel::Communicator::getNumProc() == 1) {
+        IO::FieldIO::loadMappedFieldConfiguration(configurationName,lattice);
     } else {
-        IO::FieldIO::loadFieldConfiguration(configurationName,m_lattice);
+        IO::FieldIO::loadFieldConfiguration(configurationName,lattice);
     }
 }
 
@@ -579,7 +957,11 @@ void System::flowConfigurations()
         Parallel::Communicator::MPIExit("Missing configurations to flow. Check input folder: " + Parameters::getInputFolder());
     }
 
-    for (unsigned int i = 0; i < configurationNames.size(); i++) {
+    // With flow groups, each group takes the next configuration once it is done with the previous
+    Parallel::WorkQueue queue(configurationNames.size());
+    std::vector<unsigned long> flowedConfigurations;
+    unsigned long i = 0;
+    while (queue.next(i)) {
         // Loads configuration, either in chroma format(reversed doubles) or regular format.
         if (!Parameters::getLoadChromaConfigurations()) {
             load(configurationNames[i]);
@@ -593,12 +975,293 @@ void System::flowConfigurations()
         }
 
         // Flows the configuration loaded
-        flowConfiguration(i);
+        flowConfiguration(static_cast<unsigned int>(i));
+        flowedConfigurations.push_back(i);
+    }
+
+    if (m_processRank==0) printf("\nFlowing of %lu configurations done.", flowedConfigurations.size());
+
+    if (m_flowAnalysis != nullptr) {
+        m_flowAnalysis->gatherGroups(flowedConfigurations);
+        if (Parallel::Communicator::getGroup() == 0) {
+            m_flowAnalysis->analyze();
+        }
+    }
+}
+
+void System::measureConfigurations()
+{
+    /*
+     * Method for measuring the observables on several configurations given as a vector of strings, without flowing them.
+     */
+    std::vector<std::string> configurationNames = Parameters::getFieldConfigurationFileNames();
+
+    if (configurationNames.size() == 0) {
+        Parallel::Communicator::MPIExit("Missing configurations to measure. Check input folder: " + Parameters::getInputFolder());
+    }
+
+    if (m_processRank == 0) {
+        printf("\ni    ");
+        m_correlator->printHeader();
+    }
+
+    for (unsigned int i = 0; i < configurationNames.size(); i++) {
+        // Loads configuration, either in chroma format(reversed doubles) or regular format.
+        if (!Parameters::getLoadChromaConfigurations()) {
+            load(configurationNames[i]);
+        } else {
+            loadChroma(configurationNames[i]);
+        }
+
+        m_correlator->calculate(m_lattice, i);
+
+        if (m_processRank == 0) {
+            printf("\n%-4d ", i);
+        }
+        m_correlator->printObservable(i);
+    }
+
+    if (m_processRank == 0) printf("\nMeasuring of %lu configurations done.\n", configurationNames.size());
+
+    m_correlator->runStatistics();
+    m_correlator->writeObservableToFile(0);
+    m_correlator->printStatistics();
+}
+
+/*!
+ * \brief System::adaptNCor sets NCor such that the integrated autocorrelation time of the configurations approaches adaptiveNCorTarget.
+ * \param iConfigNext the configuration the new NCor is used from.
+ *
+ * The autocorrelation time in units of configurations is roughly inversely proportional to NCor once it is above the target, such that
+ * NCor is scaled by the ratio of the estimated time to the target. The estimate is then restarted, as it is only valid for a single NCor.
+ */
+void System::adaptNCor(const unsigned int iConfigNext)
+{
+    const double tauInt = m_correlator->getIntegratedAutocorrelationTime();
+    const unsigned int NCorOld = m_NCor;
+
+    double NCor = std::ceil(double(m_NCor) * tauInt / Parameters::getAdaptiveNCorTarget());
+    NCor = std::min(std::max(NCor, 1.0), double(Parameters::getAdaptiveNCorMax()));
+    m_NCor = static_cast<unsigned int>(NCor);
+
+    m_correlator->resetAutocorrelation();
+    m_iAdaptiveStart = iConfigNext;
+
+    if (m_processRank == 0) {
+        printf("\nIntegrated autocorrelation time %.4f configurations, NCor %d -> %d", tauInt, NCorOld, m_NCor);
     }
+}
+
+/*!
+ * \brief System::checkpoint writes a checkpoint if checkpointInterval minutes of wall time have passed since the last one.
+ * \param iThermNext the thermalization update to continue from.
+ * \param iConfigNext the configuration to continue from.
+ *
+ * Called after each completed thermalization update and configuration. Root decides whether a checkpoint is due, such that all processors agree.
+ */
+void System::checkpoint(const unsigned int iThermNext, const unsigned int iConfigNext)
+{
+    if (m_checkpointInterval <= 0) return;
 
+    int checkpointDue = 0;
+    if (m_processRank == 0) {
+        checkpointDue = duration_cast<duration<double>>(steady_clock::now() - m_lastCheckpoint).count() >= m_checkpointInterval;
+    }
+    MPI_Bcast(&checkpointDue, 1, MPI_INT, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+    if (!checkpointDue) return;
 
+    m_iThermStart = iThermNext;
+    m_iConfigStart = iConfigNext;
+    writeCheckpoint();
+    m_lastCheckpoint = steady_clock::now();
+}
 
-    if (m_processRank==0) printf("\nFlowing of %lu configurations done.", configurationNames.size());
+/*!
+ * \brief System::writeCheckpoint writes the full state of the Markov chain to the checkpoint of the batch.
+ *
+ * The state of each processor holds the counters, its sub-lattice, the states of the Metropolis and SU3 matrix generator RNGs,
+ * as well as every observable measured so far. Buffered binary flow observables are written out first, such that they match the checkpoint,
+ * and the number of records written to them and to the file of the scales is stored.
+ */
+void System::writeCheckpoint()
+{
+    IO::ObservablesContainer::flushAll();
+
+    CheckpointCounters counters;
+    std::memset(&counters, 0, sizeof(CheckpointCounters));
+    counters.systemIsThermalized = m_systemIsThermalized;
+    counters.storeThermalizationObservables = m_storeThermalizationObservables;
+    counters.iThermStart = m_iThermStart;
+    counters.iConfigStart = m_iConfigStart;
+    counters.NThermSteps = m_NThermSteps;
+    if (m_systemIsThermalized) {
+        counters.numberOfObservables = m_NThermSteps + m_iConfigStart;
+    } else if (m_storeThermalizationObservables) {
+        counters.numberOfObservables = m_iThermStart;
+    }
+    counters.observablesLength = unsigned(m_correlator->getObservablesVector(0).size());
+    counters.NCor = m_NCor;
+    counters.iAdaptiveStart = m_iAdaptiveStart;
+    counters.acceptanceScore = m_acceptanceScore;
+    counters.updateStorer = m_updateStorer;
+    counters.updateStorerTherm = m_updateStorerTherm;
+    counters.NSweeps = m_NSweeps;
+
+    std::vector<char> state;
+    state.reserve(sizeof(CheckpointCounters) + 4*m_subLatticeSize*sizeof(SU3)
+                  + counters.numberOfObservables*counters.observablesLength*sizeof(double));
+
+    packState(state, &counters, sizeof(CheckpointCounters));
+    // The links are stored in lexicographic order, such that a checkpoint may be resumed with another site ordering
+    std::vector<SU3> lexicographicLinks(m_subLatticeSize);
+    for (int mu = 0; mu < 4; mu++) {
+        for (unsigned long iSite = 0; iSite < m_subLatticeSize; iSite++) {
+            lexicographicLinks[iSite] = m_lattice[mu][Parallel::Index::getSiteIndex(iSite)];
+        }
+        packState(state, lexicographicLinks.data(), m_subLatticeSize*sizeof(SU3));
+    }
+
+    std::ostringstream generatorState;
+    generatorState << m_generator;
+    packString(state, generatorState.str());
+    packString(state, m_SU3Generator->getState());
+
+    for (unsigned int iObs = 0; iObs < counters.numberOfObservables; iObs++) {
+        const std::vector<double> obs = m_correlator->getObservablesVector(iObs);
+        packState(state, obs.data(), counters.observablesLength*sizeof(double));
+    }
+
+    // Plaquettes held by the thermalization detector
+    std::vector<double> thermalizationValues;
+    if (m_thermalizationDetector != nullptr) {
+        thermalizationValues = m_thermalizationDetector->getValues();
+    }
+    const unsigned long long NThermalizationValues = thermalizationValues.size();
+    packState(state, &NThermalizationValues, sizeof(unsigned long long));
+    packState(state, thermalizationValues.data(), thermalizationValues.size()*sizeof(double));
+
+    // Flow observables kept for the flow analysis, only held by the root processor
+    std::vector<double> flowAnalysisSamples;
+    if (m_flowAnalysis != nullptr) {
+        flowAnalysisSamples = m_flowAnalysis->getSamples();
+    }
+    const unsigned long long NFlowAnalysisSamples = flowAnalysisSamples.size();
+    packState(state, &NFlowAnalysisSamples, sizeof(unsigned long long));
+    packState(state, flowAnalysisSamples.data(), flowAnalysisSamples.size()*sizeof(double));
+
+    // Records of the binary flow observables and scales written so far, only known by the root processor
+    const std::map<std::string, unsigned long long> recordCounts = IO::ObservablesContainer::getRecordCounts();
+    const unsigned long long NContainers = recordCounts.size();
+    packState(state, &NContainers, sizeof(unsigned long long));
+    for (auto &recordCount : recordCounts) {
+        packString(state, recordCount.first);
+        packState(state, &recordCount.second, sizeof(unsigned long long));
+    }
+    const unsigned int NScales = m_scaleSetting != nullptr ? m_scaleSetting->getNumberOfScales() : 0;
+    packState(state, &NScales, sizeof(unsigned int));
+
+    IO::CheckpointIO::writeCheckpoint(state);
+
+    if (m_processRank == 0) {
+        if (m_systemIsThermalized) {
+            printf("\nCheckpoint written after %d configurations.", m_iConfigStart);
+        } else {
+            printf("\nCheckpoint written after %d thermalization updates.", m_iThermStart - 1);
+        }
+    }
+}
+
+/*!
+ * \brief System::loadCheckpoint restores the full state of the Markov chain from the checkpoint of the batch.
+ *
+ * The run continues from the update following the checkpoint, and is identical to a run that was never interrupted. Binary flow observables
+ * and scales written after the checkpoint are dropped, as their configurations are generated again.
+ * The number of configurations may be increased in order to extend a finished chain.
+ */
+void System::loadCheckpoint()
+{
+    std::vector<char> state;
+    IO::CheckpointIO::loadCheckpoint(state);
+
+    std::size_t position = 0;
+    CheckpointCounters counters;
+    unpackState(state, position, &counters, sizeof(CheckpointCounters));
+
+    if (bool(counters.storeThermalizationObservables) != m_storeThermalizationObservables) {
+        Parallel::Communicator::MPIExit("Error: storeThermalizationObservables must be the same as when the checkpoint was written.");
+    }
+    if (counters.iConfigStart > m_NCf) {
+        Parallel::Communicator::MPIExit("Error: checkpoint holds " + std::to_string(counters.iConfigStart)
+                                        + " configurations, which is more than NCf=" + std::to_string(m_NCf));
+    }
+
+    m_systemIsThermalized = counters.systemIsThermalized;
+    m_iThermStart = counters.iThermStart;
+    m_iConfigStart = counters.iConfigStart;
+    m_NThermSteps = counters.NThermSteps;
+    m_NCor = counters.NCor;
+    m_iAdaptiveStart = counters.iAdaptiveStart;
+    m_acceptanceScore = counters.acceptanceScore;
+    m_updateStorer = counters.updateStorer;
+    m_updateStorerTherm = counters.updateStorerTherm;
+    m_NSweeps = counters.NSweeps;
+
+    std::vector<SU3> lexicographicLinks(m_subLatticeSize);
+    for (int mu = 0; mu < 4; mu++) {
+        unpackState(state, position, lexicographicLinks.data(), m_subLatticeSize*sizeof(SU3));
+        for (unsigned long iSite = 0; iSite < m_subLatticeSize; iSite++) {
+            m_lattice[mu][Parallel::Index::getSiteIndex(iSite)] = lexicographicLinks[iSite];
+        }
+    }
+
+    std::istringstream generatorState(unpackString(state, position));
+    generatorState >> m_generator;
+    m_SU3Generator->setState(unpackString(state, position));
+
+    std::vector<double> obs(counters.observablesLength);
+    for (unsigned int iObs = 0; iObs < counters.numberOfObservables; iObs++) {
+        unpackState(state, position, obs.data(), counters.observablesLength*sizeof(double));
+        m_correlator->copyObservable(iObs, obs);
+    }
+
+    unsigned long long NThermalizationValues = 0;
+    unpackState(state, position, &NThermalizationValues, sizeof(unsigned long long));
+    std::vector<double> thermalizationValues(NThermalizationValues);
+    unpackState(state, position, thermalizationValues.data(), NThermalizationValues*sizeof(double));
+    if (m_thermalizationDetector != nullptr) {
+        m_thermalizationDetector->setValues(thermalizationValues);
+    }
+
+    unsigned long long NFlowAnalysisSamples = 0;
+    unpackState(state, position, &NFlowAnalysisSamples, sizeof(unsigned long long));
+    std::vector<double> flowAnalysisSamples(NFlowAnalysisSamples);
+    unpackState(state, position, flowAnalysisSamples.data(), NFlowAnalysisSamples*sizeof(double));
+    if (m_flowAnalysis != nullptr) {
+        m_flowAnalysis->setSamples(flowAnalysisSamples);
+    }
+
+    // Output written after the checkpoint belongs to configurations that are generated again
+    unsigned long long NContainers = 0;
+    unpackState(state, position, &NContainers, sizeof(unsigned long long));
+    std::map<std::string, unsigned long long> recordCounts;
+    for (unsigned long long iContainer = 0; iContainer < NContainers; iContainer++) {
+        const std::string observableName = unpackString(state, position);
+        unpackState(state, position, &recordCounts[observableName], sizeof(unsigned long long));
+    }
+    IO::ObservablesContainer::restoreRecordCounts(recordCounts);
+    unsigned int NScales = 0;
+    unpackState(state, position, &NScales, sizeof(unsigned int));
+    if (m_scaleSetting != nullptr) {
+        m_scaleSetting->restoreScales(NScales);
+    }
+
+    if (m_processRank == 0) {
+        if (m_systemIsThermalized) {
+            printf("\nContinuing from configuration %d.", m_iConfigStart);
+        } else {
+            printf("\nContinuing from thermalization update %d.", m_iThermStart);
+        }
+    }
 }
 
 double System::getAcceptanceRate()
@@ -606,5 +1269,5 @@ double System::getAcceptanceRate()
     /*
      * Returns the acceptance ratio of the main run of the System algorithm.
      */
-    return m_acceptanceScore/double(m_NCf*m_NCor*unsigned(Parallel::Communicator::getNumProc()));
+    return m_acceptanceScore/double(m_NSweeps*unsigned(Parallel::Communicator::getNumProc()));
 }
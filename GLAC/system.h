@@ -17,6 +17,10 @@
 #include <chrono>
 #include "actions/actions.h"
 #include "observables/observables.h"
+#include "observables/tools/thermalizationdetector.h"
+#include "observables/tools/flowanalysis.h"
+#include "observables/tools/flowschedule.h"
+#include "observables/tools/scalesetting.h"
 #include "math/matrices/su3matrixgenerator.h"
 #include "math/lattice.h"
 #include "flow/flow.h"
@@ -73,6 +77,13 @@ private:
     double m_updateStorer = 0;
     double m_updateStorerTherm = 0;
 
+    // Number of updates in the main run, as NCor may change when adaptive
+    unsigned long long m_NSweeps = 0;
+
+    // Adapts NCor to the integrated autocorrelation time of the configurations since m_iAdaptiveStart
+    unsigned int m_iAdaptiveStart = 0;
+    void adaptNCor(const unsigned int iConfigNext);
+
     // Function for choosing and setting the correlators/observables
     void setObservable(const std::vector<std::string> &obsList, const bool flow);
 
@@ -89,15 +100,27 @@ private:
     // Flow
     Flow * m_flow = nullptr;
     void flowConfiguration(const unsigned int iConfig);
+    bool finishFlowStep(const unsigned int iFlow);
     void copyToFlowLattice();
-    Lattice<SU3> * m_flowLattice;
+    Lattice<SU3> * m_flowLattice = nullptr;
+    FlowSchedule * m_flowSchedule = nullptr;
+    ScaleSetting * m_scaleSetting = nullptr;
+    // The flow energy, summed over the processors at each flow step if needed by the flow schedule or the scale setting
+    ObservableStorer * m_flowEnergy = nullptr;
+
+    // Resampling analysis of the flow observables of all configurations
+    FlowAnalysis * m_flowAnalysis = nullptr;
 
     // Function for updating our system using the Metropolis algorithm
     void update();
     inline void updateLink(const unsigned int iSite, const int mu);
+    void updateSite(const unsigned int x, const unsigned int y, const unsigned int z, const unsigned int t, const int mu);
+    void sweepLexicographic();
+    void sweepCheckerboard();
 
     // Thermalization function
     void thermalize();
+    ThermalizationDetector * m_thermalizationDetector = nullptr;
 
     // SU3 generator
     SU3MatrixGenerator * m_SU3Generator = nullptr;
@@ -106,14 +129,27 @@ private:
     std::mt19937_64 m_generator;
     std::uniform_real_distribution<double> m_uniform_distribution;
 
+    // Checkpointing of the Markov chain state
+    unsigned int m_iThermStart = 1;
+    unsigned int m_iConfigStart = 0;
+    double m_checkpointInterval = 0; // In seconds
+    steady_clock::time_point m_lastCheckpoint;
+    void checkpoint(const unsigned int iThermNext, const unsigned int iConfigNext);
+    void writeCheckpoint();
+    void loadCheckpoint();
+
     // Functions loading fields configurations from file
     void loadChroma(const std::string &configurationName);
     void load(const std::string &configurationName);
     void flowConfigurations();
+    void measureConfigurations();
     void loadConfigurationAndRunMetropolis();
 
     // Function for running metropolis algorithm
     void runMetropolis();
+
+    // Function for timing sweeps and flow per processor and phase
+    void runScalingBenchmark();
 public:
     System();
     ~System();
@@ -0,0 +1,344 @@
+#include "benchmarks.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <mpi.h>
+
+#include "lib/json.hpp"
+#include "config/parameters.h"
+#include "parallelization/parallel.h"
+#include "actions/wilsongaugeaction.h"
+#include "actions/wilsonexplicitder.h"
+#include "observables/mastersampler.h"
+#include "math/exponentiation/su3exp.h"
+
+using nlohmann::json;
+using std::chrono::steady_clock;
+using std::chrono::duration_cast;
+using std::chrono::duration;
+
+namespace {
+    // Nominal cost of the SU3 operations, in flops and bytes
+    const double SU3MultiplicationFlops = 198;
+    const double SU3AdditionFlops = 18;
+    const double SU3Bytes = 144;
+
+    // Staple of one link: 6 plaquette sides of two multiplications each, summed
+    const double stapleFlops = 12*SU3MultiplicationFlops + 6*SU3AdditionFlops;
+}
+
+/*!
+ * \brief Benchmarks::Benchmarks constructor
+ *
+ * Random generators and the SU3MatrixGenerator are set up by PerformanceTests.
+ */
+Benchmarks::Benchmarks()
+{
+}
+
+Benchmarks::~Benchmarks()
+{
+}
+
+/*!
+ * \brief Benchmarks::run times every kernel for every sub lattice extent, and prints and writes the results.
+ *
+ * Restores the sub lattice dimensions of the configuration when done.
+ */
+void Benchmarks::run()
+{
+    const std::vector<unsigned int> NConfig = Parameters::getN();
+
+    // The processor grid follows from the lattice and sub lattice dimensions of the configuration
+    m_processorsPerDimension.resize(4);
+    for (int i = 0; i < 3; i++) {
+        m_processorsPerDimension[i] = Parameters::getNSpatial() / NConfig[i];
+    }
+    m_processorsPerDimension[3] = Parameters::getNTemporal() / NConfig[3];
+
+    for (auto L : Parameters::getBenchmarkSubLatticeSizes()) {
+        if (L < 3) {
+            Parallel::Communicator::MPIExit("Error: benchmark sub lattice extents must be larger than 2.");
+        }
+    }
+
+    if (m_processRank == 0) {
+        printf("\nRunning component benchmarks on %d processors with %d warm-up runs and %d repetitions.\n",
+               m_numprocs, Parameters::getBenchmarkWarmup(), Parameters::getBenchmarkRepetitions());
+    }
+
+    for (auto L : Parameters::getBenchmarkSubLatticeSizes()) {
+        benchmarkSubLattice(L);
+    }
+
+    setSubLatticeDimensions(NConfig);
+
+    printResults();
+    writeResults();
+}
+
+/*!
+ * \brief Benchmarks::setSubLatticeDimensions sets the sub lattice dimensions of every processor.
+ * \param N the sub lattice dimensions, x, y, z, t.
+ *
+ * The processor grid is kept, such that the global lattice grows with the sub lattice.
+ */
+void Benchmarks::setSubLatticeDimensions(const std::vector<unsigned int> &N)
+{
+    Parallel::Index::setN(N);
+    Parallel::Communicator::setN(N);
+    Parameters::setN(N);
+    Parameters::setSubLatticeSize(N[0]*N[1]*N[2]*N[3]);
+}
+
+/*!
+ * \brief Benchmarks::timeKernel times a kernel, and stores the median and minimum time of the repetitions.
+ * \param kernel name of the kernel.
+ * \param subLatticeExtent extent L of the L^4 sub lattice.
+ * \param flopsPerSite nominal flops per lattice site, 0 if not counted.
+ * \param bytesPerSite nominal bytes moved per lattice site.
+ * \param runKernel runs the kernel once over the sub lattice.
+ *
+ * Processors are synchronized before every repetition, and the time of a repetition is that of the slowest processor.
+ */
+void Benchmarks::timeKernel(const std::string &kernel, const unsigned int subLatticeExtent,
+                            const double flopsPerSite, const double bytesPerSite, std::function<void()> runKernel)
+{
+    for (unsigned int i = 0; i < Parameters::getBenchmarkWarmup(); i++) {
+        runKernel();
+    }
+
+    std::vector<double> times(Parameters::getBenchmarkRepetitions());
+    steady_clock::time_point preUpdate;
+    for (unsigned int i = 0; i < times.size(); i++) {
+        MPI_Barrier(Parallel::ParallelParameters::ACTIVE_COMM);
+        preUpdate = steady_clock::now();
+        runKernel();
+        times[i] = duration_cast<duration<double>>(steady_clock::now() - preUpdate).count();
+    }
+
+    MPI_Allreduce(MPI_IN_PLACE, times.data(), int(times.size()), MPI_DOUBLE, MPI_MAX, Parallel::ParallelParameters::ACTIVE_COMM);
+
+    BenchmarkResult result;
+    result.kernel = kernel;
+    result.subLatticeExtent = subLatticeExtent;
+    result.flopsPerSite = flopsPerSite;
+    result.bytesPerSite = bytesPerSite;
+    result.median = 0;
+    result.min = 0;
+
+    if (times.size() > 0) {
+        std::sort(times.begin(), times.end());
+        const unsigned long n = times.size();
+        result.median = (n % 2 == 1) ? times[n/2] : 0.5*(times[n/2 - 1] + times[n/2]);
+        result.min = times[0];
+    }
+
+    m_results.push_back(result);
+
+    if (m_processRank == 0 && m_verbose) {
+        printf("\n%-20s L = %2d: %12.6E seconds", kernel.c_str(), subLatticeExtent, result.median);
+    }
+}
+
+/*!
+ * \brief Benchmarks::benchmarkSubLattice times all kernels on a L^4 sub lattice of random SU3 matrices.
+ * \param subLatticeExtent extent L of the sub lattice.
+ */
+void Benchmarks::benchmarkSubLattice(const unsigned int subLatticeExtent)
+{
+    const std::vector<unsigned int> N(4, subLatticeExtent);
+    setSubLatticeDimensions(N);
+
+    // Action, clover and exponentiation read the sub lattice dimensions when constructed
+    Action *S = nullptr;
+    if (Parameters::getActionType() == "wilson") {
+        S = new WilsonGaugeAction;
+    } else if (Parameters::getActionType() == "wilsonExplicitDer") {
+        S = new WilsonExplicitDer;
+    } else {
+        Parallel::Communicator::MPIExit("Error: action type " + Parameters::getActionType() + " not recognized.");
+    }
+    MasterSampler clover(true);
+    SU3Exp SU3ExpFunc;
+
+    Lattice<SU3> *lattice = new Lattice<SU3>[4];
+    Lattice<SU3> *results = new Lattice<SU3>[4];
+    Lattice<SU3> *derivative = new Lattice<SU3>[4];
+    for (int mu = 0; mu < 4; mu++) {
+        lattice[mu].allocate(N);
+        results[mu].allocate(N);
+        for (unsigned long iSite = 0; iSite < lattice[mu].m_sites.size(); iSite++) {
+            lattice[mu].m_sites[iSite] = m_SU3Generator->generateRST();
+        }
+    }
+    for (int mu = 0; mu < 4; mu++) {
+        derivative[mu] = S->getActionDerivative(lattice, mu)*(Parameters::getFlowEpsilon()*0.25);
+    }
+
+    timeKernel("su3_multiply", subLatticeExtent, SU3MultiplicationFlops, 3*SU3Bytes, [&]() {
+        results[0] = lattice[0];
+        results[0] *= lattice[1];
+    });
+
+    timeKernel("su3_inverse", subLatticeExtent, 0, 2*SU3Bytes, [&]() {
+        results[0] = inv(lattice[0]);
+    });
+
+    timeKernel("staple", subLatticeExtent, 4*stapleFlops, 4*SU3Bytes, [&]() {
+        for (unsigned int x = 0; x < N[0]; x++) {
+            for (unsigned int y = 0; y < N[1]; y++) {
+                for (unsigned int z = 0; z < N[2]; z++) {
+                    for (unsigned int t = 0; t < N[3]; t++) {
+                        for (int mu = 0; mu < 4; mu++) {
+                            S->computeStaple(lattice, int(x), int(y), int(z), int(t), mu);
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    // Staple plus the multiplication with the link and projection onto the generators
+    timeKernel("action_derivative", subLatticeExtent, 4*(stapleFlops + SU3MultiplicationFlops + 3*SU3AdditionFlops), 8*SU3Bytes, [&]() {
+        for (int mu = 0; mu < 4; mu++) {
+            results[mu] = S->getActionDerivative(lattice, mu);
+        }
+    });
+
+    // Three pairs of clovers, each of four leaves of three multiplications
+    timeKernel("clover", subLatticeExtent, 3*2*(4*3*SU3MultiplicationFlops + 3*SU3AdditionFlops), 4*SU3Bytes, [&]() {
+        clover.calculate(lattice, 0);
+    });
+
+    // The flops of the exponentiation depend on the branches taken, and are not counted
+    timeKernel("exponential", subLatticeExtent, 0, 8*SU3Bytes, [&]() {
+        for (int mu = 0; mu < 4; mu++) {
+            for (unsigned long iSite = 0; iSite < derivative[mu].m_sites.size(); iSite++) {
+                results[mu].m_sites[iSite] = SU3ExpFunc.exp(derivative[mu].m_sites[iSite]);
+            }
+        }
+    });
+
+    timeKernel("shift", subLatticeExtent, 0, 8*SU3Bytes, [&]() {
+        for (int mu = 0; mu < 4; mu++) {
+            results[mu] = shift(lattice[mu], FORWARDS, mu);
+        }
+    });
+
+    // Same sweep as System::update, the random matrix generation and accept/reject are not counted as flops
+    const unsigned int NUpdates = Parameters::getNUpdates();
+    SU3 updatedMatrix;
+    timeKernel("metropolis_sweep", subLatticeExtent, 4*(stapleFlops + NUpdates*(2*SU3MultiplicationFlops + SU3AdditionFlops)), 8*SU3Bytes, [&]() {
+        for (unsigned int x = 0; x < N[0]; x++) {
+            for (unsigned int y = 0; y < N[1]; y++) {
+                for (unsigned int z = 0; z < N[2]; z++) {
+                    for (unsigned int t = 0; t < N[3]; t++) {
+                        const unsigned long iSite = Parallel::Index::getIndex(x,y,z,t);
+                        for (int mu = 0; mu < 4; mu++) {
+                            S->computeStaple(lattice, int(x), int(y), int(z), int(t), mu);
+                            for (unsigned int n = 0; n < NUpdates; n++) {
+                                updatedMatrix = m_SU3Generator->generateRST()*lattice[mu][iSite];
+                                if (exp(-S->getDeltaAction(lattice[mu][iSite], updatedMatrix)) > m_uniform_distribution(m_generator)) {
+                                    lattice[mu][iSite] = updatedMatrix;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    delete [] lattice;
+    delete [] results;
+    delete [] derivative;
+    delete S;
+}
+
+/*!
+ * \brief Benchmarks::printResults prints a table of the results from the root processor.
+ *
+ * Rates are per processor, GFLOP/s is left out for kernels where flops are not counted.
+ */
+void Benchmarks::printResults()
+{
+    if (m_processRank != 0) return;
+
+    printf("\n%-20s %4s %14s %14s %12s %10s %10s", "Kernel", "L", "Median(s)", "Min(s)", "ns/site", "GFLOP/s", "GB/s");
+    for (auto &result : m_results) {
+        const double sites = std::pow(double(result.subLatticeExtent), 4);
+        printf("\n%-20s %4d %14.6E %14.6E %12.4f", result.kernel.c_str(), result.subLatticeExtent,
+               result.median, result.min, result.median / sites * 1e9);
+        if (result.flopsPerSite > 0) {
+            printf(" %10.4f", result.flopsPerSite * sites / result.median * 1e-9);
+        } else {
+            printf(" %10s", "-");
+        }
+        printf(" %10.4f", result.bytesPerSite * sites / result.median * 1e-9);
+    }
+    printf("\n");
+}
+
+/*!
+ * \brief Benchmarks::writeResults writes the results to benchmarks.json in the observables folder of the batch.
+ *
+ * Along with the results, the processor grid, compiler and host are written, such that runs of different builds and nodes may be compared.
+ */
+void Benchmarks::writeResults()
+{
+    if (m_processRank != 0) return;
+
+    char hostName[MPI_MAX_PROCESSOR_NAME];
+    int hostNameLength;
+    MPI_Get_processor_name(hostName, &hostNameLength);
+
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    json j;
+    j["date"] = date;
+    j["host"] = std::string(hostName, static_cast<unsigned long>(hostNameLength));
+    j["compiler"] = __VERSION__;
+    j["numberOfProcessors"] = m_numprocs;
+    j["processorsPerDimension"] = m_processorsPerDimension;
+    j["warmup"] = Parameters::getBenchmarkWarmup();
+    j["repetitions"] = Parameters::getBenchmarkRepetitions();
+    j["NUpdates"] = Parameters::getNUpdates();
+    j["actionType"] = Parameters::getActionType();
+
+    j["results"] = json::array();
+    for (auto &result : m_results) {
+        const double sites = std::pow(double(result.subLatticeExtent), 4);
+        json r;
+        r["kernel"] = result.kernel;
+        r["subLatticeExtent"] = result.subLatticeExtent;
+        r["sitesPerProcessor"] = (unsigned long) sites;
+        r["medianSeconds"] = result.median;
+        r["minSeconds"] = result.min;
+        r["nsPerSite"] = result.median / sites * 1e9;
+        r["nsPerSiteMin"] = result.min / sites * 1e9;
+        r["flopsPerSite"] = result.flopsPerSite;
+        r["bytesPerSite"] = result.bytesPerSite;
+        if (result.flopsPerSite > 0) {
+            r["GFLOPS"] = result.flopsPerSite * sites / result.median * 1e-9;
+        } else {
+            r["GFLOPS"] = nullptr;
+        }
+        r["GBPerSecond"] = result.bytesPerSite * sites / result.median * 1e-9;
+        j["results"].push_back(r);
+    }
+
+    const std::string fname = Parameters::getFilePath() + Parameters::getOutputFolder()
+            + Parameters::getBatchName() + "/observables/benchmarks.json";
+    std::ofstream file(fname);
+    file << std::setw(4) << j << std::endl;
+    file.close();
+
+    printf("\nBenchmarks written to %s\n", fname.c_str());
+}
@@ -0,0 +1,58 @@
+/*!
+ * \class Benchmarks
+ *
+ * \brief Component level benchmarks of the lattice kernels, for comparing builds and nodes.
+ *
+ * Each kernel is timed over a full sub lattice for each of the sub lattice extents in benchmarkSubLatticeSizes,
+ * with benchmarkWarmup untimed runs before benchmarkRepetitions timed ones. The time of a repetition is the slowest
+ * processor, and the median and minimum over repetitions are reported together with ns/site, GFLOP/s and GB/s per processor.
+ *
+ * Flop and byte counts are nominal: 198 flops for a SU3 multiplication, 18 for an addition, and
+ * 144 bytes for every SU3 matrix that must be read or written per site, ignoring cache reuse.
+ * Results are printed and written to benchmarks.json in the observables folder of the batch.
+ *
+ * \author Mathias M. Vege
+ * \version 1.0
+ * \date 2017-2019
+ * \copyright MIT Licence
+ */
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include "performancetests.h"
+#include "math/lattice.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+class Benchmarks : public PerformanceTests
+{
+private:
+    struct BenchmarkResult
+    {
+        std::string kernel;
+        unsigned int subLatticeExtent;
+        double median;
+        double min;
+        double flopsPerSite;
+        double bytesPerSite;
+    };
+
+    std::vector<BenchmarkResult> m_results;
+    std::vector<unsigned int> m_processorsPerDimension;
+
+    void setSubLatticeDimensions(const std::vector<unsigned int> &N);
+    void timeKernel(const std::string &kernel, const unsigned int subLatticeExtent,
+                    const double flopsPerSite, const double bytesPerSite, std::function<void()> runKernel);
+    void benchmarkSubLattice(const unsigned int subLatticeExtent);
+
+    void printResults();
+    void writeResults();
+public:
+    Benchmarks();
+    ~Benchmarks();
+
+    void run();
+};
+
+#endif // BENCHMARKS_H
@@ -14,6 +14,7 @@
 
 #include "tests/testsuite.h"
 #include "performancetests.h"
+#include "benchmarks.h"
 #include "parallelization/communicator.h"
 
 #include "tests/unit_tests/actiontests.h"
@@ -105,5 +106,22 @@ void runPerformanceTests(bool runTests)
     }
 }
 
+/*!
+ * \brief runBenchmarks will run the component benchmarks. Exits once complete.
+ * \param runBenchmarks if true, will run the benchmarks.
+ */
+void runBenchmarks(bool runBenchmarks)
+{
+    if (runBenchmarks)
+    {
+        Benchmarks benchmarker;
+        benchmarker.run();
+        Parallel::Communicator::setBarrier();
+        Parallel::Communicator::freeMPIGroups();
+        Parallel::Communicator::setBarrier();
+        MPI_Finalize();
+        exit(0);
+    }
+}
 
 #endif // TEST_H
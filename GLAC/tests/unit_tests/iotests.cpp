@@ -6,6 +6,16 @@
 #include "parallelization/parallel.h"
 #include "config/parameters.h"
 #include "io/fieldio.h"
+#include "io/checksum.h"
+#include "io/observablescontainer.h"
+#include "io/observablesio.h"
+#include "io/checkpointio.h"
+#include "observables/energydensity.h"
+#include "observables/tools/scalesetting.h"
+#include <fstream>
+#include <cstring>
+#include <iterator>
+#include <unistd.h>
 
 IOTests::IOTests()
 {
@@ -221,9 +231,665 @@ bool IOTests::testIOWriteDoubles()
     return passed;
 }
 
+bool IOTests::testIOFieldHeader()
+{
+    if ((m_processRank == 0) && m_verbose) {
+        printf("    Testing IO field configuration header for lattice of size %d^3 x %d\n", Parameters::getNSpatial(), Parameters::getNTemporal());
+    }
+
+    bool passed = true;
+
+    // Reference value of the CRC-32 for the string "123456789"
+    if (IO::crc32("123456789", 9) != 0xCBF43926) {
+        if (m_processRank == 0) cout << "Error: CRC-32 check value " << IO::crc32("123456789", 9) << " is not correct." << endl;
+        passed = false;
+    }
+
+    if (Parallel::ParallelParameters::active) {
+
+        // A unit configuration has a plaquette of exactly 1
+        Lattice<SU3> * LBefore = new Lattice<SU3>[4];
+        Lattice<SU3> * LAfter = new Lattice<SU3>[4];
+        for (int i = 0; i < 4; i++) LBefore[i].allocate(m_dim);
+        for (int i = 0; i < 4; i++) LAfter[i].allocate(m_dim);
+
+        for (int mu = 0; mu < 4; mu++)
+        {
+            for (unsigned long iSite = 0; iSite < m_subLatticeSize; iSite++)
+            {
+                LBefore[mu][iSite].identity();
+            }
+        }
+
+        const bool tmpFieldConfigurationHeader = Parameters::getFieldConfigurationHeader();
+        Parameters::setFieldConfigurationHeader(true);
+        IO::FieldIO::writeFieldToFile(LBefore, 1);
+
+        Parallel::Communicator::setBarrierActive();
+
+        std::string cfg_name = Parameters::getBatchName() + "_b" + std::to_string(Parameters::getBeta())
+                + "_N" + std::to_string(Parameters::getNSpatial())
+                + "_NT" + std::to_string(Parameters::getNTemporal())
+                + "_np" + std::to_string(Parallel::Communicator::getNumProc())
+                + "_config" + std::string("00001") + ".bin";
+
+        if (m_processRank == 0) {
+            std::string filenamePath = Parameters::getFilePath() + Parameters::getOutputFolder() + Parameters::getBatchName()
+                    + "/field_configurations/" + cfg_name;
+
+            IO::FieldHeader header;
+            std::ifstream file(filenamePath, std::ios::binary | std::ios::ate);
+            long long fileSize = file.tellg();
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(&header), sizeof(IO::FieldHeader));
+
+            if (std::strcmp(header.magic, "GLACFLD") != 0) {
+                cout << "Error: field header magic " << header.magic << " is not correct." << endl;
+                passed = false;
+            }
+            if (header.precision != sizeof(double)) {
+                cout << "Error: field header precision " << header.precision << " is not correct." << endl;
+                passed = false;
+            }
+            if (header.dimensions[0] != m_N || header.dimensions[1] != m_N || header.dimensions[2] != m_N || header.dimensions[3] != m_NT) {
+                cout << "Error: field header dimensions are not correct." << endl;
+                passed = false;
+            }
+            if (header.configNumber != 1 + unsigned(Parameters::getConfigStartNumber()) || fabs(header.beta - Parameters::getBeta()) > m_eps) {
+                cout << "Error: field header configuration number or beta is not correct." << endl;
+                passed = false;
+            }
+            if (fabs(header.plaquette - 1.0) > m_eps) {
+                cout << "Error: field header plaquette " << header.plaquette << " of unit configuration is not 1." << endl;
+                passed = false;
+            }
+            if (fileSize != (long long)(sizeof(IO::FieldHeader) + Parameters::getLatticeSize()*72*sizeof(double))) {
+                cout << "Error: field configuration file size " << fileSize << " is not correct." << endl;
+                passed = false;
+            }
+        }
+        MPI_Bcast(&passed, 1, MPI_C_BOOL, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+
+        // Loading verifies the dimensions, file size and checksums
+        std::string tmpInputFolder = Parameters::getInputFolder();
+        Parameters::setInputFolder("/output/" + Parameters::getBatchName() + "/field_configurations/");
+        IO::FieldIO::loadFieldConfiguration(cfg_name, LAfter);
+
+        for (int mu = 0; mu < 4; mu++)
+        {
+            for (unsigned long iSite = 0; iSite < m_subLatticeSize; iSite++)
+            {
+                if (!compareSU3(LBefore[mu][iSite], LAfter[mu][iSite])) {
+                    passed = false;
+                    break;
+                }
+            }
+        }
+
+        // Without the header only the links are written, and are still loaded
+        Parameters::setFieldConfigurationHeader(false);
+        IO::FieldIO::writeFieldToFile(LBefore, 1);
+        Parameters::setFieldConfigurationHeader(tmpFieldConfigurationHeader);
+
+        Parallel::Communicator::setBarrierActive();
+
+        if (m_processRank == 0) {
+            std::ifstream file(Parameters::getFilePath() + Parameters::getOutputFolder() + Parameters::getBatchName()
+                               + "/field_configurations/" + cfg_name, std::ios::binary | std::ios::ate);
+            if ((long long)(file.tellg()) != (long long)(Parameters::getLatticeSize()*72*sizeof(double))) {
+                cout << "Error: field configuration file size " << file.tellg() << " without header is not correct." << endl;
+                passed = false;
+            }
+        }
+        MPI_Bcast(&passed, 1, MPI_C_BOOL, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+
+        for (int mu = 0; mu < 4; mu++) LAfter[mu].zeros();
+        IO::FieldIO::loadFieldConfiguration(cfg_name, LAfter);
+        Parameters::setInputFolder(tmpInputFolder);
+
+        for (int mu = 0; mu < 4; mu++)
+        {
+            for (unsigned long iSite = 0; iSite < m_subLatticeSize; iSite++)
+            {
+                if (!compareSU3(LBefore[mu][iSite], LAfter[mu][iSite])) {
+                    passed = false;
+                    break;
+                }
+            }
+        }
+
+        delete [] LBefore;
+        delete [] LAfter;
+    }
+
+    if (passed) {
+        if (m_processRank == 0) cout << "PASSED: IO field configuration header." << endl;
+    } else {
+        if (m_processRank == 0) cout << "FAILED: IO field configuration header." << endl;
+    }
+
+    return passed;
+}
+
+bool IOTests::testIOMappedLoad()
+{
+    bool passed = true;
+
+    // Memory mapped loading is only available when running on a single processor
+    if (Parallel::ParallelParameters::active && m_numprocs == 1) {
+
+        if (m_verbose) {
+            printf("    Testing memory mapped loading of lattice of size %d^3 x %d\n", Parameters::getNSpatial(), Parameters::getNTemporal());
+        }
+
+        Lattice<SU3> * LBefore = new Lattice<SU3>[4];
+        Lattice<SU3> * LAfter = new Lattice<SU3>[4];
+        for (int i = 0; i < 4; i++) LBefore[i].allocate(m_dim);
+        for (int i = 0; i < 4; i++) LAfter[i].allocate(m_dim);
+
+        for (int mu = 0; mu < 4; mu++)
+        {
+            for (unsigned long iSite = 0; iSite < m_subLatticeSize; iSite++)
+            {
+                LBefore[mu][iSite] = m_SU3Generator->generateRandom();
+            }
+        }
+
+        IO::FieldIO::writeFieldToFile(LBefore, 2);
+
+        std::string cfg_name = Parameters::getBatchName() + "_b" + std::to_string(Parameters::getBeta())
+                + "_N" + std::to_string(Parameters::getNSpatial())
+                + "_NT" + std::to_string(Parameters::getNTemporal())
+                + "_np" + std::to_string(Parallel::Communicator::getNumProc())
+                + "_config" + std::string("00002") + ".bin";
+
+        std::string tmpInputFolder = Parameters::getInputFolder();
+        Parameters::setInputFolder("/output/" + Parameters::getBatchName() + "/field_configurations/");
+        IO::FieldIO::loadMappedFieldConfiguration(cfg_name, LAfter);
+        Parameters::setInputFolder(tmpInputFolder);
+
+        for (int mu = 0; mu < 4; mu++)
+        {
+            for (unsigned long iSite = 0; iSite < m_subLatticeSize; iSite++)
+            {
+                if (!compareSU3(LBefore[mu][iSite], LAfter[mu][iSite])) {
+                    cout << "Error in mapped load at site " << iSite << " and direction " << mu << endl;
+                    passed = false;
+                    break;
+                }
+            }
+        }
+
+        delete [] LBefore;
+        delete [] LAfter;
+    }
+
+    if (passed) {
+        if (m_processRank == 0) cout << "PASSED: IO memory mapped lattice load." << endl;
+    } else {
+        if (m_processRank == 0) cout << "FAILED: IO memory mapped lattice load." << endl;
+    }
+
+    return passed;
+}
+
+bool IOTests::testIOCompressedDoubles()
+{
+    if ((m_processRank == 0) && m_verbose) {
+        printf("    Testing IO compressed doubles writing for lattice of size %d^3 x %d\n", Parameters::getNSpatial(), Parameters::getNTemporal());
+    }
+
+    bool passed = true;
+
+    if (Parallel::ParallelParameters::active) {
+
+        Lattice<double> LBefore;
+        Lattice<double> LAfter;
+        LBefore.allocate(m_dim);
+        LAfter.allocate(m_dim);
+
+        for (unsigned long iSite = 0; iSite < m_subLatticeSize; iSite++)
+        {
+            LBefore[iSite] = m_uniform_distribution(m_generator) - 0.5;
+        }
+
+        std::string filenameIOTest = "ioDoublesIOTest";
+        std::string filenamePath = Parameters::getFilePath() + Parameters::getOutputFolder() + Parameters::getBatchName()
+                + "/scalar_fields/" + filenameIOTest + "/" + Parameters::getBatchName() + "_b" + std::to_string(Parameters::getBeta())
+                + "_N" + std::to_string(Parameters::getNSpatial())
+                + "_NT" + std::to_string(Parameters::getNTemporal())
+                + "_np" + std::to_string(Parallel::Communicator::getNumProc())
+                + "_config" + std::string("00000") + ".cbin";
+
+        const int tmpQuantizationBits = Parameters::getFieldDensityQuantizationBits();
+
+        // Lossless compression should reproduce the field exactly, while the quantized must be within half a quantization step
+        const int quantizationBits[2] = {0, 12};
+        for (int iTest = 0; iTest < 2; iTest++) {
+            Parameters::setFieldDensityQuantizationBits(quantizationBits[iTest]);
+
+            IO::FieldIO::writeCompressedDoublesFieldToFile(LBefore, 0, filenameIOTest);
+            Parallel::Communicator::setBarrierActive();
+            LAfter.zeros();
+            IO::FieldIO::loadCompressedDoublesField(filenamePath, LAfter);
+
+            double maxAbs = 0;
+            for (unsigned long iSite = 0; iSite < m_subLatticeSize; iSite++)
+            {
+                if (fabs(LBefore[iSite]) > maxAbs) maxAbs = fabs(LBefore[iSite]);
+            }
+            const double tolerance = (quantizationBits[iTest] == 0) ? 0 : maxAbs / (std::ldexp(1.0, quantizationBits[iTest]) - 2.0) * (1 + m_eps);
+
+            for (unsigned long iSite = 0; iSite < m_subLatticeSize; iSite++)
+            {
+                if (fabs(LBefore[iSite] - LAfter[iSite]) > tolerance) {
+                    cout << "Error in compressed doubles with " << quantizationBits[iTest] << " quantization bits: "
+                         << LBefore[iSite] << " " << LAfter[iSite] << endl;
+                    passed = false;
+                    break;
+                }
+            }
+        }
+
+        Parameters::setFieldDensityQuantizationBits(tmpQuantizationBits);
+    }
+
+    if (passed) {
+        if (m_processRank == 0) cout << "PASSED: IO compressed lattice doubles write and load." << endl;
+    } else {
+        if (m_processRank == 0) cout << "FAILED: IO compressed lattice doubles write or load." << endl;
+    }
+
+    return passed;
+}
+
+bool IOTests::testIOObservablesContainer()
+{
+    if ((m_processRank == 0) && m_verbose) {
+        printf("    Testing IO binary observables container\n");
+    }
+
+    bool passed = true;
+
+    const std::string observableName = "ioObservablesContainerTest";
+    const std::string fname = Parameters::getFilePath() + Parameters::getOutputFolder() + Parameters::getBatchName()
+            + "/flow_observables/" + observableName + "/" + Parameters::getBatchName() + "_" + observableName + "_flow.bdat";
+
+    const bool tmpBinaryFlowObservables = Parameters::getBinaryFlowObservables();
+    const unsigned int tmpBatchSize = Parameters::getFlowObservablesBatchSize();
+    Parameters::setBinaryFlowObservables(true);
+    Parameters::setFlowObservablesBatchSize(2);
+
+    if (m_processRank == 0) std::remove(fname.c_str());
+
+    // Writes three configurations, where the last is only written when flushed
+    const unsigned int NRows = Parameters::getNFlows() + 1;
+    const unsigned int NConfigs = 3;
+    std::vector<std::vector<double>> observables(NConfigs, std::vector<double>(NRows));
+    for (unsigned int iCfg = 0; iCfg < NConfigs; iCfg++) {
+        for (unsigned int iFlow = 0; iFlow < NRows; iFlow++) {
+            observables[iCfg][iFlow] = m_uniform_distribution(m_generator);
+        }
+        IO::writeFlowObservableToFile(observables[iCfg], observableName, iCfg);
+    }
+    IO::ObservablesContainer::flushAll();
+
+    Parameters::setBinaryFlowObservables(tmpBinaryFlowObservables);
+    Parameters::setFlowObservablesBatchSize(tmpBatchSize);
+
+    if (m_processRank == 0) {
+        std::ifstream file(fname, std::ios::binary);
+        IO::ContainerHeader header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(IO::ContainerHeader));
+
+        if (std::strcmp(header.magic, "GLACOBS") != 0 || header.rows != NRows || header.columns != 1) {
+            cout << "Error: observables container header is not correct." << endl;
+            passed = false;
+        }
+
+        for (unsigned int iCfg = 0; iCfg < NConfigs && passed; iCfg++) {
+            unsigned int configNumber, crc;
+            std::vector<double> record(NRows);
+            file.read(reinterpret_cast<char*>(&configNumber), sizeof(unsigned int));
+            file.read(reinterpret_cast<char*>(&crc), sizeof(unsigned int));
+            file.read(reinterpret_cast<char*>(record.data()), std::streamsize(NRows*sizeof(double)));
+
+            if (!file || configNumber != iCfg + unsigned(Parameters::getConfigStartNumber()) || crc != IO::crc32(record.data(), NRows*sizeof(double))) {
+                cout << "Error: observables container record " << iCfg << " is not correct." << endl;
+                passed = false;
+                break;
+            }
+            for (unsigned int iFlow = 0; iFlow < NRows; iFlow++) {
+                if (record[iFlow] != observables[iCfg][iFlow]) {
+                    cout << "Error: observables container record " << iCfg << " has wrong value " << record[iFlow] << endl;
+                    passed = false;
+                    break;
+                }
+            }
+        }
+
+        // Nothing but the header and the records should have been written
+        file.peek();
+        if (!file.eof()) {
+            cout << "Error: observables container contains more than " << NConfigs << " records." << endl;
+            passed = false;
+        }
+    }
+    MPI_Bcast(&passed, 1, MPI_C_BOOL, 0, MPI_COMM_WORLD);
+
+    if (passed) {
+        if (m_processRank == 0) cout << "PASSED: IO binary observables container." << endl;
+    } else {
+        if (m_processRank == 0) cout << "FAILED: IO binary observables container." << endl;
+    }
+
+    return passed;
+}
+
+bool IOTests::testIOObservablesContainerRestore()
+{
+    if ((m_processRank == 0) && m_verbose) {
+        printf("    Testing IO binary observables container restored to a checkpoint\n");
+    }
+
+    bool passed = true;
+
+    // One observable appended to before the checkpoint, and one only after it
+    const std::vector<std::string> observableNames = {"ioContainerRestoreTest", "ioContainerRestoreTestAfter"};
+    std::vector<std::string> fnames;
+    for (auto &observableName : observableNames) {
+        fnames.push_back(Parameters::getFilePath() + Parameters::getOutputFolder() + Parameters::getBatchName() + "/flow_observables/"
+                         + observableName + "/" + Parameters::getBatchName() + "_" + observableName + "_flow.bdat");
+        if (m_processRank == 0) std::remove(fnames.back().c_str());
+    }
+
+    const bool tmpBinaryFlowObservables = Parameters::getBinaryFlowObservables();
+    const unsigned int tmpBatchSize = Parameters::getFlowObservablesBatchSize();
+    Parameters::setBinaryFlowObservables(true);
+    Parameters::setFlowObservablesBatchSize(2);
+
+    const std::vector<double> observables(Parameters::getNFlows() + 1, 1.0);
+    for (unsigned int iCfg = 0; iCfg < 3; iCfg++) {
+        IO::writeFlowObservableToFile(observables, observableNames[0], iCfg);
+    }
+    IO::ObservablesContainer::flushAll();
+    const std::map<std::string, unsigned long long> recordCounts = IO::ObservablesContainer::getRecordCounts();
+
+    // Configurations generated after the checkpoint, before the run is interrupted
+    for (unsigned int iCfg = 3; iCfg < 5; iCfg++) {
+        IO::writeFlowObservableToFile(observables, observableNames[0], iCfg);
+        IO::writeFlowObservableToFile(observables, observableNames[1], iCfg);
+    }
+    IO::ObservablesContainer::flushAll();
+
+    // Restores the checkpoint, and generates the configurations after it again
+    IO::ObservablesContainer::restoreRecordCounts(recordCounts);
+    std::vector<unsigned long long> restoredCounts(2, 0);
+    if (m_processRank == 0) {
+        std::ifstream file(fnames[0], std::ios::binary);
+        file.seekg(0, std::ios::end);
+        restoredCounts[0] = (unsigned long long)(file.tellg() - std::streamoff(sizeof(IO::ContainerHeader)))
+                / (2*sizeof(unsigned int) + observables.size()*sizeof(double));
+    }
+    IO::writeFlowObservableToFile(observables, observableNames[0], 3);
+    IO::writeFlowObservableToFile(observables, observableNames[1], 3);
+    IO::ObservablesContainer::flushAll();
+
+    Parameters::setBinaryFlowObservables(tmpBinaryFlowObservables);
+    Parameters::setFlowObservablesBatchSize(tmpBatchSize);
+
+    if (m_processRank == 0) {
+        if (recordCounts.count(observableNames[1]) != 0 || recordCounts.at(observableNames[0]) != 3 || restoredCounts[0] != 3) {
+            cout << "Error: observables container is not restored to the 3 records of the checkpoint." << endl;
+            passed = false;
+        }
+
+        // Each container holds the configurations up to the checkpoint, and the one generated again after it
+        const std::vector<std::vector<unsigned int>> expectedConfigs = {{0, 1, 2, 3}, {3}};
+        for (unsigned int iObs = 0; iObs < 2; iObs++) {
+            std::ifstream file(fnames[iObs], std::ios::binary);
+            file.seekg(sizeof(IO::ContainerHeader));
+            std::vector<unsigned int> configs;
+            unsigned int configNumber, crc;
+            std::vector<double> record(observables.size());
+            while (file.read(reinterpret_cast<char*>(&configNumber), sizeof(unsigned int))) {
+                file.read(reinterpret_cast<char*>(&crc), sizeof(unsigned int));
+                file.read(reinterpret_cast<char*>(record.data()), std::streamsize(record.size()*sizeof(double)));
+                configs.push_back(configNumber - unsigned(Parameters::getConfigStartNumber()));
+            }
+            if (configs != expectedConfigs[iObs]) {
+                cout << "Error: observables container " << observableNames[iObs] << " holds " << configs.size()
+                     << " records after restoring, expected " << expectedConfigs[iObs].size() << "." << endl;
+                passed = false;
+            }
+            file.close();
+            std::remove(fnames[iObs].c_str());
+        }
+    }
+    MPI_Bcast(&passed, 1, MPI_C_BOOL, 0, MPI_COMM_WORLD);
+
+    if (passed) {
+        if (m_processRank == 0) cout << "PASSED: IO binary observables container restored to a checkpoint." << endl;
+    } else {
+        if (m_processRank == 0) cout << "FAILED: IO binary observables container restored to a checkpoint." << endl;
+    }
+
+    return passed;
+}
+
+bool IOTests::testIOCheckpoint()
+{
+    if ((m_processRank == 0) && m_verbose) {
+        printf("    Testing IO checkpoint write and read\n");
+    }
+
+    bool passed = true;
+
+    // Blocks of different sizes on each processor, in order to test the block index
+    std::vector<char> state(1000 + 17*unsigned(m_processRank));
+    for (unsigned long i = 0; i < state.size(); i++) {
+        state[i] = char(m_uniform_distribution(m_generator)*255);
+    }
+
+    IO::CheckpointIO::writeCheckpoint(state);
+
+    std::vector<char> loadedState;
+    IO::CheckpointIO::loadCheckpoint(loadedState);
+
+    if (loadedState != state) {
+        cout << "Error: checkpoint block of processor " << m_processRank << " is not restored correctly." << endl;
+        passed = false;
+    }
+
+    if (m_processRank == 0) {
+        std::ifstream file(IO::CheckpointIO::getFilename(), std::ios::binary);
+        IO::CheckpointHeader header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(IO::CheckpointHeader));
+        if (std::strcmp(header.magic, "GLACCHK") != 0 || header.numberOfProcessors != unsigned(Parallel::Communicator::getNumProc())
+                || header.dimensions[3] != Parameters::getNTemporal() || header.beta != Parameters::getBeta()) {
+            cout << "Error: checkpoint header is not correct." << endl;
+            passed = false;
+        }
+        file.close();
+    }
+
+    if (m_processRank == 0) {
+        std::remove(IO::CheckpointIO::getFilename().c_str());
+        std::remove(IO::CheckpointIO::getPreviousFilename().c_str());
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &passed, 1, MPI_C_BOOL, MPI_LAND, MPI_COMM_WORLD);
+
+    if (passed) {
+        if (m_processRank == 0) cout << "PASSED: IO checkpoint write and read." << endl;
+    } else {
+        if (m_processRank == 0) cout << "FAILED: IO checkpoint write and read." << endl;
+    }
+
+    return passed;
+}
+
+bool IOTests::testIOCheckpointFallback()
+{
+    if ((m_processRank == 0) && m_verbose) {
+        printf("    Testing IO checkpoint fallback to the previous checkpoint\n");
+    }
+
+    bool passed = true;
+
+    std::vector<char> previousState(1000 + 17*unsigned(m_processRank));
+    std::vector<char> lastState(previousState.size());
+    for (unsigned long i = 0; i < previousState.size(); i++) {
+        previousState[i] = char(m_uniform_distribution(m_generator)*255);
+        lastState[i] = char(previousState[i] + 1);
+    }
+
+    // The last checkpoint is corrupt, truncated as by a node failing while it was flushed, or missing
+    const std::vector<std::string> damages = {"corrupt", "truncated", "missing"};
+    for (unsigned int iDamage = 0; iDamage < damages.size(); iDamage++) {
+        IO::CheckpointIO::writeCheckpoint(previousState);
+        IO::CheckpointIO::writeCheckpoint(lastState);
+
+        if (m_processRank == 0) {
+            const std::string fname = IO::CheckpointIO::getFilename();
+            if (iDamage == 0) {
+                std::fstream file(fname, std::ios::binary | std::ios::in | std::ios::out);
+                file.seekg(-1, std::ios::end);
+                char lastByte = 0;
+                file.read(&lastByte, 1);
+                lastByte = char(lastByte ^ 0x55);
+                file.seekp(-1, std::ios::end);
+                file.write(&lastByte, 1);
+                file.close();
+            } else if (iDamage == 1) {
+                std::ifstream file(fname, std::ios::binary);
+                file.seekg(0, std::ios::end);
+                const long long fileSize = file.tellg();
+                file.close();
+                if (truncate(fname.c_str(), fileSize - 10) != 0) passed = false;
+            } else {
+                std::remove(fname.c_str());
+            }
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        std::vector<char> loadedState;
+        IO::CheckpointIO::loadCheckpoint(loadedState);
+        if (loadedState != previousState || !IO::CheckpointIO::checkpointExists()) {
+            cout << "Error: previous checkpoint of processor " << m_processRank << " is not restored when the last one is "
+                 << damages[iDamage] << "." << endl;
+            passed = false;
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+
+    if (m_processRank == 0) {
+        std::remove(IO::CheckpointIO::getFilename().c_str());
+        std::remove(IO::CheckpointIO::getPreviousFilename().c_str());
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &passed, 1, MPI_C_BOOL, MPI_LAND, MPI_COMM_WORLD);
+
+    if (passed) {
+        if (m_processRank == 0) cout << "PASSED: IO checkpoint fallback to the previous checkpoint." << endl;
+    } else {
+        if (m_processRank == 0) cout << "FAILED: IO checkpoint fallback to the previous checkpoint." << endl;
+    }
+
+    return passed;
+}
+
+bool IOTests::testIOAutoResume()
+{
+    if ((m_processRank == 0) && m_verbose) {
+        printf("    Testing IO automatic resume from checkpoint\n");
+    }
+
+    bool passed = true;
+
+    const bool tmpAutoResume = Parameters::getAutoResume();
+    const bool tmpRestartFromCheckpoint = Parameters::getRestartFromCheckpoint();
+    Parameters::setAutoResume(true);
+    Parameters::setRestartFromCheckpoint(false);
+
+    if (m_processRank == 0) {
+        std::remove(IO::CheckpointIO::getFilename().c_str());
+        std::remove(IO::CheckpointIO::getPreviousFilename().c_str());
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    // Without a checkpoint the run starts from scratch
+    if (IO::CheckpointIO::resumeIfCheckpointed() || Parameters::getRestartFromCheckpoint()) {
+        cout << "Error: run resumes without a checkpoint on processor " << m_processRank << "." << endl;
+        passed = false;
+    }
+
+    // The scales of a run interrupted after a checkpoint, which must be kept when it resumes
+    const std::string scalesFilename = Parameters::getFilePath() + Parameters::getOutputFolder() + Parameters::getBatchName()
+            + "/observables/" + Parameters::getBatchName() + "_scale_setting.dat";
+    const std::string scales = "config t0 w0 NFlows\n0 1.5 1.2 100\n";
+    if (m_processRank == 0) {
+        std::ofstream file(scalesFilename);
+        file << scales;
+        if (!file.good()) {
+            cout << "Error: could not write " << scalesFilename << ", check that the observables folder exists." << endl;
+            passed = false;
+        }
+        file.close();
+    }
+    IO::CheckpointIO::writeCheckpoint(std::vector<char>(100, 'a'));
+
+    if (!IO::CheckpointIO::resumeIfCheckpointed() || !Parameters::getRestartFromCheckpoint()) {
+        cout << "Error: run does not resume from the checkpoint on processor " << m_processRank << "." << endl;
+        passed = false;
+    }
+
+    // Output set up after the decision to resume continues the files of the interrupted run
+    EnergyDensity energy(true);
+    ScaleSetting scaleSetting(&energy, Parameters::getNFlows(), Parameters::getFlowEpsilon(), 0.0);
+    if (m_processRank == 0) {
+        std::ifstream file(scalesFilename);
+        const std::string readScales((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (readScales != scales) {
+            cout << "Error: scales of the interrupted run are not kept when resuming." << endl;
+            passed = false;
+        }
+        file.close();
+
+        // Scales written after the checkpoint are dropped when it is restored
+        std::ofstream appendFile(scalesFilename, std::ios::app);
+        appendFile << "1 1.6 1.3 100\n";
+        appendFile.close();
+    }
+    scaleSetting.restoreScales(1);
+    if (m_processRank == 0) {
+        std::ifstream file(scalesFilename);
+        const std::string readScales((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (readScales != scales || scaleSetting.getNumberOfScales() != 1) {
+            cout << "Error: scales written after the checkpoint are not dropped when restoring it." << endl;
+            passed = false;
+        }
+        file.close();
+        std::remove(scalesFilename.c_str());
+        std::remove(IO::CheckpointIO::getFilename().c_str());
+        std::remove(IO::CheckpointIO::getPreviousFilename().c_str());
+    }
+
+    Parameters::setAutoResume(tmpAutoResume);
+    Parameters::setRestartFromCheckpoint(tmpRestartFromCheckpoint);
+    MPI_Allreduce(MPI_IN_PLACE, &passed, 1, MPI_C_BOOL, MPI_LAND, MPI_COMM_WORLD);
+
+    if (passed) {
+        if (m_processRank == 0) cout << "PASSED: IO automatic resume from checkpoint." << endl;
+    } else {
+        if (m_processRank == 0) cout << "FAILED: IO automatic resume from checkpoint." << endl;
+    }
+
+    return passed;
+}
+
 bool IOTests::runIOTests()
 {
-    bool passed = (testIOWriteDoubles() && testIOLatticeWriteRead());
+    bool passed = (testIOWriteDoubles() && testIOLatticeWriteRead() && testIOFieldHeader() && testIOMappedLoad() && testIOCompressedDoubles()
+                   && testIOObservablesContainer() && testIOObservablesContainerRestore() && testIOCheckpoint() && testIOCheckpointFallback() && testIOAutoResume());
 
     if (m_processRank == 0) {
         if (passed) {
@@ -9,6 +9,14 @@ private:
     // Test for IO
     bool testIOLatticeWriteRead();
     bool testIOWriteDoubles();
+    bool testIOFieldHeader();
+    bool testIOMappedLoad();
+    bool testIOCompressedDoubles();
+    bool testIOObservablesContainer();
+    bool testIOObservablesContainerRestore();
+    bool testIOCheckpoint();
+    bool testIOCheckpointFallback();
+    bool testIOAutoResume();
 public:
     IOTests();
 
@@ -626,6 +626,121 @@ bool LatticeOperations::testZeros() {
     return passed;
 }
 
+bool LatticeOperations::testProcessGrid() {
+    /*
+     * Tests the factorisation of processors over the lattice dimensions.
+     */
+    bool passed = true;
+    const std::vector<unsigned int> N = {8, 8, 8, 16};
+    const std::vector<unsigned int> NOdd = {24, 24, 24, 48};
+
+    // The temporal dimension is the largest, and has the smallest face
+    if (Parallel::ProcessGrid::decompose(1, N) != std::vector<unsigned int>({1, 1, 1, 1})
+            || Parallel::ProcessGrid::decompose(2, N) != std::vector<unsigned int>({1, 1, 1, 2})
+            || Parallel::ProcessGrid::decompose(3, NOdd) != std::vector<unsigned int>({1, 1, 1, 3})) {
+        passed = false;
+        cout << "    FAILED: process grid does not split the dimension with the smallest face." << endl;
+    }
+
+    // Any number of processors dividing the lattice is used in full
+    std::vector<unsigned int> grid = Parallel::ProcessGrid::decompose(96, NOdd);
+    unsigned int numprocs = 1;
+    for (unsigned int i = 0; i < grid.size(); i++) {
+        numprocs *= grid[i];
+        if (NOdd[i] % grid[i] != 0 || (grid[i] > 1 && NOdd[i] / grid[i] <= 2)) numprocs = 0;
+    }
+    if (grid.size() != 4 || numprocs != 96) {
+        passed = false;
+        cout << "    FAILED: process grid of 96 processors does not divide the lattice." << endl;
+    }
+
+    // No sub-lattice extents of two or less, and the largest valid number of processors otherwise
+    grid = Parallel::ProcessGrid::largestDecomposition(7, N);
+    if (!Parallel::ProcessGrid::decompose(7, N).empty() || !Parallel::ProcessGrid::decompose(4, {4, 4, 4, 4}).empty()
+            || grid.size() != 4 || grid[0]*grid[1]*grid[2]*grid[3] != 4) {
+        passed = false;
+        cout << "    FAILED: process grid accepts processors that can not divide the lattice." << endl;
+    }
+
+    // A node holds a block spanning the dimension with the largest face first, and the nodes cover every rank of the grid once
+    grid = {2, 2, 2, 4};
+    const std::vector<unsigned int> block = Parallel::ProcessGrid::nodeBlock(8, {16, 16, 16, 16}, grid);
+    std::vector<bool> placed(32, false);
+    bool placementCorrect = block == std::vector<unsigned int>({2, 1, 1, 4})
+            && Parallel::ProcessGrid::nodeBlock(3, {16, 16, 16, 16}, grid).empty();
+    for (unsigned int node = 0; node < 4 && placementCorrect; node++) {
+        for (unsigned int localRank = 0; localRank < 8; localRank++) {
+            const unsigned int rank = Parallel::ProcessGrid::nodeMappedRank(node, localRank, grid, block);
+            // Within a node only the x and t coordinates differ, such that the t faces are exchanged within the node
+            const unsigned int firstRank = Parallel::ProcessGrid::nodeMappedRank(node, 0, grid, block);
+            if (rank >= 32 || placed[rank] || (rank / 2) % 4 != (firstRank / 2) % 4) {
+                placementCorrect = false;
+                break;
+            }
+            placed[rank] = true;
+        }
+    }
+    if (!placementCorrect) {
+        passed = false;
+        cout << "    FAILED: process grid is not placed on the nodes in blocks." << endl;
+    }
+
+    if (m_verbose && passed) cout << "    SUCCESS: process grid decomposition is correct." << endl;
+
+    return passed;
+}
+
+bool LatticeOperations::testNeighbourTables() {
+    /*
+     * Tests the neighbour tables against the periodic index arithmetic, in each site ordering.
+     */
+    bool passed = true;
+    const std::vector<unsigned int> N = Parallel::Index::getN();
+    const Parallel::SiteOrdering ordering = Parallel::Index::getOrdering();
+    const Parallel::SiteOrdering orderings[3] = {Parallel::LEXICOGRAPHIC, Parallel::BLOCKED, Parallel::MORTON};
+
+    for (int iOrdering = 0; iOrdering < 3 && passed; iOrdering++) {
+        Parallel::Index::setOrdering(orderings[iOrdering]);
+        for (unsigned int x = 0; x < N[0]; x++) {
+            for (unsigned int y = 0; y < N[1]; y++) {
+                for (unsigned int z = 0; z < N[2]; z++) {
+                    for (unsigned int t = 0; t < N[3]; t++) {
+                        const unsigned int n[4] = {x, y, z, t};
+                        const unsigned long iSite = Parallel::Index::getIndex(x,y,z,t);
+                        for (int mu = 0; mu < 4; mu++) {
+                            unsigned int backward[4] = {x, y, z, t};
+                            unsigned int forward[4] = {x, y, z, t};
+                            backward[mu] = (n[mu] + N[mu] - 1) % N[mu];
+                            forward[mu] = (n[mu] + 1) % N[mu];
+                            if (Parallel::Index::getNeighbourIndex(iSite, 2*mu) != Parallel::Index::getIndex(backward[0],backward[1],backward[2],backward[3])
+                                    || Parallel::Index::getNeighbourIndex(iSite, 2*mu+1) != Parallel::Index::getIndex(forward[0],forward[1],forward[2],forward[3])
+                                    || Parallel::Index::isOnFace(iSite, 2*mu) != (n[mu] == 0)
+                                    || Parallel::Index::isOnFace(iSite, 2*mu+1) != (n[mu] == N[mu] - 1)) {
+                                passed = false;
+                            }
+                            // The sites of a face are listed by their halo index
+                            for (int direction = 2*mu; direction < 2*mu + 2; direction++) {
+                                if (Parallel::Index::isOnFace(iSite, direction)
+                                        && Parallel::Index::getFaceSites(direction)[Parallel::Index::getHaloIndex(iSite, mu)] != iSite) {
+                                    passed = false;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    Parallel::Index::setOrdering(ordering);
+
+    if (passed) {
+        if (m_verbose) cout << "    SUCCESS: neighbour tables are correct." << endl;
+    } else {
+        cout << "    FAILED: neighbour tables differ from the periodic sub lattice indices." << endl;
+    }
+    return passed;
+}
+
 bool LatticeOperations::testLatticeShift() {
     /*
      * Tests the lattice shift function for all possible directions.
@@ -747,6 +862,82 @@ bool LatticeOperations::testLatticeShift() {
     return passed;
 }
 
+bool LatticeOperations::testHaloExchange() {
+    /*
+     * Tests that the lattice shifts are the same with the faces passed through the shared window of the node as by MPI point-to-point,
+     * with the node split into blocks such that both neighbours on the node and on other nodes are covered.
+     */
+    bool passed = true;
+
+    Parallel::Communicator::setBarrier();
+
+    if (Parallel::ParallelParameters::active) {
+        const bool wasShared = Parallel::HaloExchange::isShared();
+
+        // Every site of the lattice is distinct
+        Lattice<SU3> L;
+        L.allocate(m_dim);
+        for (unsigned long iSite = 0; iSite < m_subLatticeSize; iSite++) {
+            L[iSite] = double(m_processRank*m_subLatticeSize + iSite);
+        }
+
+        // Shifts with the faces passed by MPI point-to-point
+        Parallel::HaloExchange::finalize();
+        Lattice<SU3> reference[8];
+        for (int dir = 0; dir < 8; dir++) {
+            reference[dir] = shift(L, dir % 2 == 0 ? BACKWARDS : FORWARDS, dir / 2);
+        }
+
+        // Shifts with the window shared by the whole node, by blocks of one processor, and by blocks of two processors
+        int neighbours[2] = {0, 0};
+        for (int ranksPerNode : {0, 1, 2}) {
+            Parallel::HaloExchange::initialize(m_dim, ranksPerNode);
+            for (int dir = 0; dir < 8; dir++) {
+                neighbours[Parallel::HaloExchange::isOnNode(dir) ? 0 : 1]++;
+
+                Lattice<SU3> shifted = shift(L, dir % 2 == 0 ? BACKWARDS : FORWARDS, dir / 2);
+                for (unsigned long iSite = 0; iSite < m_subLatticeSize; iSite++) {
+                    if (!compareSU3(shifted[iSite], reference[dir][iSite])) {
+                        passed = false;
+                        printf("    Rank %d: shift %d differs with the shared memory halo at site %lu, with %d processors per node.\n",
+                               m_processRank, dir, iSite, ranksPerNode);
+                        break;
+                    }
+                }
+            }
+        }
+
+        Parallel::HaloExchange::finalize();
+        if (wasShared) {
+            Parallel::HaloExchange::initialize(m_dim);
+        }
+
+        // With several processors, both neighbours on the node and on other nodes must have been passed to
+        int numActive = 0;
+        MPI_Comm_size(Parallel::ParallelParameters::ACTIVE_COMM, &numActive);
+        MPI_Allreduce(MPI_IN_PLACE, neighbours, 2, MPI_INT, MPI_SUM, Parallel::ParallelParameters::ACTIVE_COMM);
+        if (numActive > 1 && (neighbours[0] == 0 || neighbours[1] == 0)) {
+            passed = false;
+            if (m_processRank == 0) printf("    Halo exchange test covered %d neighbours on the node and %d on other nodes.\n", neighbours[0], neighbours[1]);
+        }
+    }
+
+    // Fails if any processor fails
+    int passedAll = passed ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &passedAll, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    passed = passedAll == 1;
+
+    if (m_processRank == 0) {
+        if (passed) {
+            if (m_verbose) cout << "    SUCCESS: lattice shifts are the same with and without the shared memory halo." << endl;
+        } else {
+            cout << "    FAILED: lattice shifts differ with the shared memory halo." << endl;
+        }
+    }
+
+    return passed;
+}
+
 bool LatticeOperations::testFieldGaugeInvariance() {
     /*
      * Tests if the lattice remaince gauge invariant
@@ -812,6 +1003,387 @@ bool LatticeOperations::testFieldGaugeInvariance() {
     return passed;
 }
 
+bool LatticeOperations::testLinkWindow() {
+    /*
+     * Tests that the links fetched one-sided are the same as those passed between the processors by the link getters.
+     */
+    bool passed = true;
+
+    Parallel::Communicator::setBarrier();
+
+    if (Parallel::ParallelParameters::active) {
+        // Every link of the lattice is distinct
+        Lattice<SU3> L[4];
+        for (int mu = 0; mu < 4; mu++) {
+            L[mu].allocate(m_dim);
+            for (unsigned long iSite = 0; iSite < m_subLatticeSize; iSite++) {
+                L[mu][iSite] = double((m_processRank*4 + mu)*m_subLatticeSize + iSite);
+            }
+        }
+
+        Parallel::LinkWindow::initialize(m_dim);
+        Parallel::LinkWindow::attach(L);
+        for (int mu = 0; mu < 4; mu++) {
+            Parallel::LinkWindow::fetch(mu);
+        }
+
+        SU3 fetched[3];
+        for (unsigned int x = 0; x < m_dim[0]; x++) {
+            for (unsigned int y = 0; y < m_dim[1]; y++) {
+                for (unsigned int z = 0; z < m_dim[2]; z++) {
+                    for (unsigned int t = 0; t < m_dim[3]; t++) {
+                        const unsigned long iSite = Parallel::Index::getIndex(x,y,z,t);
+                        for (int mu = 0; mu < 4; mu++) {
+                            for (int nu = 0; nu < 4; nu++) {
+                                if (mu == nu) continue;
+
+                                // The links from the cache, and then passed in lock-step by all processors
+                                for (int attached = 1; attached >= 0; attached--) {
+                                    if (attached) {
+                                        Parallel::LinkWindow::attach(L);
+                                    } else {
+                                        Parallel::LinkWindow::detach();
+                                    }
+                                    SU3 positive = Parallel::Communicator::getPositiveLink(L, iSite, mu, nu);
+                                    SU3 negative = Parallel::Communicator::getNegativeLink(L, iSite, nu, mu);
+                                    SU3 diagonal = Parallel::Communicator::getNeighboursNeighbourLink(L, iSite, mu, nu, nu);
+                                    if (attached) {
+                                        fetched[0] = positive;
+                                        fetched[1] = negative;
+                                        fetched[2] = diagonal;
+                                    } else if (!compareSU3(positive, fetched[0]) || !compareSU3(negative, fetched[1])
+                                               || !compareSU3(diagonal, fetched[2])) {
+                                        passed = false;
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        Parallel::LinkWindow::finalize();
+    }
+
+    // Fails if any processor fails
+    int passedAll = passed ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &passedAll, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    passed = passedAll == 1;
+
+    if (m_processRank == 0) {
+        if (passed) {
+            if (m_verbose) cout << "    SUCCESS: links fetched one-sided are the same as those passed between processors." << endl;
+        } else {
+            cout << "    FAILED: links fetched one-sided differ from those passed between processors." << endl;
+        }
+    }
+
+    return passed;
+}
+
+bool LatticeOperations::testTemporalReduction() {
+    /*
+     * Tests that the single reduction to the temporal dimension gives the same as a reduction per flow time, and that the
+     * results are only set on the root.
+     */
+    bool passed = true;
+
+    Parallel::Communicator::setBarrier();
+
+    if (Parallel::ParallelParameters::active) {
+        // Temporary sets the number of flow times
+        const unsigned int tempNFlows = Parameters::getNFlows();
+        Parameters::setNFlows(3);
+
+        const unsigned long NT = Parameters::getNTemporal();
+        const unsigned long NFlowTimes = Parameters::getNFlows() + 1;
+        const unsigned long tOffset = m_dim[3]*Parallel::Neighbours::getProcessorDimensionPosition(3);
+
+        // Integer values, such that the sums are exact regardless of the order of summation
+        std::vector<double> obs(NFlowTimes*m_dim[3]);
+        for (unsigned long iFlow = 0; iFlow < NFlowTimes; iFlow++) {
+            for (unsigned long it = 0; it < m_dim[3]; it++) {
+                obs[iFlow*m_dim[3] + it] = double((iFlow*NT + tOffset + it)*m_numprocs + m_processRank);
+            }
+        }
+
+        std::vector<double> obsResults(NFlowTimes*NT, -1.0);
+        Parallel::Communicator::reduceToTemporalDimension(obsResults, obs);
+
+        // Reduces one flow time at the time, as done before the flow times were placed in a single buffer
+        std::vector<double> obsReference(NFlowTimes*NT, 0);
+        std::vector<double> tempSend(NT);
+        for (unsigned long iFlow = 0; iFlow < NFlowTimes; iFlow++) {
+            std::fill(tempSend.begin(), tempSend.end(), 0.0);
+            for (unsigned long it = 0; it < m_dim[3]; it++) {
+                tempSend[tOffset + it] = obs[iFlow*m_dim[3] + it];
+            }
+            MPI_Reduce(tempSend.data(), &obsReference[iFlow*NT], int(NT), MPI_DOUBLE, MPI_SUM, 0, Parallel::ParallelParameters::ACTIVE_COMM);
+        }
+
+        for (unsigned long i = 0; i < NFlowTimes*NT; i++) {
+            if (m_processRank == 0) {
+                if (obsResults[i] != obsReference[i]) {
+                    passed = false;
+                    printf("    Flow time %lu, t = %lu: %f, per flow time reduction: %f\n", i / NT, i % NT, obsResults[i], obsReference[i]);
+                    break;
+                }
+            } else if (obsResults[i] != -1.0) {
+                passed = false;
+                break;
+            }
+        }
+
+        Parameters::setNFlows(tempNFlows);
+    }
+
+    // Fails if any processor fails
+    int passedAll = passed ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &passedAll, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    passed = passedAll == 1;
+
+    if (m_processRank == 0) {
+        if (passed) {
+            if (m_verbose) cout << "    SUCCESS: reduction to the temporal dimension matches the reduction per flow time." << endl;
+        } else {
+            cout << "    FAILED: reduction to the temporal dimension differs from the reduction per flow time." << endl;
+        }
+    }
+
+    return passed;
+}
+
+bool LatticeOperations::testReductionBuffer() {
+    /*
+     * Tests that the slots packed in a reduction buffer are each summed over the active processors, for the blocking reduce to a
+     * root, the blocking allreduce and the non-blocking start and wait.
+     */
+    bool passed = true;
+
+    Parallel::Communicator::setBarrier();
+
+    if (Parallel::ParallelParameters::active) {
+        int numActive = 0;
+        MPI_Comm_size(Parallel::ParallelParameters::ACTIVE_COMM, &numActive);
+
+        // Slots of different sizes, holding integer values such that the sums are exact
+        const unsigned long slotSizes[3] = {1, 4, 7};
+        double scalar;
+        double array[4];
+        std::vector<double> vector(slotSizes[2]);
+        double *slots[3] = {&scalar, array, vector.data()};
+
+        auto value = [](const int rank, const unsigned long iSlot, const unsigned long i) {
+            return double(100*rank + 10*iSlot + i);
+        };
+        auto fill = [&]() {
+            for (unsigned long iSlot = 0; iSlot < 3; iSlot++) {
+                for (unsigned long i = 0; i < slotSizes[iSlot]; i++) {
+                    slots[iSlot][i] = value(m_processRank, iSlot, i);
+                }
+            }
+        };
+        // Checks each slot against the sum over the active processors, or against the values of this processor if not summed here
+        auto check = [&](const bool summed) {
+            bool correct = true;
+            for (unsigned long iSlot = 0; iSlot < 3; iSlot++) {
+                for (unsigned long i = 0; i < slotSizes[iSlot]; i++) {
+                    double expected = 0;
+                    if (summed) {
+                        for (int iRank = 0; iRank < numActive; iRank++) {
+                            expected += value(iRank, iSlot, i);
+                        }
+                    } else {
+                        expected = value(m_processRank, iSlot, i);
+                    }
+                    if (slots[iSlot][i] != expected) {
+                        correct = false;
+                    }
+                }
+            }
+            return correct;
+        };
+
+        Parallel::ReductionBuffer buffer;
+        buffer.add(&scalar);
+        buffer.add(array, slotSizes[1]);
+        buffer.add(vector);
+        if (buffer.getSize() != slotSizes[0] + slotSizes[1] + slotSizes[2]) {
+            passed = false;
+        }
+
+        // Reduces to the first and the last active processor
+        for (int root : {0, numActive - 1}) {
+            fill();
+            buffer.reduce(root);
+            if (!check(m_processRank == root)) {
+                passed = false;
+                printf("    Rank %d: reduction buffer reduce to root %d gave wrong slot values.\n", m_processRank, root);
+            }
+        }
+
+        fill();
+        buffer.allreduce();
+        if (!check(true)) {
+            passed = false;
+            printf("    Rank %d: reduction buffer allreduce gave wrong slot values.\n", m_processRank);
+        }
+
+        // Non-blocking reduction, with the sums written back by wait
+        fill();
+        buffer.start();
+        buffer.wait();
+        if (!check(true)) {
+            passed = false;
+            printf("    Rank %d: reduction buffer start and wait gave wrong slot values.\n", m_processRank);
+        }
+
+        // A cleared buffer may be reused
+        buffer.clear();
+        if (buffer.getSize() != 0) {
+            passed = false;
+        }
+        buffer.add(vector);
+        fill();
+        buffer.allreduce();
+        for (unsigned long i = 0; i < slotSizes[2]; i++) {
+            double expected = 0;
+            for (int iRank = 0; iRank < numActive; iRank++) {
+                expected += value(iRank, 2, i);
+            }
+            if (vector[i] != expected || scalar != value(m_processRank, 0, 0)) {
+                passed = false;
+            }
+        }
+    }
+
+    // Fails if any processor fails
+    int passedAll = passed ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &passedAll, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    passed = passedAll == 1;
+
+    if (m_processRank == 0) {
+        if (passed) {
+            if (m_verbose) cout << "    SUCCESS: reduction buffer sums each slot over the processors." << endl;
+        } else {
+            cout << "    FAILED: reduction buffer does not sum each slot over the processors." << endl;
+        }
+    }
+
+    return passed;
+}
+
+bool LatticeOperations::testWorkQueue() {
+    /*
+     * Tests that the work queue hands out every item exactly once, both to a single group and when shared by several groups, and that
+     * it stays empty once all items are taken.
+     */
+    bool passed = true;
+    const unsigned long NItems = 25;
+
+    Parallel::Communicator::setBarrier();
+
+    int worldRank = 0, worldSize = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &worldSize);
+
+    // A single group takes the items in order
+    if (Parallel::ParallelParameters::active) {
+        Parallel::WorkQueue queue(NItems);
+        unsigned long item = 0, expected = 0;
+        while (queue.next(item)) {
+            if (item != expected++) {
+                passed = false;
+            }
+        }
+        if (expected != NItems || queue.next(item)) {
+            passed = false;
+        }
+    }
+
+    // Splits the processors in groups of two if possible, or else of one, as done for the flow groups
+    const int groupSize = (worldSize % 2 == 0 && worldSize > 2) ? 2 : 1;
+    const int group = worldRank / groupSize;
+
+    MPI_Comm tempGroupComm = Parallel::ParallelParameters::GROUP_COMM;
+    MPI_Comm tempActiveComm = Parallel::ParallelParameters::ACTIVE_COMM;
+    MPI_Comm tempLeaderComm = Parallel::ParallelParameters::LEADER_COMM;
+
+    MPI_Comm groupComm, leaderComm;
+    MPI_Comm_split(MPI_COMM_WORLD, group, worldRank, &groupComm);
+    int groupRank = 0;
+    MPI_Comm_rank(groupComm, &groupRank);
+    MPI_Comm_split(MPI_COMM_WORLD, groupRank == 0 ? 0 : MPI_UNDEFINED, group, &leaderComm);
+
+    Parallel::ParallelParameters::GROUP_COMM = groupComm;
+    Parallel::ParallelParameters::ACTIVE_COMM = groupComm;
+    Parallel::ParallelParameters::LEADER_COMM = leaderComm;
+
+    std::vector<unsigned long> items;
+    bool endsCleanly = true;
+    {
+        Parallel::WorkQueue queue(NItems);
+        unsigned long item = 0;
+        while (queue.next(item)) {
+            items.push_back(item);
+        }
+        // Further calls find the queue empty as well
+        endsCleanly = !queue.next(item) && !queue.next(item);
+    }
+    if (!endsCleanly) {
+        passed = false;
+        printf("    Rank %d: work queue handed out items after it was empty.\n", worldRank);
+    }
+
+    // All processors of a group must have been handed the items of their leader
+    unsigned long NTaken = items.size();
+    MPI_Bcast(&NTaken, 1, MPI_UNSIGNED_LONG, 0, groupComm);
+    std::vector<unsigned long> leaderItems(NTaken);
+    if (groupRank == 0) leaderItems = items;
+    MPI_Bcast(leaderItems.data(), int(NTaken), MPI_UNSIGNED_LONG, 0, groupComm);
+    if (leaderItems != items) {
+        passed = false;
+        printf("    Rank %d: work queue items differ from those of the group leader.\n", worldRank);
+    }
+
+    // Counts how many times each item was handed out to a group
+    std::vector<int> counts(NItems, 0);
+    if (groupRank == 0) {
+        for (auto &item : items) {
+            if (item < NItems) counts[item]++;
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, counts.data(), int(NItems), MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    for (unsigned long i = 0; i < NItems; i++) {
+        if (counts[i] != 1) {
+            passed = false;
+            if (worldRank == 0) printf("    Work queue item %lu was handed out %d times.\n", i, counts[i]);
+        }
+    }
+
+    Parallel::ParallelParameters::GROUP_COMM = tempGroupComm;
+    Parallel::ParallelParameters::ACTIVE_COMM = tempActiveComm;
+    Parallel::ParallelParameters::LEADER_COMM = tempLeaderComm;
+    if (leaderComm != MPI_COMM_NULL) MPI_Comm_free(&leaderComm);
+    MPI_Comm_free(&groupComm);
+
+    // Fails if any processor fails
+    int passedAll = passed ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &passedAll, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    passed = passedAll == 1;
+
+    if (m_processRank == 0) {
+        if (passed) {
+            if (m_verbose) cout << "    SUCCESS: work queue hands out every item once to " << worldSize / groupSize << " group(s)." << endl;
+        } else {
+            cout << "    FAILED: work queue does not hand out every item once." << endl;
+        }
+    }
+
+    return passed;
+}
+
 bool LatticeOperations::fullLatticeTests()
 {
     /*
@@ -849,7 +1421,14 @@ bool LatticeOperations::runLatticeTests()
      *  - summing and taking the real trace
      *  - multiplying two lattices and taking the real sum
      *  - finding the inverse
+     *  - process grid decomposition
+     *  - neighbour tables
      *  - lattice shift
+     *  - shared memory halo exchange
+     *  - one-sided link fetching
+     *  - reduction to the temporal dimension
+     *  - reduction buffer
+     *  - work queue shared by processor groups
      *  - (if config is provided) gauge field invariance tests
      */
     if (m_verbose && m_processRank == 0) cout << "Running lattice tests." << endl;
@@ -864,12 +1443,20 @@ bool LatticeOperations::runLatticeTests()
                   && testLatticeInverse() && testLatticeTrace() && testMakeHermitian()
                   && testMakeAntiHermitian() && testLatticeSumSpatial()
                   && testLatticeRealTraceMultiplication() && testLatticeImagTraceMultiplication()
-                  && testTranpose() && testConjugate() && testZeros() && testIdentity());
+                  && testTranpose() && testConjugate() && testZeros() && testIdentity()
+                  && testProcessGrid() && testNeighbourTables());
     }
 
     MPI_Bcast(&passed, 1, MPI_BYTE, 0, MPI_COMM_WORLD);
     Parallel::Communicator::setBarrier();
 
+    // Tests including parallel communication, run by all processors
+    passed = testHaloExchange() && passed;
+    passed = testLinkWindow() && passed;
+    passed = testTemporalReduction() && passed;
+    passed = testReductionBuffer() && passed;
+    passed = testWorkQueue() && passed;
+
 //    passed = passed && fullLatticeTests();
 
     if (passed) {
@@ -44,9 +44,20 @@ private:
     bool testIdentity();
     bool testZeros();
 
+    // Process grid decomposition
+    bool testProcessGrid();
+
+    // Neighbour tables of the sub lattice
+    bool testNeighbourTables();
+
     // Tests including parallel communication
     bool fullLatticeTests();
     bool testLatticeShift();
+    bool testHaloExchange();
+    bool testLinkWindow();
+    bool testTemporalReduction();
+    bool testReductionBuffer();
+    bool testWorkQueue();
     bool testFieldGaugeInvariance();
 public:
     LatticeOperations();
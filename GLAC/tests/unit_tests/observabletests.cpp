@@ -1,6 +1,15 @@
 #include "observabletests.h"
 #include "observables/observables.h"
+#include "observables/tools/streamingstatistics.h"
+#include "observables/tools/autocorrelationestimator.h"
+#include "observables/tools/thermalizationdetector.h"
+#include "observables/tools/resampling.h"
+#include "observables/tools/flowanalysis.h"
+#include "observables/tools/flowschedule.h"
 #include "parallelization/communicator.h"
+#include <cmath>
+#include <numeric>
+#include <random>
 
 ObservableTests::ObservableTests()
 {
@@ -15,6 +24,370 @@ bool ObservableTests::testTopCharge()
     return passed;
 }
 
+bool ObservableTests::testStreamingStatistics()
+{
+    bool passed = true;
+
+    // Values with a large offset, where a naive sum of squares loses all precision of the variance
+    const unsigned long NValues = 1000;
+    const double offset = 1e9;
+    std::vector<double> values(NValues);
+    StreamingStatistics statistics;
+    for (unsigned long i = 0; i < NValues; i++) {
+        values[i] = offset + m_uniform_distribution(m_generator);
+        statistics.push(values[i]);
+    }
+
+    double mean = 0;
+    for (auto value : values) mean += (value - offset);
+    mean = mean / double(NValues) + offset;
+    double variance = 0;
+    for (auto value : values) variance += (value - mean)*(value - mean);
+    variance /= double(NValues);
+
+    if (statistics.getCount() != NValues) {
+        cout << "    FAILED: streaming statistics counted " << statistics.getCount() << " values, expected " << NValues << endl;
+        passed = false;
+    }
+    if (fabs(statistics.getMean() - mean) > 1e-15 * offset) {
+        cout << "    FAILED: streaming mean " << statistics.getMean() << " differs from " << mean << endl;
+        passed = false;
+    }
+    if (fabs(statistics.getVariance() - variance) > 1e-6 * variance) {
+        cout << "    FAILED: streaming variance " << statistics.getVariance() << " differs from " << variance << endl;
+        passed = false;
+    }
+
+    // Each value repeated twice, such that blocks of two are the original values and the binned error is larger by sqrt(2)
+    StreamingStatistics pairs;
+    for (unsigned long i = 0; i < NValues; i++) {
+        pairs.push(values[i] - offset);
+        pairs.push(values[i] - offset);
+    }
+    const std::vector<double> binnedErrors = pairs.getBinnedStandardErrors();
+    const double expectedError = sqrt(variance / double(NValues - 1));
+    if (binnedErrors.size() < 2 || fabs(binnedErrors[1] - expectedError) > 1e-10 * expectedError) {
+        cout << "    FAILED: binned standard error of paired values is not the standard error of the values." << endl;
+        passed = false;
+    }
+    if (pairs.getBinnedStandardError() < expectedError * (1 - 1e-10)) {
+        cout << "    FAILED: binned standard error is smaller than the error of uncorrelated blocks." << endl;
+        passed = false;
+    }
+
+    statistics.reset();
+    if (statistics.getCount() != 0 || statistics.getMean() != 0 || statistics.getBinnedStandardErrors(1).size() != 0) {
+        cout << "    FAILED: streaming statistics not empty after reset." << endl;
+        passed = false;
+    }
+
+    if (m_verbose) cout << "    Streaming statistics test " << (passed ? "passed" : "failed") << endl;
+
+    return passed;
+}
+
+bool ObservableTests::testAutocorrelationEstimator()
+{
+    bool passed = true;
+
+    // An AR(1) process x_i = phi x_{i-1} + noise has rho(t) = phi^t, and tau_int = (1 + phi)/(2(1 - phi))
+    const unsigned long NValues = 200000;
+    const double phi = 0.8;
+    const double expectedTau = (1 + phi) / (2 * (1 - phi));
+
+    std::mt19937_64 generator(1234);
+    std::normal_distribution<double> noise(0, 1);
+
+    AutocorrelationEstimator correlated;
+    AutocorrelationEstimator uncorrelated;
+    double x = 0;
+    for (unsigned long i = 0; i < NValues; i++) {
+        x = phi * x + noise(generator);
+        correlated.push(1.0 + x);
+        uncorrelated.push(1.0 + noise(generator));
+    }
+
+    const double tau = correlated.getIntegratedAutocorrelationTime();
+    if (fabs(tau - expectedTau) > 4 * correlated.getIntegratedAutocorrelationTimeError()) {
+        cout << "    FAILED: integrated autocorrelation time " << tau << " of an AR(1) process differs from " << expectedTau << endl;
+        passed = false;
+    }
+
+    const std::vector<double> rho = correlated.getAutocorrelation();
+    if (rho.size() != correlated.getMaximumLag() + 1 || rho[0] != 1.0 || fabs(rho[1] - phi) > 0.01) {
+        cout << "    FAILED: autocorrelation function of an AR(1) process is not phi^t." << endl;
+        passed = false;
+    }
+
+    if (fabs(uncorrelated.getIntegratedAutocorrelationTime() - 0.5) > 4 * uncorrelated.getIntegratedAutocorrelationTimeError()) {
+        cout << "    FAILED: integrated autocorrelation time of uncorrelated values is "
+             << uncorrelated.getIntegratedAutocorrelationTime() << ", expected 0.5" << endl;
+        passed = false;
+    }
+
+    correlated.reset();
+    if (correlated.getCount() != 0 || correlated.getAutocorrelation().size() != 0) {
+        cout << "    FAILED: autocorrelation estimator not empty after reset." << endl;
+        passed = false;
+    }
+
+    if (m_verbose) cout << "    Autocorrelation estimator test " << (passed ? "passed" : "failed") << endl;
+
+    return passed;
+}
+
+bool ObservableTests::testThermalizationDetector()
+{
+    bool passed = true;
+
+    const unsigned int window = 50;
+    std::mt19937_64 generator(4321);
+    std::normal_distribution<double> noise(0, 0.01);
+
+    // A plaquette relaxing from a hot start, with correlated noise
+    ThermalizationDetector detector(window, 2.0);
+    double x = 0;
+    unsigned int NThermalized = 0;
+    for (unsigned int i = 0; i < 2000; i++) {
+        x = 0.5 * x + noise(generator);
+        detector.push(0.6 - 0.5*exp(-double(i)/100.0) + x);
+
+        if (i + 1 < 2*window && detector.isThermalized()) {
+            cout << "    FAILED: thermalization detected before both windows are filled." << endl;
+            passed = false;
+        }
+        if (detector.isThermalized()) {
+            NThermalized = i + 1;
+            break;
+        }
+    }
+
+    // The relaxation has decayed to the size of the noise after about five relaxation times
+    if (NThermalized < 300 || NThermalized > 1000) {
+        cout << "    FAILED: thermalization detected after " << NThermalized << " values, expected between 300 and 1000." << endl;
+        passed = false;
+    }
+
+    // Restoring the values gives the same decision
+    ThermalizationDetector restored(window, 2.0);
+    restored.setValues(detector.getValues());
+    if (!restored.isThermalized() || restored.getDifference() != detector.getDifference()) {
+        cout << "    FAILED: thermalization detector with restored values differs." << endl;
+        passed = false;
+    }
+
+    if (m_verbose) cout << "    Thermalization detector test " << (passed ? "passed" : "failed") << endl;
+
+    return passed;
+}
+
+bool ObservableTests::testResampling()
+{
+    bool passed = true;
+
+    const unsigned long NSamples = 1000;
+    const unsigned long NBootstraps = 1000;
+    std::mt19937_64 generator(2468);
+    std::normal_distribution<double> noise(0, 1);
+
+    std::vector<double> samples(NSamples);
+    double mean = 0;
+    for (auto &sample : samples) {
+        sample = 1.0 + noise(generator);
+        mean += sample;
+    }
+    mean /= double(NSamples);
+    double variance = 0;
+    for (auto sample : samples) variance += (sample - mean)*(sample - mean);
+    variance /= double(NSamples - 1);
+    const double standardError = sqrt(variance / double(NSamples));
+
+    // The jackknife error of the mean is the standard error of the mean
+    Resampling resampling(samples, 1, 1);
+    std::vector<double> jackknifeMeans(resampling.getNumberOfBlocks());
+    for (unsigned long iBlock = 0; iBlock < resampling.getNumberOfBlocks(); iBlock++) {
+        jackknifeMeans[iBlock] = resampling.getJackknifeMean(iBlock)[0];
+    }
+    double jackknifeMean, jackknifeError;
+    Resampling::getJackknifeStatistics(jackknifeMeans, jackknifeMean, jackknifeError);
+    if (fabs(jackknifeMean - mean) > 1e-12 || fabs(jackknifeError - standardError) > 1e-12 * standardError) {
+        cout << "    FAILED: jackknife error of the mean " << jackknifeError << " differs from the standard error " << standardError << endl;
+        passed = false;
+    }
+
+    // The bootstrap error of the mean agrees with the standard error within the noise of the resampling
+    std::vector<double> bootstrapMeans(NBootstraps);
+    for (unsigned long iBoot = 0; iBoot < NBootstraps; iBoot++) {
+        bootstrapMeans[iBoot] = resampling.getBootstrapMean(iBoot, 1234)[0];
+    }
+    double bootstrapMean, bootstrapError;
+    Resampling::getBootstrapStatistics(bootstrapMeans, bootstrapMean, bootstrapError);
+    if (fabs(bootstrapError - standardError) > 0.1 * standardError || fabs(bootstrapMean - mean) > 4 * standardError / sqrt(double(NBootstraps))) {
+        cout << "    FAILED: bootstrap error of the mean " << bootstrapError << " differs from the standard error " << standardError << endl;
+        passed = false;
+    }
+    if (resampling.getBootstrapMean(7, 1234) != resampling.getBootstrapMean(7, 1234)) {
+        cout << "    FAILED: bootstrap resample is not given by its number and seed." << endl;
+        passed = false;
+    }
+
+    // Samples beyond the last complete block are left out
+    Resampling blocked(samples, 1, 300);
+    if (blocked.getNumberOfBlocks() != 3 || fabs(blocked.getJackknifeMean(0)[0]*600 - std::accumulate(samples.begin() + 300, samples.begin() + 900, 0.0)) > 1e-9) {
+        cout << "    FAILED: blocked resampling does not use the complete blocks." << endl;
+        passed = false;
+    }
+
+    if (m_verbose) cout << "    Resampling test " << (passed ? "passed" : "failed") << endl;
+
+    return passed;
+}
+
+bool ObservableTests::testFlowScales()
+{
+    bool passed = true;
+
+    // With t^2 E(t) = 0.1 t, both t d/dt (t^2 E) and t^2 E are 0.3 at t = 3
+    const double flowEpsilon = 0.01;
+    std::vector<double> energy(1001, 0);
+    for (unsigned long i = 1; i < energy.size(); i++) {
+        energy[i] = 0.1 / (double(i)*flowEpsilon);
+    }
+
+    const double t0 = FlowAnalysis::findT0(energy, flowEpsilon);
+    const double w0 = FlowAnalysis::findW0(energy, flowEpsilon);
+    if (fabs(t0 - 3.0) > 1e-10 || fabs(w0 - sqrt(3.0)) > 1e-10) {
+        cout << "    FAILED: t0 = " << t0 << " and w0 = " << w0 << ", expected 3 and " << sqrt(3.0) << endl;
+        passed = false;
+    }
+
+    // Scales beyond the largest flow time are not reached
+    energy.resize(200);
+    if (!std::isnan(FlowAnalysis::findT0(energy, flowEpsilon)) || !std::isnan(FlowAnalysis::findW0(energy, flowEpsilon))) {
+        cout << "    FAILED: scale found beyond the largest flow time." << endl;
+        passed = false;
+    }
+
+    if (fabs(FlowAnalysis::interpolate({0.0, 1.0, 4.0}, 0.15, 0.1) - 2.5) > 1e-12) {
+        cout << "    FAILED: interpolation between flow times." << endl;
+        passed = false;
+    }
+
+    if (m_verbose) cout << "    Flow scales test " << (passed ? "passed" : "failed") << endl;
+
+    return passed;
+}
+
+bool ObservableTests::testFlowSchedule()
+{
+    bool passed = true;
+
+    const unsigned int NFlows = 20;
+    const unsigned int NFlowsTemp = Parameters::getNFlows();
+    Parameters::setNFlows(NFlows);
+
+    FlowScheduleEntry entry;
+    entry.observable = "plaq";
+    entry.interval = 5;
+    entry.flowTimes = {0.07};
+
+    Plaquette plaquette(true);
+    FlowSchedule schedule(&plaquette, {entry}, NFlows, 0.01, 0.1);
+    ObservableStorer *observable = plaquette.getObservableStorer("plaq");
+
+    // Measures a linear function of the flow step at the steps scheduled
+    schedule.reset();
+    for (unsigned int iFlow = 0; iFlow <= NFlows; iFlow++) {
+        const bool due = schedule.schedule(iFlow);
+        const bool expected = iFlow % 5 == 0 || iFlow == 7;
+        if (due != expected || observable->isScheduled() != expected) {
+            cout << "    FAILED: flow step " << iFlow << " is " << (due ? "" : "not ") << "scheduled." << endl;
+            passed = false;
+        }
+        if (due) (*observable)[iFlow] = 2.0*double(iFlow) + 1.0;
+    }
+
+    // The skipped flow steps are marked as NaN, and are interpolated from the measured ones when t0 and w0 are found
+    schedule.markSkipped(NFlows);
+    for (unsigned int iFlow = 0; iFlow <= NFlows; iFlow++) {
+        const bool measured = iFlow % 5 == 0 || iFlow == 7;
+        if (measured != !std::isnan((*observable)[iFlow])) {
+            cout << "    FAILED: flow step " << iFlow << " is " << (*observable)[iFlow] << " after marking the skipped steps." << endl;
+            passed = false;
+        }
+    }
+    std::vector<double> filled = observable->getObservableArray();
+    FlowAnalysis::fillGaps(filled);
+    for (unsigned int iFlow = 0; iFlow <= NFlows; iFlow++) {
+        if (fabs(filled[iFlow] - (2.0*double(iFlow) + 1.0)) > 1e-12) {
+            cout << "    FAILED: skipped flow step " << iFlow << " interpolated to " << filled[iFlow] << endl;
+            passed = false;
+        }
+    }
+    if (!observable->isScheduled()) {
+        cout << "    FAILED: observable not scheduled after the flow." << endl;
+        passed = false;
+    }
+
+    Parameters::setNFlows(NFlowsTemp);
+
+    if (m_verbose) cout << "    Flow schedule test " << (passed ? "passed" : "failed") << endl;
+
+    return passed;
+}
+
+bool ObservableTests::testFlowScheduleStatistics()
+{
+    bool passed = true;
+
+    const unsigned int NFlows = 40;
+    const unsigned int NFlowsTemp = Parameters::getNFlows();
+    Parameters::setNFlows(NFlows);
+
+    // A sparse schedule, measuring only every tenth flow step
+    FlowScheduleEntry entry;
+    entry.observable = "plaq";
+    entry.interval = 10;
+
+    Plaquette plaquette(true);
+    FlowSchedule schedule(&plaquette, {entry}, NFlows, 0.01, 0.1);
+    ObservableStorer *observable = plaquette.getObservableStorer("plaq");
+
+    schedule.reset();
+    double sum = 0;
+    unsigned long NMeasured = 0;
+    for (unsigned int iFlow = 0; iFlow <= NFlows; iFlow++) {
+        if (schedule.schedule(iFlow)) {
+            (*observable)[iFlow] = 2.0*double(iFlow) + 1.0;
+            sum += (*observable)[iFlow];
+            NMeasured++;
+        }
+    }
+    schedule.markSkipped(NFlows);
+
+    // The statistics only include the flow steps measured, leaving out the NaN of the skipped ones
+    observable->runStatistics();
+    const StreamingStatistics &statistics = observable->getStatistics();
+    if (statistics.getCount() != NMeasured) {
+        cout << "    FAILED: statistics of " << statistics.getCount() << " flow steps, expected " << NMeasured << endl;
+        passed = false;
+    }
+    if (!std::isfinite(statistics.getMean()) || fabs(statistics.getMean() - sum/double(NMeasured)) > 1e-12) {
+        cout << "    FAILED: mean " << statistics.getMean() << " of the scheduled flow steps is not " << sum/double(NMeasured) << endl;
+        passed = false;
+    }
+    if (!std::isfinite(statistics.getVariance()) || !std::isfinite(statistics.getBinnedStandardError())) {
+        cout << "    FAILED: variance or binned error of the scheduled flow steps is not finite." << endl;
+        passed = false;
+    }
+
+    Parameters::setNFlows(NFlowsTemp);
+
+    if (m_verbose) cout << "    Flow schedule statistics test " << (passed ? "passed" : "failed") << endl;
+
+    return passed;
+}
+
 // Observable tests
 bool ObservableTests::runObservableTests()
 {
@@ -23,7 +396,8 @@ bool ObservableTests::runObservableTests()
     if (m_processRank == 0) {
         if (m_verbose) cout << "Running observables tests." << endl;
 
-        passed = testTopCharge();
+        passed = testTopCharge() && testStreamingStatistics() && testAutocorrelationEstimator() && testThermalizationDetector()
+                && testResampling() && testFlowScales() && testFlowSchedule() && testFlowScheduleStatistics();
 
         if (passed) {
             cout << "PASSED: observable tests." << endl;
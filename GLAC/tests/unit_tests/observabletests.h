@@ -8,6 +8,15 @@ class ObservableTests : public TestCore
 private:
     // Tests for observables
     bool testTopCharge();
+
+    // Tests for observable statistics
+    bool testStreamingStatistics();
+    bool testAutocorrelationEstimator();
+    bool testThermalizationDetector();
+    bool testResampling();
+    bool testFlowScales();
+    bool testFlowSchedule();
+    bool testFlowScheduleStatistics();
 public:
     ObservableTests();
 
@@ -126,6 +126,29 @@ def natural_sort(l):
     alphanum_key = lambda key: [convert(c) for c in re.split(r'(\d+)', key)]
     return sorted(l, key=alphanum_key)
 
+def parse_flow_schedule(schedule_args):
+    """
+    Parses the flow schedule given on the command line.
+
+    Args:
+        schedule_args: list of strings on the format observable:interval or
+            observable:interval:adaptive.
+
+    Returns:
+        A dictionary of the schedule of each observable.
+    """
+
+    schedule = {}
+    for arg in schedule_args:
+        fields = arg.split(":")
+        if len(fields) < 2 or not fields[1].isdigit() or \
+                (len(fields) == 3 and fields[2] != "adaptive") or len(fields) > 3:
+            sys.exit("ERROR: flow schedule %s is not on the format observable:interval[:adaptive]." % arg)
+        schedule[fields[0]] = {"interval": int(fields[1])}
+        if len(fields) == 3:
+            schedule[fields[0]]["adaptive"] = True
+    return schedule
+
 class JobCreator:
     """Class for initializing jobs."""
 
@@ -159,47 +182,70 @@ class JobCreator:
 
         # Checking that we have an output folder.
         self._checkFolderPath(self.outputFolder)
-        self._checkFolderPath(os.path.join(self.outputFolder, self.runName))
+
+        # An ensemble of chains writes each chain to its own batch.
+        if self.NChains > 1:
+            for i in range(self.NChains):
+                self._create_run_folders("%s_chain%d" % (self.runName, i))
+        else:
+            self._create_run_folders(self.runName)
+
+        self._checkFolderPath(os.path.join(self.inputFolder))
+        self._checkFolderPath(os.path.join("input", self.runName))
+
+    def _create_run_folders(self, run_name):
+        """Sets up the output folders of a single batch.
+
+        Args:
+            run_name: name of the batch.
+        """
+
+        self._checkFolderPath(os.path.join(self.outputFolder, run_name))
 
         if not self.load_field_configs and not self.create_fields_folders:
-            self._checkFolderPath(os.path.join(self.outputFolder, self.runName, "field_configurations"))
+            self._checkFolderPath(os.path.join(self.outputFolder, run_name, "field_configurations"))
             if not self.uTest:
-                self._checkFolderPath(os.path.join(self.outputFolder, self.runName, "observables"))
+                self._checkFolderPath(os.path.join(self.outputFolder, run_name, "observables"))
 
             if self.uTest or (self.NFlows != 0 and self.create_fields_folders):
-                self._checkFolderPath(os.path.join(self.outputFolder, self.runName, "scalar_fields"))
+                self._checkFolderPath(os.path.join(self.outputFolder, run_name, "scalar_fields"))
 
                 if self.uTest:
-                    self._checkFolderPath(os.path.join(self.outputFolder, self.runName, "scalar_fields", "ioDoublesIOTest"))
+                    self._checkFolderPath(os.path.join(self.outputFolder, run_name, "scalar_fields", "ioDoublesIOTest"))
+                    self._checkFolderPath(os.path.join(self.outputFolder, run_name, "flow_observables"))
+                    self._checkFolderPath(os.path.join(self.outputFolder, run_name, "flow_observables", "ioObservablesContainerTest"))
+                    self._checkFolderPath(os.path.join(self.outputFolder, run_name, "flow_observables", "ioContainerRestoreTest"))
+                    self._checkFolderPath(os.path.join(self.outputFolder, run_name, "flow_observables", "ioContainerRestoreTestAfter"))
+                    self._checkFolderPath(os.path.join(self.outputFolder, run_name, "observables"))
 
 
+        # Loaded configurations that are not flowed only have their observables measured.
+        if self.load_field_configs and self.NFlows == 0:
+            self._checkFolderPath(os.path.join(self.outputFolder, run_name, "observables"))
+
         if not self.uTest:
 
             if self.NFlows != 0:
 
                 # Only in the case we are not creating any scalar fields
                 if not self.create_fields_folders:
-                    self._checkFolderPath(os.path.join(self.outputFolder, self.runName, "flow_observables"))
+                    self._checkFolderPath(os.path.join(self.outputFolder, run_name, "flow_observables"))
 
-                if not os.path.isdir(os.path.join(self.outputFolder, self.runName, "scalar_fields")) and self.create_fields_folders:
-                    self._checkFolderPath(os.path.join(self.outputFolder, self.runName, "scalar_fields"))
+                if not os.path.isdir(os.path.join(self.outputFolder, run_name, "scalar_fields")) and self.create_fields_folders:
+                    self._checkFolderPath(os.path.join(self.outputFolder, run_name, "scalar_fields"))
 
                 for fobs in self.flow_observables:
 
                     # Only in the case we are not creating any scalar fields
                     if not self.create_fields_folders:
-                        self._checkFolderPath(os.path.join(self.outputFolder, self.runName, "flow_observables", fobs))
+                        self._checkFolderPath(os.path.join(self.outputFolder, run_name, "flow_observables", fobs))
 
                     # The name of the observable for the scalar fields is different than the default names.
                     if self.create_fields_folders and fobs in AVAILABLE_SCALAR_FIELDS:
                         if "topc" in fobs.lower():
-                            self._checkFolderPath(os.path.join(self.outputFolder, self.runName, "scalar_fields", "topc"))
+                            self._checkFolderPath(os.path.join(self.outputFolder, run_name, "scalar_fields", "topc"))
                         if "energy" in fobs.lower():
-                            self._checkFolderPath(os.path.join(self.outputFolder, self.runName, "scalar_fields", "energy"))
-
-
-        self._checkFolderPath(os.path.join(self.inputFolder))
-        self._checkFolderPath(os.path.join("input", self.runName))
+                            self._checkFolderPath(os.path.join(self.outputFolder, run_name, "scalar_fields", "energy"))
 
 
     def _checkFolderPath(self, folder):
@@ -269,6 +315,12 @@ class JobCreator:
         json_dict["NSpatial"] = config_dict["N"]
         json_dict["NTemporal"] = config_dict["NT"]
         json_dict["subDims"] = config_dict["subDims"] # Will have to check for this being false
+        json_dict["cartesianTopology"] = config_dict["cartesianTopology"]
+        json_dict["sharedMemoryHalo"] = config_dict["sharedMemoryHalo"]
+        json_dict["oneSidedMetropolis"] = config_dict["oneSidedMetropolis"]
+        json_dict["siteOrdering"] = config_dict["siteOrdering"]
+        json_dict["NChains"] = config_dict["NChains"]
+        json_dict["NFlowGroups"] = config_dict["NFlowGroups"]
         json_dict["beta"] = config_dict["beta"]
         json_dict["NCf"] = config_dict["NCf"]
         json_dict["NCor"] = config_dict["NCor"]
@@ -280,6 +332,7 @@ class JobCreator:
         json_dict["outputFolder"] = self._clean_file_path(config_dict["outputFolder"])
         json_dict["inputFolder"] = self._clean_file_path(config_dict["inputFolder"])
         json_dict["storeConfigurations"] = config_dict["storeCfgs"]
+        json_dict["fieldConfigurationHeader"] = config_dict["fieldConfigurationHeader"]
         json_dict["storeThermalizationObservables"] = config_dict["storeThermCfgs"]
 
         json_dict["load_config_and_run"] = config_dict["load_config_and_run"]
@@ -312,6 +365,10 @@ class JobCreator:
         json_dict["NRandTests"] = config_dict["NRandTests"]
         json_dict["NDerivativeTests"] = config_dict["NDerivativeTests"]
         json_dict["TaylorPolDegree"] = config_dict["TaylorPolDegree"]
+        json_dict["benchmarking"] = config_dict["benchmarking"]
+        json_dict["benchmarkSubLatticeSizes"] = config_dict["benchmarkSubLatticeSizes"]
+        json_dict["benchmarkRepetitions"] = config_dict["benchmarkRepetitions"]
+        json_dict["benchmarkWarmup"] = config_dict["benchmarkWarmup"]
 
         # Data generation related variables
         json_dict["SU3Eps"] = config_dict["SU3Eps"]
@@ -319,6 +376,45 @@ class JobCreator:
         json_dict["metropolisSeed"] = config_dict["metropolisSeed"]
         json_dict["randomMatrixSeed"] = config_dict["randomMatrixSeed"]
         json_dict["samplingFrequency"] = config_dict["samplingFrequency"]
+        json_dict["binaryFlowObservables"] = config_dict["binaryFlowObservables"]
+        json_dict["flowObservablesBatchSize"] = config_dict["flowObservablesBatchSize"]
+        json_dict["compressFieldDensities"] = config_dict["compressFieldDensities"]
+        json_dict["fieldDensityQuantizationBits"] = config_dict["fieldDensityQuantizationBits"]
+
+        # Checkpointing of the Markov chain
+        json_dict["checkpointInterval"] = config_dict["checkpointInterval"]
+        json_dict["restartFromCheckpoint"] = config_dict["restartFromCheckpoint"]
+        json_dict["autoResume"] = config_dict["autoResume"]
+
+        # Scaling benchmark
+        json_dict["scalingBenchmark"] = config_dict["scalingBenchmark"]
+        json_dict["scalingBenchmarkSweeps"] = config_dict["scalingBenchmarkSweeps"]
+
+        # Adaptive number of updates between configurations
+        json_dict["adaptiveNCor"] = config_dict["adaptiveNCor"]
+        json_dict["adaptiveNCorTarget"] = config_dict["adaptiveNCorTarget"]
+        json_dict["adaptiveNCorInterval"] = config_dict["adaptiveNCorInterval"]
+        json_dict["adaptiveNCorMax"] = config_dict["adaptiveNCorMax"]
+
+        # Automatic end of the thermalization
+        json_dict["autoThermalization"] = config_dict["autoThermalization"]
+        json_dict["NThermMin"] = config_dict["NThermMin"]
+        json_dict["thermalizationWindow"] = config_dict["thermalizationWindow"]
+        json_dict["thermalizationInterval"] = config_dict["thermalizationInterval"]
+        json_dict["thermalizationTolerance"] = config_dict["thermalizationTolerance"]
+
+        # Resampling analysis of the flow observables
+        json_dict["flowAnalysis"] = config_dict["flowAnalysis"]
+        json_dict["NBootstraps"] = config_dict["NBootstraps"]
+        json_dict["resamplingBlockSize"] = config_dict["resamplingBlockSize"]
+
+        # Measurement schedule of the flow observables
+        json_dict["flowSchedule"] = config_dict["flowSchedule"]
+        json_dict["flowScheduleAdaptiveWidth"] = config_dict["flowScheduleAdaptiveWidth"]
+
+        # Scale setting with early termination of the flow
+        json_dict["scaleSetting"] = config_dict["scaleSetting"]
+        json_dict["scaleSettingMargin"] = config_dict["scaleSettingMargin"]
 
         # Debugger
         json_dict["debug"] = config_dict["debug"]
@@ -376,6 +472,7 @@ class JobCreator:
         NUpdates                = job_config["NUpdates"]
         SU3Eps                  = job_config["SU3Eps"]
         self.flow_observables   = job_config["flowObservables"]
+        self.NChains            = job_config["NChains"]
         self.inputFolder        = job_config["inputFolder"]
         self.outputFolder       = job_config["outputFolder"]
         self.observables        = job_config["observables"]
@@ -459,6 +556,9 @@ class JobCreator:
             content += "\n#SBATCH --ntasks={0:<d}".format(threads)
             content += "\n#SBATCH --nodes={0:<1d}".format(nodes)
             content += "\n#SBATCH --mail-type=BEGIN,TIME_LIMIT_10,END"
+            if job_config.get("autoResume", False):
+                # Puts the job back in the queue if its node fails
+                content += "\n#SBATCH --requeue"
             content += "\n" + sbatch_exclusions + "\n"
             content += "\nsource /cluster/bin/jobsetup\n"
             content += "\nmodule purge                # clear any inherited modules"
@@ -510,7 +610,14 @@ class JobCreator:
         run_command += " "
         run_command += os.path.join(self.base_folder, "input", self.json_file_name)
 
-        content += "\n" + run_command
+        if job_config.get("autoResume", False):
+            # A failed run is started again, resuming from its last checkpoint
+            resume_attempts = 3
+            content += "\nfor attempt in $(seq 1 {0:<d}); do".format(resume_attempts)
+            content += "\n    " + run_command + " && break"
+            content += "\ndone"
+        else:
+            content += "\n" + run_command
 
         if system == "slurm":
             job = 'jobfile.slurm'
@@ -707,6 +814,12 @@ def main(args):
         "N"                         : 8, # Small lattice as default
         "NT"                        : 16,
         "subDims"                   : [],
+        "cartesianTopology"         : False, # Places the process grid on the nodes with a Cartesian communicator
+        "sharedMemoryHalo"          : False, # Exchanges the halos within a node through shared memory
+        "oneSidedMetropolis"        : False, # Checkerboard Metropolis sweep with the boundary links fetched one-sided
+        "siteOrdering"              : "lexicographic", # Order the sites of the sub-lattice are stored in
+        "NChains"                   : 1, # Number of independent Markov chains the processors are split between
+        "NFlowGroups"               : 1, # Number of processor groups the loaded configurations are flowed by
         "beta"                      : 6.0,
         "NCf"                       : 100,
         "NCor"                      : 20,
@@ -714,6 +827,7 @@ def main(args):
         "NFlows"                    : 0,
         "NUpdates"                  : 10,
         "storeCfgs"                 : True,
+        "fieldConfigurationHeader"  : False, # Writes a FieldHeader before the links of each configuration
         "storeThermCfgs"            : False,
         "verboseRun"                : False,
         "hotStart"                  : False,
@@ -738,6 +852,10 @@ def main(args):
         "NRandTests"                : int(1e6),
         "NDerivativeTests"          : int(1e2),
         "TaylorPolDegree"           : 8,
+        "benchmarking"              : False,
+        "benchmarkSubLatticeSizes"  : [4, 8], # Sub lattice extent per processor, L^4 sites
+        "benchmarkRepetitions"      : 10,
+        "benchmarkWarmup"           : 2,
         "SU3Eps"                    : 0.24,
         "flowEpsilon"               : 0.01,
         "metropolisSeed"            : 0,
@@ -745,6 +863,31 @@ def main(args):
         "threads"                   : 64,
         "scalar_fields_folders"     : False,
         "samplingFrequency"         : 25,
+        "binaryFlowObservables"     : False,
+        "flowObservablesBatchSize"  : 10,
+        "compressFieldDensities"    : False,
+        "fieldDensityQuantizationBits": 12, # 0 gives lossless compression
+        "checkpointInterval"        : 0, # Minutes of wall time between checkpoints, 0 disables checkpointing
+        "restartFromCheckpoint"     : False,
+        "autoResume"                : False, # Resumes from the last checkpoint of the run if there is one, and requeues failed jobs
+        "scalingBenchmark"          : False, # Times sweeps and flow steps per processor, split into compute, communication and I/O
+        "scalingBenchmarkSweeps"    : 10,
+        "adaptiveNCor"              : False, # Adapts NCor to the integrated autocorrelation time of the plaquette and topological charge
+        "adaptiveNCorTarget"        : 1.0, # Integrated autocorrelation time in units of configurations
+        "adaptiveNCorInterval"      : 100, # Configurations between each adjustment of NCor
+        "adaptiveNCorMax"           : 1000,
+        "autoThermalization"        : False, # Ends the thermalization once the plaquette has stabilized, between NThermMin and NTherm updates
+        "NThermMin"                 : 0,
+        "thermalizationWindow"      : 50, # Updates in each of the two plaquette windows compared
+        "thermalizationInterval"    : 5, # Updates between each plaquette measurement of the thermalization windows
+        "thermalizationTolerance"   : 2.0, # Standard errors the window means may differ by
+        "flowAnalysis"              : False, # Jackknife and bootstrap estimates of t0, w0 and chi_t at the end of the run
+        "NBootstraps"               : 500,
+        "resamplingBlockSize"       : 1, # Configurations in each block of the resampling
+        "flowSchedule"              : {}, # E.g. {"topc": {"interval": 10, "flowTimes": [1.0, 2.0]}, "energy": {"interval": 10, "adaptive": True}}
+        "flowScheduleAdaptiveWidth" : 0.15, # Distance in t^2 E from 0.3 where adaptive observables are measured at every flow step
+        "scaleSetting"              : False, # Ends the flow once t0 and w0 are passed, and writes them for each configuration
+        "scaleSettingMargin"        : 0.05, # Amount t^2 E and t d/dt(t^2 E) must exceed 0.3 by before the flow is ended
         "debug"                     : False,
         "cpu_approx_runtime_hr"     : 2, # In order to catch if config we are loading contains cpu approx time
         "cpu_approx_runtime_min"    : 0,
@@ -787,6 +930,12 @@ def main(args):
     job_parser.add_argument('-N', '--NSpatial',                 default=config_default["N"],                        type=int, help='spatial lattice dimension')
     job_parser.add_argument('-NT', '--NTemporal',               default=config_default["NT"],                       type=int, help='temporal lattice dimension')
     job_parser.add_argument('-sd', '--subDims',                 default=False,                                      type=int, nargs=4, help='List of sub lattice dimension sizes, length 4')
+    job_parser.add_argument('-nch', '--NChains',                default=config_default["NChains"],                  type=int, help='Number of independent Markov chains to run in one job. The threads are split evenly between the chains, each writing to the batch <run name>_chain<i>.')
+    job_parser.add_argument('-nfg', '--NFlowGroups',            default=config_default["NFlowGroups"],              type=int, help='Number of processor groups flowing the loaded configurations(-lcfg), each taking the next configuration once done with the previous. The threads are split evenly between the groups.')
+    job_parser.add_argument('-cart', '--cartesianTopology',     default=config_default["cartesianTopology"],        action='store_true', help='Places the process grid on the nodes with a Cartesian communicator, keeping the halo exchanges across the largest faces within a node.')
+    job_parser.add_argument('-osm', '--oneSidedMetropolis',     default=config_default["oneSidedMetropolis"],       action='store_true', help='Sweeps the lattice in checkerboard order, fetching the links of neighbouring processors with one-sided MPI_Get before each phase rather than link by link.')
+    job_parser.add_argument('-shm', '--sharedMemoryHalo',       default=config_default["sharedMemoryHalo"],         action='store_true', help='Exchanges the lattice faces between processors on the same node through an MPI-3 shared memory window instead of messages.')
+    job_parser.add_argument('-so', '--siteOrdering',            default=config_default["siteOrdering"],             type=str, choices=["lexicographic","blocked","morton"], help='Order the sites of the sub-lattice are stored in. Blocked and morton keep the neighbours in all directions close in memory.')
     job_parser.add_argument('-b', '--beta',                     default=config_default["beta"],                     type=float, help='beta value')
     job_parser.add_argument('-NCfgs', '-Ncfg', '-NCf', '--NConfigs', default=config_default["NCf"],                      type=int, help='number of configurations to generate')
     job_parser.add_argument('-NCor', '-NCorr', '--NCor',        default=config_default["NCor"],                     type=int, help='number of correlation updates to perform')
@@ -796,6 +945,7 @@ def main(args):
 
     # Data storage related variables
     job_parser.add_argument('-sc', '--storeCfgs',               default=config_default["storeCfgs"],                type=int, choices=[0,1], help='Specifying if we are to store configurations')
+    job_parser.add_argument('-fch', '--fieldConfigurationHeader', default=config_default["fieldConfigurationHeader"], action='store_true', help='Writes the configurations with a header holding the lattice dimensions, beta, plaquette and checksums.')
     job_parser.add_argument('-st', '--storeThermCfgs',          default=config_default["storeThermCfgs"],           type=int, choices=[0,1], help='Specifies if we are to store the thermalization plaquettes')
     job_parser.add_argument('-bf', '--base_folder',             default=config_default["base_folder"],              type=str, help='Sets the base folder. Default is os.path.getcwd().') # Human readable output related variables
     job_parser.add_argument('-vr', '--verboseRun',              default=config_default["verboseRun"],               action='store_true', help='Verbose run of GLAC. By default, it is off.')
@@ -811,8 +961,30 @@ def main(args):
     # Data generation related variables
     job_parser.add_argument('-SU3Eps', '--SU3Epsilon',          default=config_default["SU3Eps"],                   type=float, help='SU3 epsilon random increment value.')
     job_parser.add_argument('-fEps', '--flowEpsilon',           default=config_default["flowEpsilon"],              type=float, help='Flow epsilon derivative small change value.')
+    job_parser.add_argument('-bfobs', '--binaryFlowObservables', default=config_default["binaryFlowObservables"],   action='store_true', help='Appends the flow observables of all configurations to a single binary file per observable, instead of a text file per configuration.')
+    job_parser.add_argument('-fobsbs', '--flowObservablesBatchSize', default=config_default["flowObservablesBatchSize"], type=int, help='Number of configurations buffered before the binary flow observables are appended to file.')
     job_parser.add_argument('-mSeed', '--metropolisSeed',       default=config_default["metropolisSeed"],           type=float, help='Seed for the Metropolis algorithm.')
     job_parser.add_argument('-rSeed', '--randomMatrixSeed',     default=config_default["randomMatrixSeed"],         type=float, help='Seed for the random matrix generation.')
+    job_parser.add_argument('-sbench', '--scalingBenchmark',    default=config_default["scalingBenchmark"],         action='store_true', help='Runs a scaling benchmark of -sbsweeps sweeps and NFlows flow steps, and writes the compute, halo exchange, reduction and I/O time of each processor as JSON.')
+    job_parser.add_argument('-sbsweeps', '--scalingBenchmarkSweeps', default=config_default["scalingBenchmarkSweeps"], type=int, help='Number of Metropolis sweeps to time in the scaling benchmark.')
+    job_parser.add_argument('-chkp', '--checkpointInterval',    default=config_default["checkpointInterval"],       type=float, help='Minutes of wall time between each checkpoint of the Markov chain. Default is 0, which disables checkpointing.')
+    job_parser.add_argument('-ar', '--autoResume',              default=config_default["autoResume"],               action='store_true', help='Resumes the run from its last intact checkpoint if there is one, and runs the job again if it fails. Requires -chkp.')
+    job_parser.add_argument('-ancor', '--adaptiveNCor',         default=config_default["adaptiveNCor"],             action='store_true', help='Adapts NCor during the run, such that the integrated autocorrelation time of the plaquette and topological charge approaches -ancortarget configurations.')
+    job_parser.add_argument('-ancortarget', '--adaptiveNCorTarget', default=config_default["adaptiveNCorTarget"],   type=float, help='Target integrated autocorrelation time in units of configurations. Must be larger than 0.5.')
+    job_parser.add_argument('-ancorint', '--adaptiveNCorInterval', default=config_default["adaptiveNCorInterval"],  type=int, help='Number of configurations between each adjustment of NCor.')
+    job_parser.add_argument('-ancormax', '--adaptiveNCorMax',   default=config_default["adaptiveNCorMax"],          type=int, help='Largest NCor allowed when adapting.')
+    job_parser.add_argument('-athm', '--autoThermalization',    default=config_default["autoThermalization"],       action='store_true', help='Ends the thermalization once the mean plaquette of the two most recent windows of -thmwin updates agree, after at least -NThMin and at most NTherm updates.')
+    job_parser.add_argument('-NThMin', '--NThermMin',           default=config_default["NThermMin"],                type=int, help='Minimum number of thermalization updates when ending the thermalization automatically.')
+    job_parser.add_argument('-thmwin', '--thermalizationWindow', default=config_default["thermalizationWindow"],    type=int, help='Number of updates in each window of plaquettes compared when ending the thermalization automatically.')
+    job_parser.add_argument('-thmint', '--thermalizationInterval', default=config_default["thermalizationInterval"], type=int, help='Number of updates between each plaquette measurement when ending the thermalization automatically. The window must hold at least 10 measurements.')
+    job_parser.add_argument('-thmtol', '--thermalizationTolerance', default=config_default["thermalizationTolerance"], type=float, help='Number of standard errors the mean plaquette of the two windows may differ by.')
+    job_parser.add_argument('-fa', '--flowAnalysis',            default=config_default["flowAnalysis"],             action='store_true', help='Estimates t0, w0 and the topological susceptibility with jackknife and bootstrap errors from the flow observables at the end of the run.')
+    job_parser.add_argument('-nboot', '--NBootstraps',          default=config_default["NBootstraps"],              type=int, help='Number of bootstrap resamples in the flow analysis.')
+    job_parser.add_argument('-rbs', '--resamplingBlockSize',    default=config_default["resamplingBlockSize"],      type=int, help='Number of consecutive configurations in each block of the flow analysis resampling.')
+    job_parser.add_argument('-fsch', '--flowSchedule',          default=None,                                       type=str, nargs='+', help='Measurement schedule of flow observables, given as observable:interval or observable:interval:adaptive, e.g. topc:10 energy:10:adaptive. Observables not given are measured at every flow step. Skipped flow times are written as NaN.')
+    job_parser.add_argument('-fschw', '--flowScheduleAdaptiveWidth', default=config_default["flowScheduleAdaptiveWidth"], type=float, help='Distance in t^2 E from 0.3 within which adaptive flow observables are measured at every flow step.')
+    job_parser.add_argument('-scale', '--scaleSetting',         default=config_default["scaleSetting"],             action='store_true', help='Ends the flow of each configuration once t0 and w0 have been passed, and writes them for each configuration. NFlows is then the largest number of flow steps.')
+    job_parser.add_argument('-scalem', '--scaleSettingMargin',  default=config_default["scaleSettingMargin"],       type=float, help='Amount t^2 E and t d/dt(t^2 E) must exceed 0.3 by before the flow is ended.')
 
     # Other usefull parsing options
     job_parser.add_argument('-sq', '--square',                  default=False,                                      action='store_true', help='Enforce square sub lattices(or as close as possible).')
@@ -855,6 +1027,22 @@ def main(args):
     load_parser.add_argument('-vr', '--verboseRun',             default=config_default["verboseRun"],              action='store_true', help='Verbose run of GLAC. By default, it is off.')
     load_parser.add_argument('-igntsk', '--ignore_tasks_per_node', default=False,                                   action='store_true', help='If enabled, will ignore requirement of having 16 tasks per node.')
     load_parser.add_argument('--account_name',                   default=config_default["account_name"],             type=str, help='Account name associated to the abel cluster')
+    load_parser.add_argument('-chkp', '--checkpointInterval',   default=None,                                       type=float, help='Minutes of wall time between each checkpoint of the Markov chain.')
+    load_parser.add_argument('-sbench', '--scalingBenchmark',   default=False,                                      action='store_true', help='Runs a scaling benchmark of the loaded run instead, timing -sbsweeps sweeps and NFlows flow steps.')
+    load_parser.add_argument('-sbsweeps', '--scalingBenchmarkSweeps', default=None,                                 type=int, help='Number of Metropolis sweeps to time in the scaling benchmark.')
+    load_parser.add_argument('-fa', '--flowAnalysis',           default=False,                                      action='store_true', help='Estimates t0, w0 and the topological susceptibility with jackknife and bootstrap errors from the flow observables at the end of the run.')
+    load_parser.add_argument('-nboot', '--NBootstraps',         default=None,                                       type=int, help='Number of bootstrap resamples in the flow analysis.')
+    load_parser.add_argument('-rbs', '--resamplingBlockSize',   default=None,                                       type=int, help='Number of consecutive configurations in each block of the flow analysis resampling.')
+    load_parser.add_argument('-fsch', '--flowSchedule',         default=None,                                       type=str, nargs='+', help='Measurement schedule of flow observables, given as observable:interval or observable:interval:adaptive.')
+    load_parser.add_argument('-fschw', '--flowScheduleAdaptiveWidth', default=None,                                 type=float, help='Distance in t^2 E from 0.3 within which adaptive flow observables are measured at every flow step.')
+    load_parser.add_argument('-scale', '--scaleSetting',        default=False,                                      action='store_true', help='Ends the flow of each configuration once t0 and w0 have been passed, and writes them for each configuration.')
+    load_parser.add_argument('-scalem', '--scaleSettingMargin', default=None,                                       type=float, help='Amount t^2 E and t d/dt(t^2 E) must exceed 0.3 by before the flow is ended.')
+    load_parser.add_argument('-nfg', '--NFlowGroups',           default=None,                                       type=int, help='Number of processor groups flowing the loaded configurations(-lcfg), each taking the next configuration once done with the previous.')
+    load_parser.add_argument('-cart', '--cartesianTopology',   default=False,                                      action='store_true', help='Places the process grid on the nodes with a Cartesian communicator, keeping the halo exchanges across the largest faces within a node.')
+    load_parser.add_argument('-shm', '--sharedMemoryHalo',     default=False,                                      action='store_true', help='Exchanges the lattice faces between processors on the same node through an MPI-3 shared memory window instead of messages.')
+    load_parser.add_argument('-so', '--siteOrdering',          default=None,                                       type=str, choices=["lexicographic","blocked","morton"], help='Order the sites of the sub-lattice are stored in. Blocked and morton keep the neighbours in all directions close in memory.')
+    load_parser.add_argument('-rst', '--restart',               default=False,                                      action='store_true', help='Restarts the run from its last checkpoint. The run name, lattice and run parameters must be the same as for the checkpointed run.')
+    load_parser.add_argument('-ar', '--autoResume',             default=False,                                      action='store_true', help='Resumes the run from its last intact checkpoint if there is one, and runs the job again if it fails. Requires a checkpoint interval.')
 
     ######## Unit test parser ########
     unit_test_parser = subparser.add_parser('utest', help='Runs unit tests embedded in the GLAC program. Will exit when complete.')
@@ -876,6 +1064,10 @@ def main(args):
     performance_test_parser.add_argument('-NRandTests',         default=config_default["NRandTests"],               type=int, help='Number of random tests we will run.')
     performance_test_parser.add_argument('-NDerivativeTests',   default=config_default["NDerivativeTests"],         type=int, help='Number of full lattice derivative tests we will run.')
     performance_test_parser.add_argument('-TaylorPolDegree',    default=config_default["TaylorPolDegree"],          type=int, help='Degree of the Taylor polynomial for exponentiation(default is 8).')
+    performance_test_parser.add_argument('-bench', '--benchmark', default=False,                                      action='store_true', help='If toggled, will run the component benchmark suite instead of the performance tests.')
+    performance_test_parser.add_argument('-bsizes', '--benchmarkSubLatticeSizes', default=config_default["benchmarkSubLatticeSizes"], type=int, nargs='+', help='Sub lattice extents L per processor to benchmark, each giving L^4 sites.')
+    performance_test_parser.add_argument('-brep', '--benchmarkRepetitions', default=config_default["benchmarkRepetitions"], type=int, help='Number of timed repetitions of each benchmark.')
+    performance_test_parser.add_argument('-bwarm', '--benchmarkWarmup', default=config_default["benchmarkWarmup"],   type=int, help='Number of untimed warm-up runs of each benchmark.')
     performance_test_parser.add_argument('-ex', '--exclude',    default=False,                                      type=str, nargs='+', help='Nodes to exclude.')
     performance_test_parser.add_argument('-igntsk', '--ignore_tasks_per_node', default=False,                       action='store_true', help='If enabled, will ignore requirement of having 16 tasks per node.')
 
@@ -906,6 +1098,8 @@ def main(args):
     # Data storage related variables
     field_density_parser.add_argument('-bf', '--base_folder',  default=config_default["base_folder"],              type=str, help='Sets the base folder. Default is os.path.getcwd().')
     field_density_parser.add_argument('-sf', '--samplingFrequency', default=config_default["samplingFrequency"],   type=int, help='Sets the sampling frequency of the flow. Lattice to be written to file every given number.')
+    field_density_parser.add_argument('-cfd', '--compressFieldDensities', default=config_default["compressFieldDensities"], action='store_true', help='Writes the field densities in compressed .cbin files.')
+    field_density_parser.add_argument('-qb', '--fieldDensityQuantizationBits', default=config_default["fieldDensityQuantizationBits"], type=int, help='Number of bits the compressed field densities are quantized to, relative to the largest value of each block. 0 gives lossless compression.')
     field_density_parser.add_argument('-vr', '--verboseRun',   default=config_default["verboseRun"],               action='store_true', help='Verbose run of GLAC. By default, it is off.')
     
     # Debug variables
@@ -994,6 +1188,42 @@ def main(args):
             configuration["flowObservables"] = []
         if args.debug != False:
             configuration["debug"] = args.debug
+        if args.checkpointInterval != None:
+            configuration["checkpointInterval"] = args.checkpointInterval
+        if args.scalingBenchmark:
+            configuration["scalingBenchmark"] = True
+        if args.scalingBenchmarkSweeps != None:
+            configuration["scalingBenchmarkSweeps"] = args.scalingBenchmarkSweeps
+        if args.flowAnalysis:
+            configuration["flowAnalysis"] = True
+        if args.NBootstraps != None:
+            configuration["NBootstraps"] = args.NBootstraps
+        if args.resamplingBlockSize != None:
+            configuration["resamplingBlockSize"] = args.resamplingBlockSize
+        if args.flowSchedule != None:
+            configuration["flowSchedule"] = parse_flow_schedule(args.flowSchedule)
+        if args.flowScheduleAdaptiveWidth != None:
+            configuration["flowScheduleAdaptiveWidth"] = args.flowScheduleAdaptiveWidth
+        if args.scaleSetting:
+            configuration["scaleSetting"] = True
+        if args.scaleSettingMargin != None:
+            configuration["scaleSettingMargin"] = args.scaleSettingMargin
+        if args.cartesianTopology:
+            configuration["cartesianTopology"] = True
+        if args.sharedMemoryHalo:
+            configuration["sharedMemoryHalo"] = True
+        if args.siteOrdering != None:
+            configuration["siteOrdering"] = args.siteOrdering
+        if args.NFlowGroups != None:
+            configuration["NFlowGroups"] = args.NFlowGroups
+        if args.restart:
+            if args.load_configurations:
+                sys.exit("ERROR: can not restart from a checkpoint(-rst) together with load configurations(-lcfg).")
+            configuration["restartFromCheckpoint"] = True
+        if args.autoResume:
+            if args.load_configurations:
+                sys.exit("ERROR: can not resume automatically(-ar) together with load configurations(-lcfg).")
+            configuration["autoResume"] = True
         for key in list(config_default.keys()):
             if not key in configuration:
                 configuration[key] = config_default[key]
@@ -1026,6 +1256,7 @@ def main(args):
         config_default["NFlows"]                    = args.NFlows
         config_default["NUpdates"]                  = args.NUpdates
         config_default["storeCfgs"]                 = bool(args.storeCfgs)
+        config_default["fieldConfigurationHeader"]  = args.fieldConfigurationHeader
         config_default["storeThermCfgs"]            = bool(args.storeThermCfgs)
         config_default["verboseRun"]                = args.verboseRun
         config_default["hotStart"]                  = bool(args.hotStart)
@@ -1036,8 +1267,39 @@ def main(args):
         config_default["flowObservables"]           = args.flowObservables
         config_default["SU3Eps"]                    = args.SU3Epsilon
         config_default["flowEpsilon"]               = args.flowEpsilon
+        config_default["binaryFlowObservables"]     = args.binaryFlowObservables
+        config_default["flowObservablesBatchSize"]  = args.flowObservablesBatchSize
         config_default["metropolisSeed"]            = args.metropolisSeed
         config_default["randomMatrixSeed"]          = args.randomMatrixSeed
+        config_default["checkpointInterval"]        = args.checkpointInterval
+        if args.autoResume and args.checkpointInterval <= 0:
+            sys.exit("ERROR: automatic resume(-ar) requires a checkpoint interval(-chkp).")
+        config_default["autoResume"]                = args.autoResume
+        config_default["scalingBenchmark"]          = args.scalingBenchmark
+        config_default["scalingBenchmarkSweeps"]    = args.scalingBenchmarkSweeps
+        config_default["adaptiveNCor"]              = args.adaptiveNCor
+        config_default["adaptiveNCorTarget"]        = args.adaptiveNCorTarget
+        config_default["adaptiveNCorInterval"]      = args.adaptiveNCorInterval
+        config_default["adaptiveNCorMax"]           = args.adaptiveNCorMax
+        config_default["autoThermalization"]        = args.autoThermalization
+        config_default["NThermMin"]                 = args.NThermMin
+        config_default["thermalizationWindow"]      = args.thermalizationWindow
+        config_default["thermalizationInterval"]    = args.thermalizationInterval
+        config_default["thermalizationTolerance"]   = args.thermalizationTolerance
+        config_default["flowAnalysis"]              = args.flowAnalysis
+        config_default["NBootstraps"]               = args.NBootstraps
+        config_default["resamplingBlockSize"]       = args.resamplingBlockSize
+        if args.flowSchedule != None:
+            config_default["flowSchedule"]          = parse_flow_schedule(args.flowSchedule)
+        config_default["flowScheduleAdaptiveWidth"] = args.flowScheduleAdaptiveWidth
+        config_default["scaleSetting"]              = args.scaleSetting
+        config_default["scaleSettingMargin"]        = args.scaleSettingMargin
+        config_default["cartesianTopology"]         = args.cartesianTopology
+        config_default["sharedMemoryHalo"]          = args.sharedMemoryHalo
+        config_default["oneSidedMetropolis"]        = args.oneSidedMetropolis
+        config_default["siteOrdering"]              = args.siteOrdering
+        config_default["NChains"]                   = args.NChains
+        config_default["NFlowGroups"]               = args.NFlowGroups
         config_default["cpu_approx_runtime_hr"]     = args.cpu_approx_runtime_hr
         config_default["cpu_approx_runtime_min"]    = args.cpu_approx_runtime_min
         config_default["account_name"]              = args.account_name
@@ -1151,6 +1413,10 @@ def main(args):
         config_default["NRandTests"] = args.NRandTests
         config_default["NDerivativeTests"] = args.NDerivativeTests
         config_default["TaylorPolDegree"] = args.TaylorPolDegree
+        config_default["benchmarking"] = args.benchmark
+        config_default["benchmarkSubLatticeSizes"] = args.benchmarkSubLatticeSizes
+        config_default["benchmarkRepetitions"] = args.benchmarkRepetitions
+        config_default["benchmarkWarmup"] = args.benchmarkWarmup
 
         # Checks if we are to exclude any of the nodes
         if args.exclude:
@@ -1223,6 +1489,8 @@ def main(args):
         configuration["observables"] = ["energyTopcFieldDensity"]
         configuration["flowObservables"] = ["energyTopcFieldDensity"]
         configuration["samplingFrequency"] = args.samplingFrequency
+        configuration["compressFieldDensities"] = args.compressFieldDensities
+        configuration["fieldDensityQuantizationBits"] = args.fieldDensityQuantizationBits
 
         # Sets nodes to skip, usefull when clusters contain bad nodes
         if args.exclude:
@@ -0,0 +1,91 @@
+import numpy as np
+import sys
+
+"""
+Program for reading the compressed scalar fields(.cbin) written by GLAC, as
+given by LatticeActionChargeDensity when compressFieldDensities is true.
+Returns the field in the same layout as the uncompressed .bin files, that is
+with x running fastest. See GLAC/io/fieldcompression.h for the file layout.
+"""
+
+header_dtype = np.dtype([("magic", "S8"), ("version", "<u4"),
+	("quantization_bits", "<i4"), ("dimensions", "<u4", 4),
+	("sub_dimensions", "<u4", 4), ("number_of_blocks", "<u4"),
+	("config_number", "<u4"), ("padding", "S8")])
+
+index_dtype = np.dtype([("offset", "<u8"), ("size", "<u8"), ("scale", "<f8"),
+	("position", "<u4", 4)])
+
+def _read_varints(data):
+	"""Decodes a sequence of LEB128 variable length integers."""
+	values = []
+	value, shift = 0, 0
+	for byte in bytearray(data):
+		value |= (byte & 0x7F) << shift
+		if byte & 0x80:
+			shift += 7
+		else:
+			values.append(value)
+			value, shift = 0, 0
+	return np.array(values, dtype=np.uint64)
+
+def _decompress_block(data, quantization_bits, scale, size):
+	"""Decompresses a single block of doubles."""
+	if quantization_bits > 0:
+		zigzag = _read_varints(data)[:size]
+		deltas = (zigzag >> np.uint64(1)).astype(np.int64) ^ -(zigzag & np.uint64(1)).astype(np.int64)
+		step = scale / (2.0**(quantization_bits - 1) - 1.0)
+		return np.cumsum(deltas).astype(np.float64) * step
+	else:
+		data = bytearray(data)
+		values = np.empty(size, dtype=np.uint64)
+		previous, i = 0, 0
+		for j in range(size):
+			n = data[i]
+			residual = int.from_bytes(bytes(data[i+1:i+1+n]), "little")
+			previous ^= residual
+			values[j] = previous
+			i += 1 + n
+		return values.view(np.float64)
+
+def read_compressed_field(file_name, block=None):
+	"""
+	Reads a compressed scalar field.
+
+	Args:
+		file_name: path of the .cbin file.
+		block: optional, rank of a single block to read.
+
+	Returns:
+		the full field as a (t, z, y, x) numpy array, or the sub-lattice of
+		a single block when block is given.
+	"""
+	with open(file_name, "rb") as f:
+		header = np.frombuffer(f.read(header_dtype.itemsize), dtype=header_dtype)[0]
+		if header["magic"] != b"GLACCSF":
+			sys.exit("%s is not a compressed GLAC field." % file_name)
+		n_blocks = int(header["number_of_blocks"])
+		index = np.frombuffer(f.read(index_dtype.itemsize*n_blocks), dtype=index_dtype)
+
+		Nx, Ny, Nz, Nt = [int(n) for n in header["sub_dimensions"]]
+		N = [int(n) for n in header["dimensions"]]
+		field = np.empty((N[3], N[2], N[1], N[0]), dtype=np.float64)
+
+		blocks = range(n_blocks) if block is None else [block]
+		for b in blocks:
+			f.seek(int(index[b]["offset"]))
+			values = _decompress_block(f.read(int(index[b]["size"])),
+				int(header["quantization_bits"]), float(index[b]["scale"]),
+				Nx*Ny*Nz*Nt).reshape((Nt, Nz, Ny, Nx))
+			if block is not None:
+				return values
+			px, py, pz, pt = [int(p) for p in index[b]["position"]]
+			field[pt*Nt:(pt+1)*Nt, pz*Nz:(pz+1)*Nz, py*Ny:(py+1)*Ny, px*Nx:(px+1)*Nx] = values
+
+	return field
+
+if __name__ == '__main__':
+	if len(sys.argv) < 2:
+		sys.exit("Usage: python compressed_field_reader.py field.cbin")
+	field = read_compressed_field(sys.argv[1])
+	print("Field of shape %s: min %g, max %g, sum %g" % (field.shape, field.min(), field.max(), field.sum()))
@@ -6,8 +6,17 @@ Takes an file generated by N processors, and loads another one that has loaded,
 and then written the same configuration to file.
 """
 
-file1 = np.fromfile("output/scalar16cubed16run1.bin")
-file2 = np.fromfile("output/configs_profiling_run_beta6.000000_config1.bin")
+def load_links(file_path):
+	"""Loads the links of a configuration, skipping the 128 byte header if written with -fch."""
+	with open(file_path, "rb") as f:
+		if f.read(8) != b"GLACFLD\0":
+			f.seek(0)
+		else:
+			f.seek(128)
+		return np.fromfile(f)
+
+file1 = load_links("output/scalar16cubed16run1.bin")
+file2 = load_links("output/configs_profiling_run_beta6.000000_config1.bin")
 
 errors = 0
 
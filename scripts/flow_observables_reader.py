@@ -0,0 +1,63 @@
+import numpy as np
+import sys
+import zlib
+
+"""
+Program for reading the binary flow observable containers(.bdat) written by
+GLAC when binaryFlowObservables is true. See GLAC/io/observablescontainer.h
+for the file layout.
+"""
+
+header_dtype = np.dtype([("magic", "S8"), ("version", "<u4"), ("rows", "<u4"),
+	("columns", "<u4"), ("record_size", "<u4"), ("beta", "<f8"),
+	("flow_epsilon", "<f8"), ("padding", "S24")])
+
+def read_flow_observables(file_name, verify=True):
+	"""
+	Reads a binary flow observables container.
+
+	Args:
+		file_name: path of the .bdat file.
+		verify: optional, checks the CRC-32 of each record. Default is True.
+
+	Returns:
+		dictionary with beta, the flow times, the configuration numbers, and
+		the observables as an array of shape (configurations, rows, columns).
+		A record only partially written at the end of the file is skipped, and
+		the records are sorted by configuration number.
+	"""
+	with open(file_name, "rb") as f:
+		header = np.frombuffer(f.read(header_dtype.itemsize), dtype=header_dtype)[0]
+		if header["magic"] != b"GLACOBS":
+			sys.exit("%s is not a GLAC observables container." % file_name)
+		rows, columns = int(header["rows"]), int(header["columns"])
+		record_dtype = np.dtype([("config_number", "<u4"), ("crc", "<u4"),
+			("data", "<f8", (rows, columns))])
+		body = f.read()
+
+	n_records = len(body) // record_dtype.itemsize
+	records = np.frombuffer(body[:n_records*record_dtype.itemsize], dtype=record_dtype)
+
+	if verify:
+		for r in records:
+			if zlib.crc32(r["data"].tobytes()) & 0xFFFFFFFF != r["crc"]:
+				sys.exit("Checksum mismatch for configuration %d in %s." % (r["config_number"], file_name))
+
+	# A run restarted from a checkpoint may repeat the configurations after the
+	# checkpoint, of which the last record is kept
+	_, last = np.unique(records["config_number"][::-1], return_index=True)
+	records = records[len(records) - 1 - last]
+
+	return {
+		"beta": float(header["beta"]),
+		"flow_time": np.arange(rows)*float(header["flow_epsilon"]),
+		"config_numbers": records["config_number"].copy(),
+		"observables": records["data"].copy(),
+	}
+
+if __name__ == '__main__':
+	if len(sys.argv) < 2:
+		sys.exit("Usage: python flow_observables_reader.py observable_flow.bdat")
+	data = read_flow_observables(sys.argv[1])
+	print("beta %g: %d configurations, observables of shape %s" % (data["beta"],
+		len(data["config_numbers"]), data["observables"].shape[1:]))